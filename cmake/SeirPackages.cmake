@@ -95,6 +95,7 @@ include(${CMAKE_CURRENT_LIST_DIR}/SeirPackages/doctest.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/SeirPackages/fmt.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/SeirPackages/freetype.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/SeirPackages/jpeg.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/SeirPackages/lz4.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/SeirPackages/nasm.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/SeirPackages/ogg.cmake)
 include(${CMAKE_CURRENT_LIST_DIR}/SeirPackages/plf_colony.cmake)
@@ -0,0 +1,33 @@
+# This file is part of Seir.
+# Copyright (C) Sergei Blagodarin.
+# SPDX-License-Identifier: Apache-2.0
+
+# https://github.com/lz4/lz4/releases
+function(seir_provide_lz4 result)
+	cmake_parse_arguments(arg "FLAG" "SET_UPDATED;STATIC_RUNTIME" "" ${ARGN})
+	_seir_provide_begin("lz4")
+	set(version "1.10.0")
+	set(package "lz4-${version}")
+	seir_download("https://github.com/lz4/lz4/archive/refs/tags/v${version}.tar.gz"
+		NAME "${package}.tar.gz"
+		SHA256 "537512904744b35e232912055ccf8ec66d768639ff3abe5788d90d792ec5f48b"
+		EXTRACT_DIR "${package}"
+		RESULT downloaded
+		)
+	set(install_dir ${SEIR_3RDPARTY_DIR}/lz4)
+	if(downloaded OR NOT EXISTS ${install_dir})
+		set(source_dir ${CMAKE_BINARY_DIR}/${package})
+		set(build_dir ${source_dir}-build)
+		message(STATUS "[SEIR] Building lz4 from ${source_dir}")
+		_seir_cmake(${source_dir}/build/cmake ${build_dir} ${install_dir} STATIC_RUNTIME ${arg_STATIC_RUNTIME} OPTIONS
+			-DBUILD_SHARED_LIBS=OFF
+			-DBUILD_STATIC_LIBS=ON
+			-DLZ4_BUILD_CLI=OFF
+			)
+		message(STATUS "[SEIR] Provided lz4 at ${install_dir}")
+		if(arg_SET_UPDATED)
+			set(${arg_SET_UPDATED} ON PARENT_SCOPE)
+		endif()
+	endif()
+	_seir_provide_end_library("lz4")
+endfunction()
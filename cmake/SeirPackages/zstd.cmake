@@ -22,6 +22,7 @@ function(seir_provide_zstd result)
 			-DZSTD_BUILD_PROGRAMS=OFF
 			-DZSTD_BUILD_SHARED=OFF
 			-DZSTD_LEGACY_SUPPORT=OFF
+			-DZSTD_MULTITHREAD_SUPPORT=ON
 			-DZSTD_USE_STATIC_RUNTIME=${arg_STATIC_RUNTIME}
 			)
 		message(STATUS "[SEIR] Provided zstd at ${install_dir}")
@@ -5,6 +5,7 @@
 #include <seir_audio/player.hpp>
 
 #include <seir_audio/decoder.hpp>
+#include <seir_base/profiler.hpp>
 #include "backend.hpp"
 #include "mixer.hpp"
 
@@ -25,7 +26,10 @@ namespace
 	public:
 		AudioPlayerImpl(seir::AudioCallbacks& callbacks, unsigned preferredSamplingRate)
 			: _callbacks{ callbacks }
-			, _thread{ [this, preferredSamplingRate] { runAudioBackend(*this, preferredSamplingRate); } }
+			, _thread{ [this, preferredSamplingRate] {
+				SEIR_PROFILE_THREAD("Audio");
+				runAudioBackend(*this, preferredSamplingRate);
+			} }
 		{
 		}
 
@@ -114,6 +118,7 @@ namespace
 
 		size_t onBackendRead(float* output, size_t maxFrames) noexcept override
 		{
+			SEIR_PROFILE_ZONE("AudioMixing");
 			size_t totalFrames = 0;
 			for (const auto& decoder : _activeDecoders)
 				if (const auto frames = _mixer.mix(output, maxFrames, !totalFrames, *decoder); frames > totalFrames)
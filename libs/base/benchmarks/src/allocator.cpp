@@ -0,0 +1,90 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/allocator.hpp>
+#include <seir_base/arena_allocator.hpp>
+#include <seir_base/pool_allocator.hpp>
+
+#include <array>
+#include <cstdint>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	// Small allocations of mixed sizes typical for per-frame data (vertex batches, strings, etc.).
+	constexpr auto kAllocationSizes = [] {
+		std::array<size_t, 256> result{};
+		uint32_t state = 1;
+		for (auto& size : result)
+		{
+			state = state * 1664525u + 1013904223u;
+			size = 16 + (state >> 20) % 1024;
+		}
+		return result;
+	}();
+
+	// Allocates and immediately deallocates a block of the specified size.
+	template <class A>
+	void benchmark_allocate(benchmark::State& state)
+	{
+		const auto size = static_cast<size_t>(state.range(0));
+		for (auto _ : state)
+		{
+			auto capacity = size;
+			const auto memory = A::allocate(capacity);
+			benchmark::DoNotOptimize(memory);
+			A::deallocate(memory);
+		}
+		state.SetItemsProcessed(state.iterations());
+	}
+
+	// Allocates a "frame" of blocks of mixed sizes, then deallocates all of them.
+	template <class A>
+	void benchmark_frame(benchmark::State& state)
+	{
+		std::array<void*, kAllocationSizes.size()> blocks{};
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < blocks.size(); ++i)
+			{
+				auto size = kAllocationSizes[i];
+				blocks[i] = A::allocate(size);
+			}
+			benchmark::DoNotOptimize(blocks.data());
+			for (const auto block : blocks)
+				A::deallocate(block);
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(blocks.size()));
+	}
+
+	void benchmark_frameArena(benchmark::State& state)
+	{
+		seir::Arena arena;
+		std::array<void*, kAllocationSizes.size()> blocks{};
+		for (auto _ : state)
+		{
+			seir::ArenaScope scope{ arena };
+			for (size_t i = 0; i < blocks.size(); ++i)
+			{
+				auto size = kAllocationSizes[i];
+				blocks[i] = seir::ArenaAllocator::allocate(size);
+			}
+			benchmark::DoNotOptimize(blocks.data());
+		}
+		state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(blocks.size()));
+	}
+
+	void allocate_Malloc(benchmark::State& state) { benchmark_allocate<seir::Allocator>(state); }
+	void allocate_Pool(benchmark::State& state) { benchmark_allocate<seir::PoolAllocator>(state); }
+	void frame_Malloc(benchmark::State& state) { benchmark_frame<seir::Allocator>(state); }
+	void frame_Pool(benchmark::State& state) { benchmark_frame<seir::PoolAllocator>(state); }
+	void frame_Arena(benchmark::State& state) { benchmark_frameArena(state); }
+}
+
+BENCHMARK(allocate_Malloc)->RangeMultiplier(4)->Range(16, 4096)->ThreadRange(1, 4);
+BENCHMARK(allocate_Pool)->RangeMultiplier(4)->Range(16, 4096)->ThreadRange(1, 4);
+BENCHMARK(frame_Malloc)->ThreadRange(1, 4);
+BENCHMARK(frame_Pool)->ThreadRange(1, 4);
+BENCHMARK(frame_Arena)->ThreadRange(1, 4);
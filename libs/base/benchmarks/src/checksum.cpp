@@ -0,0 +1,43 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/checksum.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	std::vector<std::byte> makeData(size_t size)
+	{
+		std::vector<std::byte> result(size);
+		uint32_t state = 1;
+		for (auto& byte : result)
+		{
+			state = state * 1664525u + 1013904223u;
+			byte = static_cast<std::byte>(state >> 24);
+		}
+		return result;
+	}
+
+	template <class Checksum>
+	void benchmark_checksum(benchmark::State& state)
+	{
+		const auto input = makeData(static_cast<size_t>(state.range(0)));
+		for (auto _ : state)
+		{
+			const auto result = Checksum{}.process(input.data(), input.size()).value();
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+	}
+
+	void Adler32(benchmark::State& state) { benchmark_checksum<seir::Adler32>(state); }
+	void Crc32(benchmark::State& state) { benchmark_checksum<seir::Crc32>(state); }
+}
+
+BENCHMARK(Adler32)->RangeMultiplier(16)->Range(16, 1 << 20);
+BENCHMARK(Crc32)->RangeMultiplier(16)->Range(16, 1 << 20);
@@ -0,0 +1,67 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/base64.hpp>
+#include <seir_base/base85.hpp>
+
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	std::vector<std::byte> makeData(size_t size)
+	{
+		std::vector<std::byte> result(size);
+		uint32_t state = 1;
+		for (auto& byte : result)
+		{
+			state = state * 1664525u + 1013904223u;
+			byte = static_cast<std::byte>(state >> 24);
+		}
+		return result;
+	}
+
+	template <auto encodedSize, auto encode>
+	void benchmark_encode(benchmark::State& state)
+	{
+		const auto input = makeData(static_cast<size_t>(state.range(0)));
+		std::vector<char> output(encodedSize(input.size()));
+		for (auto _ : state)
+		{
+			const auto result = encode(output, input);
+			benchmark::DoNotOptimize(result);
+			benchmark::DoNotOptimize(output.data());
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(input.size()));
+	}
+
+	template <auto encodedSize, auto encode, auto decodedSize, auto decode>
+	void benchmark_decode(benchmark::State& state)
+	{
+		const auto data = makeData(static_cast<size_t>(state.range(0)));
+		std::vector<char> input(encodedSize(data.size()));
+		if (!encode(input, data))
+			return state.SkipWithError("Encoding failed");
+		std::vector<std::byte> output(decodedSize(input.size()));
+		for (auto _ : state)
+		{
+			const auto result = decode(output, input);
+			benchmark::DoNotOptimize(result);
+			benchmark::DoNotOptimize(output.data());
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(output.size()));
+	}
+
+	void encodeBase64Url(benchmark::State& state) { benchmark_encode<seir::base64EncodedSize, seir::encodeBase64Url>(state); }
+	void decodeBase64Url(benchmark::State& state) { benchmark_decode<seir::base64EncodedSize, seir::encodeBase64Url, seir::base64DecodedSize, seir::decodeBase64Url>(state); }
+	void encodeZ85(benchmark::State& state) { benchmark_encode<seir::base85EncodedSize, seir::encodeZ85>(state); }
+	void decodeZ85(benchmark::State& state) { benchmark_decode<seir::base85EncodedSize, seir::encodeZ85, seir::base85DecodedSize, seir::decodeZ85>(state); }
+}
+
+BENCHMARK(encodeBase64Url)->RangeMultiplier(16)->Range(16, 1 << 20);
+BENCHMARK(decodeBase64Url)->RangeMultiplier(16)->Range(16, 1 << 20);
+BENCHMARK(encodeZ85)->RangeMultiplier(16)->Range(16, 1 << 20);
+BENCHMARK(decodeZ85)->RangeMultiplier(16)->Range(16, 1 << 20);
@@ -0,0 +1,152 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/mpsc_ring.hpp>
+#include <seir_base/spsc_ring.hpp>
+#include <seir_base/triple_buffer.hpp>
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	constexpr size_t kItemCount = 1 << 16;
+
+	// Mutex-protected queue to compare lock-free queues against.
+	class LockedQueue
+	{
+	public:
+		bool tryPush(unsigned value)
+		{
+			std::scoped_lock lock{ _mutex };
+			_items.emplace_back(value);
+			return true;
+		}
+
+		bool tryPop(unsigned& value)
+		{
+			std::scoped_lock lock{ _mutex };
+			if (_items.empty())
+				return false;
+			value = _items.front();
+			_items.pop_front();
+			return true;
+		}
+
+	private:
+		std::mutex _mutex;
+		std::deque<unsigned> _items;
+	};
+
+	// Passes items from the specified number of producer threads to the benchmark thread.
+	template <typename Queue>
+	void benchmark_transfer(benchmark::State& state, Queue& queue)
+	{
+		const auto producerCount = static_cast<unsigned>(state.range(0));
+		const auto itemsPerProducer = static_cast<unsigned>(kItemCount / producerCount);
+		for (auto _ : state)
+		{
+			std::vector<std::thread> producers;
+			for (unsigned i = 0; i < producerCount; ++i)
+				producers.emplace_back([&queue, itemsPerProducer] {
+					for (unsigned j = 0; j < itemsPerProducer; ++j)
+						while (!queue.tryPush(j))
+							std::this_thread::yield();
+				});
+			unsigned value = 0;
+			for (auto remaining = itemsPerProducer * producerCount; remaining > 0;)
+			{
+				if (queue.tryPop(value))
+					--remaining;
+				else
+					std::this_thread::yield();
+			}
+			benchmark::DoNotOptimize(value);
+			for (auto& producer : producers)
+				producer.join();
+		}
+		state.SetItemsProcessed(state.iterations() * itemsPerProducer * producerCount);
+	}
+
+	// Measures round-trip latency by bouncing a single item between two threads.
+	void benchmark_pingPong(benchmark::State& state)
+	{
+		seir::SpscRing<unsigned, 2> forward;
+		seir::SpscRing<unsigned, 2> backward;
+		std::thread echo{ [&] {
+			for (unsigned value = 0; value != ~0u;)
+			{
+				while (!forward.tryPop(value))
+					std::this_thread::yield();
+				while (!backward.tryPush(value))
+					std::this_thread::yield();
+			}
+		} };
+		unsigned value = 0;
+		for (auto _ : state)
+		{
+			while (!forward.tryPush(value))
+				std::this_thread::yield();
+			while (!backward.tryPop(value))
+				std::this_thread::yield();
+		}
+		while (!forward.tryPush(~0u))
+			std::this_thread::yield();
+		echo.join();
+	}
+
+	void benchmark_tripleBuffer(benchmark::State& state)
+	{
+		seir::TripleBuffer<std::array<unsigned, 16>> buffer;
+		std::atomic<bool> stop{ false };
+		std::thread writer{ [&] {
+			for (unsigned i = 0; !stop.load(std::memory_order_relaxed); ++i)
+			{
+				buffer.back().fill(i);
+				buffer.publish();
+			}
+		} };
+		int64_t updates = 0;
+		for (auto _ : state)
+		{
+			updates += buffer.update();
+			benchmark::DoNotOptimize(buffer.front()[0]);
+		}
+		stop.store(true);
+		writer.join();
+		state.counters["updates"] = static_cast<double>(updates) / static_cast<double>(state.iterations());
+	}
+
+	void transfer_Spsc(benchmark::State& state)
+	{
+		seir::SpscRing<unsigned, 1024> queue;
+		benchmark_transfer(state, queue);
+	}
+
+	void transfer_Mpsc(benchmark::State& state)
+	{
+		seir::MpscRing<unsigned> queue{ 1024 };
+		benchmark_transfer(state, queue);
+	}
+
+	void transfer_Ref(benchmark::State& state)
+	{
+		LockedQueue queue;
+		benchmark_transfer(state, queue);
+	}
+
+	void pingPong_Spsc(benchmark::State& state) { benchmark_pingPong(state); }
+	void update_TripleBuffer(benchmark::State& state) { benchmark_tripleBuffer(state); }
+}
+
+BENCHMARK(transfer_Spsc)->Arg(1)->UseRealTime();
+BENCHMARK(transfer_Mpsc)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK(transfer_Ref)->Arg(1)->Arg(2)->Arg(4)->UseRealTime();
+BENCHMARK(pingPong_Spsc)->UseRealTime();
+BENCHMARK(update_TripleBuffer)->UseRealTime();
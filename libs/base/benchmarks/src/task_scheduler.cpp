@@ -0,0 +1,65 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/task_scheduler.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	// Some floating-point work which can't be optimized out.
+	float work(size_t index) noexcept
+	{
+		auto value = static_cast<float>(index);
+		for (int i = 0; i < 64; ++i)
+			value = std::sqrt(value + 1.f);
+		return value;
+	}
+
+	// Spawns the specified number of empty tasks and waits for them.
+	void spawn(benchmark::State& state)
+	{
+		seir::TaskScheduler scheduler{ static_cast<unsigned>(state.range(0)) };
+		const auto taskCount = state.range(1);
+		for (auto _ : state)
+		{
+			seir::TaskGroup group{ scheduler };
+			for (int64_t i = 0; i < taskCount; ++i)
+				group.run([] {});
+			group.wait();
+		}
+		state.SetItemsProcessed(state.iterations() * taskCount);
+	}
+
+	void parallelFor_Opt(benchmark::State& state)
+	{
+		seir::TaskScheduler scheduler{ static_cast<unsigned>(state.range(0)) };
+		std::vector<float> values(static_cast<size_t>(state.range(1)));
+		for (auto _ : state)
+		{
+			scheduler.parallelFor(0, values.size(), 256, [&values](size_t i) { values[i] = work(i); });
+			benchmark::DoNotOptimize(values.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(1));
+	}
+
+	void parallelFor_Ref(benchmark::State& state)
+	{
+		std::vector<float> values(static_cast<size_t>(state.range(1)));
+		for (auto _ : state)
+		{
+			for (size_t i = 0; i < values.size(); ++i)
+				values[i] = work(i);
+			benchmark::DoNotOptimize(values.data());
+		}
+		state.SetItemsProcessed(state.iterations() * state.range(1));
+	}
+}
+
+BENCHMARK(spawn)->ArgNames({ "workers", "tasks" })->ArgsProduct({ { 0, 1, 3, 7 }, { 1, 64, 4096 } })->UseRealTime();
+BENCHMARK(parallelFor_Opt)->ArgNames({ "workers", "size" })->ArgsProduct({ { 0, 1, 3, 7 }, { 1 << 12, 1 << 16 } })->UseRealTime();
+BENCHMARK(parallelFor_Ref)->ArgNames({ "workers", "size" })->Args({ 0, 1 << 12 })->Args({ 0, 1 << 16 })->UseRealTime();
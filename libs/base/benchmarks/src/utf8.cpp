@@ -0,0 +1,115 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/utf8.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	constexpr size_t kCorpusSize = 64 * 1024;
+
+	// Texts of about the same size in different scripts.
+	std::string makeCorpus(int64_t index)
+	{
+		constexpr std::array<std::string_view, 3> kSentences{
+			"The quick brown fox jumps over the lazy dog. ",
+			"\xd0\xa1\xd1\x8a\xd0\xb5\xd1\x88\xd1\x8c \xd0\xb6\xd0\xb5 \xd0\xb5\xd1\x89\xd1\x91 \xd1\x8d\xd1\x82\xd0\xb8\xd1\x85 "
+			"\xd0\xbc\xd1\x8f\xd0\xb3\xd0\xba\xd0\xb8\xd1\x85 \xd1\x84\xd1\x80\xd0\xb0\xd0\xbd\xd1\x86\xd1\x83\xd0\xb7\xd1\x81\xd0\xba\xd0\xb8\xd1\x85 "
+			"\xd0\xb1\xd1\x83\xd0\xbb\xd0\xbe\xd0\xba, \xd0\xb4\xd0\xb0 \xd0\xb2\xd1\x8b\xd0\xbf\xd0\xb5\xd0\xb9 \xd0\xb6\xd0\xb5 \xd1\x87\xd0\xb0\xd1\x8e. ",
+			"\xe6\x88\x91\xe8\x83\xbd\xe5\x90\x9e\xe4\xb8\x8b\xe7\x8e\xbb\xe7\x92\x83\xe8\x80\x8c\xe4\xb8\x8d\xe4\xbc\xa4\xe8\xba\xab\xe4\xbd\x93\xe3\x80\x82",
+		};
+		const auto sentence = kSentences[static_cast<size_t>(index)];
+		std::string result;
+		result.reserve(kCorpusSize + sentence.size());
+		while (result.size() < kCorpusSize)
+			result += sentence;
+		return result;
+	}
+
+	void setCorpusLabel(benchmark::State& state)
+	{
+		constexpr std::array<const char*, 3> kLabels{ "ASCII", "Cyrillic", "CJK" };
+		state.SetLabel(kLabels[static_cast<size_t>(state.range(0))]);
+	}
+
+	void isValidUtf8(benchmark::State& state)
+	{
+		const auto text = makeCorpus(state.range(0));
+		for (auto _ : state)
+		{
+			const auto result = seir::isValidUtf8(text);
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+		setCorpusLabel(state);
+	}
+
+	void countUtf8_Opt(benchmark::State& state)
+	{
+		const auto text = makeCorpus(state.range(0));
+		for (auto _ : state)
+		{
+			const auto result = seir::countUtf8(text);
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+		setCorpusLabel(state);
+	}
+
+	void countUtf8_Ref(benchmark::State& state)
+	{
+		const auto text = makeCorpus(state.range(0));
+		for (auto _ : state)
+		{
+			size_t result = 0;
+			for (size_t offset = 0; offset < text.size(); ++result)
+				static_cast<void>(seir::readUtf8(text, offset));
+			benchmark::DoNotOptimize(result);
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+		setCorpusLabel(state);
+	}
+
+	void decodeUtf8_Opt(benchmark::State& state)
+	{
+		const auto text = makeCorpus(state.range(0));
+		std::vector<char32_t> output(text.size());
+		for (auto _ : state)
+		{
+			size_t offset = 0;
+			const auto result = seir::decodeUtf8(output, text, offset);
+			benchmark::DoNotOptimize(result);
+			benchmark::DoNotOptimize(output.data());
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+		setCorpusLabel(state);
+	}
+
+	void decodeUtf8_Ref(benchmark::State& state)
+	{
+		const auto text = makeCorpus(state.range(0));
+		std::vector<char32_t> output(text.size());
+		for (auto _ : state)
+		{
+			size_t result = 0;
+			for (size_t offset = 0; offset < text.size();)
+				output[result++] = seir::readUtf8(text, offset);
+			benchmark::DoNotOptimize(result);
+			benchmark::DoNotOptimize(output.data());
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+		setCorpusLabel(state);
+	}
+}
+
+BENCHMARK(isValidUtf8)->DenseRange(0, 2);
+BENCHMARK(countUtf8_Opt)->DenseRange(0, 2);
+BENCHMARK(countUtf8_Ref)->DenseRange(0, 2);
+BENCHMARK(decodeUtf8_Opt)->DenseRange(0, 2);
+BENCHMARK(decodeUtf8_Ref)->DenseRange(0, 2);
@@ -0,0 +1,84 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace seir
+{
+	// Monotonic memory resource which allocates memory sequentially from large blocks
+	// and releases all of it at once. The blocks are kept for reuse until the arena is destroyed.
+	class Arena
+	{
+	public:
+		//
+		static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+		//
+		explicit Arena(size_t blockSize = kDefaultBlockSize) noexcept;
+		Arena(const Arena&) = delete;
+		Arena& operator=(const Arena&) = delete;
+		~Arena() noexcept;
+
+		// Returns the total size of memory blocks owned by the arena.
+		[[nodiscard]] constexpr size_t capacity() const noexcept { return _capacity; }
+
+		// Makes all memory allocated from the arena available for reuse.
+		void reset() noexcept;
+
+		// Allocates memory aligned to alignof(std::max_align_t),
+		// rounding the size up to the alignment.
+		[[nodiscard]] void* tryAllocate(size_t& size) noexcept;
+
+	private:
+		struct Block;
+		friend class ArenaScope;
+		const size_t _blockSize;
+		Block* _first = nullptr;
+		Block* _current = nullptr;
+		size_t _offset = 0;
+		size_t _capacity = 0;
+	};
+
+	// Makes the arena current for ArenaAllocator in the calling thread for the lifetime of the scope.
+	// On exit, restores the previously current arena and releases everything allocated within the scope.
+	class ArenaScope
+	{
+	public:
+		explicit ArenaScope(Arena&) noexcept;
+		ArenaScope(const ArenaScope&) = delete;
+		ArenaScope& operator=(const ArenaScope&) = delete;
+		~ArenaScope() noexcept;
+
+	private:
+		Arena& _arena;
+		Arena* const _previousArena;
+		Arena::Block* const _block;
+		const size_t _offset;
+	};
+
+	// Allocator which takes memory from the current arena of the calling thread.
+	// Deallocation does nothing, the memory is released when the arena scope ends.
+	class ArenaAllocator
+	{
+	public:
+		//
+		[[nodiscard]] static void* allocate(size_t& size);
+
+		//
+		static void deallocate(void*) noexcept {}
+
+		// Returns nullptr if there is no current arena.
+		[[nodiscard]] static void* tryAllocate(size_t& size) noexcept;
+	};
+}
+
+inline void* seir::ArenaAllocator::allocate(size_t& size)
+{
+	if (const auto memory = tryAllocate(size); memory) [[likely]]
+		return memory;
+	throw std::bad_alloc{};
+}
@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <span>
+#include <type_traits>
 
 namespace seir
 {
@@ -20,6 +21,14 @@ namespace seir
 
 	// Decodes base64url-encoded data (RFC 4648, see https://datatracker.ietf.org/doc/html/rfc4648).
 	[[nodiscard]] constexpr bool decodeBase64Url(std::span<std::byte> output, std::span<const char> input) noexcept;
+
+	// Encodes the beginning of the input using SIMD instructions (if available) and returns the number
+	// of bytes encoded, which is a multiple of 3. The output must be large enough for the entire input.
+	[[nodiscard]] size_t encodeBase64UrlBulk(std::span<char> output, std::span<const std::byte> input) noexcept;
+
+	// Decodes the beginning of the input using SIMD instructions (if available) and returns the number
+	// of characters decoded, which is a multiple of 4. Stops before blocks with invalid characters.
+	[[nodiscard]] size_t decodeBase64UrlBulk(std::span<std::byte> output, std::span<const char> input) noexcept;
 }
 
 constexpr size_t seir::base64EncodedSize(size_t size) noexcept
@@ -35,8 +44,14 @@ constexpr bool seir::encodeBase64Url(std::span<char> output, std::span<const std
 		return false;
 	auto out = output.data();
 	auto in = input.data();
+	if (!std::is_constant_evaluated())
+	{
+		const auto size = encodeBase64UrlBulk(output, input);
+		out += size / 3 * 4;
+		in += size;
+	}
 	const auto tail = input.size() % 3;
-	for (const auto end = in + input.size() - tail; in != end;)
+	for (const auto end = input.data() + input.size() - tail; in != end;)
 	{
 		auto value = std::to_integer<uint32_t>(*in++) << 16;
 		*out++ = table[value >> 18];
@@ -92,7 +107,13 @@ constexpr bool seir::decodeBase64Url(std::span<std::byte> output, std::span<cons
 		return false;
 	auto out = output.data();
 	auto in = input.data();
-	for (const auto end = in + input.size() - tail; in != end;)
+	if (!std::is_constant_evaluated())
+	{
+		const auto size = decodeBase64UrlBulk(output, input.first(input.size() - tail));
+		out += size / 4 * 3;
+		in += size;
+	}
+	for (const auto end = input.data() + input.size() - tail; in != end;)
 	{
 		uint32_t value = 0;
 		for (size_t i = 0; i < 4; ++i)
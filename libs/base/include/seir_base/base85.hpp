@@ -6,6 +6,7 @@
 
 #include <cstdint>
 #include <span>
+#include <type_traits>
 
 namespace seir
 {
@@ -20,6 +21,14 @@ namespace seir
 
 	// Decodes Z85-encoded data (see https://rfc.zeromq.org/spec/32/).
 	[[nodiscard]] constexpr bool decodeZ85(std::span<std::byte> output, std::span<const char> input) noexcept;
+
+	// Encodes the beginning of the input using SIMD instructions (if available) and returns the number
+	// of bytes encoded, which is a multiple of 4. The output must be large enough for the entire input.
+	[[nodiscard]] size_t encodeZ85Bulk(std::span<char> output, std::span<const std::byte> input) noexcept;
+
+	// Decodes the beginning of the input using SIMD instructions (if available) and returns the number
+	// of characters decoded, which is a multiple of 5. Stops before blocks with invalid characters.
+	[[nodiscard]] size_t decodeZ85Bulk(std::span<std::byte> output, std::span<const char> input) noexcept;
 }
 
 constexpr size_t seir::base85EncodedSize(size_t size) noexcept
@@ -35,8 +44,14 @@ constexpr bool seir::encodeZ85(std::span<char> output, std::span<const std::byte
 		return false;
 	auto out = output.data();
 	auto in = input.data();
+	if (!std::is_constant_evaluated())
+	{
+		const auto size = encodeZ85Bulk(output, input);
+		out += size / 4 * 5;
+		in += size;
+	}
 	const auto tail = input.size() & 0b11;
-	for (const auto end = in + input.size() - tail; in != end;)
+	for (const auto end = input.data() + input.size() - tail; in != end;)
 	{
 		auto value = std::to_integer<uint32_t>(*in++) << 24;
 		value += std::to_integer<uint32_t>(*in++) << 16;
@@ -50,23 +65,17 @@ constexpr bool seir::encodeZ85(std::span<char> output, std::span<const std::byte
 	}
 	if (tail > 0)
 	{
-		auto value = std::to_integer<uint32_t>(in[0]) << 24;
-		if (tail > 1)
+		uint32_t value = 0;
+		for (size_t i = 0; i < tail; ++i)
+			value += std::to_integer<uint32_t>(in[i]) << (24 - 8 * i);
+		// Missing digits are decoded as zeros, so the value is rounded up to keep the encoded bytes intact.
+		const uint32_t scale = tail == 1 ? 85 * 85 * 85 : (tail == 2 ? 85 * 85 : 85);
+		value = (value + scale - 1) / scale;
+		for (auto i = tail + 1; i > 0; --i)
 		{
-			value += std::to_integer<uint32_t>(in[1]) << 16;
-			if (tail > 2)
-			{
-				value += std::to_integer<uint32_t>(in[2]) << 8;
-				out[3] = table[(value + 84) / 85 % 85];
-				out[2] = table[value / (85 * 85) % 85];
-			}
-			else
-				out[2] = table[(value + 84 * 85) / (85 * 85) % 85];
-			out[1] = table[value / (85 * 85 * 85) % 85];
+			out[i - 1] = table[value % 85];
+			value /= 85;
 		}
-		else
-			out[1] = table[(value + 84 * 85 * 85) / (85 * 85 * 85) % 85];
-		out[0] = table[value / (85 * 85 * 85 * 85)]; // cppcheck-suppress[unreadVariable]
 	}
 	return true;
 }
@@ -103,7 +112,13 @@ constexpr bool seir::decodeZ85(std::span<std::byte> output, std::span<const char
 		return false;
 	auto out = output.data();
 	auto in = input.data();
-	for (const auto end = in + input.size() - tail; in != end;)
+	if (!std::is_constant_evaluated())
+	{
+		const auto size = decodeZ85Bulk(output, input.first(input.size() - tail));
+		out += size / 5 * 4;
+		in += size;
+	}
+	for (const auto end = input.data() + input.size() - tail; in != end;)
 	{
 		uint64_t value = 0;
 		for (size_t i = 0; i < 5; ++i)
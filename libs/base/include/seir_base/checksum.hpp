@@ -0,0 +1,54 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace seir
+{
+	// CRC-32 with the reflected 0xEDB88320 polynomial (the one used by zlib, PNG, ZIP, etc.).
+	// Uses carry-less multiplication or CRC instructions where available.
+	class Crc32
+	{
+	public:
+		constexpr Crc32() noexcept = default;
+
+		//
+		Crc32& process(const void* data, size_t size) noexcept;
+
+		//
+		[[nodiscard]] constexpr uint32_t value() const noexcept { return ~_value; }
+
+	private:
+		uint32_t _value = 0xffffffff;
+	};
+
+	// Adler-32 as defined by the zlib specification.
+	class Adler32
+	{
+	public:
+		constexpr Adler32() noexcept = default;
+
+		//
+		Adler32& process(const void* data, size_t size) noexcept;
+
+		// Appends the checksum of the data which follows the data processed so far.
+		constexpr Adler32& combine(const Adler32& next, size_t nextSize) noexcept
+		{
+			_b = static_cast<uint32_t>((_b + next._b + nextSize % kModulus * uint64_t{ _a + kModulus - 1 }) % kModulus);
+			_a = (_a + next._a + kModulus - 1) % kModulus;
+			return *this;
+		}
+
+		//
+		[[nodiscard]] constexpr uint32_t value() const noexcept { return _b << 16 | _a; }
+
+	private:
+		static constexpr uint32_t kModulus = 65521;
+		uint32_t _a = 1;
+		uint32_t _b = 0;
+	};
+}
@@ -4,9 +4,12 @@
 
 #pragma once
 
+#include <seir_base/profiler.hpp>
+
 #include <cassert>
 #include <chrono>
 #include <optional>
+#include <type_traits>
 
 // TODO: Remove '#ifndef __APPLE__' when P0355 is implemented: https://libcxx.llvm.org/Status/Cxx20.html
 
@@ -50,6 +53,7 @@ namespace seir
 	};
 
 	// Variable frame rate clock, useful for FPS measurement.
+	// If profiling is enabled, steady clock frames are reported to the Profiler.
 	template <typename Clock = std::chrono::steady_clock>
 #ifndef __APPLE__
 	requires std::chrono::is_clock_v<Clock>
@@ -130,6 +134,10 @@ std::optional<seir::VariablePeriod> seir::VariableRate<Clock>::advance() noexcep
 		_lastFrameTime = now;
 		return {};
 	}
+#if SEIR_PROFILER
+	if constexpr (std::is_same_v<Clock, Profiler::Clock>)
+		Profiler::addFrame(_lastFrameTime, now);
+#endif
 	const auto frameDuration = now - _lastFrameTime;
 	_lastFrameTime = now;
 	if (frameDuration > _maxFrameDuration)
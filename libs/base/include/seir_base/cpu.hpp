@@ -0,0 +1,18 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+namespace seir
+{
+	// Instruction set extensions which are not required by the build but may be available at runtime.
+	enum class CpuFeature
+	{
+		Avx2,
+		Pclmul,
+	};
+
+	// Checks whether the CPU the program is running on supports the feature.
+	[[nodiscard]] bool hasCpuFeature(CpuFeature) noexcept;
+}
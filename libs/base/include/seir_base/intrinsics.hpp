@@ -11,6 +11,19 @@
 #		include <x86intrin.h>
 #	endif
 #	define SEIR_INTRINSICS_SSE 1
+#	define SEIR_INTRINSICS_NEON 0
+#elif defined(_M_ARM64) || defined(__aarch64__)
+#	include <arm_neon.h>
+#	define SEIR_INTRINSICS_SSE 0
+#	define SEIR_INTRINSICS_NEON 1
 #else
 #	define SEIR_INTRINSICS_SSE 0
+#	define SEIR_INTRINSICS_NEON 0
+#endif
+
+// Enables instruction set extensions for a function which is called only if they're supported at runtime.
+#if defined(__GNUC__) || defined(__clang__)
+#	define SEIR_TARGET(features) __attribute__((target(features)))
+#else
+#	define SEIR_TARGET(features)
 #endif
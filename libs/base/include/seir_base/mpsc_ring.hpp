@@ -0,0 +1,100 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_base/allocator.hpp>
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace seir
+{
+	// Bounded lock-free queue for multiple producer threads and a single consumer thread
+	// (based on the bounded MPMC queue by Dmitry Vyukov).
+	// The allocator must provide memory suitably aligned for T.
+	template <typename T, typename A = Allocator>
+	class MpscRing
+	{
+	public:
+		// Creates a queue with the capacity rounded up to a power of two.
+		explicit MpscRing(size_t capacity)
+			: _mask{ std::bit_ceil(capacity > 1 ? capacity : 2) - 1 }
+		{
+			auto size = (_mask + 1) * sizeof(Cell);
+			_cells = static_cast<Cell*>(A::allocate(size));
+			for (size_t i = 0; i <= _mask; ++i)
+				std::construct_at(&_cells[i]._sequence, i);
+		}
+
+		MpscRing(const MpscRing&) = delete;
+		MpscRing& operator=(const MpscRing&) = delete;
+
+		~MpscRing() noexcept
+		{
+			for (auto head = _head; _cells[head & _mask]._sequence.load(std::memory_order_acquire) == head + 1; ++head)
+				std::destroy_at(reinterpret_cast<T*>(_cells[head & _mask]._value));
+			A::deallocate(_cells);
+		}
+
+		[[nodiscard]] constexpr size_t capacity() const noexcept { return _mask + 1; }
+
+		// Adds an item to the queue if it isn't full. May be called by any thread.
+		template <typename... Args>
+		[[nodiscard]] bool tryPush(Args&&... args) noexcept
+		{
+			// A claimed cell must always be published, otherwise the consumer would wait for it forever.
+			static_assert(noexcept(T{ std::declval<Args>()... }), "MpscRing items must be constructed without throwing");
+			auto tail = _tail.load(std::memory_order_relaxed);
+			for (;;)
+			{
+				auto& cell = _cells[tail & _mask];
+				const auto difference = static_cast<std::make_signed_t<size_t>>(cell._sequence.load(std::memory_order_acquire) - tail);
+				if (!difference)
+				{
+					if (_tail.compare_exchange_weak(tail, tail + 1, std::memory_order_relaxed))
+					{
+						new (cell._value) T{ std::forward<Args>(args)... };
+						cell._sequence.store(tail + 1, std::memory_order_release);
+						return true;
+					}
+				}
+				else if (difference < 0)
+					return false;
+				else
+					tail = _tail.load(std::memory_order_relaxed);
+			}
+		}
+
+		// Moves the oldest item out of the queue if it isn't empty. Must be called only by the consumer thread.
+		[[nodiscard]] bool tryPop(T& value) noexcept(std::is_nothrow_move_assignable_v<T>)
+		{
+			auto& cell = _cells[_head & _mask];
+			if (cell._sequence.load(std::memory_order_acquire) != _head + 1)
+				return false;
+			const auto source = reinterpret_cast<T*>(cell._value);
+			value = std::move(*source);
+			std::destroy_at(source);
+			cell._sequence.store(_head + _mask + 1, std::memory_order_release);
+			++_head;
+			return true;
+		}
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_t> _sequence;
+			alignas(T) std::byte _value[sizeof(T)];
+		};
+
+		const size_t _mask;
+		Cell* _cells = nullptr;
+		alignas(64) std::atomic<size_t> _tail{ 0 };
+		alignas(64) size_t _head = 0;
+	};
+}
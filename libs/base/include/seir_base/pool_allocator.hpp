@@ -0,0 +1,39 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <new>
+
+namespace seir
+{
+	// Allocator which rounds small allocations up to power-of-two size classes
+	// and serves them from per-thread caches of free blocks, falling back
+	// to a shared pool and then to the general heap. The memory is aligned
+	// to alignof(std::max_align_t) and may be deallocated from any thread.
+	// Freed small blocks are never returned to the general heap.
+	class PoolAllocator
+	{
+	public:
+		//
+		static constexpr size_t kMaxPooledSize = 4096;
+
+		//
+		[[nodiscard]] static void* allocate(size_t& size);
+
+		//
+		static void deallocate(void* memory) noexcept;
+
+		//
+		[[nodiscard]] static void* tryAllocate(size_t& size) noexcept;
+	};
+}
+
+inline void* seir::PoolAllocator::allocate(size_t& size)
+{
+	if (const auto memory = tryAllocate(size); memory) [[likely]]
+		return memory;
+	throw std::bad_alloc{};
+}
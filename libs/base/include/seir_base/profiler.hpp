@@ -0,0 +1,85 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_base/macros.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Profiling macros expand to nothing unless SEIR_PROFILER is nonzero.
+#ifndef SEIR_PROFILER
+#	define SEIR_PROFILER 0
+#endif
+
+namespace seir
+{
+	// Collects timings of code zones from all threads.
+	// Zones are recorded to lock-free per-thread ring buffers which are drained
+	// on every frame (see VariableRate) and when the profile is exported.
+	// Only the latest zones of every thread are kept (see setRecordLimit), so the profile doesn't grow indefinitely.
+	// Zone and thread names must have static storage duration (e.g. be string literals).
+	class Profiler
+	{
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		// Records a zone of the calling thread. The zone is dropped if the thread's buffer is full.
+		static void addZone(const char* name, Clock::time_point begin, Clock::time_point end) noexcept;
+
+		// Records a frame zone and moves recorded zones from per-thread buffers to the profile.
+		static void addFrame(Clock::time_point begin, Clock::time_point end) noexcept;
+
+		// Discards the profile and all recorded zones.
+		static void clear() noexcept;
+
+		// Moves recorded zones from per-thread buffers to the profile.
+		static void collect() noexcept;
+
+		// Returns the profile in a compact binary format:
+		// - "SeirProfile" signature;
+		// - string count, then every string as its length followed by its characters;
+		// - thread count, then every thread as its name index (plus one, zero if the thread isn't named)
+		//   and zone count, followed by every zone as its name index, start time delta
+		//   (from the previous zone of the thread) and duration in nanoseconds.
+		// Zones are ordered by start time, and all numbers are LEB128-encoded.
+		[[nodiscard]] static std::vector<std::byte> binaryTrace();
+
+		// Returns the profile in Chrome trace event format (JSON).
+		[[nodiscard]] static std::string chromeTrace();
+
+		// Sets the maximum number of zones kept for every thread (2^20 by default).
+		// The oldest zones of a thread are discarded when there are more.
+		static void setRecordLimit(size_t) noexcept;
+
+		// Sets the name of the calling thread.
+		static void setThreadName(const char* name) noexcept;
+	};
+
+	// Records a zone from construction to destruction.
+	class ProfilerZone
+	{
+	public:
+		explicit ProfilerZone(const char* name) noexcept
+			: _name{ name }, _begin{ Profiler::Clock::now() } {}
+		ProfilerZone(const ProfilerZone&) = delete;
+		ProfilerZone& operator=(const ProfilerZone&) = delete;
+		~ProfilerZone() noexcept { Profiler::addZone(_name, _begin, Profiler::Clock::now()); }
+
+	private:
+		const char* const _name;
+		const Profiler::Clock::time_point _begin;
+	};
+}
+
+#if SEIR_PROFILER
+#	define SEIR_PROFILE_THREAD(name) seir::Profiler::setThreadName(name)
+#	define SEIR_PROFILE_ZONE(name) const seir::ProfilerZone SEIR_JOIN(seirProfilerZone, __LINE__)(name)
+#else
+#	define SEIR_PROFILE_THREAD(name) static_cast<void>(0)
+#	define SEIR_PROFILE_ZONE(name) static_cast<void>(0)
+#endif
@@ -0,0 +1,80 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace seir
+{
+	// Fixed-capacity wait-free queue for a single producer thread and a single consumer thread.
+	template <typename T, size_t kCapacity>
+	class SpscRing // NOLINT(cppcoreguidelines-pro-type-member-init)
+	{
+	public:
+		static_assert(std::has_single_bit(kCapacity));
+
+		constexpr SpscRing() noexcept = default;
+		SpscRing(const SpscRing&) = delete;
+		SpscRing& operator=(const SpscRing&) = delete;
+
+		~SpscRing() noexcept
+		{
+			for (auto head = _head.load(std::memory_order_relaxed), tail = _tail.load(std::memory_order_relaxed); head != tail; ++head)
+				std::destroy_at(item(head));
+		}
+
+		[[nodiscard]] static constexpr size_t capacity() noexcept { return kCapacity; }
+
+		// Returns the number of items in the queue, which may be outdated by the time it returns.
+		[[nodiscard]] size_t size() const noexcept { return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire); }
+
+		// Adds an item to the queue if it isn't full. Must be called only by the producer thread.
+		template <typename... Args>
+		[[nodiscard]] bool tryPush(Args&&... args) noexcept(std::is_nothrow_constructible_v<T, Args...>)
+		{
+			const auto tail = _tail.load(std::memory_order_relaxed);
+			if (tail - _producerHead == kCapacity)
+			{
+				_producerHead = _head.load(std::memory_order_acquire);
+				if (tail - _producerHead == kCapacity)
+					return false;
+			}
+			new (item(tail)) T{ std::forward<Args>(args)... };
+			_tail.store(tail + 1, std::memory_order_release);
+			return true;
+		}
+
+		// Moves the oldest item out of the queue if it isn't empty. Must be called only by the consumer thread.
+		[[nodiscard]] bool tryPop(T& value) noexcept(std::is_nothrow_move_assignable_v<T>)
+		{
+			const auto head = _head.load(std::memory_order_relaxed);
+			if (head == _consumerTail)
+			{
+				_consumerTail = _tail.load(std::memory_order_acquire);
+				if (head == _consumerTail)
+					return false;
+			}
+			const auto source = item(head);
+			value = std::move(*source);
+			std::destroy_at(source);
+			_head.store(head + 1, std::memory_order_release);
+			return true;
+		}
+
+	private:
+		T* item(size_t index) noexcept { return reinterpret_cast<T*>(_data) + (index & (kCapacity - 1)); }
+
+		// Each side caches the other side's index to touch the shared cache line only when necessary.
+		alignas(64) std::atomic<size_t> _head{ 0 };
+		size_t _consumerTail = 0;
+		alignas(64) std::atomic<size_t> _tail{ 0 };
+		size_t _producerHead = 0;
+		alignas(64) alignas(T) std::byte _data[kCapacity * sizeof(T)];
+	};
+}
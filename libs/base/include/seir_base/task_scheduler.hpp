@@ -0,0 +1,149 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_base/pool_allocator.hpp>
+
+#include <atomic>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace seir
+{
+	class TaskGroup;
+
+	// Work-stealing task scheduler. Every worker thread has its own task deque;
+	// tasks spawned by a worker are pushed to its deque, and idle workers steal
+	// tasks from others. Threads which wait for task groups help executing tasks.
+	class TaskScheduler
+	{
+	public:
+		// Starts the specified number of worker threads.
+		// The default is one thread less than the number of hardware threads
+		// because the thread which waits for the tasks executes them too.
+		explicit TaskScheduler(unsigned workerCount = defaultWorkerCount());
+		TaskScheduler(const TaskScheduler&) = delete;
+		TaskScheduler& operator=(const TaskScheduler&) = delete;
+		~TaskScheduler() noexcept;
+
+		//
+		[[nodiscard]] static unsigned defaultWorkerCount() noexcept;
+
+		//
+		[[nodiscard]] unsigned workerCount() const noexcept;
+
+		// Calls the function for every index in [first, last) in parallel and waits for all calls to finish.
+		// The range is split recursively until parts have no more than the grain size indices.
+		template <class F>
+		void parallelFor(size_t first, size_t last, size_t grain, F&& function);
+
+	private:
+		// Type-erased task header, allocated together with the function it runs.
+		struct Task
+		{
+			void (*_run)(Task*) noexcept = nullptr;
+			TaskGroup* _group = nullptr;
+		};
+
+		const std::unique_ptr<class TaskSchedulerImpl> _impl;
+		void submit(Task*); // May throw if the task queue fails to grow.
+		void wait(const std::atomic<size_t>& pending) noexcept;
+		void notifyAll() noexcept;
+		friend TaskGroup;
+		friend TaskSchedulerImpl;
+	};
+
+	// Set of tasks which can be waited for.
+	// The tasks must not throw exceptions and must finish before the group is destroyed.
+	class TaskGroup
+	{
+	public:
+		explicit TaskGroup(TaskScheduler& scheduler) noexcept
+			: _scheduler{ scheduler } {}
+		TaskGroup(const TaskGroup&) = delete;
+		TaskGroup& operator=(const TaskGroup&) = delete;
+		~TaskGroup() noexcept { wait(); }
+
+		// Schedules the function for execution.
+		// If scheduling fails, the exception is propagated and the function is not run.
+		template <class F>
+		void run(F&& function);
+
+		// Executes pending tasks until all tasks of the group are finished.
+		void wait() noexcept { _scheduler.wait(_pending); }
+
+	private:
+		template <class F>
+		struct TaskImpl : TaskScheduler::Task
+		{
+			F _function;
+		};
+
+		TaskScheduler& _scheduler;
+		std::atomic<size_t> _pending{ 0 };
+		void finish() noexcept;
+	};
+}
+
+template <class F>
+void seir::TaskScheduler::parallelFor(size_t first, size_t last, size_t grain, F&& function)
+{
+	TaskGroup group{ *this };
+	const auto split = [&group, &function, grain = grain > 0 ? grain : 1](const auto& self, size_t begin, size_t end) -> void {
+		while (end - begin > grain)
+		{
+			const auto middle = begin + (end - begin) / 2;
+			group.run([&self, middle, end] { self(self, middle, end); });
+			end = middle;
+		}
+		for (; begin < end; ++begin)
+			function(begin);
+	};
+	if (first < last)
+		split(split, first, last);
+	group.wait();
+}
+
+template <class F>
+void seir::TaskGroup::run(F&& function)
+{
+	using Impl = TaskImpl<std::decay_t<F>>;
+	auto size = sizeof(Impl);
+	static_assert(alignof(Impl) <= alignof(std::max_align_t));
+	const auto memory = PoolAllocator::allocate(size);
+	Impl* task;
+	try
+	{
+		task = new (memory) Impl{ {}, std::forward<F>(function) };
+	}
+	catch (...)
+	{
+		PoolAllocator::deallocate(memory);
+		throw;
+	}
+	task->_run = [](TaskScheduler::Task* base) noexcept {
+		const auto self = static_cast<Impl*>(base);
+		const auto group = self->_group;
+		self->_function();
+		self->~Impl();
+		PoolAllocator::deallocate(self);
+		group->finish();
+	};
+	task->_group = this;
+	_pending.fetch_add(1, std::memory_order_relaxed);
+	try
+	{
+		_scheduler.submit(task);
+	}
+	catch (...)
+	{
+		task->~Impl();
+		PoolAllocator::deallocate(task);
+		finish();
+		throw;
+	}
+}
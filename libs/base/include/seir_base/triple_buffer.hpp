@@ -0,0 +1,60 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace seir
+{
+	// Wait-free single-value channel between a writer thread and a reader thread.
+	// The writer fills the back buffer and publishes it, the reader picks up
+	// the most recently published buffer, and neither of them ever blocks the other.
+	template <typename T>
+	class TripleBuffer
+	{
+	public:
+		TripleBuffer() = default;
+		TripleBuffer(const TripleBuffer&) = delete;
+		TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+		// Returns the buffer to be filled by the writer.
+		[[nodiscard]] T& back() noexcept { return _slots[_back]._value; }
+
+		// Makes the back buffer available to the reader. Must be called only by the writer thread.
+		// The new back buffer contains whatever was there the last time it was swapped.
+		void publish() noexcept
+		{
+			_back = _middle.exchange(static_cast<uint8_t>(_back | kDirty), std::memory_order_acq_rel) & kIndexMask;
+		}
+
+		// Returns the buffer last obtained by the reader.
+		[[nodiscard]] const T& front() const noexcept { return _slots[_front]._value; }
+
+		// Makes the most recently published buffer the front one if there is one.
+		// Returns false if nothing was published since the last update. Must be called only by the reader thread.
+		bool update() noexcept
+		{
+			if (!(_middle.load(std::memory_order_relaxed) & kDirty))
+				return false;
+			_front = _middle.exchange(_front, std::memory_order_acq_rel) & kIndexMask;
+			return true;
+		}
+
+	private:
+		static constexpr uint8_t kIndexMask = 0x3;
+		static constexpr uint8_t kDirty = 0x4;
+
+		struct alignas(64) Slot
+		{
+			T _value{};
+		};
+
+		Slot _slots[3];
+		alignas(64) std::atomic<uint8_t> _middle{ 1 };
+		alignas(64) uint8_t _back = 0;
+		alignas(64) uint8_t _front = 2;
+	};
+}
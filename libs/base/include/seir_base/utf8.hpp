@@ -6,6 +6,7 @@
 
 #include <array>
 #include <cstdint>
+#include <span>
 #include <string_view>
 
 namespace seir
@@ -68,4 +69,17 @@ namespace seir
 		}
 		return 0;
 	}
+
+	// Checks whether the text is well-formed UTF-8 (see https://www.unicode.org/versions/latest/ch03.pdf, table 3-7),
+	// i.e. contains no overlong encodings, surrogates or codepoints above U+10FFFF.
+	[[nodiscard]] bool isValidUtf8(std::string_view text) noexcept;
+
+	// Returns the number of codepoints in valid UTF-8 text.
+	// For invalid text, returns the number of bytes which are not continuation bytes.
+	[[nodiscard]] size_t countUtf8(std::string_view text) noexcept;
+
+	// Decodes codepoints starting at the specified offset until either the text or the output ends,
+	// advancing the offset and returning the number of codepoints decoded.
+	// The result is the same as of calling readUtf8 repeatedly.
+	[[nodiscard]] size_t decodeUtf8(std::span<char32_t> output, std::string_view text, size_t& offset) noexcept;
 }
@@ -0,0 +1,100 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/arena_allocator.hpp>
+
+#include <seir_base/allocator.hpp>
+
+#include <algorithm>
+#include <limits>
+
+namespace
+{
+	constexpr size_t kArenaAlignment = alignof(std::max_align_t);
+
+	thread_local seir::Arena* currentArena = nullptr;
+}
+
+namespace seir
+{
+	// Block data follows the header, which is aligned so the data is aligned too.
+	struct alignas(kArenaAlignment) Arena::Block
+	{
+		Block* _next;
+		size_t _size;
+	};
+
+	Arena::Arena(size_t blockSize) noexcept
+		: _blockSize{ (std::max<size_t>(blockSize, kArenaAlignment) + kArenaAlignment - 1) & ~(kArenaAlignment - 1) }
+	{
+	}
+
+	Arena::~Arena() noexcept
+	{
+		for (auto block = _first; block;)
+		{
+			const auto next = block->_next;
+			Allocator::deallocate(block);
+			block = next;
+		}
+	}
+
+	void Arena::reset() noexcept
+	{
+		_current = nullptr;
+		_offset = 0;
+	}
+
+	void* Arena::tryAllocate(size_t& size) noexcept
+	{
+		if (size > std::numeric_limits<size_t>::max() - sizeof(Block) - kArenaAlignment) [[unlikely]]
+			return nullptr;
+		const auto alignedSize = (std::max<size_t>(size, 1) + kArenaAlignment - 1) & ~(kArenaAlignment - 1);
+		if (!_current || _current->_size - _offset < alignedSize)
+		{
+			// The remaining space in the current block is wasted, which is fine as long
+			// as allocations are much smaller than blocks. Larger allocations get their own blocks.
+			auto& link = _current ? _current->_next : _first;
+			if (!link || link->_size < alignedSize)
+			{
+				const auto blockSize = std::max(_blockSize, alignedSize);
+				auto allocationSize = sizeof(Block) + blockSize;
+				const auto block = static_cast<Block*>(Allocator::tryAllocate(allocationSize));
+				if (!block) [[unlikely]]
+					return nullptr;
+				block->_next = link;
+				block->_size = blockSize;
+				link = block;
+				_capacity += blockSize;
+			}
+			_current = link;
+			_offset = 0;
+		}
+		const auto memory = reinterpret_cast<std::byte*>(_current + 1) + _offset;
+		_offset += alignedSize;
+		size = alignedSize;
+		return memory;
+	}
+
+	ArenaScope::ArenaScope(Arena& arena) noexcept
+		: _arena{ arena }
+		, _previousArena{ currentArena }
+		, _block{ arena._current }
+		, _offset{ arena._offset }
+	{
+		currentArena = &arena;
+	}
+
+	ArenaScope::~ArenaScope() noexcept
+	{
+		_arena._current = _block;
+		_arena._offset = _offset;
+		currentArena = _previousArena;
+	}
+
+	void* ArenaAllocator::tryAllocate(size_t& size) noexcept
+	{
+		return currentArena ? currentArena->tryAllocate(size) : nullptr;
+	}
+}
@@ -0,0 +1,202 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/base64.hpp>
+
+#include <seir_base/cpu.hpp>
+#include <seir_base/intrinsics.hpp>
+
+// The x86 code is based on the algorithms by Wojciech Muła
+// (see http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+// and http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html).
+
+namespace
+{
+#if SEIR_INTRINSICS_SSE
+	// Converts 12 bytes in the low part of the vector into 16 characters.
+	__m128i encodeBase64UrlSse(__m128i input) noexcept
+	{
+		input = _mm_shuffle_epi8(input, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+		const auto indices = _mm_or_si128(
+			_mm_mulhi_epu16(_mm_and_si128(input, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040)),
+			_mm_mullo_epi16(_mm_and_si128(input, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010)));
+		// 0 for 'a'-'z', 1-10 for '0'-'9', 11 for '-', 12 for '_' and 13 for 'A'-'Z'.
+		const auto ranges = _mm_or_si128(_mm_subs_epu8(indices, _mm_set1_epi8(51)), _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+		const auto offsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0);
+		return _mm_add_epi8(indices, _mm_shuffle_epi8(offsets, ranges));
+	}
+
+	// Converts 16 characters into 12 bytes in the low part of the vector.
+	// Returns false if there are invalid characters.
+	bool decodeBase64UrlSse(__m128i& data) noexcept
+	{
+		const auto lowNibbles = _mm_and_si128(data, _mm_set1_epi8(0x0F));
+		const auto highNibbles = _mm_and_si128(_mm_srli_epi32(data, 4), _mm_set1_epi8(0x0F));
+		// A character is valid if the masks for its nibbles have no common bits.
+		const auto lowMasks = _mm_setr_epi8(0x25, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x23, 0x3B, 0x3B, 0x3A, 0x3B, 0x33);
+		const auto highMasks = _mm_setr_epi8(0x20, 0x20, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20);
+		if (!_mm_testz_si128(_mm_shuffle_epi8(lowMasks, lowNibbles), _mm_shuffle_epi8(highMasks, highNibbles)))
+			return false;
+		const auto offsets = _mm_setr_epi8(0, 0, 62 - '-', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a', 0, 0, 0, 0, 0, 0, 0, 0);
+		const auto values = _mm_add_epi8(data, _mm_blendv_epi8(_mm_shuffle_epi8(offsets, highNibbles), _mm_set1_epi8(63 - '_'), _mm_cmpeq_epi8(data, _mm_set1_epi8('_'))));
+		const auto merged = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+		data = _mm_shuffle_epi8(merged, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+		return true;
+	}
+
+	SEIR_TARGET("avx2")
+	size_t encodeBase64UrlAvx2(char* output, const std::byte* input, size_t size) noexcept
+	{
+		auto out = output;
+		auto in = input;
+		for (const auto end = input + size; end - in >= 28; in += 24, out += 32)
+		{
+			auto data = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))), _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 12)), 1);
+			data = _mm256_shuffle_epi8(data, _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+			const auto indices = _mm256_or_si256(
+				_mm256_mulhi_epu16(_mm256_and_si256(data, _mm256_set1_epi32(0x0FC0FC00)), _mm256_set1_epi32(0x04000040)),
+				_mm256_mullo_epi16(_mm256_and_si256(data, _mm256_set1_epi32(0x003F03F0)), _mm256_set1_epi32(0x01000010)));
+			const auto ranges = _mm256_or_si256(_mm256_subs_epu8(indices, _mm256_set1_epi8(51)), _mm256_and_si256(_mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices), _mm256_set1_epi8(13)));
+			const auto offsets = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0,
+				'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_add_epi8(indices, _mm256_shuffle_epi8(offsets, ranges)));
+		}
+		return static_cast<size_t>(in - input);
+	}
+
+	SEIR_TARGET("avx2")
+	size_t decodeBase64UrlAvx2(std::byte* output, size_t outputSize, const char* input, size_t inputSize) noexcept
+	{
+		auto out = output;
+		auto in = input;
+		const auto outEnd = output + outputSize;
+		for (const auto inEnd = input + inputSize; inEnd - in >= 32 && outEnd - out >= 32; in += 32, out += 24)
+		{
+			const auto data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+			const auto lowNibbles = _mm256_and_si256(data, _mm256_set1_epi8(0x0F));
+			const auto highNibbles = _mm256_and_si256(_mm256_srli_epi32(data, 4), _mm256_set1_epi8(0x0F));
+			const auto lowMasks = _mm256_setr_epi8(0x25, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x23, 0x3B, 0x3B, 0x3A, 0x3B, 0x33,
+				0x25, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x21, 0x23, 0x3B, 0x3B, 0x3A, 0x3B, 0x33);
+			const auto highMasks = _mm256_setr_epi8(0x20, 0x20, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20,
+				0x20, 0x20, 0x01, 0x02, 0x04, 0x08, 0x04, 0x10, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20, 0x20);
+			if (!_mm256_testz_si256(_mm256_shuffle_epi8(lowMasks, lowNibbles), _mm256_shuffle_epi8(highMasks, highNibbles)))
+				break;
+			const auto offsets = _mm256_setr_epi8(0, 0, 62 - '-', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a', 0, 0, 0, 0, 0, 0, 0, 0,
+				0, 0, 62 - '-', 52 - '0', -'A', -'A', 26 - 'a', 26 - 'a', 0, 0, 0, 0, 0, 0, 0, 0);
+			const auto values = _mm256_add_epi8(data, _mm256_blendv_epi8(_mm256_shuffle_epi8(offsets, highNibbles), _mm256_set1_epi8(63 - '_'), _mm256_cmpeq_epi8(data, _mm256_set1_epi8('_'))));
+			auto merged = _mm256_madd_epi16(_mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140)), _mm256_set1_epi32(0x00011000));
+			merged = _mm256_shuffle_epi8(merged, _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(out), _mm256_permutevar8x32_epi32(merged, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 7, 7)));
+		}
+		return static_cast<size_t>(in - input);
+	}
+#elif SEIR_INTRINSICS_NEON
+	constexpr char kBase64UrlAlphabet[65] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+	constexpr uint8_t kBad = 0xFF;
+	constexpr uint8_t kBase64UrlValues[128]{
+		kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad,
+		kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad,
+		kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, kBad, 0x3E, kBad, kBad,
+		0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, kBad, kBad, kBad, kBad, kBad, kBad,
+		kBad, 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E,
+		0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, kBad, kBad, kBad, kBad, 0x3F,
+		kBad, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25, 0x26, 0x27, 0x28,
+		0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, kBad, kBad, kBad, kBad, kBad
+	};
+
+	uint8x16x4_t loadNeonTable(const uint8_t* data) noexcept
+	{
+		return { vld1q_u8(data), vld1q_u8(data + 16), vld1q_u8(data + 32), vld1q_u8(data + 48) };
+	}
+#endif
+}
+
+namespace seir
+{
+	size_t encodeBase64UrlBulk(std::span<char> output, std::span<const std::byte> input) noexcept
+	{
+		auto out = output.data();
+		auto in = input.data();
+		const auto end = in + input.size();
+#if SEIR_INTRINSICS_SSE
+		if (hasCpuFeature(CpuFeature::Avx2))
+		{
+			const auto size = ::encodeBase64UrlAvx2(out, in, input.size());
+			in += size;
+			out += size / 3 * 4;
+		}
+		for (; end - in >= 16; in += 12, out += 16)
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), ::encodeBase64UrlSse(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in))));
+#elif SEIR_INTRINSICS_NEON
+		const auto table = ::loadNeonTable(reinterpret_cast<const uint8_t*>(kBase64UrlAlphabet));
+		for (; end - in >= 48; in += 48, out += 64)
+		{
+			const auto data = vld3q_u8(reinterpret_cast<const uint8_t*>(in));
+			const auto mask = vdupq_n_u8(0b111111);
+			uint8x16x4_t indices;
+			indices.val[0] = vshrq_n_u8(data.val[0], 2);
+			indices.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(data.val[0], 4), vshrq_n_u8(data.val[1], 4)), mask);
+			indices.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(data.val[1], 2), vshrq_n_u8(data.val[2], 6)), mask);
+			indices.val[3] = vandq_u8(data.val[2], mask);
+			for (auto& vector : indices.val)
+				vector = vqtbl4q_u8(table, vector);
+			vst4q_u8(reinterpret_cast<uint8_t*>(out), indices);
+		}
+#else
+		static_cast<void>(out);
+		static_cast<void>(end);
+#endif
+		return static_cast<size_t>(in - input.data());
+	}
+
+	size_t decodeBase64UrlBulk(std::span<std::byte> output, std::span<const char> input) noexcept
+	{
+		auto out = output.data();
+		auto in = input.data();
+		const auto outEnd = out + output.size();
+		const auto inEnd = in + input.size();
+#if SEIR_INTRINSICS_SSE
+		if (hasCpuFeature(CpuFeature::Avx2))
+		{
+			const auto size = ::decodeBase64UrlAvx2(out, output.size(), in, input.size());
+			in += size;
+			out += size / 4 * 3;
+		}
+		for (; inEnd - in >= 16 && outEnd - out >= 16; in += 16, out += 12)
+		{
+			auto data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+			if (!::decodeBase64UrlSse(data))
+				break;
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), data);
+		}
+#elif SEIR_INTRINSICS_NEON
+		const auto lowTable = ::loadNeonTable(kBase64UrlValues);
+		const auto highTable = ::loadNeonTable(kBase64UrlValues + 64);
+		for (; inEnd - in >= 64 && outEnd - out >= 48; in += 64, out += 48)
+		{
+			auto data = vld4q_u8(reinterpret_cast<const uint8_t*>(in));
+			auto invalid = vdupq_n_u8(0);
+			for (auto& vector : data.val)
+			{
+				// Out-of-range indices produce zeros for vqtbl4q and leave values unchanged for vqtbx4q.
+				vector = vorrq_u8(vqtbx4q_u8(vqtbl4q_u8(lowTable, vector), highTable, vsubq_u8(vector, vdupq_n_u8(64))), vcgeq_u8(vector, vdupq_n_u8(128)));
+				invalid = vorrq_u8(invalid, vector);
+			}
+			if (vmaxvq_u8(invalid) >= 64)
+				break;
+			uint8x16x3_t bytes;
+			bytes.val[0] = vorrq_u8(vshlq_n_u8(data.val[0], 2), vshrq_n_u8(data.val[1], 4));
+			bytes.val[1] = vorrq_u8(vshlq_n_u8(data.val[1], 4), vshrq_n_u8(data.val[2], 2));
+			bytes.val[2] = vorrq_u8(vshlq_n_u8(data.val[2], 6), data.val[3]);
+			vst3q_u8(reinterpret_cast<uint8_t*>(out), bytes);
+		}
+#else
+		static_cast<void>(out);
+		static_cast<void>(outEnd);
+		static_cast<void>(inEnd);
+#endif
+		return static_cast<size_t>(in - input.data());
+	}
+}
@@ -0,0 +1,130 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/base85.hpp>
+
+#include <seir_base/intrinsics.hpp>
+
+namespace
+{
+#if SEIR_INTRINSICS_SSE
+	constexpr uint8_t kBad = 0xFF;
+
+	// Z85 values of characters from 0x20 to 0x7F.
+	alignas(16) constexpr uint8_t kZ85Values[6][16]{
+		{ kBad, 0x44, kBad, 0x54, 0x53, 0x52, 0x48, kBad, 0x4B, 0x4C, 0x46, 0x41, kBad, 0x3F, 0x3E, 0x45 },
+		{ 0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x40, kBad, 0x49, 0x42, 0x4A, 0x47 },
+		{ 0x51, 0x24, 0x25, 0x26, 0x27, 0x28, 0x29, 0x2A, 0x2B, 0x2C, 0x2D, 0x2E, 0x2F, 0x30, 0x31, 0x32 },
+		{ 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39, 0x3A, 0x3B, 0x3C, 0x3D, 0x4D, kBad, 0x4E, 0x43, kBad },
+		{ kBad, 0x0A, 0x0B, 0x0C, 0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18 },
+		{ 0x19, 0x1A, 0x1B, 0x1C, 0x1D, 0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x4F, kBad, 0x50, kBad, kBad },
+	};
+
+	// Divides 32-bit unsigned integers by 85 using multiplication by the reciprocal.
+	__m128i divideBy85(__m128i value) noexcept
+	{
+		const auto reciprocal = _mm_set1_epi32(static_cast<int>(0xC0C0C0C1)); // ceil(2^38 / 85)
+		const auto even = _mm_srli_epi64(_mm_mul_epu32(value, reciprocal), 38);
+		const auto odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(value, 32), reciprocal), 38);
+		return _mm_blend_epi16(even, _mm_slli_epi64(odd, 32), 0b11001100);
+	}
+
+	// Converts bytes in the range [0, 85) to Z85 characters.
+	__m128i z85Characters(__m128i digits) noexcept
+	{
+		auto characters = _mm_add_epi8(digits, _mm_set1_epi8('0'));
+		characters = _mm_add_epi8(characters, _mm_and_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8(9)), _mm_set1_epi8('a' - 10 - '0')));
+		characters = _mm_add_epi8(characters, _mm_and_si128(_mm_cmpgt_epi8(digits, _mm_set1_epi8(35)), _mm_set1_epi8('A' - 36 - ('a' - 10))));
+		const auto index = _mm_sub_epi8(digits, _mm_set1_epi8(62)); // Negative indices produce zeros.
+		const auto punctuation = _mm_blendv_epi8(
+			_mm_shuffle_epi8(_mm_setr_epi8('.', '-', ':', '+', '=', '^', '!', '/', '*', '?', '&', '<', '>', '(', ')', '['), index),
+			_mm_shuffle_epi8(_mm_setr_epi8(']', '{', '}', '@', '%', '$', '#', 0, 0, 0, 0, 0, 0, 0, 0, 0), _mm_sub_epi8(index, _mm_set1_epi8(16))),
+			_mm_cmpgt_epi8(index, _mm_set1_epi8(15)));
+		return _mm_blendv_epi8(characters, punctuation, _mm_cmpgt_epi8(index, _mm_set1_epi8(-1)));
+	}
+
+	// Converts characters to Z85 values, producing 0xFF for invalid characters.
+	__m128i z85Digits(__m128i characters) noexcept
+	{
+		const auto lowNibbles = _mm_and_si128(characters, _mm_set1_epi8(0x0F));
+		const auto highNibbles = _mm_and_si128(_mm_srli_epi32(characters, 4), _mm_set1_epi8(0x0F));
+		auto digits = _mm_set1_epi8(-1);
+		for (int i = 0; i < 6; ++i)
+			digits = _mm_blendv_epi8(digits, _mm_shuffle_epi8(_mm_load_si128(reinterpret_cast<const __m128i*>(kZ85Values[i])), lowNibbles), _mm_cmpeq_epi8(highNibbles, _mm_set1_epi8(static_cast<char>(2 + i))));
+		return digits;
+	}
+#endif
+}
+
+namespace seir
+{
+	size_t encodeZ85Bulk(std::span<char> output, std::span<const std::byte> input) noexcept
+	{
+		auto out = output.data();
+		auto in = input.data();
+#if SEIR_INTRINSICS_SSE
+		for (const auto end = in + input.size(); end - in >= 16; in += 16, out += 20)
+		{
+			auto value = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12));
+			__m128i digits[5];
+			for (int i = 4; i > 0; --i)
+			{
+				const auto quotient = ::divideBy85(value);
+				digits[i] = _mm_sub_epi32(value, _mm_mullo_epi32(quotient, _mm_set1_epi32(85)));
+				value = quotient;
+			}
+			digits[0] = value;
+			// Digits 0-3 of every group are in the first vector (digit-major), and digits 4 are in the second one.
+			const auto first = ::z85Characters(_mm_packus_epi16(_mm_packus_epi32(digits[0], digits[1]), _mm_packus_epi32(digits[2], digits[3])));
+			const auto second = ::z85Characters(_mm_packus_epi16(_mm_packus_epi32(digits[4], _mm_setzero_si128()), _mm_setzero_si128()));
+			const auto head = _mm_or_si128(
+				_mm_shuffle_epi8(first, _mm_setr_epi8(0, 4, 8, 12, -1, 1, 5, 9, 13, -1, 2, 6, 10, 14, -1, 3)),
+				_mm_shuffle_epi8(second, _mm_setr_epi8(-1, -1, -1, -1, 0, -1, -1, -1, -1, 1, -1, -1, -1, -1, 2, -1)));
+			const auto tail = _mm_or_si128(
+				_mm_shuffle_epi8(first, _mm_setr_epi8(-1, 1, 5, 9, 13, -1, 2, 6, 10, 14, -1, 3, 7, 11, 15, -1)),
+				_mm_shuffle_epi8(second, _mm_setr_epi8(0, -1, -1, -1, -1, 1, -1, -1, -1, -1, 2, -1, -1, -1, -1, 3)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), head);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out + 4), tail);
+		}
+#else
+		static_cast<void>(out);
+#endif
+		return static_cast<size_t>(in - input.data());
+	}
+
+	size_t decodeZ85Bulk(std::span<std::byte> output, std::span<const char> input) noexcept
+	{
+		auto out = output.data();
+		auto in = input.data();
+#if SEIR_INTRINSICS_SSE
+		const auto outEnd = out + output.size();
+		for (const auto inEnd = in + input.size(); inEnd - in >= 20 && outEnd - out >= 16; in += 20, out += 16)
+		{
+			const auto first = ::z85Digits(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)));
+			const auto second = ::z85Digits(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 4)));
+			if (_mm_movemask_epi8(_mm_or_si128(first, second)))
+				break;
+			// Digits 0-3 of every group go to its 32-bit lane, and so do digits 4 in another vector.
+			const auto high = _mm_or_si128(
+				_mm_shuffle_epi8(first, _mm_setr_epi8(0, 1, 2, 3, 5, 6, 7, 8, 10, 11, 12, 13, -1, -1, -1, -1)),
+				_mm_shuffle_epi8(second, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 11, 12, 13, 14)));
+			const auto low = _mm_or_si128(
+				_mm_shuffle_epi8(first, _mm_setr_epi8(4, -1, -1, -1, 9, -1, -1, -1, 14, -1, -1, -1, -1, -1, -1, -1)),
+				_mm_shuffle_epi8(second, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 15, -1, -1, -1)));
+			const auto partial = _mm_madd_epi16(_mm_maddubs_epi16(high, _mm_set1_epi16(0x0155)), _mm_set1_epi32(0x0001'0000 + 85 * 85));
+			constexpr int kMaxPartial = 0xFFFF'FFFF / 85; // 0xFFFFFFFF is divisible by 85.
+			const auto overflow = _mm_or_si128(
+				_mm_cmpgt_epi32(partial, _mm_set1_epi32(kMaxPartial)),
+				_mm_and_si128(_mm_cmpeq_epi32(partial, _mm_set1_epi32(kMaxPartial)), _mm_cmpgt_epi32(low, _mm_setzero_si128())));
+			if (!_mm_testz_si128(overflow, overflow))
+				break;
+			const auto value = _mm_add_epi32(_mm_mullo_epi32(partial, _mm_set1_epi32(85)), low);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(value, _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12)));
+		}
+#else
+		static_cast<void>(out);
+#endif
+		return static_cast<size_t>(in - input.data());
+	}
+}
@@ -0,0 +1,265 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/checksum.hpp>
+
+#include <seir_base/cpu.hpp>
+#include <seir_base/endian.hpp>
+#include <seir_base/intrinsics.hpp>
+
+#include <array>
+#include <cstring>
+
+#if SEIR_INTRINSICS_NEON && defined(__ARM_FEATURE_CRC32)
+#	include <arm_acle.h>
+#	define SEIR_CRC32_ARM 1
+#endif
+
+namespace
+{
+	constexpr uint32_t kCrc32Polynomial = 0xedb88320;
+
+	// Table k maps a byte to the CRC of that byte followed by k zero bytes,
+	// which allows to process 16 bytes at a time with independent lookups.
+	constexpr auto kCrc32Tables = [] {
+		std::array<std::array<uint32_t, 256>, 16> tables{};
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			auto value = i;
+			for (int bit = 0; bit < 8; ++bit)
+				value = (value >> 1) ^ (kCrc32Polynomial & (0 - (value & 1)));
+			tables[0][i] = value;
+		}
+		for (size_t k = 1; k < tables.size(); ++k)
+			for (size_t i = 0; i < 256; ++i)
+				tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xff];
+		return tables;
+	}();
+
+	inline uint32_t load32(const uint8_t* data) noexcept
+	{
+		uint32_t value;
+		std::memcpy(&value, data, sizeof value);
+		return seir::littleEndian(value);
+	}
+
+	uint32_t crc32Scalar(uint32_t crc, const uint8_t* data, size_t size) noexcept
+	{
+		const auto& t = kCrc32Tables;
+		for (; size >= 16; data += 16, size -= 16)
+		{
+			const auto a = crc ^ ::load32(data);
+			const auto b = ::load32(data + 4);
+			const auto c = ::load32(data + 8);
+			const auto d = ::load32(data + 12);
+			crc = t[15][a & 0xff] ^ t[14][(a >> 8) & 0xff] ^ t[13][(a >> 16) & 0xff] ^ t[12][a >> 24]
+				^ t[11][b & 0xff] ^ t[10][(b >> 8) & 0xff] ^ t[9][(b >> 16) & 0xff] ^ t[8][b >> 24]
+				^ t[7][c & 0xff] ^ t[6][(c >> 8) & 0xff] ^ t[5][(c >> 16) & 0xff] ^ t[4][c >> 24]
+				^ t[3][d & 0xff] ^ t[2][(d >> 8) & 0xff] ^ t[1][(d >> 16) & 0xff] ^ t[0][d >> 24];
+		}
+		for (; size > 0; ++data, --size)
+			crc = t[0][(crc ^ *data) & 0xff] ^ (crc >> 8);
+		return crc;
+	}
+
+#if SEIR_INTRINSICS_SSE
+	// Folds 64-byte blocks using carry-less multiplication and reduces the result with Barrett reduction,
+	// as described in "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" by Intel.
+	// The size must be a multiple of 16 and no less than 64.
+	SEIR_TARGET("pclmul")
+	inline __m128i crc32Fold(__m128i x, __m128i k, __m128i next) noexcept
+	{
+		return _mm_xor_si128(_mm_xor_si128(_mm_clmulepi64_si128(x, k, 0x11), _mm_clmulepi64_si128(x, k, 0x00)), next);
+	}
+
+	SEIR_TARGET("pclmul")
+	uint32_t crc32Pclmul(uint32_t crc, const uint8_t* data, size_t size) noexcept
+	{
+		const auto k1k2 = _mm_set_epi64x(0x01c6e41596, 0x0154442bd4);
+		const auto k3k4 = _mm_set_epi64x(0x00ccaa009e, 0x01751997d0);
+		const auto k5k0 = _mm_set_epi64x(0, 0x0163cd6124);
+		const auto poly = _mm_set_epi64x(0x01f7011641, 0x01db710641);
+		const auto mask32 = _mm_setr_epi32(-1, 0, -1, 0);
+
+		auto x1 = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)), _mm_cvtsi32_si128(static_cast<int>(crc)));
+		auto x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+		auto x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32));
+		auto x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48));
+		data += 64;
+		size -= 64;
+		for (; size >= 64; data += 64, size -= 64)
+		{
+			x1 = ::crc32Fold(x1, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+			x2 = ::crc32Fold(x2, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16)));
+			x3 = ::crc32Fold(x3, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 32)));
+			x4 = ::crc32Fold(x4, k1k2, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 48)));
+		}
+		x1 = ::crc32Fold(x1, k3k4, x2);
+		x1 = ::crc32Fold(x1, k3k4, x3);
+		x1 = ::crc32Fold(x1, k3k4, x4);
+		for (; size >= 16; data += 16, size -= 16)
+			x1 = ::crc32Fold(x1, k3k4, _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+
+		// 128 bits to 64 bits.
+		x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), _mm_clmulepi64_si128(x1, k3k4, 0x10));
+		x1 = _mm_xor_si128(_mm_srli_si128(x1, 4), _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k5k0, 0x00));
+
+		// 64 bits to 32 bits.
+		auto x2r = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), poly, 0x10);
+		x2r = _mm_clmulepi64_si128(_mm_and_si128(x2r, mask32), poly, 0x00);
+		return static_cast<uint32_t>(_mm_extract_epi32(_mm_xor_si128(x1, x2r), 1));
+	}
+#elif defined(SEIR_CRC32_ARM)
+	// The size must be a multiple of 8.
+	uint32_t crc32Arm(uint32_t crc, const uint8_t* data, size_t size) noexcept
+	{
+		for (; size >= 32; data += 32, size -= 32)
+		{
+			uint64_t values[4];
+			std::memcpy(values, data, sizeof values);
+			crc = __crc32d(crc, values[0]);
+			crc = __crc32d(crc, values[1]);
+			crc = __crc32d(crc, values[2]);
+			crc = __crc32d(crc, values[3]);
+		}
+		for (; size > 0; data += 8, size -= 8)
+		{
+			uint64_t value;
+			std::memcpy(&value, data, sizeof value);
+			crc = __crc32d(crc, value);
+		}
+		return crc;
+	}
+#endif
+
+	constexpr uint32_t kAdlerModulus = 65521;
+	constexpr size_t kAdlerMaxBlockSize = 5552; // The largest block size which can't overflow the sums.
+
+	void adler32Scalar(uint32_t& a, uint32_t& b, const uint8_t* data, size_t size) noexcept
+	{
+		while (size > 0)
+		{
+			const auto blockSize = size < kAdlerMaxBlockSize ? size : kAdlerMaxBlockSize;
+			for (size_t i = 0; i < blockSize; ++i)
+			{
+				a += data[i];
+				b += a;
+			}
+			a %= kAdlerModulus;
+			b %= kAdlerModulus;
+			data += blockSize;
+			size -= blockSize;
+		}
+	}
+
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+	// Processes 32-byte chunks and returns the number of bytes processed.
+	// Within a chunk, byte i contributes (32 - i) times its value to B,
+	// and A at the start of the chunk contributes 32 times its value.
+	size_t adler32Vectorized(uint32_t& a, uint32_t& b, const uint8_t* data, size_t size) noexcept
+	{
+		constexpr size_t kChunkSize = 32;
+		constexpr size_t kMaxChunks = kAdlerMaxBlockSize / kChunkSize;
+		const auto processedSize = size - size % kChunkSize;
+		for (auto chunks = processedSize / kChunkSize; chunks > 0;)
+		{
+			const auto blockChunks = chunks < kMaxChunks ? chunks : kMaxChunks;
+			chunks -= blockChunks;
+#	if SEIR_INTRINSICS_SSE
+			const auto weights1 = _mm_setr_epi8(32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17);
+			const auto weights2 = _mm_setr_epi8(16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1);
+			const auto ones = _mm_set1_epi16(1);
+			const auto zero = _mm_setzero_si128();
+			auto sumA = _mm_setzero_si128();
+			auto sumB = _mm_setzero_si128();
+			auto prefixA = _mm_cvtsi32_si128(static_cast<int>(a * blockChunks)); // The sum of A values at chunk starts.
+			for (auto i = blockChunks; i > 0; --i, data += kChunkSize)
+			{
+				const auto bytes1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+				const auto bytes2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + 16));
+				prefixA = _mm_add_epi32(prefixA, sumA);
+				sumA = _mm_add_epi32(sumA, _mm_add_epi32(_mm_sad_epu8(bytes1, zero), _mm_sad_epu8(bytes2, zero)));
+				sumB = _mm_add_epi32(sumB, _mm_madd_epi16(_mm_maddubs_epi16(bytes1, weights1), ones));
+				sumB = _mm_add_epi32(sumB, _mm_madd_epi16(_mm_maddubs_epi16(bytes2, weights2), ones));
+			}
+			sumB = _mm_add_epi32(sumB, _mm_slli_epi32(prefixA, 5));
+			sumA = _mm_add_epi32(sumA, _mm_shuffle_epi32(sumA, _MM_SHUFFLE(1, 0, 3, 2)));
+			sumB = _mm_add_epi32(sumB, _mm_shuffle_epi32(sumB, _MM_SHUFFLE(2, 3, 0, 1)));
+			sumB = _mm_add_epi32(sumB, _mm_shuffle_epi32(sumB, _MM_SHUFFLE(1, 0, 3, 2)));
+			a += static_cast<uint32_t>(_mm_cvtsi128_si32(sumA));
+			b += static_cast<uint32_t>(_mm_cvtsi128_si32(sumB));
+#	elif SEIR_INTRINSICS_NEON
+			static constexpr uint16_t kWeights[kChunkSize]{ 32, 31, 30, 29, 28, 27, 26, 25, 24, 23, 22, 21, 20, 19, 18, 17, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, 3, 2, 1 };
+			auto sumA = vdupq_n_u32(0);
+			auto prefixA = vsetq_lane_u32(a * static_cast<uint32_t>(blockChunks), vdupq_n_u32(0), 0);
+			auto columns1 = vdupq_n_u16(0); // Per-column byte sums can't overflow 16 bits within a block.
+			auto columns2 = vdupq_n_u16(0);
+			auto columns3 = vdupq_n_u16(0);
+			auto columns4 = vdupq_n_u16(0);
+			for (auto i = blockChunks; i > 0; --i, data += kChunkSize)
+			{
+				const auto bytes1 = vld1q_u8(data);
+				const auto bytes2 = vld1q_u8(data + 16);
+				prefixA = vaddq_u32(prefixA, sumA);
+				sumA = vpadalq_u16(sumA, vpadalq_u8(vpaddlq_u8(bytes1), bytes2));
+				columns1 = vaddw_u8(columns1, vget_low_u8(bytes1));
+				columns2 = vaddw_u8(columns2, vget_high_u8(bytes1));
+				columns3 = vaddw_u8(columns3, vget_low_u8(bytes2));
+				columns4 = vaddw_u8(columns4, vget_high_u8(bytes2));
+			}
+			auto sumB = vshlq_n_u32(prefixA, 5);
+			sumB = vmlal_u16(sumB, vget_low_u16(columns1), vld1_u16(kWeights));
+			sumB = vmlal_u16(sumB, vget_high_u16(columns1), vld1_u16(kWeights + 4));
+			sumB = vmlal_u16(sumB, vget_low_u16(columns2), vld1_u16(kWeights + 8));
+			sumB = vmlal_u16(sumB, vget_high_u16(columns2), vld1_u16(kWeights + 12));
+			sumB = vmlal_u16(sumB, vget_low_u16(columns3), vld1_u16(kWeights + 16));
+			sumB = vmlal_u16(sumB, vget_high_u16(columns3), vld1_u16(kWeights + 20));
+			sumB = vmlal_u16(sumB, vget_low_u16(columns4), vld1_u16(kWeights + 24));
+			sumB = vmlal_u16(sumB, vget_high_u16(columns4), vld1_u16(kWeights + 28));
+			a += vaddvq_u32(sumA);
+			b += vaddvq_u32(sumB);
+#	endif
+			a %= kAdlerModulus;
+			b %= kAdlerModulus;
+		}
+		return processedSize;
+	}
+#endif
+}
+
+namespace seir
+{
+	Crc32& Crc32::process(const void* data, size_t size) noexcept
+	{
+		auto bytes = static_cast<const uint8_t*>(data);
+#if SEIR_INTRINSICS_SSE
+		if (size >= 64 && hasCpuFeature(CpuFeature::Pclmul))
+		{
+			const auto foldedSize = size & ~size_t{ 15 };
+			_value = ::crc32Pclmul(_value, bytes, foldedSize);
+			bytes += foldedSize;
+			size -= foldedSize;
+		}
+#elif defined(SEIR_CRC32_ARM)
+		const auto wordSize = size & ~size_t{ 7 };
+		_value = ::crc32Arm(_value, bytes, wordSize);
+		bytes += wordSize;
+		size -= wordSize;
+#endif
+		_value = ::crc32Scalar(_value, bytes, size);
+		return *this;
+	}
+
+	Adler32& Adler32::process(const void* data, size_t size) noexcept
+	{
+		auto bytes = static_cast<const uint8_t*>(data);
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+		const auto processedSize = ::adler32Vectorized(_a, _b, bytes, size);
+		bytes += processedSize;
+		size -= processedSize;
+#endif
+		::adler32Scalar(_a, _b, bytes, size);
+		return *this;
+	}
+}
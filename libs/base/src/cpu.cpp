@@ -0,0 +1,57 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/cpu.hpp>
+
+#include <seir_base/intrinsics.hpp>
+
+#include <cstdint>
+
+namespace
+{
+	uint32_t cpuFeatureBit(seir::CpuFeature feature) noexcept
+	{
+		return uint32_t{ 1 } << static_cast<unsigned>(feature);
+	}
+
+	uint32_t detectCpuFeatures() noexcept
+	{
+		uint32_t features = 0;
+#if SEIR_INTRINSICS_SSE
+#	ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 0);
+		const auto maxLeaf = info[0];
+		__cpuid(info, 1);
+		if (info[2] & (1 << 1))
+			features |= cpuFeatureBit(seir::CpuFeature::Pclmul);
+		constexpr int kOsxsave = 1 << 27;
+		constexpr int kAvx = 1 << 28;
+		// AVX registers must be saved by the OS too, otherwise the instructions are unusable.
+		if (maxLeaf >= 7 && (info[2] & (kOsxsave | kAvx)) == (kOsxsave | kAvx) && (_xgetbv(0) & 0b110) == 0b110)
+		{
+			__cpuidex(info, 7, 0);
+			if (info[1] & (1 << 5))
+				features |= cpuFeatureBit(seir::CpuFeature::Avx2);
+		}
+#	else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2"))
+			features |= cpuFeatureBit(seir::CpuFeature::Avx2);
+		if (__builtin_cpu_supports("pclmul"))
+			features |= cpuFeatureBit(seir::CpuFeature::Pclmul);
+#	endif
+#endif
+		return features;
+	}
+}
+
+namespace seir
+{
+	bool hasCpuFeature(CpuFeature feature) noexcept
+	{
+		static const auto features = ::detectCpuFeatures();
+		return features & ::cpuFeatureBit(feature);
+	}
+}
@@ -0,0 +1,195 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/pool_allocator.hpp>
+
+#include <seir_base/allocator.hpp>
+
+#include <array>
+#include <bit>
+#include <limits>
+#include <mutex>
+
+namespace
+{
+	constexpr size_t kPoolMinSizeBits = 4;
+	constexpr size_t kPoolClassCount = std::bit_width(seir::PoolAllocator::kMaxPooledSize) - kPoolMinSizeBits;
+	constexpr size_t kPoolLargeClass = kPoolClassCount;
+	constexpr size_t kPoolSlabSize = 64 * 1024;
+	constexpr size_t kPoolBatchSize = 16 * 1024; // Blocks move between the caches and the shared pool in batches of about this size.
+
+	static_assert(seir::PoolAllocator::kMaxPooledSize == size_t{ 1 } << (kPoolMinSizeBits + kPoolClassCount - 1));
+
+	// Every block is preceded by a header which holds its size class while the block is allocated
+	// and the next free block while it is in a free list. The header also keeps the data aligned.
+	struct alignas(std::max_align_t) PoolHeader
+	{
+		PoolHeader* _next;
+		size_t _sizeClass;
+	};
+
+	constexpr size_t poolClassSize(size_t sizeClass) noexcept
+	{
+		return size_t{ 1 } << (kPoolMinSizeBits + sizeClass);
+	}
+
+	constexpr size_t poolBatchCount(size_t sizeClass) noexcept
+	{
+		return kPoolBatchSize / (sizeof(PoolHeader) + poolClassSize(sizeClass));
+	}
+
+	static_assert(poolBatchCount(kPoolClassCount - 1) >= 2);
+
+	struct PoolList
+	{
+		PoolHeader* _head = nullptr;
+		size_t _size = 0;
+
+		void push(PoolHeader* block) noexcept
+		{
+			block->_next = _head;
+			_head = block;
+			++_size;
+		}
+
+		PoolHeader* pop() noexcept
+		{
+			const auto block = _head;
+			_head = block->_next;
+			--_size;
+			return block;
+		}
+
+		// Moves up to the specified number of blocks to the other list.
+		void moveTo(PoolList& other, size_t count) noexcept
+		{
+			for (; count > 0 && _head; --count)
+				other.push(pop());
+		}
+	};
+
+	class PoolShared
+	{
+	public:
+		// Moves a batch of free blocks into the list, allocating a new slab if there are no free blocks.
+		[[nodiscard]] bool refill(PoolList& list, size_t sizeClass) noexcept
+		{
+			{
+				std::scoped_lock lock{ _mutex };
+				_lists[sizeClass].moveTo(list, poolBatchCount(sizeClass));
+			}
+			if (list._head)
+				return true;
+			const auto stride = sizeof(PoolHeader) + poolClassSize(sizeClass);
+			auto slabSize = kPoolSlabSize;
+			const auto slab = static_cast<std::byte*>(seir::Allocator::tryAllocate(slabSize));
+			if (!slab) [[unlikely]]
+				return false;
+			PoolList slabList;
+			for (size_t offset = 0; offset + stride <= slabSize; offset += stride)
+				slabList.push(reinterpret_cast<PoolHeader*>(slab + offset));
+			slabList.moveTo(list, poolBatchCount(sizeClass));
+			release(slabList, sizeClass, std::numeric_limits<size_t>::max());
+			return true;
+		}
+
+		void release(PoolList& list, size_t sizeClass, size_t count) noexcept
+		{
+			std::scoped_lock lock{ _mutex };
+			list.moveTo(_lists[sizeClass], count);
+		}
+
+	private:
+		std::mutex _mutex;
+		std::array<PoolList, kPoolClassCount> _lists;
+	};
+
+	// The shared pool is never destroyed because blocks may be deallocated
+	// during static destruction or by threads which outlive the main one.
+	PoolShared& poolShared() noexcept
+	{
+		static auto& shared = *new PoolShared; // NOLINT(cppcoreguidelines-owning-memory)
+		return shared;
+	}
+
+	struct PoolCache
+	{
+		std::array<PoolList, kPoolClassCount> _lists;
+		bool _destroyed = false;
+	};
+
+	// The cache is trivially destructible so that accessing it doesn't require
+	// thread-local initialization checks, and the guard (which is touched only
+	// when a cache list becomes non-empty) returns its blocks to the shared pool on thread exit.
+	thread_local constinit PoolCache poolCache;
+
+	struct PoolCacheGuard
+	{
+		bool _active = false;
+
+		~PoolCacheGuard() noexcept
+		{
+			for (size_t sizeClass = 0; sizeClass < kPoolClassCount; ++sizeClass)
+				poolShared().release(poolCache._lists[sizeClass], sizeClass, std::numeric_limits<size_t>::max());
+			poolCache._destroyed = true;
+		}
+	};
+
+	thread_local PoolCacheGuard poolCacheGuard;
+
+	void* allocateLarge(size_t size) noexcept
+	{
+		if (size > std::numeric_limits<size_t>::max() - sizeof(PoolHeader)) [[unlikely]]
+			return nullptr;
+		auto allocationSize = sizeof(PoolHeader) + size;
+		const auto header = static_cast<PoolHeader*>(seir::Allocator::tryAllocate(allocationSize));
+		if (!header) [[unlikely]]
+			return nullptr;
+		header->_sizeClass = kPoolLargeClass;
+		return header + 1;
+	}
+}
+
+namespace seir
+{
+	void PoolAllocator::deallocate(void* memory) noexcept
+	{
+		if (!memory)
+			return;
+		const auto header = static_cast<PoolHeader*>(memory) - 1;
+		const auto sizeClass = header->_sizeClass;
+		if (sizeClass == kPoolLargeClass)
+			return Allocator::deallocate(header);
+		if (poolCache._destroyed) [[unlikely]]
+		{
+			PoolList list;
+			list.push(header);
+			return poolShared().release(list, sizeClass, 1);
+		}
+		auto& list = poolCache._lists[sizeClass];
+		if (!list._head)
+			poolCacheGuard._active = true; // Threads which only deallocate must return their blocks too.
+		list.push(header);
+		if (const auto batchCount = poolBatchCount(sizeClass); list._size > 2 * batchCount)
+			poolShared().release(list, sizeClass, batchCount);
+	}
+
+	void* PoolAllocator::tryAllocate(size_t& size) noexcept
+	{
+		if (size > kMaxPooledSize || poolCache._destroyed) [[unlikely]]
+			return ::allocateLarge(size);
+		const auto sizeClass = size > poolClassSize(0) ? static_cast<size_t>(std::bit_width(size - 1)) - kPoolMinSizeBits : 0;
+		auto& list = poolCache._lists[sizeClass];
+		if (!list._head)
+		{
+			poolCacheGuard._active = true;
+			if (!poolShared().refill(list, sizeClass)) [[unlikely]]
+				return nullptr;
+		}
+		const auto header = list.pop();
+		header->_sizeClass = sizeClass;
+		size = poolClassSize(sizeClass);
+		return header + 1;
+	}
+}
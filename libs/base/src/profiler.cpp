@@ -0,0 +1,395 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/profiler.hpp>
+
+#include <seir_base/buffer.hpp>
+#include <seir_base/spsc_ring.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+
+namespace
+{
+	struct ProfilerRecord
+	{
+		const char* _name;
+		seir::Profiler::Clock::rep _begin;
+		seir::Profiler::Clock::rep _end;
+	};
+
+	// Zones of a thread, which are kept after the thread exits.
+	struct ProfilerThread
+	{
+		std::atomic<const char*> _name{ nullptr };
+		seir::Buffer _records; // Collected records, guarded by the profiler mutex.
+		size_t _recordCount = 0;
+		size_t _nextRecord = 0; // The record to replace when the limit is reached.
+		bool _active = true; // Whether the thread still owns a slot.
+		ProfilerThread* _next = nullptr;
+	};
+
+	// A ring buffer for zones of a running thread, which is reused
+	// after the thread exits and all its zones have been collected.
+	struct ProfilerSlot
+	{
+		seir::SpscRing<ProfilerRecord, 8192> _ring;
+		ProfilerThread* _thread = nullptr; // Guarded by the profiler mutex.
+		std::atomic<bool> _exited{ false };
+	};
+
+	constexpr size_t kMaxProfilerSlots = 256;
+	constexpr size_t kDefaultProfilerRecordLimit = size_t{ 1 } << 20;
+
+	struct ProfilerState
+	{
+		std::mutex _mutex;
+		std::array<ProfilerSlot*, kMaxProfilerSlots> _slots{};
+		size_t _slotCount = 0;
+		ProfilerThread* _firstThread = nullptr;
+		ProfilerThread* _lastThread = nullptr;
+		size_t _recordLimit = kDefaultProfilerRecordLimit;
+
+		void collect() noexcept
+		{
+			for (size_t i = 0; i < _slotCount; ++i)
+			{
+				auto& slot = *_slots[i];
+				if (!slot._thread)
+					continue;
+				// All zones of an exited thread are in the ring at this point.
+				const auto exited = slot._exited.load(std::memory_order_acquire);
+				auto& thread = *slot._thread;
+				for (;;)
+				{
+					// The oldest records are replaced when the limit is reached.
+					const auto full = thread._recordCount >= _recordLimit;
+					if (!full
+						&& (thread._recordCount + 1) * sizeof(ProfilerRecord) > thread._records.capacity()
+						&& !thread._records.tryReserve(std::min(2 * thread._records.capacity(), _recordLimit * sizeof(ProfilerRecord)), thread._recordCount * sizeof(ProfilerRecord)))
+						break;
+					if (!slot._ring.tryPop(reinterpret_cast<ProfilerRecord*>(thread._records.data())[full ? thread._nextRecord : thread._recordCount]))
+					{
+						if (exited)
+						{
+							thread._active = false;
+							slot._thread = nullptr;
+							slot._exited.store(false, std::memory_order_relaxed);
+						}
+						break;
+					}
+					if (full)
+						thread._nextRecord = (thread._nextRecord + 1) % thread._recordCount;
+					else
+						++thread._recordCount;
+				}
+			}
+		}
+
+		// Returns collected records of the thread ordered by start time, enclosing zones first.
+		static std::span<ProfilerRecord> sortedRecords(ProfilerThread& thread) noexcept
+		{
+			const std::span records{ reinterpret_cast<ProfilerRecord*>(thread._records.data()), thread._recordCount };
+			std::ranges::sort(records, [](const ProfilerRecord& left, const ProfilerRecord& right) {
+				return left._begin < right._begin || (left._begin == right._begin && left._end > right._end);
+			});
+			thread._nextRecord = 0; // The oldest record is the first one now.
+			return records;
+		}
+
+		ProfilerSlot* acquireSlot() noexcept
+		{
+			const auto findFreeSlot = [this]() -> ProfilerSlot* {
+				for (size_t i = 0; i < _slotCount; ++i)
+					if (!_slots[i]->_thread)
+						return _slots[i];
+				return nullptr;
+			};
+			if (const auto slot = findFreeSlot())
+				return slot;
+			if (_slotCount < kMaxProfilerSlots)
+			{
+				const auto slot = new (std::nothrow) ProfilerSlot;
+				if (slot)
+					_slots[_slotCount++] = slot;
+				return slot;
+			}
+			collect(); // Frees slots of exited threads.
+			return findFreeSlot();
+		}
+	};
+
+	// The state is never destroyed because threads which outlive
+	// the main one may still be recording zones during static destruction.
+	ProfilerState& profilerState() noexcept
+	{
+		static auto& state = *new ProfilerState; // NOLINT(cppcoreguidelines-owning-memory)
+		return state;
+	}
+
+	// The thread-local state is trivially destructible, and the guard
+	// (which is touched only when a slot is acquired) releases the slot on thread exit.
+	struct ProfilerCurrentThread
+	{
+		ProfilerSlot* _slot = nullptr;
+		bool _exited = false;
+	};
+
+	thread_local constinit ProfilerCurrentThread currentProfilerThread;
+
+	struct ProfilerThreadGuard
+	{
+		bool _active = false;
+
+		~ProfilerThreadGuard() noexcept
+		{
+			if (currentProfilerThread._slot)
+				currentProfilerThread._slot->_exited.store(true, std::memory_order_release);
+			currentProfilerThread = { nullptr, true };
+		}
+	};
+
+	thread_local ProfilerThreadGuard profilerThreadGuard;
+
+	ProfilerSlot* profilerSlot() noexcept
+	{
+		if (!currentProfilerThread._slot) [[unlikely]]
+		{
+			if (currentProfilerThread._exited)
+				return nullptr;
+			auto& state = ::profilerState();
+			const std::scoped_lock lock{ state._mutex };
+			const auto slot = state.acquireSlot();
+			if (!slot)
+				return nullptr;
+			const auto thread = new (std::nothrow) ProfilerThread;
+			if (!thread)
+				return nullptr;
+			if (!thread->_records.tryReserve(1024 * sizeof(ProfilerRecord), 0))
+			{
+				delete thread;
+				return nullptr;
+			}
+			(state._lastThread ? state._lastThread->_next : state._firstThread) = thread;
+			state._lastThread = thread;
+			slot->_thread = thread;
+			profilerThreadGuard._active = true;
+			currentProfilerThread._slot = slot;
+		}
+		return currentProfilerThread._slot;
+	}
+
+	int64_t nanoseconds(seir::Profiler::Clock::rep ticks) noexcept
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(seir::Profiler::Clock::duration{ ticks }).count();
+	}
+
+	void appendJsonString(std::string& output, const char* text)
+	{
+		output += '"';
+		for (; *text; ++text)
+		{
+			if (*text == '"' || *text == '\\')
+				output += '\\';
+			if (static_cast<unsigned char>(*text) >= 0x20)
+				output += *text;
+		}
+		output += '"';
+	}
+
+	// Appends microseconds with three fractional digits.
+	void appendJsonTime(std::string& output, int64_t nanoseconds)
+	{
+		if (nanoseconds < 0)
+			output += '-';
+		const auto magnitude = nanoseconds < 0 ? uint64_t{ 0 } - static_cast<uint64_t>(nanoseconds) : static_cast<uint64_t>(nanoseconds);
+		std::array<char, 24> buffer;
+		const auto end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), magnitude / 1000).ptr;
+		output.append(buffer.data(), end);
+		const auto fraction = static_cast<int>(magnitude % 1000);
+		output += '.';
+		output += static_cast<char>('0' + fraction / 100);
+		output += static_cast<char>('0' + fraction / 10 % 10);
+		output += static_cast<char>('0' + fraction % 10);
+	}
+
+	void appendJsonNumber(std::string& output, size_t value)
+	{
+		std::array<char, 24> buffer;
+		output.append(buffer.data(), std::to_chars(buffer.data(), buffer.data() + buffer.size(), value).ptr);
+	}
+
+	void appendLeb128(std::vector<std::byte>& output, uint64_t value)
+	{
+		for (; value >= 0x80; value >>= 7)
+			output.emplace_back(static_cast<std::byte>(value | 0x80));
+		output.emplace_back(static_cast<std::byte>(value));
+	}
+}
+
+namespace seir
+{
+	void Profiler::addZone(const char* name, Clock::time_point begin, Clock::time_point end) noexcept
+	{
+		if (const auto slot = ::profilerSlot())
+			static_cast<void>(slot->_ring.tryPush(name, begin.time_since_epoch().count(), end.time_since_epoch().count()));
+	}
+
+	void Profiler::addFrame(Clock::time_point begin, Clock::time_point end) noexcept
+	{
+		addZone("Frame", begin, end);
+		collect();
+	}
+
+	void Profiler::clear() noexcept
+	{
+		auto& state = ::profilerState();
+		const std::scoped_lock lock{ state._mutex };
+		state.collect();
+		ProfilerThread* last = nullptr;
+		for (auto link = &state._firstThread; *link;)
+		{
+			const auto thread = *link;
+			if (thread->_active)
+			{
+				thread->_recordCount = 0;
+				thread->_nextRecord = 0;
+				last = thread;
+				link = &thread->_next;
+			}
+			else
+			{
+				*link = thread->_next;
+				delete thread;
+			}
+		}
+		state._lastThread = last;
+	}
+
+	void Profiler::collect() noexcept
+	{
+		auto& state = ::profilerState();
+		const std::scoped_lock lock{ state._mutex };
+		state.collect();
+	}
+
+	std::vector<std::byte> Profiler::binaryTrace()
+	{
+		auto& state = ::profilerState();
+		const std::scoped_lock lock{ state._mutex };
+		state.collect();
+		size_t threadCount = 0;
+		for (auto thread = state._firstThread; thread; thread = thread->_next)
+			++threadCount;
+		std::vector<const char*> strings;
+		std::unordered_map<const char*, size_t> stringIndices;
+		const auto stringIndex = [&](const char* string) {
+			const auto [i, inserted] = stringIndices.try_emplace(string, strings.size());
+			if (inserted)
+				strings.emplace_back(string);
+			return i->second;
+		};
+		std::vector<std::byte> threads;
+		::appendLeb128(threads, threadCount);
+		for (auto thread = state._firstThread; thread; thread = thread->_next)
+		{
+			const auto name = thread->_name.load();
+			::appendLeb128(threads, name ? stringIndex(name) + 1 : 0);
+			const auto records = ProfilerState::sortedRecords(*thread);
+			::appendLeb128(threads, records.size());
+			int64_t previousBegin = 0;
+			for (const auto& record : records)
+			{
+				const auto begin = ::nanoseconds(record._begin);
+				::appendLeb128(threads, stringIndex(record._name));
+				::appendLeb128(threads, static_cast<uint64_t>(begin - previousBegin));
+				::appendLeb128(threads, static_cast<uint64_t>(::nanoseconds(record._end) - begin));
+				previousBegin = begin;
+			}
+		}
+		constexpr std::string_view signature = "SeirProfile";
+		std::vector<std::byte> result{ reinterpret_cast<const std::byte*>(signature.data()), reinterpret_cast<const std::byte*>(signature.data() + signature.size()) };
+		::appendLeb128(result, strings.size());
+		for (const auto string : strings)
+		{
+			const auto length = std::strlen(string);
+			::appendLeb128(result, length);
+			result.insert(result.end(), reinterpret_cast<const std::byte*>(string), reinterpret_cast<const std::byte*>(string + length));
+		}
+		result.insert(result.end(), threads.begin(), threads.end());
+		return result;
+	}
+
+	std::string Profiler::chromeTrace()
+	{
+		auto& state = ::profilerState();
+		const std::scoped_lock lock{ state._mutex };
+		state.collect();
+		std::string result = "{\"traceEvents\":[";
+		bool first = true;
+		const auto beginEvent = [&](const char* name, const char* phase, size_t thread) {
+			if (!first)
+				result += ",\n";
+			first = false;
+			result += "{\"name\":";
+			::appendJsonString(result, name);
+			result += ",\"ph\":\"";
+			result += phase;
+			result += "\",\"pid\":1,\"tid\":";
+			::appendJsonNumber(result, thread + 1);
+		};
+		size_t i = 0;
+		for (auto thread = state._firstThread; thread; thread = thread->_next, ++i)
+		{
+			if (const auto name = thread->_name.load())
+			{
+				beginEvent("thread_name", "M", i);
+				result += ",\"args\":{\"name\":";
+				::appendJsonString(result, name);
+				result += "}}";
+			}
+			for (const auto& record : ProfilerState::sortedRecords(*thread))
+			{
+				const auto begin = ::nanoseconds(record._begin);
+				beginEvent(record._name, "X", i);
+				result += ",\"ts\":";
+				::appendJsonTime(result, begin);
+				result += ",\"dur\":";
+				::appendJsonTime(result, ::nanoseconds(record._end) - begin);
+				result += '}';
+			}
+		}
+		result += "]}\n";
+		return result;
+	}
+
+	void Profiler::setRecordLimit(size_t limit) noexcept
+	{
+		auto& state = ::profilerState();
+		const std::scoped_lock lock{ state._mutex };
+		state.collect();
+		state._recordLimit = std::max<size_t>(limit, 1);
+		for (auto thread = state._firstThread; thread; thread = thread->_next)
+		{
+			if (thread->_recordCount <= state._recordLimit)
+				continue;
+			const auto records = ProfilerState::sortedRecords(*thread);
+			std::ranges::copy(records.last(state._recordLimit), records.begin());
+			thread->_recordCount = state._recordLimit;
+		}
+	}
+
+	void Profiler::setThreadName(const char* name) noexcept
+	{
+		if (const auto slot = ::profilerSlot())
+			slot->_thread->_name.store(name);
+	}
+}
@@ -0,0 +1,280 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/task_scheduler.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace seir
+{
+	class TaskSchedulerImpl
+	{
+	public:
+		using Task = TaskScheduler::Task;
+
+		// Chase-Lev work-stealing deque (as described in "Correct and Efficient Work-Stealing
+		// for Weak Memory Models" by Lê et al.). The owner pushes and pops tasks at the bottom,
+		// other threads steal them from the top.
+		class TaskDeque
+		{
+		public:
+			TaskDeque()
+			{
+				_arrays.emplace_back(std::make_unique<Array>(kInitialCapacity));
+				_array.store(_arrays.back().get(), std::memory_order_relaxed);
+			}
+
+			void push(Task* task)
+			{
+				const auto bottom = _bottom.load(std::memory_order_relaxed);
+				const auto top = _top.load(std::memory_order_acquire);
+				auto array = _array.load(std::memory_order_relaxed);
+				if (bottom - top >= static_cast<int64_t>(array->_mask))
+					array = grow(array, top, bottom);
+				array->put(bottom, task);
+				std::atomic_thread_fence(std::memory_order_release);
+				_bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+
+			Task* pop() noexcept
+			{
+				const auto bottom = _bottom.load(std::memory_order_relaxed) - 1;
+				const auto array = _array.load(std::memory_order_relaxed);
+				_bottom.store(bottom, std::memory_order_relaxed);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				auto top = _top.load(std::memory_order_relaxed);
+				if (top > bottom)
+				{
+					_bottom.store(bottom + 1, std::memory_order_relaxed);
+					return nullptr;
+				}
+				auto task = array->get(bottom);
+				if (top == bottom)
+				{
+					// The last task may be stolen concurrently.
+					if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+						task = nullptr;
+					_bottom.store(bottom + 1, std::memory_order_relaxed);
+				}
+				return task;
+			}
+
+			Task* steal() noexcept
+			{
+				auto top = _top.load(std::memory_order_acquire);
+				std::atomic_thread_fence(std::memory_order_seq_cst);
+				const auto bottom = _bottom.load(std::memory_order_acquire);
+				if (top >= bottom)
+					return nullptr;
+				const auto task = _array.load(std::memory_order_acquire)->get(top);
+				return _top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed) ? task : nullptr;
+			}
+
+		private:
+			static constexpr size_t kInitialCapacity = 256;
+
+			struct Array
+			{
+				const size_t _mask;
+				const std::unique_ptr<std::atomic<Task*>[]> _items;
+
+				explicit Array(size_t capacity)
+					: _mask{ capacity - 1 }, _items{ std::make_unique<std::atomic<Task*>[]>(capacity) } {}
+
+				Task* get(int64_t index) const noexcept { return _items[static_cast<size_t>(index) & _mask].load(std::memory_order_relaxed); }
+				void put(int64_t index, Task* task) noexcept { _items[static_cast<size_t>(index) & _mask].store(task, std::memory_order_relaxed); }
+			};
+
+			Array* grow(const Array* array, int64_t top, int64_t bottom)
+			{
+				// Thieves may still be reading the old array, so it is kept until the deque is destroyed.
+				auto& newArray = _arrays.emplace_back(std::make_unique<Array>(2 * (array->_mask + 1)));
+				for (auto i = top; i < bottom; ++i)
+					newArray->put(i, array->get(i));
+				_array.store(newArray.get(), std::memory_order_release);
+				return newArray.get();
+			}
+
+			alignas(64) std::atomic<int64_t> _top{ 0 };
+			alignas(64) std::atomic<int64_t> _bottom{ 0 };
+			std::atomic<Array*> _array{ nullptr };
+			std::vector<std::unique_ptr<Array>> _arrays;
+		};
+
+		struct alignas(64) Worker
+		{
+			TaskSchedulerImpl* const _scheduler;
+			TaskDeque _deque;
+			std::thread _thread;
+
+			explicit Worker(TaskSchedulerImpl* scheduler)
+				: _scheduler{ scheduler } {}
+		};
+
+		static thread_local Worker* currentWorker;
+
+		std::vector<std::unique_ptr<Worker>> _workers;
+		std::mutex _injectedMutex;
+		std::deque<Task*> _injected; // Tasks submitted from threads other than the workers.
+		std::atomic<size_t> _injectedCount{ 0 };
+		std::atomic<uint32_t> _epoch{ 0 }; // Incremented on every event idle threads may be waiting for.
+		std::atomic<uint32_t> _sleeping{ 0 };
+		std::atomic<bool> _stop{ false };
+
+		explicit TaskSchedulerImpl(unsigned workerCount)
+		{
+			_workers.reserve(workerCount);
+			for (unsigned i = 0; i < workerCount; ++i)
+				_workers.emplace_back(std::make_unique<Worker>(this));
+			for (const auto& worker : _workers)
+				worker->_thread = std::thread{ [this, worker = worker.get()] { run(worker); } };
+		}
+
+		~TaskSchedulerImpl() noexcept
+		{
+			_stop.store(true);
+			notify(true);
+			for (const auto& worker : _workers)
+				worker->_thread.join();
+		}
+
+		void notify(bool all) noexcept
+		{
+			_epoch.fetch_add(1);
+			if (_sleeping.load() > 0)
+			{
+				if (all)
+					_epoch.notify_all();
+				else
+					_epoch.notify_one();
+			}
+		}
+
+		void run(Worker* worker) noexcept
+		{
+			currentWorker = worker;
+			for (;;)
+			{
+				const auto epoch = _epoch.load();
+				if (_stop.load())
+					break;
+				if (!tryRunTask())
+					sleep(epoch);
+			}
+		}
+
+		void sleep(uint32_t epoch) noexcept
+		{
+			// Spinning for a while before sleeping reduces latency when tasks come in bursts.
+			for (int i = 0; i < kSpinCount; ++i)
+			{
+				if (_epoch.load(std::memory_order_relaxed) != epoch)
+					return;
+				std::this_thread::yield();
+			}
+			_sleeping.fetch_add(1);
+			_epoch.wait(epoch);
+			_sleeping.fetch_sub(1);
+		}
+
+		void submit(Task* task)
+		{
+			if (const auto worker = currentWorker; worker && worker->_scheduler == this)
+				worker->_deque.push(task);
+			else
+			{
+				std::scoped_lock lock{ _injectedMutex };
+				_injected.emplace_back(task);
+				_injectedCount.fetch_add(1);
+			}
+			notify(false);
+		}
+
+		bool tryRunTask() noexcept
+		{
+			Task* task = nullptr;
+			const auto worker = currentWorker && currentWorker->_scheduler == this ? currentWorker : nullptr;
+			if (worker)
+				task = worker->_deque.pop();
+			if (!task && _injectedCount.load() > 0)
+			{
+				std::scoped_lock lock{ _injectedMutex };
+				if (!_injected.empty())
+				{
+					task = _injected.front();
+					_injected.pop_front();
+					_injectedCount.fetch_sub(1);
+				}
+			}
+			if (!task && !_workers.empty())
+			{
+				thread_local size_t victimOffset = 0;
+				const auto start = victimOffset++;
+				for (size_t i = 0; i < _workers.size() && !task; ++i)
+					if (const auto& victim = _workers[(start + i) % _workers.size()]; victim.get() != worker)
+						task = victim->_deque.steal();
+			}
+			if (!task)
+				return false;
+			task->_run(task);
+			return true;
+		}
+
+	private:
+		static constexpr int kSpinCount = 64;
+	};
+
+	thread_local TaskSchedulerImpl::Worker* TaskSchedulerImpl::currentWorker = nullptr;
+
+	TaskScheduler::TaskScheduler(unsigned workerCount)
+		: _impl{ std::make_unique<TaskSchedulerImpl>(workerCount) }
+	{
+	}
+
+	TaskScheduler::~TaskScheduler() noexcept = default;
+
+	unsigned TaskScheduler::defaultWorkerCount() noexcept
+	{
+		const auto hardwareThreads = std::thread::hardware_concurrency();
+		return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+	}
+
+	unsigned TaskScheduler::workerCount() const noexcept
+	{
+		return static_cast<unsigned>(_impl->_workers.size());
+	}
+
+	void TaskScheduler::submit(Task* task)
+	{
+		_impl->submit(task);
+	}
+
+	void TaskScheduler::wait(const std::atomic<size_t>& pending) noexcept
+	{
+		for (;;)
+		{
+			const auto epoch = _impl->_epoch.load();
+			if (!pending.load())
+				break;
+			if (!_impl->tryRunTask())
+				_impl->sleep(epoch);
+		}
+	}
+
+	void TaskScheduler::notifyAll() noexcept
+	{
+		_impl->notify(true);
+	}
+
+	void TaskGroup::finish() noexcept
+	{
+		auto& scheduler = _scheduler; // The group may be destroyed as soon as the counter reaches zero.
+		if (_pending.fetch_sub(1) == 1)
+			scheduler.notifyAll();
+	}
+}
@@ -0,0 +1,341 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/utf8.hpp>
+
+#include <seir_base/cpu.hpp>
+#include <seir_base/intrinsics.hpp>
+
+#include <algorithm>
+
+namespace
+{
+	bool isValidUtf8Scalar(const uint8_t* data, const uint8_t* end) noexcept
+	{
+		while (data != end)
+		{
+			const auto lead = *data++;
+			if (lead < 0x80)
+				continue;
+			size_t continuations = 0;
+			uint8_t secondMin = 0x80;
+			uint8_t secondMax = 0xBF;
+			if (lead < 0xC2) // Continuation bytes and overlong two-byte sequences.
+				return false;
+			else if (lead < 0xE0)
+				continuations = 1;
+			else if (lead < 0xF0)
+			{
+				continuations = 2;
+				if (lead == 0xE0)
+					secondMin = 0xA0; // Overlong three-byte sequences.
+				else if (lead == 0xED)
+					secondMax = 0x9F; // Surrogates.
+			}
+			else if (lead < 0xF5)
+			{
+				continuations = 3;
+				if (lead == 0xF0)
+					secondMin = 0x90; // Overlong four-byte sequences.
+				else if (lead == 0xF4)
+					secondMax = 0x8F; // Codepoints above U+10FFFF.
+			}
+			else
+				return false;
+			if (static_cast<size_t>(end - data) < continuations || data[0] < secondMin || data[0] > secondMax)
+				return false;
+			for (size_t i = 1; i < continuations; ++i)
+				if (!seir::isUtf8Continuation(static_cast<char>(data[i])))
+					return false;
+			data += continuations;
+		}
+		return true;
+	}
+
+#if SEIR_INTRINSICS_SSE
+	SEIR_TARGET("avx2")
+	size_t skipAsciiAvx2(const char* data, size_t size) noexcept
+	{
+		size_t offset = 0;
+		for (; size - offset >= 32; offset += 32)
+			if (_mm256_movemask_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset))))
+				break;
+		return offset;
+	}
+
+	SEIR_TARGET("avx2")
+	size_t countUtf8Avx2(const char* data, size_t size, size_t& count) noexcept
+	{
+		size_t offset = 0;
+		while (size - offset >= 32)
+		{
+			// Byte counters overflow after 255 iterations.
+			auto counters = _mm256_setzero_si256();
+			for (const auto end = offset + std::min<size_t>((size - offset) / 32, 255) * 32; offset < end; offset += 32)
+				counters = _mm256_sub_epi8(counters, _mm256_cmpgt_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset)), _mm256_set1_epi8(-65)));
+			const auto sums = _mm256_sad_epu8(counters, _mm256_setzero_si256());
+			count += static_cast<size_t>(_mm256_extract_epi16(sums, 0)) + static_cast<size_t>(_mm256_extract_epi16(sums, 4))
+				+ static_cast<size_t>(_mm256_extract_epi16(sums, 8)) + static_cast<size_t>(_mm256_extract_epi16(sums, 12));
+		}
+		return offset;
+	}
+
+	SEIR_TARGET("avx2")
+	size_t decodeAsciiAvx2(char32_t* output, const char* data, size_t size) noexcept
+	{
+		size_t offset = 0;
+		for (; size - offset >= 32; offset += 32)
+		{
+			const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+			if (_mm256_movemask_epi8(block))
+				break;
+			const auto low = _mm256_castsi256_si128(block);
+			const auto high = _mm256_extracti128_si256(block, 1);
+			const auto out = reinterpret_cast<__m256i*>(output + offset);
+			_mm256_storeu_si256(out, _mm256_cvtepu8_epi32(low));
+			_mm256_storeu_si256(out + 1, _mm256_cvtepu8_epi32(_mm_srli_si128(low, 8)));
+			_mm256_storeu_si256(out + 2, _mm256_cvtepu8_epi32(high));
+			_mm256_storeu_si256(out + 3, _mm256_cvtepu8_epi32(_mm_srli_si128(high, 8)));
+		}
+		return offset;
+	}
+
+	// Decodes the ASCII prefix of the data, rounded down to the SIMD block size, and returns its size.
+	size_t decodeAscii(char32_t* output, const char* data, size_t size) noexcept
+	{
+		auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data));
+		if (_mm_movemask_epi8(block))
+			return 0;
+		size_t offset = 0;
+		if (size >= 32 && seir::hasCpuFeature(seir::CpuFeature::Avx2))
+		{
+			offset = ::decodeAsciiAvx2(output, data, size);
+			if (size - offset < 16)
+				return offset;
+			block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+		}
+		for (;;)
+		{
+			if (_mm_movemask_epi8(block))
+				break;
+			const auto out = reinterpret_cast<__m128i*>(output + offset);
+			_mm_storeu_si128(out, _mm_cvtepu8_epi32(block));
+			_mm_storeu_si128(out + 1, _mm_cvtepu8_epi32(_mm_srli_si128(block, 4)));
+			_mm_storeu_si128(out + 2, _mm_cvtepu8_epi32(_mm_srli_si128(block, 8)));
+			_mm_storeu_si128(out + 3, _mm_cvtepu8_epi32(_mm_srli_si128(block, 12)));
+			offset += 16;
+			if (size - offset < 16)
+				break;
+			block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+		}
+		return offset;
+	}
+
+	// Returns the size of the ASCII prefix of the data, rounded down to the SIMD block size.
+	size_t skipAscii(const char* data, size_t size) noexcept
+	{
+		size_t offset = 0;
+		if (seir::hasCpuFeature(seir::CpuFeature::Avx2))
+			offset = ::skipAsciiAvx2(data, size);
+		for (; size - offset >= 16; offset += 16)
+			if (_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset))))
+				break;
+		return offset;
+	}
+
+	// Validates UTF-8 in 16-byte blocks using the algorithm from "Validating UTF-8 In Less Than One Instruction
+	// Per Byte" by John Keiser and Daniel Lemire (see https://arxiv.org/abs/2010.03090). Every pair of adjacent
+	// bytes is classified using three lookup tables, and the classes have a common bit only if the pair is invalid.
+	// Returns the size of the validated part which ends at a codepoint boundary.
+	size_t validateUtf8Sse(const char* data, size_t size, bool& valid) noexcept
+	{
+		constexpr char kTooShort = 1 << 0;     // A lead byte followed by a lead byte or ASCII.
+		constexpr char kTooLong = 1 << 1;      // ASCII followed by a continuation byte.
+		constexpr char kOverlong3 = 1 << 2;    // 11100000 100xxxxx
+		constexpr char kTooLarge = 1 << 3;     // 11110100 1001xxxx, 11110100 101xxxxx, 111101xx 1001xxxx, etc.
+		constexpr char kSurrogate = 1 << 4;    // 11101101 101xxxxx
+		constexpr char kOverlong2 = 1 << 5;    // 1100000x 10xxxxxx
+		constexpr char kTooLarge1000 = 1 << 6; // 11110101 1000xxxx, 1111011x 1000xxxx, 11111xxx 1000xxxx.
+		constexpr char kOverlong4 = 1 << 6;    // 11110000 1000xxxx
+		constexpr char kTwoContinuations = static_cast<char>(1 << 7);
+		constexpr char kCarry = kTooShort | kTooLong | kTwoContinuations;
+
+		const auto firstHighTable = _mm_setr_epi8(
+			kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong, kTooLong,
+			kTwoContinuations, kTwoContinuations, kTwoContinuations, kTwoContinuations,
+			kTooShort | kOverlong2,
+			kTooShort,
+			kTooShort | kOverlong3 | kSurrogate,
+			kTooShort | kTooLarge | kTooLarge1000 | kOverlong4);
+		const auto firstLowTable = _mm_setr_epi8(
+			kCarry | kOverlong3 | kOverlong2 | kOverlong4,
+			kCarry | kOverlong2,
+			kCarry,
+			kCarry,
+			kCarry | kTooLarge,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000 | kSurrogate,
+			kCarry | kTooLarge | kTooLarge1000,
+			kCarry | kTooLarge | kTooLarge1000);
+		const auto secondHighTable = _mm_setr_epi8(
+			kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort, kTooShort,
+			kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge1000 | kOverlong4,
+			kTooLong | kOverlong2 | kTwoContinuations | kOverlong3 | kTooLarge,
+			kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+			kTooLong | kOverlong2 | kTwoContinuations | kSurrogate | kTooLarge,
+			kTooShort, kTooShort, kTooShort, kTooShort);
+
+		const auto nibbleMask = _mm_set1_epi8(0x0F);
+		auto previous = _mm_setzero_si128();
+		auto errors = _mm_setzero_si128();
+		size_t offset = 0;
+		while (size - offset >= 16)
+		{
+			const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+			if (!_mm_movemask_epi8(block))
+			{
+				// The previous block must not end with an incomplete sequence.
+				errors = _mm_or_si128(errors, _mm_subs_epu8(previous, _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, '\xEF', '\xDF', '\xBF')));
+				offset += 16 + ::skipAscii(data + offset + 16, size - offset - 16);
+				previous = _mm_setzero_si128();
+				continue;
+			}
+			const auto previous1 = _mm_alignr_epi8(block, previous, 15);
+			const auto classes = _mm_and_si128(
+				_mm_and_si128(
+					_mm_shuffle_epi8(firstHighTable, _mm_and_si128(_mm_srli_epi16(previous1, 4), nibbleMask)),
+					_mm_shuffle_epi8(firstLowTable, _mm_and_si128(previous1, nibbleMask))),
+				_mm_shuffle_epi8(secondHighTable, _mm_and_si128(_mm_srli_epi16(block, 4), nibbleMask)));
+			// Two continuation bytes in a row are valid only as the third or the fourth byte of a sequence.
+			const auto third = _mm_subs_epu8(_mm_alignr_epi8(block, previous, 14), _mm_set1_epi8(static_cast<char>(0xE0 - 0x80)));
+			const auto fourth = _mm_subs_epu8(_mm_alignr_epi8(block, previous, 13), _mm_set1_epi8(static_cast<char>(0xF0 - 0x80)));
+			const auto expectedContinuations = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(kTwoContinuations));
+			errors = _mm_or_si128(errors, _mm_xor_si128(classes, expectedContinuations));
+			previous = block;
+			offset += 16;
+		}
+		valid = _mm_testz_si128(errors, errors);
+		// The last sequence may continue past the validated part, so it is validated again by the caller.
+		for (size_t i = 1; i <= 3 && i <= offset; ++i)
+			if (static_cast<uint8_t>(data[offset - i]) >= 0xC0)
+				return offset - i;
+		return offset;
+	}
+#elif SEIR_INTRINSICS_NEON
+	size_t skipAscii(const char* data, size_t size) noexcept
+	{
+		size_t offset = 0;
+		for (; size - offset >= 16; offset += 16)
+			if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data + offset))) >= 0x80)
+				break;
+		return offset;
+	}
+
+	size_t decodeAscii(char32_t* output, const char* data, size_t size) noexcept
+	{
+		const auto offset = ::skipAscii(data, size);
+		std::copy_n(reinterpret_cast<const uint8_t*>(data), offset, output);
+		return offset;
+	}
+#endif
+}
+
+namespace seir
+{
+	bool isValidUtf8(std::string_view text) noexcept
+	{
+		auto data = reinterpret_cast<const uint8_t*>(text.data());
+		const auto end = data + text.size();
+#if SEIR_INTRINSICS_SSE
+		bool valid = true;
+		data += ::validateUtf8Sse(text.data(), text.size(), valid);
+		if (!valid)
+			return false;
+#elif SEIR_INTRINSICS_NEON
+		// Only the ASCII prefix is skipped, so that sequences are never split.
+		data += ::skipAscii(text.data(), text.size());
+#endif
+		return ::isValidUtf8Scalar(data, end);
+	}
+
+	size_t countUtf8(std::string_view text) noexcept
+	{
+		size_t count = 0;
+		size_t offset = 0;
+#if SEIR_INTRINSICS_SSE
+		if (hasCpuFeature(CpuFeature::Avx2))
+			offset = ::countUtf8Avx2(text.data(), text.size(), count);
+		while (text.size() - offset >= 16)
+		{
+			auto counters = _mm_setzero_si128();
+			for (const auto end = offset + std::min<size_t>((text.size() - offset) / 16, 255) * 16; offset < end; offset += 16)
+				counters = _mm_sub_epi8(counters, _mm_cmpgt_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + offset)), _mm_set1_epi8(-65)));
+			const auto sums = _mm_sad_epu8(counters, _mm_setzero_si128());
+			count += static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+		}
+#elif SEIR_INTRINSICS_NEON
+		offset = ::skipAscii(text.data(), text.size());
+		count = offset;
+#endif
+		for (; offset < text.size(); ++offset)
+			count += static_cast<size_t>(!isUtf8Continuation(text[offset]));
+		return count;
+	}
+
+	size_t decodeUtf8(std::span<char32_t> output, std::string_view text, size_t& offset) noexcept
+	{
+		const auto data = reinterpret_cast<const uint8_t*>(text.data());
+		size_t count = 0;
+		while (count < output.size() && offset < text.size())
+		{
+			const auto lead = data[offset];
+			if (lead < 0x80)
+			{
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+				// Short ASCII runs (like spaces between words) are cheaper to decode one by one.
+				if (const auto size = std::min(text.size() - offset, output.size() - count); size >= 16 && data[offset + 1] < 0x80 && data[offset + 2] < 0x80)
+					if (const auto asciiSize = ::decodeAscii(output.data() + count, text.data() + offset, size); asciiSize > 0)
+					{
+						offset += asciiSize;
+						count += asciiSize;
+						continue;
+					}
+#endif
+				output[count++] = lead;
+				++offset;
+			}
+			else if (text.size() - offset >= 4)
+			{
+				// Same as readUtf8, but without checking for the end of the text.
+				const auto part2 = char32_t{ data[offset + 1] & 0b0011'1111u };
+				const auto part3 = char32_t{ data[offset + 2] & 0b0011'1111u };
+				if (!(lead & 0b0010'0000))
+				{
+					output[count++] = ((lead & 0b0001'1111u) << 6) + part2;
+					offset += 2;
+				}
+				else if (!(lead & 0b0001'0000))
+				{
+					output[count++] = ((lead & 0b0000'1111u) << 12) + (part2 << 6) + part3;
+					offset += 3;
+				}
+				else
+				{
+					output[count++] = ((lead & 0b0000'0111u) << 18) + (part2 << 12) + (part3 << 6) + (data[offset + 3] & 0b0011'1111u);
+					offset += 4;
+				}
+			}
+			else
+				output[count++] = readUtf8(text, offset);
+		}
+		return count;
+	}
+}
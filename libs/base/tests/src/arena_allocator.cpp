@@ -0,0 +1,70 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/arena_allocator.hpp>
+#include <seir_base/rigid_vector.hpp>
+
+#include <cstdint>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("Arena")
+{
+	seir::Arena arena{ 1024 };
+	CHECK(arena.capacity() == 0);
+	size_t size = 1;
+	const auto first = arena.tryAllocate(size);
+	REQUIRE(first);
+	CHECK(size == alignof(std::max_align_t));
+	CHECK(reinterpret_cast<uintptr_t>(first) % alignof(std::max_align_t) == 0);
+	CHECK(arena.capacity() == 1024);
+	size = 100;
+	const auto second = arena.tryAllocate(size);
+	CHECK(static_cast<std::byte*>(second) == static_cast<std::byte*>(first) + alignof(std::max_align_t));
+	CHECK(size % alignof(std::max_align_t) == 0);
+	size = 4096;
+	const auto large = arena.tryAllocate(size);
+	REQUIRE(large);
+	CHECK(size == 4096);
+	CHECK(arena.capacity() == 1024 + 4096);
+	arena.reset();
+	size = 1;
+	CHECK(arena.tryAllocate(size) == first);
+	size = 4096;
+	CHECK(arena.tryAllocate(size) == large);
+	CHECK(arena.capacity() == 1024 + 4096);
+}
+
+TEST_CASE("ArenaAllocator")
+{
+	size_t size = 1;
+	CHECK_FALSE(seir::ArenaAllocator::tryAllocate(size));
+	CHECK_THROWS_AS(static_cast<void>(seir::ArenaAllocator::allocate(size)), std::bad_alloc);
+	seir::Arena arena;
+	void* outer = nullptr;
+	{
+		seir::ArenaScope outerScope{ arena };
+		outer = seir::ArenaAllocator::allocate(size);
+		void* inner = nullptr;
+		{
+			seir::Arena otherArena;
+			seir::ArenaScope otherScope{ otherArena };
+			inner = seir::ArenaAllocator::allocate(size);
+			CHECK(inner != outer);
+		}
+		{
+			seir::ArenaScope innerScope{ arena };
+			seir::RigidVector<int, seir::ArenaAllocator> vector;
+			vector.reserve(2);
+			vector.emplace_back(1);
+			vector.emplace_back(2);
+			inner = vector.data();
+			CHECK(inner == static_cast<std::byte*>(outer) + alignof(std::max_align_t));
+		}
+		CHECK(seir::ArenaAllocator::allocate(size) == inner);
+	}
+	CHECK_FALSE(seir::ArenaAllocator::tryAllocate(size));
+	seir::ArenaScope scope{ arena };
+	CHECK(seir::ArenaAllocator::allocate(size) == outer);
+}
@@ -4,8 +4,11 @@
 
 #include <seir_base/base64.hpp>
 
-#include <vector>
+#include <algorithm>
+#include <array>
+#include <string>
 #include <string_view>
+#include <vector>
 
 #include <ostream>
 #include <doctest/doctest.h>
@@ -208,3 +211,66 @@ TEST_CASE("decodeBase64")
 		}
 	}
 }
+
+static_assert([] {
+	constexpr std::array input{ std::byte{ 0x22 }, std::byte{ 0x44 }, std::byte{ 0x66 }, std::byte{ 0x88 } };
+	std::array<char, 6> output{};
+	return seir::encodeBase64Url(output, input) && std::string_view{ output.data(), output.size() } == "IkRmiA";
+}());
+
+static_assert([] {
+	constexpr std::string_view input = "IkRmiA";
+	std::array<std::byte, 4> output{};
+	return seir::decodeBase64Url(output, input) && output == std::array{ std::byte{ 0x22 }, std::byte{ 0x44 }, std::byte{ 0x66 }, std::byte{ 0x88 } };
+}());
+
+TEST_CASE("base64Url (long)")
+{
+	std::vector<uint8_t> data(300);
+	uint32_t seed = 1;
+	for (auto& byte : data)
+	{
+		seed = seed * 1664525 + 1013904223;
+		byte = static_cast<uint8_t>(seed >> 24);
+	}
+	SUBCASE("valid")
+	{
+		for (size_t size = 0; size <= data.size(); ++size)
+		{
+			const auto input = std::span{ data }.first(size);
+			std::string encoded(seir::base64EncodedSize(size), '.');
+			REQUIRE(seir::encodeBase64Url(encoded, std::as_bytes(input)));
+			std::string expected;
+			for (size_t offset = 0; offset < size; offset += 3)
+			{
+				// Blocks this short are encoded without SIMD instructions.
+				const auto block = input.subspan(offset, std::min<size_t>(size - offset, 3));
+				std::array<char, 4> blockOutput{};
+				REQUIRE(seir::encodeBase64Url(blockOutput, std::as_bytes(block)));
+				expected.append(blockOutput.data(), seir::base64EncodedSize(block.size()));
+			}
+			CHECK(encoded == expected);
+			std::vector<uint8_t> decoded(size);
+			REQUIRE(seir::decodeBase64Url(std::as_writable_bytes(std::span{ decoded }), encoded));
+			CHECK(std::equal(decoded.begin(), decoded.end(), input.begin(), input.end()));
+		}
+	}
+	SUBCASE("invalid")
+	{
+		std::string encoded(seir::base64EncodedSize(data.size()), '.');
+		REQUIRE(seir::encodeBase64Url(encoded, std::as_bytes(std::span{ data })));
+		constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+		std::vector<uint8_t> decoded(data.size());
+		size_t decodedCount = 0;
+		for (const size_t position : { size_t{ 0 }, size_t{ 17 }, size_t{ 100 }, size_t{ 255 }, encoded.size() - 1 })
+			for (int i = 0; i < 256; ++i)
+				if (const auto c = static_cast<char>(i); alphabet.find(c) == std::string_view::npos)
+				{
+					auto corrupted = encoded;
+					corrupted[position] = c;
+					if (seir::decodeBase64Url(std::as_writable_bytes(std::span{ decoded }), corrupted))
+						++decodedCount;
+				}
+		CHECK(decodedCount == 0);
+	}
+}
@@ -4,7 +4,9 @@
 
 #include <seir_base/base85.hpp>
 
+#include <algorithm>
 #include <array>
+#include <string>
 #include <string_view>
 #include <vector>
 
@@ -212,3 +214,75 @@ TEST_CASE("decodeZ85")
 		}
 	}
 }
+
+static_assert([] {
+	constexpr std::array input{ std::byte{ 0x86 }, std::byte{ 0x4F }, std::byte{ 0xD2 }, std::byte{ 0x6F }, std::byte{ 0xFF } };
+	std::array<char, 7> output{};
+	return seir::encodeZ85(output, input) && std::string_view{ output.data(), output.size() } == "Hello@%";
+}());
+
+static_assert([] {
+	constexpr std::string_view input = "Hello@%";
+	std::array<std::byte, 5> output{};
+	return seir::decodeZ85(output, input) && output == std::array{ std::byte{ 0x86 }, std::byte{ 0x4F }, std::byte{ 0xD2 }, std::byte{ 0x6F }, std::byte{ 0xFF } };
+}());
+
+TEST_CASE("Z85 (long)")
+{
+	std::vector<uint8_t> data(300);
+	uint32_t seed = 1;
+	for (auto& byte : data)
+	{
+		seed = seed * 1664525 + 1013904223;
+		byte = static_cast<uint8_t>(seed >> 24);
+	}
+	std::fill_n(data.begin() + 32, 4, uint8_t{ 0x00 });
+	std::fill_n(data.begin() + 36, 4, uint8_t{ 0xFF });
+	SUBCASE("valid")
+	{
+		for (size_t size = 0; size <= data.size(); ++size)
+		{
+			const auto input = std::span{ data }.first(size);
+			std::string encoded(seir::base85EncodedSize(size), '.');
+			REQUIRE(seir::encodeZ85(encoded, std::as_bytes(input)));
+			std::string expected;
+			for (size_t offset = 0; offset < size; offset += 4)
+			{
+				// Blocks this short are encoded without SIMD instructions.
+				const auto block = input.subspan(offset, std::min<size_t>(size - offset, 4));
+				std::array<char, 5> blockOutput{};
+				REQUIRE(seir::encodeZ85(blockOutput, std::as_bytes(block)));
+				expected.append(blockOutput.data(), seir::base85EncodedSize(block.size()));
+			}
+			CHECK(encoded == expected);
+			std::vector<uint8_t> decoded(size);
+			REQUIRE(seir::decodeZ85(std::as_writable_bytes(std::span{ decoded }), encoded));
+			CHECK(std::equal(decoded.begin(), decoded.end(), input.begin(), input.end()));
+		}
+	}
+	SUBCASE("invalid")
+	{
+		std::string encoded(seir::base85EncodedSize(data.size()), '.');
+		REQUIRE(seir::encodeZ85(encoded, std::as_bytes(std::span{ data })));
+		constexpr std::string_view alphabet = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ.-:+=^!/*?&<>()[]{}@%$#";
+		std::vector<uint8_t> decoded(data.size());
+		size_t decodedCount = 0;
+		for (const size_t position : { size_t{ 0 }, size_t{ 19 }, size_t{ 100 }, size_t{ 254 }, encoded.size() - 1 })
+			for (int i = 0; i < 256; ++i)
+				if (const auto c = static_cast<char>(i); alphabet.find(c) == std::string_view::npos)
+				{
+					auto corrupted = encoded;
+					corrupted[position] = c;
+					if (seir::decodeZ85(std::as_writable_bytes(std::span{ decoded }), corrupted))
+						++decodedCount;
+				}
+		for (size_t position = 0; position + 5 <= encoded.size(); position += 5)
+		{
+			auto corrupted = encoded;
+			corrupted.replace(position, 5, "%nSc1"); // 2^32
+			if (seir::decodeZ85(std::as_writable_bytes(std::span{ decoded }), corrupted))
+				++decodedCount;
+		}
+		CHECK(decodedCount == 0);
+	}
+}
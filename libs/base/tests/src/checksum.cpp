@@ -0,0 +1,86 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/checksum.hpp>
+
+#include <random>
+#include <string_view>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+	std::vector<uint8_t> makeRandomData(size_t size)
+	{
+		std::mt19937 random{ 1 };
+		std::vector<uint8_t> result(size);
+		for (auto& byte : result)
+			byte = static_cast<uint8_t>(random());
+		return result;
+	}
+
+	uint32_t referenceCrc32(const uint8_t* data, size_t size)
+	{
+		uint32_t crc = 0xffffffff;
+		for (size_t i = 0; i < size; ++i)
+		{
+			crc ^= data[i];
+			for (int bit = 0; bit < 8; ++bit)
+				crc = (crc >> 1) ^ (0xedb88320 & (0 - (crc & 1)));
+		}
+		return ~crc;
+	}
+
+	uint32_t referenceAdler32(const uint8_t* data, size_t size)
+	{
+		uint32_t a = 1;
+		uint32_t b = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			a = (a + data[i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		return b << 16 | a;
+	}
+
+	constexpr std::string_view kCheckString = "123456789";
+}
+
+TEST_CASE("Crc32")
+{
+	CHECK(seir::Crc32{}.value() == 0);
+	CHECK(seir::Crc32{}.process(kCheckString.data(), kCheckString.size()).value() == 0xcbf43926);
+	const auto data = makeRandomData(70'000);
+	for (const size_t size : { 1u, 15u, 16u, 17u, 63u, 64u, 65u, 127u, 128u, 129u, 1000u, 4096u, 65'537u })
+		for (const size_t offset : { 0u, 1u, 7u })
+		{
+			CAPTURE(size);
+			CAPTURE(offset);
+			const auto expected = referenceCrc32(data.data() + offset, size);
+			CHECK(seir::Crc32{}.process(data.data() + offset, size).value() == expected);
+			const auto split = size / 3;
+			CHECK(seir::Crc32{}.process(data.data() + offset, split).process(data.data() + offset + split, size - split).value() == expected);
+		}
+}
+
+TEST_CASE("Adler32")
+{
+	CHECK(seir::Adler32{}.value() == 1);
+	CHECK(seir::Adler32{}.process("Wikipedia", 9).value() == 0x11e60398);
+	const auto data = makeRandomData(70'000);
+	for (const size_t size : { 1u, 31u, 32u, 33u, 100u, 5552u, 5553u, 5600u, 65'537u })
+		for (const size_t offset : { 0u, 1u, 7u })
+		{
+			CAPTURE(size);
+			CAPTURE(offset);
+			const auto expected = referenceAdler32(data.data() + offset, size);
+			CHECK(seir::Adler32{}.process(data.data() + offset, size).value() == expected);
+			const auto split = size / 3;
+			CHECK(seir::Adler32{}.process(data.data() + offset, split).process(data.data() + offset + split, size - split).value() == expected);
+			CHECK(seir::Adler32{}.process(data.data() + offset, split).combine(seir::Adler32{}.process(data.data() + offset + split, size - split), size - split).value() == expected);
+		}
+	const std::vector<uint8_t> ones(100'000, 0xff); // Maximum sums.
+	CHECK(seir::Adler32{}.process(ones.data(), ones.size()).value() == referenceAdler32(ones.data(), ones.size()));
+}
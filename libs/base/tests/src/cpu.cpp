@@ -0,0 +1,27 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/cpu.hpp>
+
+#include <seir_base/intrinsics.hpp>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("hasCpuFeature")
+{
+#if !SEIR_INTRINSICS_SSE
+	CHECK_FALSE(seir::hasCpuFeature(seir::CpuFeature::Avx2));
+#elif defined(__AVX2__)
+	CHECK(seir::hasCpuFeature(seir::CpuFeature::Avx2));
+#else
+	static_cast<void>(seir::hasCpuFeature(seir::CpuFeature::Avx2));
+#endif
+#if !SEIR_INTRINSICS_SSE
+	CHECK_FALSE(seir::hasCpuFeature(seir::CpuFeature::Pclmul));
+#elif defined(__PCLMUL__)
+	CHECK(seir::hasCpuFeature(seir::CpuFeature::Pclmul));
+#else
+	static_cast<void>(seir::hasCpuFeature(seir::CpuFeature::Pclmul));
+#endif
+}
@@ -0,0 +1,58 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/mpsc_ring.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("MpscRing")
+{
+	seir::MpscRing<std::unique_ptr<int>> ring{ 3 };
+	CHECK(ring.capacity() == 4);
+	std::unique_ptr<int> value;
+	CHECK_FALSE(ring.tryPop(value));
+	for (int i = 0; i < 4; ++i)
+		CHECK(ring.tryPush(std::make_unique<int>(i)));
+	CHECK_FALSE(ring.tryPush(std::make_unique<int>(4)));
+	for (int i = 0; i < 2; ++i)
+	{
+		REQUIRE(ring.tryPop(value));
+		CHECK(*value == i);
+	}
+	CHECK(ring.tryPush(std::make_unique<int>(4))); // The remaining items are destroyed with the ring.
+}
+
+TEST_CASE("MpscRing (threads)")
+{
+	constexpr unsigned kProducers = 4;
+	constexpr unsigned kCount = 25'000;
+	seir::MpscRing<unsigned> ring{ 64 };
+	std::vector<std::thread> producers;
+	for (unsigned producer = 0; producer < kProducers; ++producer)
+		producers.emplace_back([&ring, producer] {
+			for (unsigned i = 0; i < kCount; ++i)
+				while (!ring.tryPush(producer * kCount + i))
+					std::this_thread::yield();
+		});
+	// Items from every producer must arrive in the order they were pushed.
+	std::vector<unsigned> next(kProducers, 0);
+	bool ordered = true;
+	for (unsigned i = 0; i < kProducers * kCount; ++i)
+	{
+		unsigned value = 0;
+		while (!ring.tryPop(value))
+			std::this_thread::yield();
+		const auto producer = value / kCount;
+		ordered = ordered && producer < kProducers && value % kCount == next[producer]++;
+	}
+	for (auto& producer : producers)
+		producer.join();
+	CHECK(ordered);
+	unsigned value = 0;
+	CHECK_FALSE(ring.tryPop(value));
+}
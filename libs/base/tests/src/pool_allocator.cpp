@@ -0,0 +1,77 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/pool_allocator.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("PoolAllocator")
+{
+	SUBCASE("Size classes")
+	{
+		for (const auto& [requested, allocated] : { std::pair<size_t, size_t>{ 0, 16 }, { 1, 16 }, { 16, 16 }, { 17, 32 }, { 1000, 1024 }, { 4096, 4096 }, { 4097, 4097 } })
+		{
+			INFO(requested);
+			auto size = requested;
+			const auto memory = seir::PoolAllocator::allocate(size);
+			REQUIRE(memory);
+			CHECK(size == allocated);
+			CHECK(reinterpret_cast<uintptr_t>(memory) % alignof(std::max_align_t) == 0);
+			std::memset(memory, 0xff, size);
+			seir::PoolAllocator::deallocate(memory);
+		}
+	}
+	SUBCASE("Reuse")
+	{
+		size_t size = 100;
+		const auto first = seir::PoolAllocator::allocate(size);
+		seir::PoolAllocator::deallocate(first);
+		CHECK(seir::PoolAllocator::allocate(size) == first);
+		seir::PoolAllocator::deallocate(first);
+	}
+	SUBCASE("Threads")
+	{
+		// Blocks allocated in one thread and deallocated in another
+		// must end up in the shared pool instead of being lost.
+		// The consumer frees too few blocks to release any of them before it exits.
+		constexpr size_t kBlockSize = seir::PoolAllocator::kMaxPooledSize / 2;
+		std::vector<void*> blocks;
+		std::thread producer{ [&blocks] {
+			for (int i = 0; i < 100; ++i)
+			{
+				size_t size = kBlockSize;
+				blocks.emplace_back(seir::PoolAllocator::allocate(size));
+				std::memset(blocks.back(), i & 0xff, size);
+			}
+		} };
+		producer.join();
+		std::thread consumer{ [&blocks] {
+			for (const auto block : blocks)
+				seir::PoolAllocator::deallocate(block);
+		} };
+		consumer.join();
+		size_t returned = 0;
+		std::thread checker{ [&blocks, &returned] {
+			std::vector<void*> allocated;
+			while (returned < blocks.size() && allocated.size() < 100 * blocks.size())
+			{
+				size_t size = kBlockSize;
+				allocated.emplace_back(seir::PoolAllocator::allocate(size));
+				if (std::find(blocks.begin(), blocks.end(), allocated.back()) != blocks.end())
+					++returned;
+			}
+			for (const auto block : allocated)
+				seir::PoolAllocator::deallocate(block);
+		} };
+		checker.join();
+		CHECK(returned == blocks.size());
+	}
+	seir::PoolAllocator::deallocate(nullptr);
+}
@@ -0,0 +1,167 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/profiler.hpp>
+
+#include <cstring>
+#include <thread>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+	seir::Profiler::Clock::time_point timePoint(int64_t nanoseconds) noexcept
+	{
+		return seir::Profiler::Clock::time_point{ std::chrono::duration_cast<seir::Profiler::Clock::duration>(std::chrono::nanoseconds{ nanoseconds }) };
+	}
+
+	class BinaryReader
+	{
+	public:
+		explicit BinaryReader(const std::vector<std::byte>& data) noexcept
+			: _data{ data } {}
+
+		bool atEnd() const noexcept { return _offset == _data.size(); }
+
+		uint64_t number() noexcept
+		{
+			uint64_t result = 0;
+			for (int shift = 0; _offset < _data.size(); shift += 7)
+			{
+				const auto byte = static_cast<uint64_t>(_data[_offset++]);
+				result |= (byte & 0x7F) << shift;
+				if (byte < 0x80)
+					break;
+			}
+			return result;
+		}
+
+		std::string string(size_t size)
+		{
+			std::string result(size, '\0');
+			if (_offset + size <= _data.size())
+				std::memcpy(result.data(), _data.data() + _offset, size);
+			_offset += size;
+			return result;
+		}
+
+	private:
+		const std::vector<std::byte>& _data;
+		size_t _offset = 0;
+	};
+}
+
+TEST_CASE("Profiler")
+{
+	seir::Profiler::clear();
+	std::thread{ [] {
+		seir::Profiler::setThreadName("Worker");
+		seir::Profiler::addZone("Outer", ::timePoint(1'000'000), ::timePoint(1'004'000));
+		seir::Profiler::addZone("Inner", ::timePoint(1'001'500), ::timePoint(1'002'000));
+	} }.join();
+	std::thread{ [] {
+		seir::Profiler::addFrame(::timePoint(2'000'000), ::timePoint(2'016'667));
+	} }.join();
+	SUBCASE("chromeTrace")
+	{
+		const auto trace = seir::Profiler::chromeTrace();
+		const auto threadName = trace.find(R"({"name":"thread_name","ph":"M","pid":1,"tid":)");
+		const auto outer = trace.find(R"({"name":"Outer","ph":"X","pid":1,"tid":)");
+		const auto inner = trace.find(R"({"name":"Inner","ph":"X","pid":1,"tid":)");
+		const auto frame = trace.find(R"({"name":"Frame","ph":"X","pid":1,"tid":)");
+		REQUIRE(threadName != std::string::npos);
+		REQUIRE(outer != std::string::npos);
+		REQUIRE(inner != std::string::npos);
+		REQUIRE(frame != std::string::npos);
+		CHECK(threadName < outer);
+		CHECK(outer < inner);
+		CHECK(trace.find(R"("args":{"name":"Worker"}})", threadName) != std::string::npos);
+		CHECK(trace.find(R"("ts":1000.000,"dur":4.000})", outer) != std::string::npos);
+		CHECK(trace.find(R"("ts":1001.500,"dur":0.500})", inner) != std::string::npos);
+		CHECK(trace.find(R"("ts":2000.000,"dur":16.667})", frame) != std::string::npos);
+	}
+	SUBCASE("binaryTrace")
+	{
+		const auto trace = seir::Profiler::binaryTrace();
+		BinaryReader reader{ trace };
+		CHECK(reader.string(11) == "SeirProfile");
+		std::vector<std::string> strings(reader.number());
+		for (auto& string : strings)
+			string = reader.string(reader.number());
+		std::string zones;
+		for (auto threads = reader.number(); threads > 0; --threads)
+		{
+			if (const auto name = reader.number(); name > 0)
+				zones += strings.at(name - 1) + ':';
+			uint64_t time = 0;
+			for (auto count = reader.number(); count > 0; --count)
+			{
+				const auto& zone = strings.at(reader.number());
+				time += reader.number();
+				zones += zone + '@' + std::to_string(time) + '+' + std::to_string(reader.number()) + ';';
+			}
+		}
+		CHECK(reader.atEnd());
+		CHECK(zones.find("Worker:Outer@1000000+4000;Inner@1001500+500;") != std::string::npos);
+		CHECK(zones.find("Frame@2000000+16667;") != std::string::npos);
+	}
+	SUBCASE("negative duration")
+	{
+		std::thread{ [] {
+			seir::Profiler::addZone("Negative", ::timePoint(3'000'000), ::timePoint(2'998'500));
+		} }.join();
+		const auto trace = seir::Profiler::chromeTrace();
+		CHECK(trace.find(R"("name":"Negative","ph":"X","pid":1,"tid":)") != std::string::npos);
+		CHECK(trace.find(R"("ts":3000.000,"dur":-1.500})") != std::string::npos);
+	}
+	SUBCASE("many threads")
+	{
+		// Every thread has its own zones even if there are more threads than ring buffers.
+		constexpr int kThreadCount = 300;
+		for (int i = 0; i < kThreadCount; ++i)
+			std::thread{ [i] {
+				seir::Profiler::addZone("Many", ::timePoint(4'000'000 + i), ::timePoint(4'000'001 + i));
+			} }.join();
+		const auto trace = seir::Profiler::chromeTrace();
+		int zones = 0;
+		for (auto i = trace.find(R"("name":"Many")"); i != std::string::npos; i = trace.find(R"("name":"Many")", i + 1))
+			++zones;
+		CHECK(zones == kThreadCount);
+		CHECK(trace.find(R"("ts":4000.299,"dur":0.001})") != std::string::npos);
+	}
+	SUBCASE("record limit")
+	{
+		// Only the latest zones are kept, both when lowering the limit and when collecting.
+		seir::Profiler::setRecordLimit(1);
+		seir::Profiler::setRecordLimit(3);
+		std::thread{ [] {
+			for (int i = 0; i < 10; ++i)
+			{
+				seir::Profiler::addZone("Limited", ::timePoint(5'000'000 + i * 1000), ::timePoint(5'000'001 + i * 1000));
+				if (i == 4)
+					seir::Profiler::collect();
+			}
+		} }.join();
+		const auto trace = seir::Profiler::chromeTrace();
+		seir::Profiler::setRecordLimit(1 << 20);
+		CHECK(trace.find(R"("name":"Outer")") == std::string::npos);
+		CHECK(trace.find(R"("name":"Inner")") != std::string::npos);
+		CHECK(trace.find(R"("name":"Frame")") != std::string::npos);
+		std::string zones;
+		for (auto i = trace.find(R"("name":"Limited")"); i != std::string::npos; i = trace.find(R"("name":"Limited")", i + 1))
+			zones += trace.substr(trace.find(R"("ts":)", i), 13) + ';';
+		CHECK(zones == R"("ts":5007.000;"ts":5008.000;"ts":5009.000;)");
+	}
+	SUBCASE("clear")
+	{
+		seir::Profiler::clear();
+		{
+			const seir::ProfilerZone zone{ "Zone" };
+		}
+		const auto trace = seir::Profiler::chromeTrace();
+		CHECK(trace.find(R"("name":"Zone")") != std::string::npos);
+		CHECK(trace.find(R"("name":"Outer")") == std::string::npos);
+		CHECK(trace.find(R"("name":"Frame")") == std::string::npos);
+	}
+}
@@ -0,0 +1,52 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/spsc_ring.hpp>
+
+#include <memory>
+#include <thread>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("SpscRing")
+{
+	seir::SpscRing<std::unique_ptr<int>, 4> ring;
+	CHECK(ring.capacity() == 4);
+	CHECK(ring.size() == 0);
+	std::unique_ptr<int> value;
+	CHECK_FALSE(ring.tryPop(value));
+	for (int i = 0; i < 4; ++i)
+		CHECK(ring.tryPush(std::make_unique<int>(i)));
+	CHECK(ring.size() == 4);
+	CHECK_FALSE(ring.tryPush(std::make_unique<int>(4)));
+	for (int i = 0; i < 2; ++i)
+	{
+		REQUIRE(ring.tryPop(value));
+		CHECK(*value == i);
+	}
+	CHECK(ring.tryPush(std::make_unique<int>(4)));
+	CHECK(ring.size() == 3); // The remaining items are destroyed with the ring.
+}
+
+TEST_CASE("SpscRing (threads)")
+{
+	constexpr unsigned kCount = 100'000;
+	seir::SpscRing<unsigned, 64> ring;
+	std::thread producer{ [&ring] {
+		for (unsigned i = 0; i < kCount; ++i)
+			while (!ring.tryPush(i))
+				std::this_thread::yield();
+	} };
+	bool ordered = true;
+	for (unsigned i = 0; i < kCount; ++i)
+	{
+		unsigned value = 0;
+		while (!ring.tryPop(value))
+			std::this_thread::yield();
+		ordered = ordered && value == i;
+	}
+	producer.join();
+	CHECK(ordered);
+	CHECK(ring.size() == 0);
+}
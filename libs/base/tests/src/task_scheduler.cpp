@@ -0,0 +1,93 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/task_scheduler.hpp>
+
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("TaskScheduler")
+{
+	for (const unsigned workerCount : { 0u, 1u, 4u })
+	{
+		INFO(workerCount);
+		seir::TaskScheduler scheduler{ workerCount };
+		CHECK(scheduler.workerCount() == workerCount);
+		SUBCASE("TaskGroup")
+		{
+			std::atomic<int> counter{ 0 };
+			{
+				seir::TaskGroup group{ scheduler };
+				for (int i = 0; i < 1000; ++i)
+					group.run([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+				group.wait();
+				CHECK(counter.load() == 1000);
+				group.run([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+			}
+			CHECK(counter.load() == 1001);
+		}
+		SUBCASE("TaskGroup (nested)")
+		{
+			std::atomic<int> counter{ 0 };
+			seir::TaskGroup outer{ scheduler };
+			for (int i = 0; i < 10; ++i)
+				outer.run([&scheduler, &counter] {
+					seir::TaskGroup inner{ scheduler };
+					for (int j = 0; j < 100; ++j)
+						inner.run([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+				});
+			outer.wait();
+			CHECK(counter.load() == 1000);
+		}
+		SUBCASE("TaskGroup (threads)")
+		{
+			std::atomic<int> counter{ 0 };
+			seir::TaskGroup group{ scheduler };
+			std::vector<std::thread> threads;
+			for (int i = 0; i < 4; ++i)
+				threads.emplace_back([&group, &counter] {
+					for (int j = 0; j < 250; ++j)
+						group.run([&counter] { counter.fetch_add(1, std::memory_order_relaxed); });
+				});
+			for (auto& thread : threads)
+				thread.join();
+			group.wait();
+			CHECK(counter.load() == 1000);
+		}
+		SUBCASE("TaskGroup (throwing copy)")
+		{
+			struct Function
+			{
+				int* _counter;
+				explicit Function(int* counter) noexcept
+					: _counter{ counter } {}
+				Function(const Function&) { throw std::runtime_error{ "copy" }; }
+				void operator()() const noexcept { ++*_counter; }
+			};
+			int counter = 0;
+			const Function function{ &counter };
+			seir::TaskGroup group{ scheduler };
+			CHECK_THROWS_AS(group.run(function), std::runtime_error);
+			group.wait();
+			CHECK(counter == 0);
+		}
+		SUBCASE("parallelFor")
+		{
+			std::vector<int> values(10'000, 0);
+			scheduler.parallelFor(0, values.size(), 64, [&values](size_t i) { values[i] += static_cast<int>(i); });
+			bool ok = true;
+			for (size_t i = 0; i < values.size(); ++i)
+				ok = ok && values[i] == static_cast<int>(i);
+			CHECK(ok);
+			std::atomic<size_t> calls{ 0 };
+			scheduler.parallelFor(5, 5, 1, [&calls](size_t) { calls.fetch_add(1); });
+			CHECK(calls.load() == 0);
+			scheduler.parallelFor(0, 3, 0, [&calls](size_t) { calls.fetch_add(1); });
+			CHECK(calls.load() == 3);
+		}
+	}
+}
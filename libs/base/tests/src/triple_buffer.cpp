@@ -0,0 +1,61 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/triple_buffer.hpp>
+
+#include <array>
+#include <thread>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("TripleBuffer")
+{
+	seir::TripleBuffer<int> buffer;
+	CHECK(buffer.front() == 0);
+	CHECK_FALSE(buffer.update());
+	buffer.back() = 1;
+	buffer.publish();
+	buffer.back() = 2;
+	buffer.publish();
+	CHECK(buffer.update());
+	CHECK(buffer.front() == 2);
+	CHECK_FALSE(buffer.update());
+	CHECK(buffer.front() == 2);
+	buffer.back() = 3;
+	buffer.publish();
+	CHECK(buffer.update());
+	CHECK(buffer.front() == 3);
+}
+
+TEST_CASE("TripleBuffer (threads)")
+{
+	// The reader must always see a consistent value, and the values must never go back.
+	constexpr unsigned kCount = 100'000;
+	seir::TripleBuffer<std::array<unsigned, 16>> buffer;
+	std::thread writer{ [&buffer] {
+		for (unsigned i = 1; i <= kCount; ++i)
+		{
+			buffer.back().fill(i);
+			buffer.publish();
+		}
+	} };
+	bool consistent = true;
+	bool monotonic = true;
+	for (unsigned last = 0; last < kCount;)
+	{
+		if (!buffer.update())
+		{
+			std::this_thread::yield();
+			continue;
+		}
+		const auto& value = buffer.front();
+		for (const auto item : value)
+			consistent = consistent && item == value[0];
+		monotonic = monotonic && value[0] > last;
+		last = value[0];
+	}
+	writer.join();
+	CHECK(consistent);
+	CHECK(monotonic);
+}
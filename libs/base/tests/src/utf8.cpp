@@ -4,7 +4,9 @@
 
 #include <seir_base/utf8.hpp>
 
+#include <algorithm>
 #include <string>
+#include <vector>
 
 #include <ostream>
 #include <doctest/doctest.h>
@@ -95,3 +97,119 @@ TEST_CASE("writeUtf8")
 	CHECK(writeUtf8(0x110000) == "");
 	CHECK(writeUtf8(0xffffffff) == "");
 }
+
+namespace
+{
+	// Text with codepoints of all sizes which is long enough to be processed using SIMD instructions.
+	struct MixedText
+	{
+		std::string _text;
+		std::vector<char32_t> _codepoints;
+		std::vector<size_t> _offsets; // Codepoint boundaries.
+
+		MixedText()
+		{
+			constexpr std::array<char32_t, 12> kCodepoints{ 'A', 0x7f, 0x80, 0x44b, 0x7ff, 0x800, 0x4e2d, 0xd7ff, 0xe000, 0xffff, 0x10000, 0x10ffff };
+			for (size_t i = 0; i < 200; ++i)
+			{
+				// Mostly ASCII with runs of multibyte codepoints.
+				const auto codepoint = (i / 10) % 3 == 0 ? kCodepoints[i % kCodepoints.size()] : static_cast<char32_t>('a' + i % 26);
+				std::array<char, 4> buffer;
+				_offsets.emplace_back(_text.size());
+				_text.append(buffer.data(), seir::writeUtf8(buffer, codepoint));
+				_codepoints.emplace_back(codepoint);
+			}
+			_offsets.emplace_back(_text.size());
+		}
+	};
+}
+
+TEST_CASE("isValidUtf8")
+{
+	SUBCASE("short")
+	{
+		for (const std::string_view text : {
+				 "", "\x00", "\x7f", "\xc2\x80", "\xdf\xbf", "\xe0\xa0\x80", "\xed\x9f\xbf", "\xee\x80\x80",
+				 "\xef\xbf\xbf", "\xf0\x90\x80\x80", "\xf4\x8f\xbf\xbf" })
+			CHECK(seir::isValidUtf8(text));
+		for (const std::string_view text : {
+				 "\x80", "\xbf", "\xc0\x80", "\xc1\xbf", "\xc2", "\xc2\x7f", "\xc2\xc2", "\xe0\x80\x80", "\xe0\x9f\xbf",
+				 "\xe2\x82", "\xed\xa0\x80", "\xed\xbf\xbf", "\xf0\x80\x80\x80", "\xf0\x8f\xbf\xbf", "\xf0\x9f\x98",
+				 "\xf4\x90\x80\x80", "\xf5\x80\x80\x80", "\xf8\x88\x80\x80\x80", "\xff", "\xc2\x80\x80" })
+			CHECK_FALSE(seir::isValidUtf8(text));
+	}
+	SUBCASE("long")
+	{
+		const MixedText mixed;
+		CHECK(seir::isValidUtf8(mixed._text));
+		size_t mismatches = 0;
+		for (size_t size = 0; size <= mixed._text.size(); ++size)
+		{
+			const auto isBoundary = std::find(mixed._offsets.begin(), mixed._offsets.end(), size) != mixed._offsets.end();
+			if (seir::isValidUtf8(std::string_view{ mixed._text }.substr(0, size)) != isBoundary)
+				++mismatches;
+		}
+		for (const std::string_view invalid : { "\x80", "\xc1\xbf", "\xc2", "\xe0\x9f\xbf", "\xed\xa0\x80", "\xf0\x8f\xbf\xbf", "\xf4\x90\x80\x80", "\xff" })
+			for (const auto offset : mixed._offsets)
+			{
+				auto text = mixed._text;
+				text.insert(offset, invalid);
+				if (seir::isValidUtf8(text))
+					++mismatches;
+			}
+		CHECK(mismatches == 0);
+	}
+}
+
+TEST_CASE("countUtf8")
+{
+	CHECK(seir::countUtf8("") == 0);
+	CHECK(seir::countUtf8("abc") == 3);
+	CHECK(seir::countUtf8("\xd0\xb0\xe4\xb8\xad\xf0\x90\x80\x80") == 3);
+	CHECK(seir::countUtf8("\x80\xbf") == 0);
+	const MixedText mixed;
+	size_t mismatches = 0;
+	for (size_t i = 0; i < mixed._offsets.size(); ++i)
+		if (seir::countUtf8(std::string_view{ mixed._text }.substr(mixed._offsets[i])) != mixed._codepoints.size() - i)
+			++mismatches;
+	CHECK(mismatches == 0);
+	CHECK(seir::countUtf8(std::string(1000, 'a') + std::string(1000, '\x80')) == 1000);
+}
+
+TEST_CASE("decodeUtf8")
+{
+	const auto decode = [](std::string_view text, size_t bufferSize) {
+		std::vector<char32_t> result;
+		std::vector<char32_t> buffer(bufferSize);
+		for (size_t offset = 0; offset < text.size();)
+		{
+			const auto count = seir::decodeUtf8(buffer, text, offset);
+			REQUIRE(count > 0);
+			result.insert(result.end(), buffer.begin(), buffer.begin() + static_cast<std::ptrdiff_t>(count));
+		}
+		return result;
+	};
+	SUBCASE("valid")
+	{
+		const MixedText mixed;
+		for (const size_t bufferSize : { 1u, 7u, 16u, 64u, 1000u })
+			CHECK(decode(mixed._text, bufferSize) == mixed._codepoints);
+		const std::string ascii(1000, 'a');
+		CHECK(decode(ascii, 1000) == std::vector<char32_t>(1000, U'a'));
+	}
+	SUBCASE("invalid")
+	{
+		const auto text = MixedText{}._text + "\xff\x80" + std::string(40, 'x') + "\xe0\xa0";
+		std::vector<char32_t> expected;
+		for (size_t offset = 0; offset < text.size();)
+			expected.emplace_back(seir::readUtf8(text, offset));
+		for (const size_t bufferSize : { 1u, 7u, 16u, 64u, 1000u })
+			CHECK(decode(text, bufferSize) == expected);
+	}
+	SUBCASE("empty output")
+	{
+		size_t offset = 0;
+		CHECK(seir::decodeUtf8({}, "abc", offset) == 0);
+		CHECK(offset == 0);
+	}
+}
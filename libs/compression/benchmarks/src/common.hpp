@@ -0,0 +1,111 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_compression/compression.hpp>
+
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+// Files from the data directory which are representative of what gets into packages.
+constexpr std::array kSampleFiles{
+	"fonts/SourceCodePro-Regular.ttf",
+	"fonts/SourceSans3-Regular.ttf",
+	"icon.ico",
+};
+
+// Generated samples which cover both ends of the compressibility spectrum.
+constexpr std::array kSyntheticSamples{
+	"synthetic/text",
+	"synthetic/noise",
+};
+
+constexpr size_t kSyntheticSampleSize = 1 << 20;
+
+constexpr auto kSampleCount = kSampleFiles.size() + kSyntheticSamples.size();
+
+// Generates text-like data from a small vocabulary, or random bytes.
+inline std::vector<std::byte> makeSyntheticSample(size_t index, size_t size)
+{
+	constexpr std::array<std::string_view, 16> words{
+		"the", "seir", "archive", "of", "compressed", "data", "and", "a",
+		"file", "with", "some", "blocks", "to", "be", "packed", "in",
+	};
+	std::vector<std::byte> result;
+	result.reserve(size);
+	uint32_t state = 1;
+	const auto next = [&state] { return state = state * 1664525u + 1013904223u; };
+	while (result.size() < size)
+	{
+		if (index == 0)
+		{
+			const auto value = next();
+			for (const auto c : words[value >> 28])
+				result.emplace_back(static_cast<std::byte>(c));
+			result.emplace_back(static_cast<std::byte>((value >> 24) % 8 ? ' ' : '\n'));
+		}
+		else
+			result.emplace_back(static_cast<std::byte>(next() >> 24));
+	}
+	result.resize(size);
+	return result;
+}
+
+// Loads the sample specified by the first benchmark argument.
+inline std::vector<std::byte> loadSample(benchmark::State& state)
+{
+	const auto index = static_cast<size_t>(state.range(0));
+	if (index >= kSampleFiles.size())
+	{
+		state.SetLabel(kSyntheticSamples[index - kSampleFiles.size()]);
+		return makeSyntheticSample(index - kSampleFiles.size(), kSyntheticSampleSize);
+	}
+	const auto name = kSampleFiles[index];
+	state.SetLabel(name);
+	std::vector<std::byte> result;
+	if (std::ifstream stream{ std::string{ SEIR_DATA_DIR } + name, std::ios::binary | std::ios::ate })
+	{
+		result.resize(static_cast<size_t>(stream.tellg()));
+		stream.seekg(0);
+		if (!stream.read(reinterpret_cast<char*>(result.data()), static_cast<std::streamsize>(result.size())))
+			result.clear();
+	}
+	if (result.empty())
+		state.SkipWithError("Unable to load sample data");
+	return result;
+}
+
+// Returns the compression level specified by the second benchmark argument.
+inline seir::CompressionLevel sampleCompressionLevel(const benchmark::State& state)
+{
+	return static_cast<seir::CompressionLevel>(state.range(1));
+}
+
+// Runs the benchmark for every sample at every actual compression level.
+inline void sampleArguments(benchmark::internal::Benchmark* benchmark)
+{
+	benchmark->ArgNames({ "sample", "level" });
+	benchmark->ArgsProduct({
+		benchmark::CreateDenseRange(0, static_cast<int64_t>(kSampleCount - 1), 1),
+		benchmark::CreateDenseRange(static_cast<int64_t>(seir::CompressionLevel::Minimum), static_cast<int64_t>(seir::CompressionLevel::Maximum), 1),
+	});
+}
+
+inline std::vector<std::byte> compressSample(seir::Compression compression, seir::CompressionLevel level, const std::vector<std::byte>& original)
+{
+	std::vector<std::byte> compressed;
+	if (const auto compressor = seir::Compressor::create(compression); compressor && compressor->prepare(level))
+	{
+		compressed.resize(compressor->maxCompressedSize(original.size()));
+		compressed.resize(compressor->compress(compressed.data(), compressed.size(), original.data(), original.size()));
+	}
+	return compressed;
+}
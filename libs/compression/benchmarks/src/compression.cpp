@@ -0,0 +1,98 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "common.hpp"
+
+namespace
+{
+	void benchmark_compress(benchmark::State& state, seir::Compression compression)
+	{
+		const auto original = loadSample(state);
+		if (original.empty())
+			return;
+		const auto level = sampleCompressionLevel(state);
+		const auto compressor = seir::Compressor::create(compression);
+		if (!compressor || !compressor->prepare(level))
+		{
+			state.SkipWithError("Compressor creation failed");
+			return;
+		}
+		std::vector<std::byte> compressed(compressor->maxCompressedSize(original.size()));
+		size_t compressedSize = 0;
+		for (auto _ : state)
+		{
+			if (!compressor->prepare(level)
+				|| !(compressedSize = compressor->compress(compressed.data(), compressed.size(), original.data(), original.size())))
+			{
+				state.SkipWithError("Compression failed");
+				return;
+			}
+			benchmark::DoNotOptimize(compressed.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(original.size()));
+		state.counters["ratio"] = static_cast<double>(original.size()) / static_cast<double>(compressedSize);
+	}
+
+	// Measures the cost of compressing small inputs with a new compressor every time
+	// (as opposed to reusing a prepared one), i. e. the context allocation overhead.
+	void benchmark_compressSmall(benchmark::State& state, seir::Compression compression, bool reuse)
+	{
+		const auto original = makeSyntheticSample(0, static_cast<size_t>(state.range(0)));
+		auto compressor = seir::Compressor::create(compression);
+		if (!compressor || !compressor->prepare(seir::CompressionLevel::Default))
+		{
+			state.SkipWithError("Compressor creation failed");
+			return;
+		}
+		std::vector<std::byte> compressed(compressor->maxCompressedSize(original.size()));
+		for (auto _ : state)
+		{
+			if (!reuse)
+				compressor = seir::Compressor::create(compression);
+			if (!compressor
+				|| !compressor->prepare(seir::CompressionLevel::Default)
+				|| !compressor->compress(compressed.data(), compressed.size(), original.data(), original.size()))
+			{
+				state.SkipWithError("Compression failed");
+				return;
+			}
+			benchmark::DoNotOptimize(compressed.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(original.size()));
+	}
+
+#if SEIR_COMPRESSION_LZ4
+	void compress_Lz4(benchmark::State& state) { benchmark_compress(state, seir::Compression::Lz4); }
+	void compressSmall_Lz4_Create(benchmark::State& state) { benchmark_compressSmall(state, seir::Compression::Lz4, false); }
+	void compressSmall_Lz4_Reuse(benchmark::State& state) { benchmark_compressSmall(state, seir::Compression::Lz4, true); }
+#endif
+#if SEIR_COMPRESSION_ZLIB
+	void compress_Zlib(benchmark::State& state) { benchmark_compress(state, seir::Compression::Zlib); }
+	void compressSmall_Zlib_Create(benchmark::State& state) { benchmark_compressSmall(state, seir::Compression::Zlib, false); }
+	void compressSmall_Zlib_Reuse(benchmark::State& state) { benchmark_compressSmall(state, seir::Compression::Zlib, true); }
+#endif
+#if SEIR_COMPRESSION_ZSTD
+	void compress_Zstd(benchmark::State& state) { benchmark_compress(state, seir::Compression::Zstd); }
+	void compressSmall_Zstd_Create(benchmark::State& state) { benchmark_compressSmall(state, seir::Compression::Zstd, false); }
+	void compressSmall_Zstd_Reuse(benchmark::State& state) { benchmark_compressSmall(state, seir::Compression::Zstd, true); }
+#endif
+}
+
+#if SEIR_COMPRESSION_LZ4
+BENCHMARK(compress_Lz4)->Apply(sampleArguments);
+BENCHMARK(compressSmall_Lz4_Create)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+BENCHMARK(compressSmall_Lz4_Reuse)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+#endif
+#if SEIR_COMPRESSION_ZLIB
+BENCHMARK(compress_Zlib)->Apply(sampleArguments);
+BENCHMARK(compressSmall_Zlib_Create)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+BENCHMARK(compressSmall_Zlib_Reuse)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+#endif
+#if SEIR_COMPRESSION_ZSTD
+BENCHMARK(compress_Zstd)->Apply(sampleArguments);
+BENCHMARK(compressSmall_Zstd_Create)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+BENCHMARK(compressSmall_Zstd_Reuse)->RangeMultiplier(8)->Range(1 << 6, 1 << 15);
+#endif
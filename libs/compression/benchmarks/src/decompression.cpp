@@ -0,0 +1,55 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "common.hpp"
+
+namespace
+{
+	void benchmark_decompress(benchmark::State& state, seir::Compression compression)
+	{
+		const auto original = loadSample(state);
+		if (original.empty())
+			return;
+		const auto compressed = compressSample(compression, sampleCompressionLevel(state), original);
+		const auto decompressor = seir::Decompressor::create(compression);
+		if (compressed.empty() || !decompressor)
+		{
+			state.SkipWithError("Compression failed");
+			return;
+		}
+		std::vector<std::byte> decompressed(original.size());
+		for (auto _ : state)
+		{
+			if (!decompressor->decompress(decompressed.data(), decompressed.size(), compressed.data(), compressed.size()))
+			{
+				state.SkipWithError("Decompression failed");
+				return;
+			}
+			benchmark::DoNotOptimize(decompressed.data());
+			benchmark::ClobberMemory();
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(original.size()));
+		state.counters["ratio"] = static_cast<double>(original.size()) / static_cast<double>(compressed.size());
+	}
+
+#if SEIR_COMPRESSION_LZ4
+	void decompress_Lz4(benchmark::State& state) { benchmark_decompress(state, seir::Compression::Lz4); }
+#endif
+#if SEIR_COMPRESSION_ZLIB
+	void decompress_Zlib(benchmark::State& state) { benchmark_decompress(state, seir::Compression::Zlib); }
+#endif
+#if SEIR_COMPRESSION_ZSTD
+	void decompress_Zstd(benchmark::State& state) { benchmark_decompress(state, seir::Compression::Zstd); }
+#endif
+}
+
+#if SEIR_COMPRESSION_LZ4
+BENCHMARK(decompress_Lz4)->Apply(sampleArguments);
+#endif
+#if SEIR_COMPRESSION_ZLIB
+BENCHMARK(decompress_Zlib)->Apply(sampleArguments);
+#endif
+#if SEIR_COMPRESSION_ZSTD
+BENCHMARK(decompress_Zstd)->Apply(sampleArguments);
+#endif
@@ -4,9 +4,10 @@
 
 #pragma once
 
-#include <seir_base/unique_ptr.hpp>
+#include <seir_base/shared_ptr.hpp>
 
 #include <cstddef>
+#include <limits>
 
 namespace seir
 {
@@ -14,6 +15,7 @@ namespace seir
 	enum class Compression
 	{
 		None, // Special value to specify no compression.
+		Lz4,
 		Zlib,
 		Zstd,
 	};
@@ -27,6 +29,22 @@ namespace seir
 		Maximum,
 	};
 
+	// Compression dictionary which can be shared between multiple compressors and decompressors.
+	class CompressionDictionary : public ReferenceCounter
+	{
+	public:
+		// Creates a dictionary from raw dictionary data.
+		// Returns an empty pointer if the compression algorithm doesn't support dictionaries.
+		[[nodiscard]] static SharedPtr<CompressionDictionary> create(Compression, const void* data, size_t size);
+
+		// Trains a raw dictionary on the specified samples stored one after another.
+		// Returns the actual dictionary size or zero if the compression algorithm
+		// doesn't support dictionaries or there is not enough data to train on.
+		[[nodiscard]] static size_t train(Compression, void* dst, size_t dstCapacity, const void* samples, const size_t* sampleSizes, size_t sampleCount) noexcept;
+
+		virtual ~CompressionDictionary() noexcept = default;
+	};
+
 	// Data compression interface.
 	class Compressor
 	{
@@ -42,6 +60,16 @@ namespace seir
 		// before compressed data size estimation.
 		[[nodiscard]] virtual bool prepare(CompressionLevel) noexcept = 0;
 
+		// Sets the dictionary to use for compression (or resets it if the pointer is empty).
+		// The dictionary must have been created for the same compression algorithm.
+		// The new dictionary takes effect after the next prepare() call.
+		[[nodiscard]] virtual bool setDictionary(const SharedPtr<CompressionDictionary>&) noexcept = 0;
+
+		// Sets the number of worker threads to compress large inputs with (zero means no worker threads).
+		// Compression algorithms without multithreading support (all except zstd) ignore it.
+		// The new value takes effect after the next prepare() call.
+		virtual void setWorkerCount(unsigned) noexcept = 0;
+
 		// Returns the maximum compressed data size for uncompressed data of the specified size.
 		[[nodiscard]] virtual size_t maxCompressedSize(size_t uncompressedSize) const noexcept = 0;
 
@@ -59,6 +87,107 @@ namespace seir
 		static UniquePtr<Decompressor> create(Compression);
 
 		virtual ~Decompressor() noexcept = default;
+
+		// Sets the dictionary to use for decompression (or resets it if the pointer is empty).
+		// The dictionary must have been created for the same compression algorithm.
+		[[nodiscard]] virtual bool setDictionary(const SharedPtr<CompressionDictionary>&) noexcept = 0;
+
 		[[nodiscard]] virtual bool decompress(void* dst, size_t dstCapacity, const void* src, size_t srcSize) noexcept = 0;
 	};
+
+	// Raw deflate compressor for parts of a single zlib stream, which allows compressing the parts
+	// in parallel and concatenating the results (the way pigz does). Every part except the last one
+	// ends at a byte boundary without ending the stream, and the data preceding a part is used
+	// as a dictionary to compress the part almost as well as a single compressor would.
+	// The concatenated parts must be wrapped into a zlib header and an Adler-32 trailer.
+	class ZlibPartCompressor
+	{
+	public:
+		// Returns an empty pointer if zlib support is disabled.
+		static UniquePtr<ZlibPartCompressor> create();
+
+		virtual ~ZlibPartCompressor() noexcept = default;
+
+		// Prepares for compression. Must be called before every compress() call.
+		[[nodiscard]] virtual bool prepare(CompressionLevel) noexcept = 0;
+
+		// Returns the maximum compressed part size for uncompressed part of the specified size.
+		[[nodiscard]] virtual size_t maxCompressedSize(size_t uncompressedSize) const noexcept = 0;
+
+		// Compresses a part of the stream into the output buffer.
+		// The preceding data must immediately precede the part in the uncompressed stream
+		// (only the last 32 KiB of it are used). Returns the actual compressed part size.
+		[[nodiscard]] virtual size_t compress(void* dst, size_t dstCapacity, const void* src, size_t srcSize, const void* preceding, size_t precedingSize, bool last) noexcept = 0;
+	};
+
+	// Input and output data windows for streaming compression and decompression.
+	// Stream functions advance the windows by the amounts of data consumed and produced.
+	struct CompressionBuffers
+	{
+		const std::byte* _src = nullptr;
+		size_t _srcSize = 0;
+		std::byte* _dst = nullptr;
+		size_t _dstSize = 0;
+	};
+
+	// Result of a streaming compression or decompression step.
+	enum class CompressionStatus
+	{
+		Error,    // The data is invalid or an internal error occurred.
+		Continue, // More input data or output space is required.
+		End,      // The stream has ended and all output data has been produced.
+	};
+
+	// Streaming data compression interface.
+	class CompressStream
+	{
+	public:
+		//
+		static constexpr size_t kUnknownSize = std::numeric_limits<size_t>::max();
+
+		//
+		static UniquePtr<CompressStream> create(Compression);
+
+		virtual ~CompressStream() noexcept = default;
+
+		// Starts a new compressed stream, discarding the state of the previous one.
+		// Knowing the total uncompressed size in advance allows some algorithms (namely zstd)
+		// to choose better parameters and to store the size in the compressed stream.
+		[[nodiscard]] virtual bool prepare(CompressionLevel, size_t totalSize = kUnknownSize) noexcept = 0;
+
+		// Sets the dictionary to use for compression (or resets it if the pointer is empty).
+		// The new dictionary takes effect after the next prepare() call.
+		[[nodiscard]] virtual bool setDictionary(const SharedPtr<CompressionDictionary>&) noexcept = 0;
+
+		// Sets the number of worker threads to compress large streams with (zero means no worker threads).
+		// Compression algorithms without multithreading support (all except zstd) ignore it.
+		// The new value takes effect after the next prepare() call.
+		virtual void setWorkerCount(unsigned) noexcept = 0;
+
+		// Compresses as much input data as possible into the output buffer.
+		// If the input is the last part of the stream, the function must be called
+		// with the same flag value until it returns CompressionStatus::End.
+		[[nodiscard]] virtual CompressionStatus compress(CompressionBuffers&, bool last) noexcept = 0;
+	};
+
+	// Streaming data decompression interface.
+	class DecompressStream
+	{
+	public:
+		//
+		static UniquePtr<DecompressStream> create(Compression);
+
+		virtual ~DecompressStream() noexcept = default;
+
+		// Starts decompressing a new stream, discarding the state of the previous one.
+		[[nodiscard]] virtual bool prepare() noexcept = 0;
+
+		// Sets the dictionary to use for decompression (or resets it if the pointer is empty).
+		// The new dictionary takes effect after the next prepare() call.
+		[[nodiscard]] virtual bool setDictionary(const SharedPtr<CompressionDictionary>&) noexcept = 0;
+
+		// Decompresses as much input data as possible into the output buffer.
+		// Returns CompressionStatus::End when the compressed stream ends.
+		[[nodiscard]] virtual CompressionStatus decompress(CompressionBuffers&) noexcept = 0;
+	};
 }
@@ -12,6 +12,12 @@ namespace seir
 		{
 		case Compression::None:
 			break;
+		case Compression::Lz4:
+#if SEIR_COMPRESSION_LZ4
+			return createLz4Compressor();
+#else
+			break;
+#endif
 		case Compression::Zlib:
 #if SEIR_COMPRESSION_ZLIB
 			return createZlibCompressor();
@@ -34,6 +40,12 @@ namespace seir
 		{
 		case Compression::None:
 			break;
+		case Compression::Lz4:
+#if SEIR_COMPRESSION_LZ4
+			return createLz4Decompressor();
+#else
+			break;
+#endif
 		case Compression::Zlib:
 #if SEIR_COMPRESSION_ZLIB
 			return createZlibDecompressor();
@@ -49,4 +61,105 @@ namespace seir
 		}
 		return {};
 	}
+
+	UniquePtr<CompressStream> CompressStream::create(Compression compression)
+	{
+		switch (compression)
+		{
+		case Compression::None:
+			break;
+		case Compression::Lz4:
+#if SEIR_COMPRESSION_LZ4
+			return createLz4CompressStream();
+#else
+			break;
+#endif
+		case Compression::Zlib:
+#if SEIR_COMPRESSION_ZLIB
+			return createZlibCompressStream();
+#else
+			break;
+#endif
+		case Compression::Zstd:
+#if SEIR_COMPRESSION_ZSTD
+			return createZstdCompressStream();
+#else
+			break;
+#endif
+		}
+		return {};
+	}
+
+	UniquePtr<DecompressStream> DecompressStream::create(Compression compression)
+	{
+		switch (compression)
+		{
+		case Compression::None:
+			break;
+		case Compression::Lz4:
+#if SEIR_COMPRESSION_LZ4
+			return createLz4DecompressStream();
+#else
+			break;
+#endif
+		case Compression::Zlib:
+#if SEIR_COMPRESSION_ZLIB
+			return createZlibDecompressStream();
+#else
+			break;
+#endif
+		case Compression::Zstd:
+#if SEIR_COMPRESSION_ZSTD
+			return createZstdDecompressStream();
+#else
+			break;
+#endif
+		}
+		return {};
+	}
+
+	UniquePtr<ZlibPartCompressor> ZlibPartCompressor::create()
+	{
+#if SEIR_COMPRESSION_ZLIB
+		return createZlibPartCompressor();
+#else
+		return {};
+#endif
+	}
+
+	SharedPtr<CompressionDictionary> CompressionDictionary::create(Compression compression, [[maybe_unused]] const void* data, [[maybe_unused]] size_t size)
+	{
+		switch (compression)
+		{
+		case Compression::None:
+		case Compression::Lz4:
+		case Compression::Zlib:
+			break;
+		case Compression::Zstd:
+#if SEIR_COMPRESSION_ZSTD
+			return createZstdDictionary(data, size);
+#else
+			break;
+#endif
+		}
+		return {};
+	}
+
+	size_t CompressionDictionary::train(Compression compression, [[maybe_unused]] void* dst, [[maybe_unused]] size_t dstCapacity, [[maybe_unused]] const void* samples, [[maybe_unused]] const size_t* sampleSizes, [[maybe_unused]] size_t sampleCount) noexcept
+	{
+		switch (compression)
+		{
+		case Compression::None:
+		case Compression::Lz4:
+		case Compression::Zlib:
+			break;
+		case Compression::Zstd:
+#if SEIR_COMPRESSION_ZSTD
+			return trainZstdDictionary(dst, dstCapacity, samples, sampleSizes, sampleCount);
+#else
+			break;
+#endif
+		}
+		return 0;
+	}
 }
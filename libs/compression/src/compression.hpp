@@ -8,12 +8,33 @@
 
 namespace seir
 {
+	inline void advance(CompressionBuffers& buffers, size_t consumed, size_t produced) noexcept
+	{
+		buffers._src += consumed;
+		buffers._srcSize -= consumed;
+		buffers._dst += produced;
+		buffers._dstSize -= produced;
+	}
+
+#if SEIR_COMPRESSION_LZ4
+	UniquePtr<Compressor> createLz4Compressor();
+	UniquePtr<Decompressor> createLz4Decompressor();
+	UniquePtr<CompressStream> createLz4CompressStream();
+	UniquePtr<DecompressStream> createLz4DecompressStream();
+#endif
 #if SEIR_COMPRESSION_ZLIB
 	UniquePtr<Compressor> createZlibCompressor();
 	UniquePtr<Decompressor> createZlibDecompressor();
+	UniquePtr<CompressStream> createZlibCompressStream();
+	UniquePtr<DecompressStream> createZlibDecompressStream();
+	UniquePtr<ZlibPartCompressor> createZlibPartCompressor();
 #endif
 #if SEIR_COMPRESSION_ZSTD
 	UniquePtr<Compressor> createZstdCompressor();
 	UniquePtr<Decompressor> createZstdDecompressor();
+	UniquePtr<CompressStream> createZstdCompressStream();
+	UniquePtr<DecompressStream> createZstdDecompressStream();
+	SharedPtr<CompressionDictionary> createZstdDictionary(const void* data, size_t size);
+	size_t trainZstdDictionary(void* dst, size_t dstCapacity, const void* samples, const size_t* sampleSizes, size_t sampleCount) noexcept;
 #endif
 }
@@ -0,0 +1,258 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "compression.hpp"
+
+#include <seir_base/buffer.hpp>
+#include <seir_base/pointer.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+#include <lz4frame.h>
+#include <lz4hc.h>
+
+namespace
+{
+	using Lz4CompressionContext = seir::CPtr<::LZ4F_cctx, ::LZ4F_freeCompressionContext>;
+	using Lz4DecompressionContext = seir::CPtr<::LZ4F_dctx, ::LZ4F_freeDecompressionContext>;
+
+	Lz4CompressionContext createLz4CompressionContext() noexcept
+	{
+		Lz4CompressionContext context;
+		if (::LZ4F_isError(::LZ4F_createCompressionContext(context.out(), LZ4F_VERSION)))
+			context.reset();
+		return context;
+	}
+
+	Lz4DecompressionContext createLz4DecompressionContext() noexcept
+	{
+		Lz4DecompressionContext context;
+		if (::LZ4F_isError(::LZ4F_createDecompressionContext(context.out(), LZ4F_VERSION)))
+			context.reset();
+		return context;
+	}
+
+	// Both one-shot and streaming implementations produce LZ4 frames,
+	// so the data compressed by one can be decompressed by the other.
+	LZ4F_preferences_t lz4Preferences(seir::CompressionLevel level, size_t contentSize) noexcept
+	{
+		LZ4F_preferences_t preferences LZ4F_INIT_PREFERENCES;
+		preferences.frameInfo.blockSizeID = LZ4F_max64KB;
+		preferences.frameInfo.contentSize = contentSize;
+		if (level == seir::CompressionLevel::Maximum)
+		{
+			// LZ4 is chosen for decompression speed, so we trade a bit of compression ratio for it.
+			preferences.compressionLevel = LZ4HC_CLEVEL_MAX;
+			preferences.favorDecSpeed = 1;
+		}
+		return preferences;
+	}
+
+	class Lz4Compressor final : public seir::Compressor
+	{
+	public:
+		[[nodiscard]] bool prepare(seir::CompressionLevel level) noexcept override
+		{
+			_level = level;
+			return _context.get() != nullptr;
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			return !dictionary;
+		}
+
+		void setWorkerCount(unsigned) noexcept override {}
+
+		[[nodiscard]] size_t maxCompressedSize(size_t uncompressedSize) const noexcept override
+		{
+			const auto preferences = ::lz4Preferences(_level, uncompressedSize);
+			return ::LZ4F_compressFrameBound(uncompressedSize, &preferences);
+		}
+
+		[[nodiscard]] size_t compress(void* dst, size_t dstCapacity, const void* src, size_t srcSize) noexcept override
+		{
+			const auto preferences = ::lz4Preferences(_level, srcSize);
+			const auto output = static_cast<std::byte*>(dst);
+			const auto headerSize = ::LZ4F_compressBegin(_context, output, dstCapacity, &preferences);
+			if (::LZ4F_isError(headerSize))
+				return 0;
+			const auto dataSize = ::LZ4F_compressUpdate(_context, output + headerSize, dstCapacity - headerSize, src, srcSize, nullptr);
+			if (::LZ4F_isError(dataSize))
+				return 0;
+			const auto footerSize = ::LZ4F_compressEnd(_context, output + headerSize + dataSize, dstCapacity - headerSize - dataSize, nullptr);
+			return ::LZ4F_isError(footerSize) ? 0 : headerSize + dataSize + footerSize;
+		}
+
+	private:
+		Lz4CompressionContext _context = ::createLz4CompressionContext();
+		seir::CompressionLevel _level = seir::CompressionLevel::None;
+	};
+
+	class Lz4Decompressor final : public seir::Decompressor
+	{
+	public:
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			return !dictionary;
+		}
+
+		[[nodiscard]] bool decompress(void* dst, size_t dstCapacity, const void* src, size_t srcSize) noexcept override
+		{
+			if (!_context)
+				return false;
+			::LZ4F_resetDecompressionContext(_context);
+			auto output = static_cast<std::byte*>(dst);
+			auto input = static_cast<const std::byte*>(src);
+			for (;;)
+			{
+				auto outputSize = dstCapacity;
+				auto inputSize = srcSize;
+				const auto result = ::LZ4F_decompress(_context, output, &outputSize, input, &inputSize, nullptr);
+				if (::LZ4F_isError(result))
+					return false;
+				output += outputSize;
+				dstCapacity -= outputSize;
+				input += inputSize;
+				srcSize -= inputSize;
+				if (!result)
+					return !dstCapacity;
+				if (!outputSize && !inputSize)
+					return false;
+			}
+		}
+
+	private:
+		Lz4DecompressionContext _context = ::createLz4DecompressionContext();
+	};
+
+	class Lz4CompressStream final : public seir::CompressStream
+	{
+	public:
+		[[nodiscard]] bool prepare(seir::CompressionLevel level, size_t totalSize) noexcept override
+		{
+			if (!_context)
+				return false;
+			_preferences = ::lz4Preferences(level, totalSize == kUnknownSize ? 0 : totalSize);
+			// LZ4 requires the output buffer to fit the whole compressed block,
+			// so the data is compressed into an internal buffer first.
+			if (!_buffer.tryReserve(::LZ4F_compressBound(kInputBlockSize, &_preferences), 0))
+				return false;
+			const auto headerSize = ::LZ4F_compressBegin(_context, _buffer.data(), _buffer.capacity(), &_preferences);
+			if (::LZ4F_isError(headerSize))
+				return false;
+			_bufferOffset = 0;
+			_bufferSize = headerSize;
+			_ended = false;
+			return true;
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			return !dictionary;
+		}
+
+		void setWorkerCount(unsigned) noexcept override {}
+
+		[[nodiscard]] seir::CompressionStatus compress(seir::CompressionBuffers& buffers, bool last) noexcept override
+		{
+			for (;;)
+			{
+				if (_bufferOffset < _bufferSize)
+				{
+					const auto size = std::min(_bufferSize - _bufferOffset, buffers._dstSize);
+					std::memcpy(buffers._dst, _buffer.data() + _bufferOffset, size);
+					seir::advance(buffers, 0, size);
+					_bufferOffset += size;
+					if (_bufferOffset < _bufferSize)
+						return seir::CompressionStatus::Continue;
+				}
+				if (_ended)
+					return seir::CompressionStatus::End;
+				size_t result = 0;
+				if (buffers._srcSize > 0)
+				{
+					const auto size = std::min(buffers._srcSize, kInputBlockSize);
+					result = ::LZ4F_compressUpdate(_context, _buffer.data(), _buffer.capacity(), buffers._src, size, nullptr);
+					seir::advance(buffers, size, 0);
+				}
+				else if (last)
+				{
+					result = ::LZ4F_compressEnd(_context, _buffer.data(), _buffer.capacity(), nullptr);
+					_ended = true;
+				}
+				else
+					return seir::CompressionStatus::Continue;
+				if (::LZ4F_isError(result))
+					return seir::CompressionStatus::Error;
+				_bufferOffset = 0;
+				_bufferSize = result;
+			}
+		}
+
+	private:
+		static constexpr size_t kInputBlockSize = 64 * 1024;
+		Lz4CompressionContext _context = ::createLz4CompressionContext();
+		LZ4F_preferences_t _preferences LZ4F_INIT_PREFERENCES;
+		seir::Buffer _buffer;
+		size_t _bufferOffset = 0;
+		size_t _bufferSize = 0;
+		bool _ended = false;
+	};
+
+	class Lz4DecompressStream final : public seir::DecompressStream
+	{
+	public:
+		[[nodiscard]] bool prepare() noexcept override
+		{
+			if (!_context)
+				return false;
+			::LZ4F_resetDecompressionContext(_context);
+			return true;
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			return !dictionary;
+		}
+
+		[[nodiscard]] seir::CompressionStatus decompress(seir::CompressionBuffers& buffers) noexcept override
+		{
+			auto outputSize = buffers._dstSize;
+			auto inputSize = buffers._srcSize;
+			const auto result = ::LZ4F_decompress(_context, buffers._dst, &outputSize, buffers._src, &inputSize, nullptr);
+			if (::LZ4F_isError(result))
+				return seir::CompressionStatus::Error;
+			seir::advance(buffers, inputSize, outputSize);
+			return result ? seir::CompressionStatus::Continue : seir::CompressionStatus::End;
+		}
+
+	private:
+		Lz4DecompressionContext _context = ::createLz4DecompressionContext();
+	};
+}
+
+namespace seir
+{
+	UniquePtr<Compressor> createLz4Compressor()
+	{
+		return makeUnique<Compressor, Lz4Compressor>();
+	}
+
+	UniquePtr<Decompressor> createLz4Decompressor()
+	{
+		return makeUnique<Decompressor, Lz4Decompressor>();
+	}
+
+	UniquePtr<CompressStream> createLz4CompressStream()
+	{
+		return makeUnique<CompressStream, Lz4CompressStream>();
+	}
+
+	UniquePtr<DecompressStream> createLz4DecompressStream()
+	{
+		return makeUnique<DecompressStream, Lz4DecompressStream>();
+	}
+}
@@ -4,6 +4,7 @@
 
 #include "compression.hpp"
 
+#include <algorithm>
 #include <cassert>
 #include <limits>
 #include <optional>
@@ -12,6 +13,47 @@
 
 namespace
 {
+	constexpr int zlibLevel(seir::CompressionLevel level) noexcept
+	{
+		switch (level)
+		{
+		case seir::CompressionLevel::None: break;
+		case seir::CompressionLevel::Minimum: return Z_BEST_SPEED;
+		case seir::CompressionLevel::Default: return Z_DEFAULT_COMPRESSION;
+		case seir::CompressionLevel::Maximum: return Z_BEST_COMPRESSION;
+		}
+		return Z_NO_COMPRESSION;
+	}
+
+	constexpr uInt zlibSize(size_t size) noexcept
+	{
+		if constexpr (constexpr auto maxSize = std::numeric_limits<uInt>::max(); maxSize < std::numeric_limits<size_t>::max())
+			if (size > maxSize)
+				return maxSize;
+		return static_cast<uInt>(size);
+	}
+
+	// Initializes the stream on first use, and then only resets it (and updates its parameters if the level changes).
+	template <typename Init>
+	bool prepareDeflate(z_stream& stream, std::optional<seir::CompressionLevel>& currentLevel, seir::CompressionLevel level, Init&& init) noexcept
+	{
+		if (currentLevel)
+		{
+			if (::deflateReset(&stream) != Z_OK)
+				return false;
+			if (currentLevel == level)
+				return true;
+		}
+		const auto levelValue = ::zlibLevel(level);
+		if (currentLevel
+				? ::deflateParams(&stream, levelValue, Z_DEFAULT_STRATEGY) != Z_OK
+					|| ::deflateReset(&stream) != Z_OK
+				: init(stream, levelValue) != Z_OK)
+			return false;
+		currentLevel = level;
+		return true;
+	}
+
 	class ZlibCompressor final : public seir::Compressor
 	{
 	public:
@@ -22,30 +64,16 @@ namespace
 
 		[[nodiscard]] bool prepare(seir::CompressionLevel level) noexcept override
 		{
-			if (_level)
-			{
-				if (::deflateReset(&_stream) != Z_OK)
-					return false;
-				if (_level == level)
-					return true;
-			}
-			int levelValue = Z_NO_COMPRESSION;
-			switch (level)
-			{
-			case seir::CompressionLevel::None: break;
-			case seir::CompressionLevel::Minimum: levelValue = Z_BEST_SPEED; break;
-			case seir::CompressionLevel::Default: levelValue = Z_DEFAULT_COMPRESSION; break;
-			case seir::CompressionLevel::Maximum: levelValue = Z_BEST_COMPRESSION; break;
-			}
-			if (_level
-					? ::deflateParams(&_stream, levelValue, Z_DEFAULT_STRATEGY) != Z_OK
-						|| ::deflateReset(&_stream) != Z_OK
-					: deflateInit(&_stream, levelValue) != Z_OK)
-				return false;
-			_level = level;
-			return true;
+			return ::prepareDeflate(_stream, _level, level, [](z_stream& stream, int levelValue) { return deflateInit(&stream, levelValue); });
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			return !dictionary;
 		}
 
+		void setWorkerCount(unsigned) noexcept override {}
+
 		[[nodiscard]] size_t maxCompressedSize(size_t uncompressedSize) const noexcept override
 		{
 			// deflateBound DOES return some valid (but suboptimal) bound
@@ -83,6 +111,11 @@ namespace
 			::inflateEnd(&_stream);
 		}
 
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			return !dictionary;
+		}
+
 		[[nodiscard]] bool decompress(void* dst, size_t dstCapacity, const void* src, size_t srcSize) noexcept override
 		{
 			if constexpr (constexpr auto maxSize = std::numeric_limits<uInt>::max(); maxSize < std::numeric_limits<size_t>::max())
@@ -111,6 +144,162 @@ namespace
 		z_stream _stream{};
 		bool _initialized = false;
 	};
+
+	class ZlibCompressStream final : public seir::CompressStream
+	{
+	public:
+		~ZlibCompressStream() noexcept override
+		{
+			::deflateEnd(&_stream);
+		}
+
+		[[nodiscard]] bool prepare(seir::CompressionLevel level, size_t) noexcept override
+		{
+			return ::prepareDeflate(_stream, _level, level, [](z_stream& stream, int levelValue) { return deflateInit(&stream, levelValue); });
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			return !dictionary;
+		}
+
+		void setWorkerCount(unsigned) noexcept override {}
+
+		[[nodiscard]] seir::CompressionStatus compress(seir::CompressionBuffers& buffers, bool last) noexcept override
+		{
+			assert(_level);
+			const auto srcSize = ::zlibSize(buffers._srcSize);
+			const auto dstSize = ::zlibSize(buffers._dstSize);
+			_stream.next_in = reinterpret_cast<const Bytef*>(buffers._src);
+			_stream.avail_in = srcSize;
+			_stream.next_out = reinterpret_cast<Bytef*>(buffers._dst);
+			_stream.avail_out = dstSize;
+			const auto status = ::deflate(&_stream, last && srcSize == buffers._srcSize ? Z_FINISH : Z_NO_FLUSH);
+			seir::advance(buffers, srcSize - _stream.avail_in, dstSize - _stream.avail_out);
+			switch (status)
+			{
+			case Z_OK:
+			case Z_BUF_ERROR: // No progress was possible, which is not an error for streaming.
+				return seir::CompressionStatus::Continue;
+			case Z_STREAM_END:
+				return seir::CompressionStatus::End;
+			default:
+				return seir::CompressionStatus::Error;
+			}
+		}
+
+	private:
+		z_stream _stream{};
+		std::optional<seir::CompressionLevel> _level;
+	};
+
+	class ZlibDecompressStream final : public seir::DecompressStream
+	{
+	public:
+		~ZlibDecompressStream() noexcept override
+		{
+			::inflateEnd(&_stream);
+		}
+
+		[[nodiscard]] bool prepare() noexcept override
+		{
+			if (_initialized)
+				return ::inflateReset(&_stream) == Z_OK;
+			if (inflateInit(&_stream) != Z_OK)
+				return false;
+			_initialized = true;
+			return true;
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			return !dictionary;
+		}
+
+		[[nodiscard]] seir::CompressionStatus decompress(seir::CompressionBuffers& buffers) noexcept override
+		{
+			assert(_initialized);
+			const auto srcSize = ::zlibSize(buffers._srcSize);
+			const auto dstSize = ::zlibSize(buffers._dstSize);
+			_stream.next_in = reinterpret_cast<const Bytef*>(buffers._src);
+			_stream.avail_in = srcSize;
+			_stream.next_out = reinterpret_cast<Bytef*>(buffers._dst);
+			_stream.avail_out = dstSize;
+			const auto status = ::inflate(&_stream, Z_NO_FLUSH);
+			seir::advance(buffers, srcSize - _stream.avail_in, dstSize - _stream.avail_out);
+			switch (status)
+			{
+			case Z_OK:
+			case Z_BUF_ERROR: // No progress was possible, which is not an error for streaming.
+				return seir::CompressionStatus::Continue;
+			case Z_STREAM_END:
+				return seir::CompressionStatus::End;
+			default:
+				return seir::CompressionStatus::Error;
+			}
+		}
+
+	private:
+		z_stream _stream{};
+		bool _initialized = false;
+	};
+
+	class ZlibPartCompressorImpl final : public seir::ZlibPartCompressor
+	{
+	public:
+		~ZlibPartCompressorImpl() noexcept override
+		{
+			::deflateEnd(&_stream);
+		}
+
+		[[nodiscard]] bool prepare(seir::CompressionLevel level) noexcept override
+		{
+			return ::prepareDeflate(_stream, _level, level, [](z_stream& stream, int levelValue) {
+				return deflateInit2(&stream, levelValue, Z_DEFLATED, -kWindowBits, 8, Z_DEFAULT_STRATEGY); // Negative window bits mean raw deflate.
+			});
+		}
+
+		[[nodiscard]] size_t maxCompressedSize(size_t uncompressedSize) const noexcept override
+		{
+			assert(_stream.state);
+			return ::deflateBound(const_cast<z_stream*>(&_stream), static_cast<uLong>(uncompressedSize)) + kSyncFlushSize;
+		}
+
+		[[nodiscard]] size_t compress(void* dst, size_t dstCapacity, const void* src, size_t srcSize, const void* preceding, size_t precedingSize, bool last) noexcept override
+		{
+			assert(_level);
+			if constexpr (constexpr auto maxSize = std::numeric_limits<uInt>::max(); maxSize < std::numeric_limits<size_t>::max())
+			{
+				if (srcSize > maxSize)
+					return 0;
+				if (dstCapacity > maxSize)
+					dstCapacity = maxSize;
+			}
+			if (precedingSize > 0)
+			{
+				constexpr size_t kMaxDictionarySize = size_t{ 1 } << kWindowBits;
+				const auto dictionarySize = std::min(precedingSize, kMaxDictionarySize);
+				if (::deflateSetDictionary(&_stream, static_cast<const Bytef*>(preceding) + (precedingSize - dictionarySize), static_cast<uInt>(dictionarySize)) != Z_OK)
+					return 0;
+			}
+			_stream.next_in = static_cast<const Bytef*>(src);
+			_stream.avail_in = static_cast<uInt>(srcSize);
+			_stream.next_out = static_cast<Bytef*>(dst);
+			_stream.avail_out = static_cast<uInt>(dstCapacity);
+			if (last)
+				return ::deflate(&_stream, Z_FINISH) == Z_STREAM_END ? dstCapacity - _stream.avail_out : 0;
+			// Sync flush ends the part with an empty stored block which aligns the output to a byte boundary.
+			// If the output buffer is full afterwards, the flush may be incomplete.
+			return ::deflate(&_stream, Z_SYNC_FLUSH) == Z_OK && !_stream.avail_in && _stream.avail_out > 0 ? dstCapacity - _stream.avail_out : 0;
+		}
+
+	private:
+		static constexpr int kWindowBits = 15;
+		static constexpr size_t kSyncFlushSize = 5; // Empty stored block header and length fields.
+
+		z_stream _stream{};
+		std::optional<seir::CompressionLevel> _level;
+	};
 }
 
 namespace seir
@@ -124,4 +313,19 @@ namespace seir
 	{
 		return makeUnique<Decompressor, ZlibDecompressor>();
 	}
+
+	UniquePtr<CompressStream> createZlibCompressStream()
+	{
+		return makeUnique<CompressStream, ZlibCompressStream>();
+	}
+
+	UniquePtr<DecompressStream> createZlibDecompressStream()
+	{
+		return makeUnique<DecompressStream, ZlibDecompressStream>();
+	}
+
+	UniquePtr<ZlibPartCompressor> createZlibPartCompressor()
+	{
+		return makeUnique<ZlibPartCompressor, ZlibPartCompressorImpl>();
+	}
 }
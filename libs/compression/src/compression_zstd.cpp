@@ -4,36 +4,121 @@
 
 #include "compression.hpp"
 
+#include <seir_base/buffer.hpp>
 #include <seir_base/pointer.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring>
+#include <limits>
 
+#include <zdict.h>
 #include <zstd.h>
 
 namespace
 {
-	class ZstdCompressor final : public seir::Compressor
+	class ZstdDictionary final : public seir::CompressionDictionary
 	{
 	public:
-		[[nodiscard]] bool prepare(seir::CompressionLevel level) noexcept override
+		const seir::Buffer _data;
+		const size_t _size;
+		const seir::CPtr<::ZSTD_DDict, ::ZSTD_freeDDict> _ddict;
+
+		ZstdDictionary(seir::Buffer&& data, size_t size) noexcept
+			: _data{ std::move(data) }, _size{ size }, _ddict{ ::ZSTD_createDDict(_data.data(), _size) } {}
+	};
+
+	int zstdLevel(seir::CompressionLevel level) noexcept
+	{
+		switch (level)
 		{
-			switch (level)
+		case seir::CompressionLevel::None:
+			[[fallthrough]]; // There is no zero compression level in zstd.
+		case seir::CompressionLevel::Minimum:
+			break;
+		case seir::CompressionLevel::Default:
+			return ::ZSTD_defaultCLevel();
+		case seir::CompressionLevel::Maximum:
+			return ::ZSTD_maxCLevel();
+		}
+		return 1; // Negative levels (ZSTD_minCLevel() to -1) ara faster but have impractical compression ratios.
+	}
+
+	// Digested dictionaries are level-specific, so we keep the last one
+	// to avoid redigesting the dictionary for every compressed block.
+	class ZstdCompressionDictionary
+	{
+	public:
+		[[nodiscard]] constexpr ::ZSTD_CDict* get() const noexcept { return _cdict; }
+
+		[[nodiscard]] bool prepare(int level) noexcept
+		{
+			if (_dictionary && (!_cdict || _level != level))
 			{
-			case seir::CompressionLevel::None:
-				[[fallthrough]]; // There is no zero compression level in zstd.
-			case seir::CompressionLevel::Minimum:
-				_level = 1; // Negative levels (ZSTD_minCLevel() to -1) ara faster but have impractical compression ratios.
-				break;
-			case seir::CompressionLevel::Default:
-				_level = ::ZSTD_defaultCLevel();
-				break;
-			case seir::CompressionLevel::Maximum:
-				_level = ::ZSTD_maxCLevel();
-				break;
+				_cdict.reset(::ZSTD_createCDict(_dictionary->_data.data(), _dictionary->_size, level));
+				if (!_cdict)
+					return false;
+				_level = level;
 			}
 			return true;
 		}
 
+		void reset(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept
+		{
+			_dictionary = seir::staticCast<ZstdDictionary>(dictionary);
+			_cdict.reset();
+		}
+
+	private:
+		seir::SharedPtr<ZstdDictionary> _dictionary;
+		seir::CPtr<::ZSTD_CDict, ::ZSTD_freeCDict> _cdict;
+		int _level = 0;
+	};
+
+	// Long-distance matching finds repetitions far beyond the regular window,
+	// which is worth its memory and speed costs only for large inputs.
+	constexpr size_t kZstdLongDistanceMatchingThreshold = 16 * 1024 * 1024;
+
+	// Starts a new frame, configuring the context for the specified input size.
+	bool resetZstdContext(::ZSTD_CCtx* context, int level, ::ZSTD_CDict* cdict, unsigned workerCount, size_t size) noexcept
+	{
+		if (::ZSTD_isError(::ZSTD_CCtx_reset(context, ZSTD_reset_session_only))
+			|| ::ZSTD_isError(::ZSTD_CCtx_refCDict(context, cdict))
+			|| ::ZSTD_isError(::ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, level))
+			|| ::ZSTD_isError(::ZSTD_CCtx_setPledgedSrcSize(context, size == seir::CompressStream::kUnknownSize ? ZSTD_CONTENTSIZE_UNKNOWN : size)))
+			return false;
+		const auto workers = static_cast<int>(std::min<unsigned>(workerCount, static_cast<unsigned>(std::numeric_limits<int>::max())));
+		// The library may have been built without multithreading support, in which case
+		// the data is compressed in the calling thread (but still with long-distance matching).
+		if (::ZSTD_isError(::ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, workers))
+			&& ::ZSTD_isError(::ZSTD_CCtx_setParameter(context, ZSTD_c_nbWorkers, 0)))
+			return false;
+		// Unknown size may turn out to be anything, and enabling long-distance matching
+		// for it would require the decompressor to allocate a huge window buffer.
+		const auto longDistanceMatching = size != seir::CompressStream::kUnknownSize && size >= kZstdLongDistanceMatchingThreshold;
+		return !::ZSTD_isError(::ZSTD_CCtx_setParameter(context, ZSTD_c_enableLongDistanceMatching, longDistanceMatching));
+	}
+
+	class ZstdCompressor final : public seir::Compressor
+	{
+	public:
+		[[nodiscard]] bool prepare(seir::CompressionLevel level) noexcept override
+		{
+			_level = ::zstdLevel(level);
+			return _dictionary.prepare(_level);
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			_dictionary.reset(dictionary);
+			return true;
+		}
+
+		void setWorkerCount(unsigned workerCount) noexcept override
+		{
+			_workerCount = workerCount;
+		}
+
 		[[nodiscard]] size_t maxCompressedSize(size_t uncompressedSize) const noexcept override
 		{
 			return ::ZSTD_compressBound(uncompressedSize);
@@ -41,26 +126,108 @@ namespace
 
 		[[nodiscard]] size_t compress(void* dst, size_t dstCapacity, const void* src, size_t srcSize) noexcept override
 		{
-			const auto result = ::ZSTD_compressCCtx(_context, dst, dstCapacity, src, srcSize, _level);
+			if (!::resetZstdContext(_context, _level, _dictionary.get(), _workerCount, srcSize))
+				return 0;
+			const auto result = ::ZSTD_compress2(_context, dst, dstCapacity, src, srcSize);
 			return ::ZSTD_isError(result) ? 0 : result;
 		}
 
 	private:
 		seir::CPtr<::ZSTD_CCtx, ::ZSTD_freeCCtx> _context{ ::ZSTD_createCCtx() };
 		int _level = 0;
+		unsigned _workerCount = 0;
+		ZstdCompressionDictionary _dictionary;
 	};
 
 	class ZstdDecompressor final : public seir::Decompressor
 	{
 	public:
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			_dictionary = seir::staticCast<ZstdDictionary>(dictionary);
+			return true;
+		}
+
 		[[nodiscard]] bool decompress(void* dst, size_t dstCapacity, const void* src, size_t srcSize) noexcept override
 		{
-			const auto result = ::ZSTD_decompressDCtx(_context, dst, dstCapacity, src, srcSize);
+			const auto result = _dictionary
+				? ::ZSTD_decompress_usingDDict(_context, dst, dstCapacity, src, srcSize, _dictionary->_ddict)
+				: ::ZSTD_decompressDCtx(_context, dst, dstCapacity, src, srcSize);
 			return !::ZSTD_isError(result) && result == dstCapacity;
 		}
 
 	private:
 		seir::CPtr<::ZSTD_DCtx, ::ZSTD_freeDCtx> _context{ ::ZSTD_createDCtx() };
+		seir::SharedPtr<ZstdDictionary> _dictionary;
+	};
+
+	class ZstdCompressStream final : public seir::CompressStream
+	{
+	public:
+		[[nodiscard]] bool prepare(seir::CompressionLevel level, size_t totalSize) noexcept override
+		{
+			const auto levelValue = ::zstdLevel(level);
+			return _dictionary.prepare(levelValue)
+				&& ::resetZstdContext(_context, levelValue, _dictionary.get(), _workerCount, totalSize);
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			_dictionary.reset(dictionary);
+			return true;
+		}
+
+		void setWorkerCount(unsigned workerCount) noexcept override
+		{
+			_workerCount = workerCount;
+		}
+
+		[[nodiscard]] seir::CompressionStatus compress(seir::CompressionBuffers& buffers, bool last) noexcept override
+		{
+			::ZSTD_inBuffer input{ buffers._src, buffers._srcSize, 0 };
+			::ZSTD_outBuffer output{ buffers._dst, buffers._dstSize, 0 };
+			const auto result = ::ZSTD_compressStream2(_context, &output, &input, last ? ZSTD_e_end : ZSTD_e_continue);
+			seir::advance(buffers, input.pos, output.pos);
+			if (::ZSTD_isError(result))
+				return seir::CompressionStatus::Error;
+			return last && !result ? seir::CompressionStatus::End : seir::CompressionStatus::Continue;
+		}
+
+	private:
+		seir::CPtr<::ZSTD_CCtx, ::ZSTD_freeCCtx> _context{ ::ZSTD_createCCtx() };
+		unsigned _workerCount = 0;
+		ZstdCompressionDictionary _dictionary;
+	};
+
+	class ZstdDecompressStream final : public seir::DecompressStream
+	{
+	public:
+		[[nodiscard]] bool prepare() noexcept override
+		{
+			return !::ZSTD_isError(::ZSTD_DCtx_reset(_context, ZSTD_reset_session_only))
+				&& !::ZSTD_isError(::ZSTD_DCtx_refDDict(_context, _dictionary ? _dictionary->_ddict.get() : nullptr));
+		}
+
+		[[nodiscard]] bool setDictionary(const seir::SharedPtr<seir::CompressionDictionary>& dictionary) noexcept override
+		{
+			_dictionary = seir::staticCast<ZstdDictionary>(dictionary);
+			return true;
+		}
+
+		[[nodiscard]] seir::CompressionStatus decompress(seir::CompressionBuffers& buffers) noexcept override
+		{
+			::ZSTD_inBuffer input{ buffers._src, buffers._srcSize, 0 };
+			::ZSTD_outBuffer output{ buffers._dst, buffers._dstSize, 0 };
+			const auto result = ::ZSTD_decompressStream(_context, &output, &input);
+			seir::advance(buffers, input.pos, output.pos);
+			if (::ZSTD_isError(result))
+				return seir::CompressionStatus::Error;
+			return result ? seir::CompressionStatus::Continue : seir::CompressionStatus::End;
+		}
+
+	private:
+		seir::CPtr<::ZSTD_DCtx, ::ZSTD_freeDCtx> _context{ ::ZSTD_createDCtx() };
+		seir::SharedPtr<ZstdDictionary> _dictionary;
 	};
 }
 
@@ -75,4 +242,32 @@ namespace seir
 	{
 		return makeUnique<Decompressor, ZstdDecompressor>();
 	}
+
+	UniquePtr<CompressStream> createZstdCompressStream()
+	{
+		return makeUnique<CompressStream, ZstdCompressStream>();
+	}
+
+	UniquePtr<DecompressStream> createZstdDecompressStream()
+	{
+		return makeUnique<DecompressStream, ZstdDecompressStream>();
+	}
+
+	SharedPtr<CompressionDictionary> createZstdDictionary(const void* data, size_t size)
+	{
+		Buffer buffer;
+		if (!buffer.tryReserve(size, 0))
+			return {};
+		std::memcpy(buffer.data(), data, size);
+		auto dictionary = makeShared<ZstdDictionary>(std::move(buffer), size);
+		if (!dictionary->_ddict)
+			return {};
+		return SharedPtr<CompressionDictionary>{ std::move(dictionary) };
+	}
+
+	size_t trainZstdDictionary(void* dst, size_t dstCapacity, const void* samples, const size_t* sampleSizes, size_t sampleCount) noexcept
+	{
+		const auto result = ::ZDICT_trainFromBuffer(dst, dstCapacity, samples, sampleSizes, static_cast<unsigned>(std::min<size_t>(sampleCount, std::numeric_limits<unsigned>::max())));
+		return ::ZDICT_isError(result) ? 0 : result;
+	}
 }
@@ -8,11 +8,12 @@
 #include <cstdint>
 #include <iterator>
 #include <limits>
+#include <string>
 #include <vector>
 
 #include <doctest/doctest.h>
 
-#if SEIR_COMPRESSION_ZLIB || SEIR_COMPRESSION_ZSTD
+#if SEIR_COMPRESSION_LZ4 || SEIR_COMPRESSION_ZLIB || SEIR_COMPRESSION_ZSTD
 TEST_CASE("Compression")
 {
 	// The generated byte sequence is [00 00 00 00 01 01 01 01 ... ff ff ff ff 00 00 00 00 ... ff ff ff ff].
@@ -34,9 +35,9 @@ TEST_CASE("Compression")
 						CHECK(compressor->compress(result.data(), dstCapacity, original.data(), size_t{ std::numeric_limits<uint32_t>::max() } + 1) == 0);
 				if (useMaxCapacity)
 				{
-					// Zstd does something weird if requested to compress into a buffer of SIZE_MAX bytes,
-					// but since its API exposes size_t, this is not our problem.
-					if (compression != seir::Compression::Zstd)
+					// LZ4 and Zstd do something weird if requested to compress into a buffer of SIZE_MAX bytes,
+					// but since their APIs expose size_t, this is not our problem.
+					if (compression == seir::Compression::Zlib)
 						dstCapacity = std::numeric_limits<size_t>::max();
 				}
 				const auto size = compressor->compress(result.data(), dstCapacity, original.data(), original.size());
@@ -81,10 +82,10 @@ TEST_CASE("Compression")
 			CHECK_FALSE(decompressor->decompress(decompressed.data(), decompressed.size(), compressed[i].data(), compressed[i].size() / 2));
 			CHECK(decompressor->decompress(decompressed.data(), decompressed.size(), compressed[i].data(), compressed[i].size()));
 			CHECK(decompressed == original);
-			if (compression != seir::Compression::Zstd)
+			if (compression == seir::Compression::Zlib)
 			{
-				// Zstd does something weird if requested to decompress into a buffer of SIZE_MAX bytes,
-				// but since its API exposes size_t, this is not our problem.
+				// LZ4 and Zstd do something weird if requested to decompress into a buffer of SIZE_MAX bytes,
+				// but since their APIs expose size_t, this is not our problem.
 				std::fill(decompressed.begin(), decompressed.end(), std::byte{});
 				CHECK(decompressor->decompress(decompressed.data(), std::numeric_limits<size_t>::max(), compressed[i].data(), compressed[i].size()));
 			}
@@ -93,6 +94,12 @@ TEST_CASE("Compression")
 					CHECK_FALSE(decompressor->decompress(decompressed.data(), decompressed.size(), compressed[i].data(), size_t{ std::numeric_limits<uint32_t>::max() } + 1));
 		}
 	};
+#	if SEIR_COMPRESSION_LZ4
+	SUBCASE("Compression::Lz4")
+	{
+		checkCompression(seir::Compression::Lz4);
+	}
+#	endif
 #	if SEIR_COMPRESSION_ZLIB
 	SUBCASE("Compression::Zlib")
 	{
@@ -108,8 +115,242 @@ TEST_CASE("Compression")
 }
 #endif
 
+#if SEIR_COMPRESSION_LZ4 || SEIR_COMPRESSION_ZLIB || SEIR_COMPRESSION_ZSTD
+TEST_CASE("CompressStream")
+{
+	std::vector<std::byte> original;
+	std::generate_n(std::back_inserter(original), 64 * 1024, [i = 0u]() mutable { return static_cast<std::byte>((i++ * 2654435761u) >> 28); });
+	const auto checkStreaming = [&original](seir::Compression compression) {
+		// Small and mutually prime window sizes to exercise all buffer boundary cases.
+		constexpr size_t srcWindow = 1009;
+		constexpr size_t dstWindow = 97;
+		std::vector<std::byte> compressed;
+		{
+			const auto stream = seir::CompressStream::create(compression);
+			REQUIRE(stream);
+			REQUIRE(stream->prepare(seir::CompressionLevel::Default, original.size()));
+			std::byte window[dstWindow];
+			seir::CompressionBuffers buffers{ original.data(), 0, nullptr, 0 };
+			for (auto remaining = original.size();;)
+			{
+				if (!buffers._srcSize)
+				{
+					buffers._srcSize = std::min(remaining, srcWindow);
+					remaining -= buffers._srcSize;
+				}
+				buffers._dst = window;
+				buffers._dstSize = dstWindow;
+				const auto status = stream->compress(buffers, !remaining);
+				REQUIRE(status != seir::CompressionStatus::Error);
+				compressed.insert(compressed.end(), window, buffers._dst);
+				if (status == seir::CompressionStatus::End)
+					break;
+			}
+			CHECK(buffers._src == original.data() + original.size());
+			CHECK(compressed.size() < original.size());
+		}
+		{
+			const auto decompressor = seir::Decompressor::create(compression);
+			REQUIRE(decompressor);
+			std::vector<std::byte> decompressed(original.size());
+			CHECK(decompressor->decompress(decompressed.data(), decompressed.size(), compressed.data(), compressed.size()));
+			CHECK(decompressed == original);
+		}
+		{
+			const auto stream = seir::DecompressStream::create(compression);
+			REQUIRE(stream);
+			std::vector<std::byte> decompressed;
+			for (int pass = 0; pass < 2; ++pass) // The stream must be reusable.
+			{
+				decompressed.clear();
+				REQUIRE(stream->prepare());
+				std::byte window[srcWindow];
+				seir::CompressionBuffers buffers{ compressed.data(), 0, nullptr, 0 };
+				for (auto remaining = compressed.size();;)
+				{
+					if (!buffers._srcSize)
+					{
+						buffers._srcSize = std::min(remaining, dstWindow);
+						remaining -= buffers._srcSize;
+					}
+					buffers._dst = window;
+					buffers._dstSize = srcWindow;
+					const auto status = stream->decompress(buffers);
+					REQUIRE(status != seir::CompressionStatus::Error);
+					decompressed.insert(decompressed.end(), window, buffers._dst);
+					if (status == seir::CompressionStatus::End)
+						break;
+					REQUIRE((remaining > 0 || buffers._srcSize > 0 || !buffers._dstSize));
+				}
+				CHECK(decompressed == original);
+			}
+			REQUIRE(stream->prepare());
+			seir::CompressionBuffers buffers{ compressed.data(), compressed.size() / 2, decompressed.data(), decompressed.size() };
+			CHECK(stream->decompress(buffers) == seir::CompressionStatus::Continue);
+		}
+	};
+#	if SEIR_COMPRESSION_LZ4
+	SUBCASE("Compression::Lz4")
+	{
+		checkStreaming(seir::Compression::Lz4);
+	}
+#	endif
+#	if SEIR_COMPRESSION_ZLIB
+	SUBCASE("Compression::Zlib")
+	{
+		checkStreaming(seir::Compression::Zlib);
+	}
+#	endif
+#	if SEIR_COMPRESSION_ZSTD
+	SUBCASE("Compression::Zstd")
+	{
+		checkStreaming(seir::Compression::Zstd);
+	}
+#	endif
+}
+#endif
+
 TEST_CASE("Compression::None")
 {
 	CHECK_FALSE(static_cast<bool>(seir::Compressor::create(seir::Compression::None)));
 	CHECK_FALSE(static_cast<bool>(seir::Decompressor::create(seir::Compression::None)));
+	CHECK_FALSE(static_cast<bool>(seir::CompressStream::create(seir::Compression::None)));
+	CHECK_FALSE(static_cast<bool>(seir::DecompressStream::create(seir::Compression::None)));
+	CHECK_FALSE(static_cast<bool>(seir::CompressionDictionary::create(seir::Compression::None, "", 0)));
+}
+
+#if SEIR_COMPRESSION_ZSTD
+TEST_CASE("CompressionDictionary")
+{
+	// Lots of small similar samples is the primary use case for dictionaries.
+	std::string samples;
+	std::vector<size_t> sampleSizes;
+	for (int i = 0; i < 1000; ++i)
+	{
+		const auto sample = "name \"sample" + std::to_string(i) + "\"\nsize " + std::to_string(i * 7 % 100) + "\ncolor " + std::to_string(i * 13 % 256) + "\n";
+		samples += sample;
+		sampleSizes.emplace_back(sample.size());
+	}
+	std::vector<std::byte> dictionaryData(4096);
+	const auto dictionarySize = seir::CompressionDictionary::train(seir::Compression::Zstd, dictionaryData.data(), dictionaryData.size(), samples.data(), sampleSizes.data(), sampleSizes.size());
+	REQUIRE(dictionarySize > 0);
+	REQUIRE(dictionarySize <= dictionaryData.size());
+	const auto dictionary = seir::CompressionDictionary::create(seir::Compression::Zstd, dictionaryData.data(), dictionarySize);
+	REQUIRE(dictionary);
+	const auto compressor = seir::Compressor::create(seir::Compression::Zstd);
+	REQUIRE(compressor);
+	const std::string_view original{ samples.data(), sampleSizes[0] };
+	const auto compress = [&compressor, original](seir::CompressionLevel level) {
+		REQUIRE(compressor->prepare(level));
+		std::vector<std::byte> result(compressor->maxCompressedSize(original.size()));
+		const auto size = compressor->compress(result.data(), result.size(), original.data(), original.size());
+		REQUIRE(size > 0);
+		result.resize(size);
+		return result;
+	};
+	const auto withoutDictionary = compress(seir::CompressionLevel::Maximum);
+	REQUIRE(compressor->setDictionary(dictionary));
+	const auto withDictionary = compress(seir::CompressionLevel::Maximum);
+	CHECK(withDictionary.size() < withoutDictionary.size());
+	CHECK(compress(seir::CompressionLevel::Minimum).size() < withoutDictionary.size());
+	const auto decompressor = seir::Decompressor::create(seir::Compression::Zstd);
+	REQUIRE(decompressor);
+	std::string decompressed(original.size(), '\0');
+	CHECK_FALSE(decompressor->decompress(decompressed.data(), decompressed.size(), withDictionary.data(), withDictionary.size()));
+	REQUIRE(decompressor->setDictionary(dictionary));
+	CHECK(decompressor->decompress(decompressed.data(), decompressed.size(), withDictionary.data(), withDictionary.size()));
+	CHECK(decompressed == original);
+	CHECK(decompressor->decompress(decompressed.data(), decompressed.size(), withoutDictionary.data(), withoutDictionary.size()));
+	CHECK(decompressed == original);
+}
+
+TEST_CASE("Compressor (workers)")
+{
+	// Random data repeated at a distance far beyond the regular zstd window
+	// is compressible only with long-distance matching.
+	std::vector<std::byte> original;
+	std::generate_n(std::back_inserter(original), 10 * 1024 * 1024, [state = uint32_t{ 1 }]() mutable {
+		state = state * 1664525u + 1013904223u;
+		return static_cast<std::byte>(state >> 24);
+	});
+	original.resize(original.size() * 2);
+	std::copy_n(original.begin(), original.size() / 2, original.begin() + static_cast<std::ptrdiff_t>(original.size() / 2));
+	const auto compressor = seir::Compressor::create(seir::Compression::Zstd);
+	REQUIRE(compressor);
+	const auto compress = [&compressor, &original](unsigned workerCount) {
+		compressor->setWorkerCount(workerCount);
+		REQUIRE(compressor->prepare(seir::CompressionLevel::Minimum));
+		std::vector<std::byte> result(compressor->maxCompressedSize(original.size()));
+		const auto size = compressor->compress(result.data(), result.size(), original.data(), original.size());
+		REQUIRE(size > 0);
+		result.resize(size);
+		return result;
+	};
+	const auto singleThreaded = compress(0);
+	const auto multithreaded = compress(4);
+	CHECK(singleThreaded.size() < original.size() * 3 / 4);
+	CHECK(multithreaded.size() < original.size() * 3 / 4);
+	const auto decompressor = seir::Decompressor::create(seir::Compression::Zstd);
+	REQUIRE(decompressor);
+	std::vector<std::byte> decompressed(original.size());
+	CHECK(decompressor->decompress(decompressed.data(), decompressed.size(), singleThreaded.data(), singleThreaded.size()));
+	CHECK(decompressed == original);
+	std::fill(decompressed.begin(), decompressed.end(), std::byte{});
+	CHECK(decompressor->decompress(decompressed.data(), decompressed.size(), multithreaded.data(), multithreaded.size()));
+	CHECK(decompressed == original);
+	const auto stream = seir::CompressStream::create(seir::Compression::Zstd);
+	REQUIRE(stream);
+	stream->setWorkerCount(4);
+	REQUIRE(stream->prepare(seir::CompressionLevel::Minimum, original.size()));
+	std::vector<std::byte> streamed(multithreaded.size() * 2);
+	seir::CompressionBuffers buffers{ original.data(), original.size(), streamed.data(), streamed.size() };
+	for (auto status = seir::CompressionStatus::Continue; status != seir::CompressionStatus::End;)
+	{
+		status = stream->compress(buffers, true);
+		REQUIRE(status != seir::CompressionStatus::Error);
+		REQUIRE(buffers._dstSize > 0);
+	}
+	streamed.resize(streamed.size() - buffers._dstSize);
+	std::fill(decompressed.begin(), decompressed.end(), std::byte{});
+	CHECK(decompressor->decompress(decompressed.data(), decompressed.size(), streamed.data(), streamed.size()));
+	CHECK(decompressed == original);
+}
+#endif
+
+#if SEIR_COMPRESSION_ZLIB
+TEST_CASE("ZlibPartCompressor")
+{
+	std::vector<std::byte> original;
+	std::generate_n(std::back_inserter(original), 256 * 1024, [i = 0u]() mutable { return static_cast<std::byte>((i++ * 2654435761u) >> 28); });
+	const auto compressor = seir::ZlibPartCompressor::create();
+	REQUIRE(compressor);
+	for (const size_t partSize : { 1000u, 40'000u, 100'000u })
+	{
+		CAPTURE(partSize);
+		std::vector<std::byte> compressed{ std::byte{ 0x78 }, std::byte{ 0x9c } };
+		for (size_t offset = 0; offset < original.size(); offset += partSize)
+		{
+			const auto size = std::min(partSize, original.size() - offset);
+			REQUIRE(compressor->prepare(seir::CompressionLevel::Default));
+			std::vector<std::byte> part(compressor->maxCompressedSize(size));
+			const auto compressedSize = compressor->compress(part.data(), part.size(), original.data() + offset, size, original.data(), offset, offset + size == original.size());
+			REQUIRE(compressedSize > 0);
+			compressed.insert(compressed.end(), part.begin(), part.begin() + static_cast<std::ptrdiff_t>(compressedSize));
+		}
+		uint32_t a = 1;
+		uint32_t b = 0;
+		for (const auto byte : original)
+		{
+			a = (a + static_cast<uint8_t>(byte)) % 65521;
+			b = (b + a) % 65521;
+		}
+		for (const auto shift : { 24, 16, 8, 0 })
+			compressed.emplace_back(static_cast<std::byte>(((b << 16 | a) >> shift) & 0xff));
+		const auto decompressor = seir::Decompressor::create(seir::Compression::Zlib);
+		REQUIRE(decompressor);
+		std::vector<std::byte> decompressed(original.size());
+		CHECK(decompressor->decompress(decompressed.data(), decompressed.size(), compressed.data(), compressed.size()));
+		CHECK(decompressed == original);
+	}
 }
+#endif
@@ -4,6 +4,7 @@
 
 #include <seir_gui/font.hpp>
 
+#include <seir_base/profiler.hpp>
 #include <seir_base/utf8.hpp>
 #include <seir_graphics/rectf.hpp>
 #include <seir_image/image.hpp>
@@ -12,6 +13,7 @@
 #include <seir_renderer/2d.hpp>
 #include <seir_renderer/renderer.hpp>
 
+#include <array>
 #include <cassert>
 #include <cstring>
 #include <limits>
@@ -66,43 +68,49 @@ namespace
 
 		void renderLine(seir::Renderer2D& renderer, const seir::RectF& rect, std::string_view text) const override
 		{
+			SEIR_PROFILE_ZONE("TextRendering");
 			const auto scale = rect.height() / static_cast<float>(_size);
 			int x = 0;
 			auto previous = _bitmapGlyphs.end();
 			renderer.setTexture(_bitmapTexture);
+			std::array<char32_t, 64> codepoints;
 			for (size_t i = 0; i < text.size();)
 			{
-				const auto current = _bitmapGlyphs.find(seir::readUtf8(text, i));
-				if (current == _bitmapGlyphs.end())
-					continue;
-				if (_hasKerning && previous != _bitmapGlyphs.end())
-				{
-					FT_Vector kerning;
-					if (!::FT_Get_Kerning(_face, previous->second._id, current->second._id, FT_KERNING_DEFAULT, &kerning))
-						x += static_cast<int>(kerning.x >> 6);
-				}
-				const auto left = rect.left() + static_cast<float>(x + current->second._offset._x) * scale;
-				if (left >= rect.right())
-					break;
-				seir::RectF positionRect{
-					{ left, rect.top() + static_cast<float>(current->second._offset._y) * scale },
-					seir::SizeF{ current->second._rect.size() } * scale,
-				};
-				seir::RectF glyphRect{ current->second._rect };
-				bool clipped = false;
-				if (positionRect.right() > rect.right())
+				const auto count = seir::decodeUtf8(codepoints, text, i);
+				for (size_t j = 0; j < count; ++j)
 				{
-					const auto originalWidth = positionRect.width();
-					positionRect._right = rect._right;
-					glyphRect.setWidth(glyphRect.width() * positionRect.width() / originalWidth);
-					clipped = true;
+					const auto current = _bitmapGlyphs.find(codepoints[j]);
+					if (current == _bitmapGlyphs.end())
+						continue;
+					if (_hasKerning && previous != _bitmapGlyphs.end())
+					{
+						FT_Vector kerning;
+						if (!::FT_Get_Kerning(_face, previous->second._id, current->second._id, FT_KERNING_DEFAULT, &kerning))
+							x += static_cast<int>(kerning.x >> 6);
+					}
+					const auto left = rect.left() + static_cast<float>(x + current->second._offset._x) * scale;
+					if (left >= rect.right())
+						return;
+					seir::RectF positionRect{
+						{ left, rect.top() + static_cast<float>(current->second._offset._y) * scale },
+						seir::SizeF{ current->second._rect.size() } * scale,
+					};
+					seir::RectF glyphRect{ current->second._rect };
+					bool clipped = false;
+					if (positionRect.right() > rect.right())
+					{
+						const auto originalWidth = positionRect.width();
+						positionRect._right = rect._right;
+						glyphRect.setWidth(glyphRect.width() * positionRect.width() / originalWidth);
+						clipped = true;
+					}
+					renderer.setTextureRect(glyphRect);
+					renderer.addRect(positionRect);
+					if (clipped)
+						return;
+					x += current->second._advance;
+					previous = current;
 				}
-				renderer.setTextureRect(glyphRect);
-				renderer.addRect(positionRect);
-				if (clipped)
-					break;
-				x += current->second._advance;
-				previous = current;
 			}
 		}
 
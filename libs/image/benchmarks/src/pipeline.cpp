@@ -0,0 +1,68 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/buffer.hpp>
+#include <seir_base/task_scheduler.hpp>
+#include <seir_image/image.hpp>
+#include <seir_image/pipeline.hpp>
+
+#include <random>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	constexpr uint32_t kImageSize = 2048;
+
+	void run(benchmark::State& state, const seir::ImagePipeline& pipeline, uint32_t dstSize, seir::TaskScheduler* scheduler)
+	{
+		const seir::ImageInfo srcInfo{ kImageSize, kImageSize, seir::PixelFormat::Rgba32 };
+		seir::Buffer src{ srcInfo.frameSize() };
+		std::minstd_rand random{ 1 };
+		for (auto data = reinterpret_cast<uint8_t*>(src.data()), end = data + srcInfo.frameSize(); data != end; ++data)
+			*data = static_cast<uint8_t>(random());
+		const seir::ImageInfo dstInfo{ dstSize, dstSize, seir::PixelFormat::Bgra32, seir::ImageAxes::XRightYUp };
+		seir::Buffer dst{ pipeline.outputSize(dstInfo) };
+		for (auto _ : state)
+		{
+			if (!pipeline.run(srcInfo, src.data(), dstInfo, dst.data(), scheduler))
+				return state.SkipWithError("Pipeline error");
+			benchmark::DoNotOptimize(dst.data());
+		}
+		state.SetBytesProcessed(state.iterations() * srcInfo.frameSize());
+	}
+
+	void ImagePipeline_MipChain(benchmark::State& state)
+	{
+		run(state, seir::ImagePipeline{}.setMipChain(true).setPremultipliedAlpha(true), kImageSize, nullptr);
+	}
+
+	void ImagePipeline_MipChain_Parallel(benchmark::State& state)
+	{
+		seir::TaskScheduler scheduler;
+		run(state, seir::ImagePipeline{}.setMipChain(true).setPremultipliedAlpha(true), kImageSize, &scheduler);
+	}
+
+	void ImagePipeline_Box(benchmark::State& state)
+	{
+		run(state, seir::ImagePipeline{}.setFilter(seir::ImageFilter::Box), kImageSize * 3 / 4, nullptr);
+	}
+
+	void ImagePipeline_Lanczos3(benchmark::State& state)
+	{
+		run(state, seir::ImagePipeline{}.setFilter(seir::ImageFilter::Lanczos3), kImageSize * 3 / 4, nullptr);
+	}
+
+	void ImagePipeline_Lanczos3_Parallel(benchmark::State& state)
+	{
+		seir::TaskScheduler scheduler;
+		run(state, seir::ImagePipeline{}.setFilter(seir::ImageFilter::Lanczos3), kImageSize * 3 / 4, &scheduler);
+	}
+}
+
+BENCHMARK(ImagePipeline_MipChain)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImagePipeline_MipChain_Parallel)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImagePipeline_Box)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImagePipeline_Lanczos3)->Unit(benchmark::kMillisecond);
+BENCHMARK(ImagePipeline_Lanczos3_Parallel)->Unit(benchmark::kMillisecond);
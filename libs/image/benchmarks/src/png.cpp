@@ -0,0 +1,124 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/task_scheduler.hpp>
+#include <seir_image/image.hpp>
+#include <seir_io/blob.hpp>
+#include <seir_io/buffer_blob.hpp>
+#include <seir_io/buffer_writer.hpp>
+#include "../../src/png_filters.hpp"
+
+#include <array>
+#include <random>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	constexpr uint32_t kTextureSize = 1024;
+
+	// A texture with smooth gradients and some noise, which is typical for game art.
+	seir::Image makeTexture(seir::PixelFormat pixelFormat)
+	{
+		const seir::ImageInfo info{ kTextureSize, kTextureSize, pixelFormat };
+		seir::Buffer buffer{ info.frameSize() };
+		std::minstd_rand random{ 1 };
+		auto data = reinterpret_cast<uint8_t*>(buffer.data());
+		for (uint32_t y = 0; y < kTextureSize; ++y)
+			for (uint32_t x = 0; x < kTextureSize; ++x)
+			{
+				const auto noise = static_cast<uint32_t>(random() % 8);
+				*data++ = static_cast<uint8_t>(x / 4 + noise);
+				*data++ = static_cast<uint8_t>(y / 4 + noise);
+				*data++ = static_cast<uint8_t>((x + y) / 8 + noise);
+				if (pixelFormat == seir::PixelFormat::Rgba32)
+					*data++ = static_cast<uint8_t>(x ^ y);
+			}
+		return { info, std::move(buffer) };
+	}
+
+	void PngLoad(benchmark::State& state)
+	{
+		constexpr std::array kPixelFormats{ seir::PixelFormat::Rgb24, seir::PixelFormat::Rgba32 };
+		const auto texture = makeTexture(kPixelFormats[static_cast<size_t>(state.range(0))]);
+		seir::Buffer buffer;
+		uint64_t size = 0;
+		seir::BufferWriter writer{ buffer, &size };
+		if (!texture.save(seir::ImageFormat::Png, writer, 50))
+			return state.SkipWithError("Encoding error");
+		const auto blob = seir::makeShared<seir::Blob, seir::BufferBlob>(std::move(buffer), static_cast<size_t>(size));
+		for (auto _ : state)
+			if (const auto image = seir::Image::load(blob); !image)
+				return state.SkipWithError("Decoding error");
+		state.SetBytesProcessed(state.iterations() * texture.info().frameSize());
+		state.SetLabel(state.range(0) ? "Rgba32" : "Rgb24");
+	}
+
+	void save(benchmark::State& state, seir::TaskScheduler* scheduler)
+	{
+		constexpr std::array kPixelFormats{ seir::PixelFormat::Rgb24, seir::PixelFormat::Rgba32 };
+		const auto texture = makeTexture(kPixelFormats[static_cast<size_t>(state.range(0))]);
+		seir::Buffer buffer;
+		uint64_t size = 0;
+		for (auto _ : state)
+		{
+			seir::BufferWriter writer{ buffer, &size };
+			if (!texture.save(seir::ImageFormat::Png, writer, static_cast<int>(state.range(1)), scheduler))
+				return state.SkipWithError("Encoding error");
+		}
+		state.SetBytesProcessed(state.iterations() * texture.info().frameSize());
+		state.SetLabel(state.range(0) ? "Rgba32" : "Rgb24");
+		state.counters["Ratio"] = static_cast<double>(size) / texture.info().frameSize();
+	}
+
+	void PngSave(benchmark::State& state)
+	{
+		save(state, nullptr);
+	}
+
+	void PngSave_Parallel(benchmark::State& state)
+	{
+		seir::TaskScheduler scheduler;
+		save(state, &scheduler);
+	}
+
+	template <bool kVectorized>
+	void unfilter(benchmark::State& state)
+	{
+		constexpr std::array<const char*, 5> kLabels{ "None", "Sub", "Up", "Average", "Paeth" };
+		const auto filter = static_cast<uint8_t>(state.range(0));
+		const auto pixelSize = static_cast<size_t>(state.range(1));
+		const auto rowSize = kTextureSize * pixelSize;
+		std::vector<uint8_t> data(rowSize * 2);
+		std::minstd_rand random{ 1 };
+		for (auto& byte : data)
+			byte = static_cast<uint8_t>(random());
+		const seir::PngUnfilter<kVectorized> unfilterRow{ pixelSize };
+		for (auto _ : state)
+		{
+			if (!unfilterRow(filter, data.data() + rowSize, data.data() + rowSize, data.data(), rowSize))
+				return state.SkipWithError("Bad filter");
+			benchmark::ClobberMemory();
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(rowSize));
+		state.SetLabel(kLabels[filter]);
+	}
+
+	void PngUnfilter_Opt(benchmark::State& state)
+	{
+		unfilter<true>(state);
+	}
+
+	void PngUnfilter_Ref(benchmark::State& state)
+	{
+		unfilter<false>(state);
+	}
+}
+
+BENCHMARK(PngLoad)->DenseRange(0, 1)->Unit(benchmark::kMillisecond);
+BENCHMARK(PngSave)->ArgsProduct({ { 0, 1 }, { 0, 10, 50 } })->Unit(benchmark::kMillisecond);
+BENCHMARK(PngSave_Parallel)->ArgsProduct({ { 0, 1 }, { 0, 10, 50 } })->Unit(benchmark::kMillisecond)->UseRealTime();
+BENCHMARK(PngUnfilter_Opt)->ArgsProduct({ { 1, 2, 3, 4 }, { 3, 4 } });
+BENCHMARK(PngUnfilter_Ref)->ArgsProduct({ { 1, 2, 3, 4 }, { 3, 4 } });
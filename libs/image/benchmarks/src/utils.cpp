@@ -0,0 +1,96 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/buffer.hpp>
+#include <seir_base/task_scheduler.hpp>
+#include <seir_image/image.hpp>
+#include <seir_image/utils.hpp>
+
+#include <array>
+#include <random>
+#include <string>
+#include <utility>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	constexpr uint32_t kImageSize = 1024;
+
+	constexpr std::array<std::pair<seir::PixelFormat, seir::PixelFormat>, 17> kConversions{ {
+		{ seir::PixelFormat::Gray8, seir::PixelFormat::Bgra32 },
+		{ seir::PixelFormat::Gray8, seir::PixelFormat::Rgba32 },
+		{ seir::PixelFormat::Intensity8, seir::PixelFormat::Bgra32 },
+		{ seir::PixelFormat::Intensity8, seir::PixelFormat::Rgba32 },
+		{ seir::PixelFormat::GrayAlpha16, seir::PixelFormat::Bgra32 },
+		{ seir::PixelFormat::GrayAlpha16, seir::PixelFormat::Rgba32 },
+		{ seir::PixelFormat::Rgb24, seir::PixelFormat::Bgr24 },
+		{ seir::PixelFormat::Rgb24, seir::PixelFormat::Rgba32 },
+		{ seir::PixelFormat::Rgb24, seir::PixelFormat::Bgra32 },
+		{ seir::PixelFormat::Bgr24, seir::PixelFormat::Rgb24 },
+		{ seir::PixelFormat::Bgr24, seir::PixelFormat::Rgba32 },
+		{ seir::PixelFormat::Bgr24, seir::PixelFormat::Bgra32 },
+		{ seir::PixelFormat::Rgba32, seir::PixelFormat::Bgra32 },
+		{ seir::PixelFormat::Bgra32, seir::PixelFormat::Rgba32 },
+		{ seir::PixelFormat::Bgra32, seir::PixelFormat::Bgra32 }, // Plain copy.
+		{ seir::PixelFormat::Bc1, seir::PixelFormat::Bgra32 },
+		{ seir::PixelFormat::Bc3, seir::PixelFormat::Bgra32 },
+	} };
+
+	const char* pixelFormatName(seir::PixelFormat pixelFormat) noexcept
+	{
+		switch (pixelFormat)
+		{
+		case seir::PixelFormat::Gray8: return "Gray8";
+		case seir::PixelFormat::Intensity8: return "Intensity8";
+		case seir::PixelFormat::GrayAlpha16: return "GrayAlpha16";
+		case seir::PixelFormat::Rgb24: return "Rgb24";
+		case seir::PixelFormat::Bgr24: return "Bgr24";
+		case seir::PixelFormat::Rgba32: return "Rgba32";
+		case seir::PixelFormat::Bgra32: return "Bgra32";
+		case seir::PixelFormat::Bc1: return "Bc1";
+		case seir::PixelFormat::Bc2: return "Bc2";
+		case seir::PixelFormat::Bc3: return "Bc3";
+		case seir::PixelFormat::Bc4: return "Bc4";
+		case seir::PixelFormat::Bc5: return "Bc5";
+		case seir::PixelFormat::Bc6h: return "Bc6h";
+		case seir::PixelFormat::Bc7: return "Bc7";
+		}
+		return "";
+	}
+
+	void copy(benchmark::State& state, seir::TaskScheduler* scheduler)
+	{
+		const auto [srcFormat, dstFormat] = kConversions[static_cast<size_t>(state.range(0))];
+		const seir::ImageInfo srcInfo{ kImageSize, kImageSize, srcFormat };
+		seir::Buffer src{ srcInfo.frameSize() };
+		std::minstd_rand random{ 1 };
+		for (auto data = reinterpret_cast<uint8_t*>(src.data()), end = data + srcInfo.frameSize(); data != end; ++data)
+			*data = static_cast<uint8_t>(random());
+		const seir::ImageInfo dstInfo{ kImageSize, kImageSize, dstFormat };
+		seir::Buffer dst{ dstInfo.frameSize() };
+		for (auto _ : state)
+		{
+			if (!seir::copyImage(srcInfo, src.data(), dstInfo, dst.data(), scheduler))
+				return state.SkipWithError("Conversion error");
+			benchmark::DoNotOptimize(dst.data());
+		}
+		state.SetBytesProcessed(state.iterations() * dstInfo.frameSize());
+		state.SetLabel(std::string{ pixelFormatName(srcFormat) } + " -> " + pixelFormatName(dstFormat));
+	}
+
+	void CopyImage(benchmark::State& state)
+	{
+		copy(state, nullptr);
+	}
+
+	void CopyImage_Parallel(benchmark::State& state)
+	{
+		seir::TaskScheduler scheduler;
+		copy(state, &scheduler);
+	}
+}
+
+BENCHMARK(CopyImage)->DenseRange(0, static_cast<int64_t>(kConversions.size()) - 1);
+BENCHMARK(CopyImage_Parallel)->DenseRange(0, static_cast<int64_t>(kConversions.size()) - 1);
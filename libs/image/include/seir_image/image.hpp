@@ -13,6 +13,7 @@
 namespace seir
 {
 	class Blob;
+	class TaskScheduler;
 	class Writer;
 
 	// Pixel format.
@@ -25,10 +26,34 @@ namespace seir
 		Bgr24 = 0b11'1,       // Blue-green-red (reverse).
 		Rgba32 = 0b100'0,     // Red-green-blue-alpha.
 		Bgra32 = 0b100'1,     // Blue-green-red-alpha (reverse RGB).
+		Bc1 = 0b1'0000'0000,  // BC1 (DXT1) blocks: RGB with optional 1-bit alpha.
+		Bc2,                  // BC2 (DXT3) blocks: RGB with explicit 4-bit alpha.
+		Bc3,                  // BC3 (DXT5) blocks: RGB with interpolated alpha.
+		Bc4,                  // BC4 blocks: single channel.
+		Bc5,                  // BC5 blocks: two channels.
+		Bc6h,                 // BC6H blocks: unsigned half-precision floating-point RGB.
+		Bc7,                  // BC7 blocks: high quality RGB with optional alpha.
 	};
 
-	//
-	[[nodiscard]] constexpr uint32_t pixelSize(PixelFormat format) noexcept { return static_cast<uint32_t>(format) >> 1; }
+	// Block-compressed formats store 4x4 pixel blocks instead of individual pixels.
+	[[nodiscard]] constexpr bool isBlockCompressed(PixelFormat format) noexcept { return static_cast<uint32_t>(format) >= static_cast<uint32_t>(PixelFormat::Bc1); }
+
+	// Returns zero for block-compressed formats.
+	[[nodiscard]] constexpr uint32_t pixelSize(PixelFormat format) noexcept { return isBlockCompressed(format) ? 0 : static_cast<uint32_t>(format) >> 1; }
+
+	// Returns zero for formats which aren't block-compressed.
+	[[nodiscard]] constexpr uint32_t blockSize(PixelFormat format) noexcept
+	{
+		if (!isBlockCompressed(format))
+			return 0;
+		return format == PixelFormat::Bc1 || format == PixelFormat::Bc4 ? 8 : 16;
+	}
+
+	// Returns the size of a row of pixels, or of a row of blocks for block-compressed formats.
+	[[nodiscard]] constexpr uint32_t rowSize(PixelFormat format, uint32_t width) noexcept
+	{
+		return isBlockCompressed(format) ? (width + 3) / 4 * blockSize(format) : width * pixelSize(format);
+	}
 
 	// Image axes orientation.
 	enum class ImageAxes
@@ -45,10 +70,10 @@ namespace seir
 		constexpr ImageInfo(uint32_t width, uint32_t height, uint32_t stride, PixelFormat pixelFormat, ImageAxes axes = ImageAxes::XRightYDown) noexcept
 			: _width{ width }, _height{ height }, _stride{ stride }, _pixelFormat{ pixelFormat }, _axes{ axes } {}
 		constexpr ImageInfo(uint32_t width, uint32_t height, PixelFormat pixelFormat, ImageAxes axes = ImageAxes::XRightYDown) noexcept
-			: ImageInfo{ width, height, width * seir::pixelSize(pixelFormat), pixelFormat, axes } {}
+			: ImageInfo{ width, height, seir::rowSize(pixelFormat, width), pixelFormat, axes } {}
 
 		[[nodiscard]] constexpr ImageAxes axes() const noexcept { return _axes; }
-		[[nodiscard]] constexpr uint32_t frameSize() const noexcept { return _stride * _height; }
+		[[nodiscard]] constexpr uint32_t frameSize() const noexcept { return _stride * (isBlockCompressed(_pixelFormat) ? (_height + 3) / 4 : _height); }
 		[[nodiscard]] constexpr uint32_t height() const noexcept { return _height; }
 		[[nodiscard]] constexpr PixelFormat pixelFormat() const noexcept { return _pixelFormat; }
 		[[nodiscard]] constexpr uint32_t pixelSize() const noexcept { return seir::pixelSize(_pixelFormat); }
@@ -94,15 +119,20 @@ namespace seir
 		//
 		[[nodiscard]] const ImageInfo& info() const noexcept { return _info; }
 
-		//
-		bool save(ImageFormat, Writer&, int compressionLevel) const noexcept;
+		// Returns the number of mip levels including the image itself.
+		// Levels are stored after the image in the same layout as produced by ImagePipeline.
+		[[nodiscard]] uint32_t mipLevelCount() const noexcept { return _mipLevelCount; }
+
+		// Formats which support parallel encoding (currently PNG) use the task scheduler if it is specified.
+		bool save(ImageFormat, Writer&, int compressionLevel, TaskScheduler* = nullptr) const noexcept;
 
 		//
-		bool saveAsScreenshot(ImageFormat, int compressionLevel) const; // NOLINT(modernize-use-nodiscard)
+		bool saveAsScreenshot(ImageFormat, int compressionLevel, TaskScheduler* = nullptr) const; // NOLINT(modernize-use-nodiscard)
 
 	private:
 		ImageInfo _info;
 		const void* _data = nullptr;
+		uint32_t _mipLevelCount = 1;
 		SharedPtr<Blob> _blob; // If we managed to memory-map image contents...
 		Buffer _buffer;        // ...and if we didn't.
 	};
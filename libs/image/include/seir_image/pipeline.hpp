@@ -0,0 +1,71 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace seir
+{
+	class ImageInfo;
+	class TaskScheduler;
+
+	// Image resampling filter.
+	enum class ImageFilter
+	{
+		Box,      // Averages the source pixels covered by the destination pixel (nearest pixel when upscaling).
+		Lanczos3, // Windowed sinc with three lobes, which is sharper but may produce ringing near edges.
+	};
+
+	// Image processing steps which are performed together in a single pass over the source image.
+	// The destination image is produced in cache-sized strips of rows which are processed
+	// in parallel if a task scheduler is specified.
+	class ImagePipeline
+	{
+	public:
+		// Sets the filter used if the destination size differs from the source size.
+		constexpr ImagePipeline& setFilter(ImageFilter filter) noexcept
+		{
+			_filter = filter;
+			return *this;
+		}
+
+		// Makes the pipeline generate the full mip chain for the destination image.
+		// Each mip level is the previous level with 2x2 pixel blocks averaged (trailing odd rows and columns are dropped),
+		// and the levels are tightly packed one after another right after the destination image.
+		constexpr ImagePipeline& setMipChain(bool enabled) noexcept
+		{
+			_mipChain = enabled;
+			return *this;
+		}
+
+		// Makes the pipeline multiply color channels by alpha before resampling.
+		constexpr ImagePipeline& setPremultipliedAlpha(bool enabled) noexcept
+		{
+			_premultipliedAlpha = enabled;
+			return *this;
+		}
+
+		// Returns the number of mip levels for the specified image size, including the image itself.
+		[[nodiscard]] static uint32_t mipLevelCount(uint32_t width, uint32_t height) noexcept;
+
+		// Returns the layout of the specified mip level of the pipeline output.
+		[[nodiscard]] static ImageInfo mipLevelInfo(const ImageInfo& dstInfo, uint32_t level) noexcept;
+		[[nodiscard]] static size_t mipLevelOffset(const ImageInfo& dstInfo, uint32_t level) noexcept;
+
+		// Returns the size of the buffer required for the pipeline output.
+		[[nodiscard]] size_t outputSize(const ImageInfo& dstInfo) const noexcept;
+
+		// Processes the source image into the destination buffer, which must be at least outputSize() bytes long.
+		// Pixel format conversions and axes orientation changes are supported to the same extent as by copyImage,
+		// except that block-compressed formats aren't supported.
+		bool run(const ImageInfo& srcInfo, const void* srcData, const ImageInfo& dstInfo, void* dstData, TaskScheduler* = nullptr) const noexcept;
+
+	private:
+		ImageFilter _filter = ImageFilter::Box;
+		bool _mipChain = false;
+		bool _premultipliedAlpha = false;
+	};
+}
@@ -8,8 +8,12 @@ namespace seir
 {
 	class Image;
 	class ImageInfo;
+	class TaskScheduler;
 
-	//
-	bool copyImage(const ImageInfo& srcInfo, const void* srcData, const ImageInfo& dstInfo, void* dstData) noexcept;
-	bool copyImage(const Image& src, const ImageInfo& dstInfo, void* dstData) noexcept;
+	// Copies image data converting it to the destination pixel format and axes orientation.
+	// Large images are converted in parallel if a task scheduler is specified.
+	// BC1, BC2 and BC3 blocks can be decoded into Rgba32 or Bgra32 pixels (e.g. for renderers without BCn support),
+	// while other block-compressed images can only be copied without changing their axes orientation.
+	bool copyImage(const ImageInfo& srcInfo, const void* srcData, const ImageInfo& dstInfo, void* dstData, TaskScheduler* = nullptr) noexcept;
+	bool copyImage(const Image& src, const ImageInfo& dstInfo, void* dstData, TaskScheduler* = nullptr) noexcept;
 }
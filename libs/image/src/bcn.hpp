@@ -0,0 +1,112 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_image/image.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace seir
+{
+	// RGBA pixels of a 4x4 block, row by row.
+	using BcPixels = std::array<std::array<uint8_t, 4>, 16>;
+
+	constexpr std::array<uint8_t, 4> bcExpandColor(uint32_t color) noexcept
+	{
+		const auto r = color >> 11;
+		const auto g = (color >> 5) & 0x3f;
+		const auto b = color & 0x1f;
+		return { static_cast<uint8_t>(r << 3 | r >> 2), static_cast<uint8_t>(g << 2 | g >> 4), static_cast<uint8_t>(b << 3 | b >> 2), 255 };
+	}
+
+	constexpr std::array<uint8_t, 4> bcMixColors(const std::array<uint8_t, 4>& first, unsigned firstWeight, const std::array<uint8_t, 4>& second, unsigned secondWeight) noexcept
+	{
+		const auto sum = firstWeight + secondWeight;
+		const auto mix = [&](size_t i) { return static_cast<uint8_t>((first[i] * firstWeight + second[i] * secondWeight + sum / 2) / sum); };
+		return { mix(0), mix(1), mix(2), 255 };
+	}
+
+	// Decodes the color part of BC1, BC2 and BC3 blocks. BC1 blocks with the first color
+	// not greater than the second one have a three color palette with transparent black.
+	constexpr void bcDecodeColors(BcPixels& pixels, const uint8_t* block, bool bc1) noexcept
+	{
+		const auto color0 = static_cast<uint32_t>(block[0] | block[1] << 8);
+		const auto color1 = static_cast<uint32_t>(block[2] | block[3] << 8);
+		std::array<std::array<uint8_t, 4>, 4> palette{ bcExpandColor(color0), bcExpandColor(color1) };
+		if (color0 > color1 || !bc1)
+		{
+			palette[2] = bcMixColors(palette[0], 2, palette[1], 1);
+			palette[3] = bcMixColors(palette[0], 1, palette[1], 2);
+		}
+		else
+		{
+			palette[2] = bcMixColors(palette[0], 1, palette[1], 1);
+			palette[3] = { 0, 0, 0, 0 };
+		}
+		auto indices = block[4] | block[5] << 8 | block[6] << 16 | static_cast<uint32_t>(block[7]) << 24;
+		for (auto& pixel : pixels)
+		{
+			const auto& color = palette[indices & 3];
+			pixel = { color[0], color[1], color[2], bc1 ? color[3] : pixel[3] };
+			indices >>= 2;
+		}
+	}
+
+	// BC2 stores explicit 4-bit alpha values.
+	constexpr void bcDecodeExplicitAlpha(BcPixels& pixels, const uint8_t* block) noexcept
+	{
+		for (size_t i = 0; i < pixels.size(); ++i)
+			pixels[i][3] = static_cast<uint8_t>(((block[i / 2] >> (i % 2 * 4)) & 0xf) * 17);
+	}
+
+	// BC3 stores alpha as two endpoints and 3-bit indices of values interpolated between them.
+	constexpr void bcDecodeInterpolatedAlpha(BcPixels& pixels, const uint8_t* block) noexcept
+	{
+		const unsigned alpha0 = block[0];
+		const unsigned alpha1 = block[1];
+		std::array<uint8_t, 8> palette{ block[0], block[1] };
+		if (alpha0 > alpha1)
+		{
+			for (unsigned i = 1; i < 7; ++i)
+				palette[i + 1] = static_cast<uint8_t>(((7 - i) * alpha0 + i * alpha1 + 3) / 7);
+		}
+		else
+		{
+			for (unsigned i = 1; i < 5; ++i)
+				palette[i + 1] = static_cast<uint8_t>(((5 - i) * alpha0 + i * alpha1 + 2) / 5);
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+		uint64_t indices = 0;
+		for (size_t i = 0; i < 6; ++i)
+			indices |= uint64_t{ block[2 + i] } << (8 * i);
+		for (auto& pixel : pixels)
+		{
+			pixel[3] = palette[indices & 7];
+			indices >>= 3;
+		}
+	}
+
+	// Only BC1-BC3 blocks can be decoded.
+	constexpr bool bcCanDecode(PixelFormat format) noexcept
+	{
+		return format == PixelFormat::Bc1 || format == PixelFormat::Bc2 || format == PixelFormat::Bc3;
+	}
+
+	constexpr void bcDecodeBlock(BcPixels& pixels, PixelFormat format, const uint8_t* block) noexcept
+	{
+		if (format == PixelFormat::Bc1)
+			bcDecodeColors(pixels, block, true);
+		else
+		{
+			if (format == PixelFormat::Bc2)
+				bcDecodeExplicitAlpha(pixels, block);
+			else
+				bcDecodeInterpolatedAlpha(pixels, block);
+			bcDecodeColors(pixels, block + 8, false);
+		}
+	}
+}
@@ -17,7 +17,7 @@ namespace seir
 
 	constexpr auto kDdsFileID = makeCC('D', 'D', 'S', ' ');
 #if SEIR_IMAGE_DDS
-	const void* loadDdsImage(Reader&, ImageInfo&) noexcept;
+	const void* loadDdsImage(Reader&, ImageInfo&, uint32_t& mipLevelCount) noexcept;
 #endif
 
 #if SEIR_IMAGE_ICO
@@ -31,7 +31,8 @@ namespace seir
 
 	constexpr auto kPngFileID = makeCC('\x89', 'P', 'N', 'G', '\r', '\n', '\x1a', '\n');
 #if SEIR_IMAGE_PNG
-	bool savePngImage(Writer&, const ImageInfo&, const void* data, int compressionLevel) noexcept;
+	const void* loadPngImage(Reader&, ImageInfo&, Buffer&) noexcept;
+	bool savePngImage(Writer&, const ImageInfo&, const void* data, int compressionLevel, TaskScheduler*) noexcept;
 #endif
 
 #if SEIR_IMAGE_TGA
@@ -4,7 +4,10 @@
 
 #include "format.hpp"
 
+#include <seir_image/pipeline.hpp>
+
 #include <limits>
+#include <optional>
 
 namespace
 {
@@ -22,7 +25,7 @@ namespace
 
 	// DDS documentation advises not to check DDSD_CAPS and DDSD_PIXELFORMAT being set.
 	constexpr auto kDdsRequiredFlags = DDSD_HEIGHT | DDSD_WIDTH;
-	constexpr auto kDdsUnsupportedFlags = ~(kDdsRequiredFlags | DDSD_CAPS | DDSD_PITCH | DDSD_PIXELFORMAT);
+	constexpr auto kDdsUnsupportedFlags = ~(kDdsRequiredFlags | DDSD_CAPS | DDSD_PITCH | DDSD_PIXELFORMAT | DDSD_MIPMAPCOUNT | DDSD_LINEARSIZE);
 
 	enum : uint32_t
 	{
@@ -32,7 +35,7 @@ namespace
 	};
 
 	// DDS documentation advises not to check DDSCAPS_TEXTURE being set.
-	constexpr auto kDdsUnsupportedCaps = ~DDSCAPS_TEXTURE;
+	constexpr auto kDdsUnsupportedCaps = ~(DDSCAPS_COMPLEX | DDSCAPS_TEXTURE | DDSCAPS_MIPMAP);
 
 	enum : uint32_t
 	{
@@ -44,6 +47,31 @@ namespace
 		DDPF_LUMINANCE = 0x20000,
 	};
 
+	enum : uint32_t
+	{
+		DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+		DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+		DXGI_FORMAT_R8_UNORM = 61,
+		DXGI_FORMAT_BC1_UNORM = 71,
+		DXGI_FORMAT_BC1_UNORM_SRGB = 72,
+		DXGI_FORMAT_BC2_UNORM = 74,
+		DXGI_FORMAT_BC2_UNORM_SRGB = 75,
+		DXGI_FORMAT_BC3_UNORM = 77,
+		DXGI_FORMAT_BC3_UNORM_SRGB = 78,
+		DXGI_FORMAT_BC4_UNORM = 80,
+		DXGI_FORMAT_BC5_UNORM = 83,
+		DXGI_FORMAT_B8G8R8A8_UNORM = 87,
+		DXGI_FORMAT_B8G8R8A8_UNORM_SRGB = 91,
+		DXGI_FORMAT_BC6H_UF16 = 95,
+		DXGI_FORMAT_BC7_UNORM = 98,
+		DXGI_FORMAT_BC7_UNORM_SRGB = 99,
+	};
+
+	enum : uint32_t
+	{
+		D3D10_RESOURCE_DIMENSION_TEXTURE2D = 3,
+	};
+
 #pragma pack(push, 1)
 
 	struct DdsPixelFormat
@@ -77,6 +105,15 @@ namespace
 		uint32_t reserved2;
 	};
 
+	struct DdsHeaderDx10
+	{
+		uint32_t dxgiFormat;
+		uint32_t resourceDimension;
+		uint32_t miscFlag;
+		uint32_t arraySize;
+		uint32_t miscFlags2;
+	};
+
 #pragma pack(pop)
 
 	constexpr uint32_t kDdsPixelFormatSize = 32;
@@ -84,11 +121,36 @@ namespace
 
 	constexpr uint32_t kDdsHeaderSize = 124;
 	static_assert(sizeof(DdsHeader) == sizeof seir::kDdsFileID + kDdsHeaderSize);
+
+	// sRGB and linear variants are loaded as the same pixel format.
+	std::optional<seir::PixelFormat> dxgiPixelFormat(uint32_t dxgiFormat) noexcept
+	{
+		switch (dxgiFormat)
+		{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB: return seir::PixelFormat::Rgba32;
+		case DXGI_FORMAT_R8_UNORM: return seir::PixelFormat::Gray8;
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB: return seir::PixelFormat::Bc1;
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB: return seir::PixelFormat::Bc2;
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB: return seir::PixelFormat::Bc3;
+		case DXGI_FORMAT_BC4_UNORM: return seir::PixelFormat::Bc4;
+		case DXGI_FORMAT_BC5_UNORM: return seir::PixelFormat::Bc5;
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB: return seir::PixelFormat::Bgra32;
+		case DXGI_FORMAT_BC6H_UF16: return seir::PixelFormat::Bc6h;
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB: return seir::PixelFormat::Bc7;
+		default: return {};
+		}
+	}
 }
 
 namespace seir
 {
-	const void* loadDdsImage(Reader& reader, ImageInfo& info) noexcept
+	const void* loadDdsImage(Reader& reader, ImageInfo& info, uint32_t& mipLevelCount) noexcept
 	{
 		const auto header = reader.read<DdsHeader>();
 		if (!header
@@ -99,7 +161,6 @@ namespace seir
 			|| !header->height
 			|| !header->width
 			|| header->depth
-			|| header->mipmapCount
 			|| header->reserved1[0]
 			|| header->reserved1[1]
 			|| header->reserved1[2]
@@ -112,7 +173,7 @@ namespace seir
 			|| header->reserved1[9]
 			|| header->reserved1[10]
 			|| header->format.size != kDdsPixelFormatSize
-			|| header->format.fourcc
+			|| (header->format.fourcc && header->format.flags != DDPF_FOURCC)
 			|| (header->caps & kDdsUnsupportedCaps)
 			|| header->caps2
 			|| header->caps3
@@ -163,30 +224,80 @@ namespace seir
 				return nullptr;
 			break;
 
+		case DDPF_FOURCC:
+			switch (header->format.fourcc)
+			{
+			case makeCC('D', 'X', 'T', '1'): pixelFormat = PixelFormat::Bc1; break;
+			case makeCC('D', 'X', 'T', '2'): // Premultiplied alpha.
+			case makeCC('D', 'X', 'T', '3'): pixelFormat = PixelFormat::Bc2; break;
+			case makeCC('D', 'X', 'T', '4'): // Premultiplied alpha.
+			case makeCC('D', 'X', 'T', '5'): pixelFormat = PixelFormat::Bc3; break;
+			case makeCC('A', 'T', 'I', '1'):
+			case makeCC('B', 'C', '4', 'U'): pixelFormat = PixelFormat::Bc4; break;
+			case makeCC('A', 'T', 'I', '2'):
+			case makeCC('B', 'C', '5', 'U'): pixelFormat = PixelFormat::Bc5; break;
+			case makeCC('D', 'X', '1', '0'):
+				if (const auto dx10 = reader.read<DdsHeaderDx10>(); dx10
+					&& dx10->resourceDimension == D3D10_RESOURCE_DIMENSION_TEXTURE2D
+					&& !dx10->miscFlag
+					&& dx10->arraySize == 1)
+				{
+					if (const auto dxgiFormat = ::dxgiPixelFormat(dx10->dxgiFormat))
+					{
+						pixelFormat = *dxgiFormat;
+						break;
+					}
+				}
+				return nullptr;
+			default:
+				return nullptr;
+			}
+			break;
+
 		default:
 			return nullptr;
 		}
 
-		const auto pixelBytes = pixelSize(pixelFormat);
-		if (header->width > std::numeric_limits<uint32_t>::max() / pixelBytes)
-			return nullptr;
-
-		auto stride = header->width * pixelBytes;
-		if (header->flags & DDSD_PITCH)
+		uint32_t stride = 0;
+		uint32_t rows = header->height;
+		if (isBlockCompressed(pixelFormat))
 		{
-			if (header->pitchOrLinearSize < stride)
+			// The pitch (or rather the linear size) of block-compressed images is redundant.
+			const auto blockRowSize = uint64_t{ (header->width + 3u) / 4 } * blockSize(pixelFormat);
+			if (blockRowSize > std::numeric_limits<uint32_t>::max())
 				return nullptr;
-			stride = header->pitchOrLinearSize;
+			stride = static_cast<uint32_t>(blockRowSize);
+			rows = (header->height + 3) / 4;
 		}
+		else
+		{
+			const auto pixelBytes = pixelSize(pixelFormat);
+			if (header->width > std::numeric_limits<uint32_t>::max() / pixelBytes)
+				return nullptr;
+			stride = header->width * pixelBytes;
+			if (header->flags & DDSD_PITCH)
+			{
+				if (header->pitchOrLinearSize < stride)
+					return nullptr;
+				stride = header->pitchOrLinearSize;
+			}
+		}
+
+		if (rows > std::numeric_limits<uint32_t>::max() / stride)
+			return nullptr;
 
-		if (header->height > std::numeric_limits<uint32_t>::max() / stride)
+		// Mip levels are stored after the top level image with no padding.
+		const ImageInfo imageInfo{ header->width, header->height, stride, pixelFormat, ImageAxes::XRightYDown };
+		const auto levelCount = (header->flags & DDSD_MIPMAPCOUNT) && header->mipmapCount > 1 ? header->mipmapCount : 1;
+		if (levelCount > ImagePipeline::mipLevelCount(header->width, header->height))
 			return nullptr;
 
-		const auto data = reader.peek(size_t{ stride } * header->height);
+		const auto data = reader.peek(ImagePipeline::mipLevelOffset(imageInfo, levelCount));
 		if (!data)
 			return nullptr;
 
-		info = { header->width, header->height, stride, pixelFormat, ImageAxes::XRightYDown };
+		info = imageInfo;
+		mipLevelCount = levelCount;
 		return data;
 	}
 }
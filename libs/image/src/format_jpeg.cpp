@@ -181,6 +181,14 @@ namespace seir
 		case PixelFormat::Bgr24: colorSpace = JCS_EXT_BGR; break;
 		case PixelFormat::Rgba32: colorSpace = JCS_EXT_RGBX; break;
 		case PixelFormat::Bgra32: colorSpace = JCS_EXT_BGRX; break;
+		case PixelFormat::Bc1:
+		case PixelFormat::Bc2:
+		case PixelFormat::Bc3:
+		case PixelFormat::Bc4:
+		case PixelFormat::Bc5:
+		case PixelFormat::Bc6h:
+		case PixelFormat::Bc7:
+			return false;
 		}
 		return JpegCompressor{ writer }.compress(info, data, colorSpace, compressionLevel);
 	}
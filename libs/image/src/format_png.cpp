@@ -4,12 +4,24 @@
 
 #include "format.hpp"
 
+#include <seir_base/checksum.hpp>
 #include <seir_base/int_utils.hpp>
+#include <seir_base/task_scheduler.hpp>
 #include <seir_compression/compression.hpp>
 #include <seir_image/utils.hpp>
 #include <seir_io/writer.hpp>
+#include "png_filters.hpp"
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <optional>
+#include <span>
+#include <vector>
 
 namespace
 {
@@ -18,6 +30,8 @@ namespace
 		IDAT = seir::makeCC('I', 'D', 'A', 'T'),
 		IEND = seir::makeCC('I', 'E', 'N', 'D'),
 		IHDR = seir::makeCC('I', 'H', 'D', 'R'),
+		PLTE = seir::makeCC('P', 'L', 'T', 'E'),
+		tRNS = seir::makeCC('t', 'R', 'N', 'S'),
 	};
 
 	enum class PngColorType : uint8_t
@@ -39,15 +53,6 @@ namespace
 		Standard = 0,
 	};
 
-	enum class PngStandardFilterType : uint8_t
-	{
-		None = 0,
-		Sub = 1,
-		Up = 2,
-		Average = 3,
-		Paeth = 4,
-	};
-
 	enum class PngInterlaceMethod : uint8_t
 	{
 		None = 0,
@@ -56,6 +61,23 @@ namespace
 
 #pragma pack(push, 1)
 
+	struct PngChunkHeader
+	{
+		uint32_t length;
+		PngChunkType type;
+	};
+
+	struct PngIhdrData
+	{
+		uint32_t width;
+		uint32_t height;
+		uint8_t bitDepth;
+		PngColorType colorType;
+		PngCompressionMethod compressionMethod;
+		PngFilterMethod filterMethod;
+		PngInterlaceMethod interlaceMethod;
+	};
+
 	struct PngHeader
 	{
 		uint64_t signature;
@@ -63,104 +85,226 @@ namespace
 		{
 			uint32_t length;
 			PngChunkType type;
-			struct
-			{
-				uint32_t width;
-				uint32_t height;
-				uint8_t bitDepth;
-				PngColorType colorType;
-				PngCompressionMethod compressionMethod;
-				PngFilterMethod filterMethod;
-				PngInterlaceMethod interlaceMethod;
-			} data;
+			PngIhdrData data;
 			uint32_t crc;
 		} ihdr;
-		struct
-		{
-			uint32_t length;
-			PngChunkType type;
-		} idat;
 	};
 
-	struct PngFooter
+#pragma pack(pop)
+
+	std::optional<seir::PixelFormat> pngPixelFormat(PngColorType colorType) noexcept
 	{
-		struct
-		{
-			uint32_t crc;
-		} idat;
-		struct
+		switch (colorType)
 		{
-			uint32_t length;
-			PngChunkType type;
-			uint32_t crc;
-		} iend;
-	};
+		case PngColorType::Grayscale: return seir::PixelFormat::Gray8;
+		case PngColorType::Truecolor: return seir::PixelFormat::Rgb24;
+		case PngColorType::Indexed: break; // Indexed pixel format depends on palette transparency.
+		case PngColorType::GrayscaleAlpha: return seir::PixelFormat::GrayAlpha16;
+		case PngColorType::TruecolorAlpha: return seir::PixelFormat::Rgba32;
+		}
+		return {};
+	}
 
-#pragma pack(pop)
+	bool writePngChunk(seir::Writer& writer, PngChunkType type, std::initializer_list<std::span<const std::byte>> parts) noexcept
+	{
+		size_t length = 0;
+		seir::Crc32 crc;
+		crc.process(&type, sizeof type);
+		for (const auto& part : parts)
+		{
+			length += part.size();
+			crc.process(part.data(), part.size());
+		}
+		const PngChunkHeader header{ seir::bigEndian(static_cast<uint32_t>(length)), type };
+		const auto crcValue = seir::bigEndian(crc.value());
+		std::array<std::span<const std::byte>, 5> chunkParts;
+		size_t partCount = 0;
+		chunkParts[partCount++] = std::as_bytes(std::span{ &header, 1 });
+		assert(parts.size() <= chunkParts.size() - 2);
+		for (const auto& part : parts)
+			if (!part.empty())
+				chunkParts[partCount++] = part;
+		chunkParts[partCount++] = std::as_bytes(std::span{ &crcValue, 1 });
+		return writer.writeParts({ chunkParts.data(), partCount });
+	}
+}
 
-	// CRC-32 as defined by the PNG specification.
-	// May be of no general use since different formats and protocols
-	// use different CRC-32 polynomials and polynomial representations.
-	class Crc32
+namespace seir
+{
+	const void* loadPngImage(Reader& reader, ImageInfo& info, Buffer& buffer) noexcept
 	{
-	public:
-		constexpr Crc32() noexcept = default;
+		if (const auto signature = reader.read<uint64_t>(); !signature || *signature != kPngFileID)
+			return nullptr;
 
-		constexpr Crc32& process(const void* data, size_t size) noexcept
+		const auto ihdrHeader = reader.read<PngChunkHeader>();
+		if (!ihdrHeader || ihdrHeader->type != PngChunkType::IHDR || bigEndian(ihdrHeader->length) != sizeof(PngIhdrData))
+			return nullptr;
+
+		const auto ihdr = reader.read<PngIhdrData>();
+		if (!ihdr
+			|| !reader.skip(sizeof(uint32_t)) // CRC.
+			|| ihdr->compressionMethod != PngCompressionMethod::Zlib
+			|| ihdr->filterMethod != PngFilterMethod::Standard
+			|| ihdr->interlaceMethod != PngInterlaceMethod::None)
+			return nullptr;
+
+		const auto width = bigEndian(ihdr->width);
+		const auto height = bigEndian(ihdr->height);
+		if (!width || !height)
+			return nullptr;
+
+		// Indexed images are expanded to RGB or RGBA depending on palette transparency.
+		// Other images are decoded directly into the matching pixel format.
+		auto pixelFormat = PixelFormat::Rgb24;
+		const auto bitDepth = ihdr->bitDepth;
+		const bool indexed = ihdr->colorType == PngColorType::Indexed;
+		if (indexed)
 		{
-			for (size_t i = 0; i < size; ++i)
-				_value = _table[static_cast<const uint8_t*>(data)[i] ^ (_value & 0xff)] ^ (_value >> 8); // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-			return *this;
+			if (bitDepth != 1 && bitDepth != 2 && bitDepth != 4 && bitDepth != 8)
+				return nullptr;
 		}
-
-		[[nodiscard]] constexpr uint32_t value() const noexcept
+		else
 		{
-			return ~_value;
+			const auto directPixelFormat = pngPixelFormat(ihdr->colorType);
+			if (bitDepth != 8 || !directPixelFormat)
+				return nullptr;
+			pixelFormat = *directPixelFormat;
 		}
 
-	private:
-		uint32_t _value = 0xffffffff;
-
-		static constexpr std::array<uint32_t, 256> _table{
-			0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
-			0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
-			0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-			0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
-			0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172, 0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
-			0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-			0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
-			0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924, 0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
-			0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-			0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
-			0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
-			0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-			0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
-			0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0, 0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
-			0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-			0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
-			0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
-			0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-			0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
-			0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
-			0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-			0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
-			0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236, 0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
-			0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-			0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
-			0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
-			0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-			0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
-			0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
-			0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdebb9ec5, 0x47b2cf7f, 0x30b5ffe9,
-			0xbdbdf21c, 0xcabac28a, 0x53b39330, 0x24b4a3a6, 0xbad03605, 0xcdd70693, 0x54de5729, 0x23d967bf,
-			0xb3667a2e, 0xc4614ab8, 0x5d681b02, 0x2a6f2b94, 0xb40bbe37, 0xc30c8ea1, 0x5a05df1b, 0x2d02ef8d
+		const auto rowSize = indexed ? (size_t{ width } * bitDepth + 7) / 8 : size_t{ width } * pixelSize(pixelFormat);
+		const auto filteredRowSize = 1 + rowSize;
+		const PngUnfilter<true> unfilter{ indexed ? 1 : pixelSize(pixelFormat) };
+
+		std::span<const uint8_t> palette;
+		std::span<const uint8_t> transparency;
+		UniquePtr<DecompressStream> decompressor;
+		CompressionBuffers buffers;
+		uint8_t* output = nullptr;
+		uint8_t* filteredRows = nullptr;
+		size_t filteredSize = 0;
+		size_t stride = 0;
+		size_t decodedRows = 0;
+		Buffer zeroRow;
+		std::array<std::array<uint8_t, 4>, 256> colors{};
+		bool ended = false;
+
+		// Decompressed rows are unfiltered as soon as possible while they are still in cache.
+		// Rows of non-indexed images are unfiltered in place from the end of the buffer towards its beginning.
+		const auto decodeRows = [&] {
+			const auto availableRows = static_cast<size_t>(reinterpret_cast<uint8_t*>(buffers._dst) - filteredRows) / filteredRowSize;
+			for (; decodedRows < availableRows; ++decodedRows)
+			{
+				const auto filteredRow = filteredRows + decodedRows * filteredRowSize;
+				const auto row = indexed ? filteredRow + 1 : output + decodedRows * stride;
+				const auto previousRow = !decodedRows ? reinterpret_cast<const uint8_t*>(zeroRow.data()) : row - (indexed ? filteredRowSize : stride);
+				if (!unfilter(filteredRow[0], row, filteredRow + 1, previousRow, rowSize))
+					return false;
+				if (!indexed)
+					continue;
+				auto pixel = output + decodedRows * stride;
+				const auto outputPixelSize = pixelSize(pixelFormat);
+				if (bitDepth == 8)
+				{
+					for (size_t x = 0; x < width; ++x, pixel += outputPixelSize)
+						std::memcpy(pixel, colors[row[x]].data(), outputPixelSize);
+				}
+				else
+				{
+					const auto pixelsPerByte = 8u / bitDepth;
+					const auto mask = (1u << bitDepth) - 1;
+					for (size_t x = 0; x < width; ++x, pixel += outputPixelSize)
+					{
+						const auto shift = 8 - bitDepth * (1 + x % pixelsPerByte);
+						std::memcpy(pixel, colors[(unsigned{ row[x / pixelsPerByte] } >> shift) & mask].data(), outputPixelSize);
+					}
+				}
+			}
+			return true;
 		};
-	};
-}
 
-namespace seir
-{
-	bool savePngImage(Writer& writer, const ImageInfo& info, const void* data, int compressionLevel) noexcept
+		for (;;)
+		{
+			const auto chunk = reader.read<PngChunkHeader>();
+			if (!chunk)
+				return nullptr;
+			const auto size = bigEndian(chunk->length);
+			const auto data = static_cast<const uint8_t*>(reader.peek(size));
+			if (!data || !reader.skip(size_t{ size } + sizeof(uint32_t))) // Chunk data and CRC.
+				return nullptr;
+			switch (chunk->type)
+			{
+			case PngChunkType::IDAT:
+				if (!decompressor)
+				{
+					if (indexed)
+					{
+						if (palette.empty())
+							return nullptr;
+						if (!transparency.empty())
+							pixelFormat = PixelFormat::Rgba32;
+						for (size_t i = 0; i < palette.size() / 3; ++i)
+							colors[i] = { palette[3 * i], palette[3 * i + 1], palette[3 * i + 2], i < transparency.size() ? transparency[i] : uint8_t{ 255 } };
+					}
+					stride = size_t{ width } * pixelSize(pixelFormat);
+					if (stride * height > std::numeric_limits<uint32_t>::max())
+						return nullptr;
+					filteredSize = filteredRowSize * height;
+					const auto bufferSize = stride * height + (indexed ? filteredSize : height);
+					if (!buffer.tryReserve(bufferSize, 0) || !zeroRow.tryReserve(rowSize, 0))
+						return nullptr;
+					std::memset(zeroRow.data(), 0, rowSize);
+					output = reinterpret_cast<uint8_t*>(buffer.data());
+					filteredRows = output + bufferSize - filteredSize;
+					decompressor = DecompressStream::create(Compression::Zlib);
+					if (!decompressor || !decompressor->prepare())
+						return nullptr;
+					buffers._dst = reinterpret_cast<std::byte*>(filteredRows);
+				}
+				buffers._src = reinterpret_cast<const std::byte*>(data);
+				buffers._srcSize = size;
+				while (buffers._srcSize > 0 && !ended)
+				{
+					constexpr size_t kOutputBlockSize = 1 << 16;
+					const auto srcSize = buffers._srcSize;
+					const auto decompressedSize = static_cast<size_t>(reinterpret_cast<uint8_t*>(buffers._dst) - filteredRows);
+					buffers._dstSize = std::min(filteredSize - decompressedSize, std::max(kOutputBlockSize, filteredRowSize));
+					const auto dstSize = buffers._dstSize;
+					switch (decompressor->decompress(buffers))
+					{
+					case CompressionStatus::Error: return nullptr;
+					case CompressionStatus::Continue:
+						if (buffers._srcSize == srcSize && buffers._dstSize == dstSize) // No progress means there is more data than expected.
+							return nullptr;
+						break;
+					case CompressionStatus::End: ended = true; break;
+					}
+					if (!decodeRows())
+						return nullptr;
+				}
+				continue;
+			case PngChunkType::IEND:
+				if (!ended || decodedRows != height)
+					return nullptr;
+				info = { width, height, static_cast<uint32_t>(stride), pixelFormat, ImageAxes::XRightYDown };
+				return output;
+			case PngChunkType::IHDR: // Duplicate header.
+				return nullptr;
+			case PngChunkType::PLTE:
+				if (decompressor || !palette.empty() || !size || size % 3 || size > 3 * 256)
+					return nullptr;
+				palette = { data, size };
+				continue;
+			case PngChunkType::tRNS:
+				if (!decompressor && indexed)
+					transparency = { data, std::min<size_t>(size, 256) };
+				continue;
+			}
+			if (!(*reinterpret_cast<const uint8_t*>(&chunk->type) & 0x20)) // Unknown critical chunk.
+				return nullptr;
+		}
+	}
+
+	bool savePngImage(Writer& writer, const ImageInfo& info, const void* data, int compressionLevel, TaskScheduler* scheduler) noexcept
 	{
 		if (!info.width() || info.width() > std::numeric_limits<uint32_t>::max())
 			return false;
@@ -168,7 +312,10 @@ namespace seir
 		if (!info.height() || info.height() > std::numeric_limits<uint32_t>::max())
 			return false;
 
-		const auto [uncompressedPixelFormat, pngColorType] = [&info]() -> std::pair<PixelFormat, PngColorType> {
+		if (isBlockCompressed(info.pixelFormat()))
+			return false;
+
+		const auto [pngPixelFormat, pngColorType] = [&info]() -> std::pair<PixelFormat, PngColorType> {
 			switch (info.pixelFormat())
 			{
 			case PixelFormat::Gray8:
@@ -182,38 +329,49 @@ namespace seir
 			case PixelFormat::Rgba32:
 			case PixelFormat::Bgra32:
 				return { PixelFormat::Rgba32, PngColorType::TruecolorAlpha };
+			case PixelFormat::Bc1:
+			case PixelFormat::Bc2:
+			case PixelFormat::Bc3:
+			case PixelFormat::Bc4:
+			case PixelFormat::Bc5:
+			case PixelFormat::Bc6h:
+			case PixelFormat::Bc7:
+				break;
 			}
 			std::unreachable();
 		}();
 
-		const auto stride = 1 + info.width() * pixelSize(uncompressedPixelFormat);
-		const ImageInfo pngInfo{ info.width(), info.height(), stride, uncompressedPixelFormat, ImageAxes::XRightYDown };
+		const auto level = compressionLevel <= 0
+			? CompressionLevel::None
+			: (compressionLevel < 50
+					  ? CompressionLevel::Minimum
+					  : (compressionLevel < 100
+								? CompressionLevel::Default
+								: CompressionLevel::Maximum));
 
-		const auto uncompressedSize = pngInfo.frameSize();
-		Buffer uncompressedBuffer{ uncompressedSize };
-		if (!copyImage(info, data, pngInfo, uncompressedBuffer.data() + 1))
-			return false;
+		const auto width = info.width();
+		const auto height = info.height();
+		const auto rowSize = size_t{ width } * pixelSize(pngPixelFormat);
+		const auto filteredRowSize = 1 + rowSize;
+		const PngFilter<true> filter{ pixelSize(pngPixelFormat) };
 
-		for (size_t i = 0; i < uncompressedSize; i += stride)
-			uncompressedBuffer.data()[i] = std::byte{ toUnderlying(PngStandardFilterType::None) };
+		// Converts the specified image rows into PNG pixel format, writing them top to bottom.
+		const auto convertRows = [&](uint32_t first, uint32_t count, uint8_t* dst, size_t dstStride) {
+			const auto srcOffset = size_t{ info.axes() == ImageAxes::XRightYDown ? first : height - first - count } * info.stride();
+			return copyImage({ width, count, info.stride(), info.pixelFormat(), info.axes() }, static_cast<const uint8_t*>(data) + srcOffset,
+				{ width, count, static_cast<uint32_t>(dstStride), pngPixelFormat, ImageAxes::XRightYDown }, dst);
+		};
 
-		Buffer compressedBuffer;
-		size_t compressedSize = 0;
-		{
-			const auto compressor = Compressor::create(Compression::Zlib);
-			if (!compressor->prepare(compressionLevel <= 0
-						? CompressionLevel::None
-						: (compressionLevel < 50
-								  ? CompressionLevel::Minimum
-								  : (compressionLevel < 100
-											? CompressionLevel::Default
-											: CompressionLevel::Maximum))))
-				return false;
-			compressedBuffer.reserve(compressor->maxCompressedSize(uncompressedSize), 0);
-			compressedSize = compressor->compress(compressedBuffer.data(), compressedBuffer.capacity(), uncompressedBuffer.data(), uncompressedSize);
-			if (!compressedSize)
-				return false;
-		}
+		// Filters the converted row which is preceded by a byte for the filter type.
+		// Returns the filtered row with the filter type, which may be the converted row itself.
+		const auto filterRow = [&](uint8_t* scratch, uint8_t* row, const uint8_t* prev) -> const uint8_t* {
+			if (level == CompressionLevel::None) // Filtering doesn't make uncompressed data smaller.
+			{
+				row[0] = toUnderlying(PngStandardFilterType::None);
+				return row;
+			}
+			return filter.filterAdaptive(scratch, row + 1, prev, rowSize);
+		};
 
 		const PngHeader header{
 			.signature = kPngFileID,
@@ -221,8 +379,8 @@ namespace seir
 				.length = bigEndian(uint32_t{ sizeof header.ihdr.data }),
 				.type = PngChunkType::IHDR,
 				.data{
-					.width = bigEndian(info.width()),
-					.height = bigEndian(info.height()),
+					.width = bigEndian(width),
+					.height = bigEndian(height),
 					.bitDepth = 8,
 					.colorType = pngColorType,
 					.compressionMethod = PngCompressionMethod::Zlib,
@@ -230,26 +388,139 @@ namespace seir
 					.interlaceMethod = PngInterlaceMethod::None,
 				},
 				.crc = bigEndian(Crc32{}.process(&header.ihdr.type, sizeof header.ihdr.type).process(&header.ihdr.data, sizeof header.ihdr.data).value()) },
-			.idat{
-				.length = bigEndian(static_cast<uint32_t>(compressedSize)),
-				.type = PngChunkType::IDAT,
-			},
 		};
+		if (!writer.write(header))
+			return false;
 
-		const PngFooter footer{
-			.idat{
-				.crc = bigEndian(Crc32{}.process(&header.idat.type, sizeof header.idat.type).process(compressedBuffer.data(), compressedSize).value()),
-			},
-			.iend{
-				.length = 0,
-				.type = PngChunkType::IEND,
-				.crc = bigEndian(Crc32{}.process(&footer.iend.type, sizeof footer.iend.type).value()),
-			},
-		};
+		// Large images are split into bands of rows which are filtered and compressed in parallel,
+		// each band using the end of the previous one as a compression dictionary (the way pigz does it).
+		// The bands are then joined into a single zlib stream, one IDAT chunk per band.
+		constexpr size_t kBandSize = 256 * 1024;
+		const auto bandRows = static_cast<uint32_t>(std::clamp<size_t>(kBandSize / filteredRowSize, 1, height));
+		const auto bandCount = (height + bandRows - 1) / bandRows;
+		if (scheduler && scheduler->workerCount() > 0 && bandCount > 1)
+		{
+			struct Band
+			{
+				size_t _size = 0;
+				Adler32 _adler32;
+				Buffer _compressed;
+				size_t _compressedSize = 0;
+			};
+			Buffer filtered;
+			if (!filtered.tryReserve(filteredRowSize * height, 0))
+				return false;
+			const auto filteredData = reinterpret_cast<uint8_t*>(filtered.data());
+			std::vector<Band> bands(bandCount);
+			std::atomic<bool> failed{ false };
+			scheduler->parallelFor(0, bandCount, 1, [&](size_t band) {
+				const auto first = static_cast<uint32_t>(band * bandRows);
+				const auto count = std::min(bandRows, height - first);
+				const auto converted = first > 0 ? 1 + count : count; // Filtering the first row of a band requires the row above.
+				Buffer rows;
+				Buffer scratch;
+				Buffer zeroRow;
+				if (!rows.tryReserve(converted * filteredRowSize, 0)
+					|| !scratch.tryReserve(5 * filteredRowSize, 0)
+					|| !zeroRow.tryReserve(rowSize, 0)
+					|| !convertRows(first + count - converted, converted, reinterpret_cast<uint8_t*>(rows.data()) + 1, filteredRowSize))
+				{
+					failed = true;
+					return;
+				}
+				std::memset(zeroRow.data(), 0, rowSize);
+				auto row = reinterpret_cast<uint8_t*>(rows.data()) + (converted - count) * filteredRowSize;
+				auto prev = first > 0 ? row - filteredRowSize + 1 : reinterpret_cast<const uint8_t*>(zeroRow.data());
+				for (auto dst = filteredData + first * filteredRowSize, end = dst + count * filteredRowSize; dst != end; dst += filteredRowSize)
+				{
+					std::memcpy(dst, filterRow(reinterpret_cast<uint8_t*>(scratch.data()), row, prev), filteredRowSize);
+					prev = row + 1;
+					row += filteredRowSize;
+				}
+			});
+			if (!failed)
+				scheduler->parallelFor(0, bandCount, 1, [&](size_t index) {
+					const auto offset = index * bandRows * filteredRowSize;
+					auto& band = bands[index];
+					band._size = std::min(size_t{ bandRows } * filteredRowSize, filteredRowSize * height - offset);
+					band._adler32.process(filteredData + offset, band._size);
+					const auto compressor = ZlibPartCompressor::create();
+					if (!compressor
+						|| !compressor->prepare(level)
+						|| !band._compressed.tryReserve(compressor->maxCompressedSize(band._size), 0)
+						|| !(band._compressedSize = compressor->compress(band._compressed.data(), band._compressed.capacity(), filteredData + offset, band._size, filteredData, offset, index + 1 == bandCount)))
+						failed = true;
+				});
+			if (failed)
+				return false;
+			// The compression level in the zlib header is informational and doesn't affect decompression.
+			const auto zlibHeader = bigEndian(static_cast<uint16_t>(level == CompressionLevel::Default ? 0x789c : (level == CompressionLevel::Maximum ? 0x78da : 0x7801)));
+			Adler32 adler32;
+			for (size_t i = 0; i < bandCount; ++i)
+			{
+				const auto& band = bands[i];
+				adler32.combine(band._adler32, band._size);
+				const auto zlibTrailer = bigEndian(adler32.value());
+				if (!::writePngChunk(writer, PngChunkType::IDAT,
+						{
+							std::as_bytes(std::span{ &zlibHeader, i == 0 ? size_t{ 1 } : size_t{ 0 } }),
+							std::span{ band._compressed.data(), band._compressedSize },
+							std::as_bytes(std::span{ &zlibTrailer, i + 1 == bandCount ? size_t{ 1 } : size_t{ 0 } }),
+						}))
+					return false;
+			}
+		}
+		else
+		{
+			// Rows are filtered one by one and streamed through the compressor,
+			// which emits IDAT chunks of limited size as soon as they're ready.
+			constexpr size_t kIdatSize = 64 * 1024;
+			Buffer rows;
+			Buffer scratch;
+			Buffer idat;
+			if (!rows.tryReserve(2 * filteredRowSize, 0)
+				|| !scratch.tryReserve(5 * filteredRowSize, 0)
+				|| !idat.tryReserve(kIdatSize, 0))
+				return false;
+			std::memset(rows.data(), 0, filteredRowSize); // The row above the first one consists of zeros.
+			const auto compressor = CompressStream::create(Compression::Zlib);
+			if (!compressor || !compressor->prepare(level, filteredRowSize * height))
+				return false;
+			CompressionBuffers buffers{ nullptr, 0, idat.data(), kIdatSize };
+			const auto flushIdat = [&] {
+				const auto size = kIdatSize - buffers._dstSize;
+				buffers._dst = idat.data();
+				buffers._dstSize = kIdatSize;
+				return ::writePngChunk(writer, PngChunkType::IDAT, { std::span{ idat.data(), size } });
+			};
+			auto prev = reinterpret_cast<uint8_t*>(rows.data());
+			auto row = prev + filteredRowSize;
+			for (uint32_t y = 0; y < height; ++y)
+			{
+				if (!convertRows(y, 1, row + 1, filteredRowSize))
+					return false;
+				buffers._src = reinterpret_cast<const std::byte*>(filterRow(reinterpret_cast<uint8_t*>(scratch.data()), row, prev + 1));
+				buffers._srcSize = filteredRowSize;
+				const bool last = y + 1 == height;
+				for (;;)
+				{
+					const auto status = compressor->compress(buffers, last);
+					if (status == CompressionStatus::Error)
+						return false;
+					if (!buffers._dstSize)
+					{
+						if (!flushIdat())
+							return false;
+					}
+					else if (status == CompressionStatus::End || (!last && !buffers._srcSize))
+						break;
+				}
+				std::swap(prev, row);
+			}
+			if (buffers._dstSize < kIdatSize && !flushIdat())
+				return false;
+		}
 
-		return writer.reserve(sizeof header + compressedSize + sizeof footer)
-			&& writer.write(header)
-			&& writer.write(compressedBuffer.data(), compressedSize)
-			&& writer.write(footer);
+		return ::writePngChunk(writer, PngChunkType::IEND, {});
 	}
 }
@@ -162,6 +162,14 @@ namespace seir
 			header.image.pixelDepth = 32;
 			header.image.descriptor = 8;
 			break;
+		case PixelFormat::Bc1:
+		case PixelFormat::Bc2:
+		case PixelFormat::Bc3:
+		case PixelFormat::Bc4:
+		case PixelFormat::Bc5:
+		case PixelFormat::Bc6h:
+		case PixelFormat::Bc7:
+			return false;
 		}
 		switch (info.axes())
 		{
@@ -18,8 +18,7 @@
 // TODO: Add support for:
 // - writing image data at aligned offsets (for more efficient copying of memory-mapped data);
 // - loading image data into the specified buffer (e.g. mapped texture memory);
-// - compressed pixel formats (e.g. S3TC);
-// - multi-layer images (e.g. textures with mipmaps);
+// - multi-layer images (e.g. texture arrays);
 // - separate image header/data loading;
 // - some sort of image packs (to be able to pre-load image headers and load image data separately).
 
@@ -39,7 +38,7 @@ namespace seir
 				break;
 			case first16(kDdsFileID):
 #if SEIR_IMAGE_DDS
-				result._data = loadDdsImage(reader, result._info);
+				result._data = loadDdsImage(reader, result._info, result._mipLevelCount);
 #endif
 				break;
 			case makeCC('\xff', '\xd8'): // JFIF SOI marker.
@@ -48,6 +47,9 @@ namespace seir
 #endif
 				break;
 			case first16(kPngFileID):
+#if SEIR_IMAGE_PNG
+				result._data = loadPngImage(reader, result._info, result._buffer);
+#endif
 				break;
 			case makeCC('R', 'I'): // WebP images start with "RIFF" followed by 4-byte size followed by "WEBP".
 #if SEIR_IMAGE_WEBP
@@ -88,7 +90,7 @@ namespace seir
 	Image::Image(const ImageInfo& info, Buffer&& buffer) noexcept
 		: _info{ info }, _data{ buffer.data() }, _buffer{ std::move(buffer) } {}
 
-	bool Image::save(ImageFormat format, [[maybe_unused]] Writer& writer, [[maybe_unused]] int compressionLevel) const noexcept
+	bool Image::save(ImageFormat format, [[maybe_unused]] Writer& writer, [[maybe_unused]] int compressionLevel, [[maybe_unused]] TaskScheduler* scheduler) const noexcept
 	{
 		switch (format)
 		{
@@ -106,7 +108,7 @@ namespace seir
 #endif
 		case ImageFormat::Png:
 #if SEIR_IMAGE_PNG
-			return savePngImage(writer, _info, _data, std::clamp(compressionLevel, 0, 100));
+			return savePngImage(writer, _info, _data, std::clamp(compressionLevel, 0, 100), scheduler);
 #else
 			break;
 #endif
@@ -114,7 +116,7 @@ namespace seir
 		return false;
 	}
 
-	bool Image::saveAsScreenshot(ImageFormat format, int compressionLevel) const
+	bool Image::saveAsScreenshot(ImageFormat format, int compressionLevel, TaskScheduler* scheduler) const
 	{
 		const auto time = std::time(nullptr);
 		::tm tm; // NOLINT(cppcoreguidelines-pro-type-member-init)
@@ -137,7 +139,7 @@ namespace seir
 		buffer[result.size] = '\0';
 		if (const auto screenshotPath = makeScreenshotPath(buffer.data()))
 			if (const auto writer = Writer::create(*screenshotPath))
-				return save(format, *writer, compressionLevel);
+				return save(format, *writer, compressionLevel, scheduler);
 		return false;
 	}
 }
@@ -0,0 +1,574 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_image/pipeline.hpp>
+
+#include <seir_base/buffer.hpp>
+#include <seir_base/intrinsics.hpp>
+#include <seir_base/task_scheduler.hpp>
+#include <seir_image/image.hpp>
+#include <seir_image/utils.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <new>
+#include <numbers>
+#include <span>
+
+namespace
+{
+	// Intermediate pixels are RGBA with channel values in [0, 255] range.
+	using Pixel = std::array<float, 4>;
+
+	constexpr float kAlphaScale = 1.f / 255;
+
+#if SEIR_INTRINSICS_SSE
+	using PixelVector = __m128;
+
+	PixelVector loadPixel(const Pixel& pixel) noexcept { return _mm_loadu_ps(pixel.data()); }
+	void storePixel(Pixel& pixel, PixelVector vector) noexcept { _mm_storeu_ps(pixel.data(), vector); }
+	PixelVector zeroPixel() noexcept { return _mm_setzero_ps(); }
+	PixelVector addPixels(PixelVector first, PixelVector second) noexcept { return _mm_add_ps(first, second); }
+	PixelVector scalePixel(PixelVector vector, float scale) noexcept { return _mm_mul_ps(vector, _mm_set1_ps(scale)); }
+
+	PixelVector premultiplyPixel(PixelVector vector) noexcept
+	{
+		const auto alpha = _mm_mul_ps(_mm_shuffle_ps(vector, vector, _MM_SHUFFLE(3, 3, 3, 3)), _mm_set1_ps(kAlphaScale));
+		return _mm_mul_ps(vector, _mm_blend_ps(alpha, _mm_set1_ps(1), 0b1000));
+	}
+#elif SEIR_INTRINSICS_NEON
+	using PixelVector = float32x4_t;
+
+	PixelVector loadPixel(const Pixel& pixel) noexcept { return vld1q_f32(pixel.data()); }
+	void storePixel(Pixel& pixel, PixelVector vector) noexcept { vst1q_f32(pixel.data(), vector); }
+	PixelVector zeroPixel() noexcept { return vdupq_n_f32(0); }
+	PixelVector addPixels(PixelVector first, PixelVector second) noexcept { return vaddq_f32(first, second); }
+	PixelVector scalePixel(PixelVector vector, float scale) noexcept { return vmulq_n_f32(vector, scale); }
+
+	PixelVector premultiplyPixel(PixelVector vector) noexcept
+	{
+		const auto alpha = vmulq_n_f32(vdupq_laneq_f32(vector, 3), kAlphaScale);
+		return vmulq_f32(vector, vsetq_lane_f32(1.f, alpha, 3));
+	}
+#else
+	using PixelVector = Pixel;
+
+	PixelVector loadPixel(const Pixel& pixel) noexcept { return pixel; }
+	void storePixel(Pixel& pixel, PixelVector vector) noexcept { pixel = vector; }
+	PixelVector zeroPixel() noexcept { return {}; }
+
+	PixelVector addPixels(PixelVector first, PixelVector second) noexcept
+	{
+		return { first[0] + second[0], first[1] + second[1], first[2] + second[2], first[3] + second[3] };
+	}
+
+	PixelVector scalePixel(PixelVector vector, float scale) noexcept
+	{
+		return { vector[0] * scale, vector[1] * scale, vector[2] * scale, vector[3] * scale };
+	}
+
+	PixelVector premultiplyPixel(PixelVector vector) noexcept
+	{
+		const auto alpha = vector[3] * kAlphaScale;
+		return { vector[0] * alpha, vector[1] * alpha, vector[2] * alpha, vector[3] };
+	}
+#endif
+
+	bool canConvert(seir::PixelFormat srcFormat, seir::PixelFormat dstFormat) noexcept
+	{
+		using enum seir::PixelFormat;
+		if (isBlockCompressed(srcFormat) || isBlockCompressed(dstFormat))
+			return false;
+		if (srcFormat == dstFormat || dstFormat == Rgba32 || dstFormat == Bgra32)
+			return true;
+		return (srcFormat == Rgb24 || srcFormat == Bgr24) && (dstFormat == Rgb24 || dstFormat == Bgr24);
+	}
+
+	constexpr Pixel makePixel(uint8_t r, uint8_t g, uint8_t b, uint8_t a) noexcept
+	{
+		return { static_cast<float>(r), static_cast<float>(g), static_cast<float>(b), static_cast<float>(a) };
+	}
+
+	void unpackRow32(Pixel* dst, const uint8_t* src, size_t width, bool swapRedBlue) noexcept
+	{
+		size_t x = 0;
+#if SEIR_INTRINSICS_SSE
+		const auto shuffle = swapRedBlue
+			? _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15)
+			: _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		for (; x + 4 <= width; x += 4)
+		{
+			const auto pixels = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * x)), shuffle);
+			_mm_storeu_ps(dst[x].data(), _mm_cvtepi32_ps(_mm_cvtepu8_epi32(pixels)));
+			_mm_storeu_ps(dst[x + 1].data(), _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(pixels, 4))));
+			_mm_storeu_ps(dst[x + 2].data(), _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(pixels, 8))));
+			_mm_storeu_ps(dst[x + 3].data(), _mm_cvtepi32_ps(_mm_cvtepu8_epi32(_mm_srli_si128(pixels, 12))));
+		}
+#endif
+		const auto red = swapRedBlue ? 2 : 0;
+		for (; x < width; ++x)
+		{
+			const auto pixel = src + 4 * x;
+			dst[x] = ::makePixel(pixel[red], pixel[1], pixel[2 - red], pixel[3]);
+		}
+	}
+
+	void unpackRow(Pixel* dst, const uint8_t* src, size_t width, seir::PixelFormat format) noexcept
+	{
+		const auto end = dst + width;
+		switch (format)
+		{
+		case seir::PixelFormat::Gray8:
+			for (; dst != end; ++dst, ++src)
+				*dst = ::makePixel(src[0], src[0], src[0], 255);
+			break;
+		case seir::PixelFormat::Intensity8:
+			for (; dst != end; ++dst, ++src)
+				*dst = ::makePixel(src[0], src[0], src[0], src[0]);
+			break;
+		case seir::PixelFormat::GrayAlpha16:
+			for (; dst != end; ++dst, src += 2)
+				*dst = ::makePixel(src[0], src[0], src[0], src[1]);
+			break;
+		case seir::PixelFormat::Rgb24:
+			for (; dst != end; ++dst, src += 3)
+				*dst = ::makePixel(src[0], src[1], src[2], 255);
+			break;
+		case seir::PixelFormat::Bgr24:
+			for (; dst != end; ++dst, src += 3)
+				*dst = ::makePixel(src[2], src[1], src[0], 255);
+			break;
+		case seir::PixelFormat::Rgba32:
+			::unpackRow32(dst, src, width, false);
+			break;
+		case seir::PixelFormat::Bgra32:
+			::unpackRow32(dst, src, width, true);
+			break;
+		case seir::PixelFormat::Bc1:
+		case seir::PixelFormat::Bc2:
+		case seir::PixelFormat::Bc3:
+		case seir::PixelFormat::Bc4:
+		case seir::PixelFormat::Bc5:
+		case seir::PixelFormat::Bc6h:
+		case seir::PixelFormat::Bc7:
+			break;
+		}
+	}
+
+	constexpr uint8_t packChannel(float value) noexcept
+	{
+		return static_cast<uint8_t>(std::clamp(value, 0.f, 255.f) + .5f);
+	}
+
+	void packRow32(uint8_t* dst, const Pixel* src, size_t width, bool swapRedBlue) noexcept
+	{
+		size_t x = 0;
+#if SEIR_INTRINSICS_SSE
+		const auto shuffle = swapRedBlue
+			? _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15)
+			: _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+		const auto convert = [](const Pixel& pixel) {
+			const auto clamped = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(pixel.data()), _mm_setzero_ps()), _mm_set1_ps(255));
+			return _mm_cvttps_epi32(_mm_add_ps(clamped, _mm_set1_ps(.5f)));
+		};
+		for (; x + 4 <= width; x += 4)
+		{
+			const auto low = _mm_packs_epi32(convert(src[x]), convert(src[x + 1]));
+			const auto high = _mm_packs_epi32(convert(src[x + 2]), convert(src[x + 3]));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 4 * x), _mm_shuffle_epi8(_mm_packus_epi16(low, high), shuffle));
+		}
+#endif
+		const auto red = swapRedBlue ? 2 : 0;
+		for (; x < width; ++x)
+		{
+			const auto pixel = dst + 4 * x;
+			pixel[red] = ::packChannel(src[x][0]);
+			pixel[1] = ::packChannel(src[x][1]);
+			pixel[2 - red] = ::packChannel(src[x][2]);
+			pixel[3] = ::packChannel(src[x][3]);
+		}
+	}
+
+	void packRow(uint8_t* dst, const Pixel* src, size_t width, seir::PixelFormat format) noexcept
+	{
+		const auto end = src + width;
+		switch (format)
+		{
+		case seir::PixelFormat::Gray8:
+			for (; src != end; ++src, ++dst)
+				dst[0] = ::packChannel((*src)[0]);
+			break;
+		case seir::PixelFormat::Intensity8:
+			for (; src != end; ++src, ++dst)
+				dst[0] = ::packChannel((*src)[3]);
+			break;
+		case seir::PixelFormat::GrayAlpha16:
+			for (; src != end; ++src, dst += 2)
+			{
+				dst[0] = ::packChannel((*src)[0]);
+				dst[1] = ::packChannel((*src)[3]);
+			}
+			break;
+		case seir::PixelFormat::Rgb24:
+			for (; src != end; ++src, dst += 3)
+			{
+				dst[0] = ::packChannel((*src)[0]);
+				dst[1] = ::packChannel((*src)[1]);
+				dst[2] = ::packChannel((*src)[2]);
+			}
+			break;
+		case seir::PixelFormat::Bgr24:
+			for (; src != end; ++src, dst += 3)
+			{
+				dst[0] = ::packChannel((*src)[2]);
+				dst[1] = ::packChannel((*src)[1]);
+				dst[2] = ::packChannel((*src)[0]);
+			}
+			break;
+		case seir::PixelFormat::Rgba32:
+			::packRow32(dst, src, width, false);
+			break;
+		case seir::PixelFormat::Bgra32:
+			::packRow32(dst, src, width, true);
+			break;
+		case seir::PixelFormat::Bc1:
+		case seir::PixelFormat::Bc2:
+		case seir::PixelFormat::Bc3:
+		case seir::PixelFormat::Bc4:
+		case seir::PixelFormat::Bc5:
+		case seir::PixelFormat::Bc6h:
+		case seir::PixelFormat::Bc7:
+			break;
+		}
+	}
+
+	void premultiplyRow(Pixel* pixels, size_t width) noexcept
+	{
+		for (const auto end = pixels + width; pixels != end; ++pixels)
+			::storePixel(*pixels, ::premultiplyPixel(::loadPixel(*pixels)));
+	}
+
+	// Source pixels and their weights for every destination pixel along one axis.
+	struct Resampler
+	{
+		struct Tap
+		{
+			uint32_t _first = 0;
+			uint32_t _count = 0;
+			uint32_t _offset = 0;
+		};
+
+		bool _identity = false;
+		seir::Buffer _taps;
+		seir::Buffer _weights;
+		size_t _tapCount = 0;
+		size_t _weightCount = 0;
+
+		bool initialize(uint32_t srcSize, uint32_t dstSize, seir::ImageFilter filter) noexcept
+		{
+			_identity = srcSize == dstSize;
+			if (!_taps.tryReserve(dstSize * sizeof(Tap), 0))
+				return false;
+			const auto scale = static_cast<double>(srcSize) / dstSize;
+			const auto addTap = [this, srcSize](double from, double to, auto&& weight) {
+				auto& tap = reinterpret_cast<Tap*>(_taps.data())[_tapCount] = {};
+				tap._first = static_cast<uint32_t>(std::clamp(std::floor(from), 0., srcSize - 1.));
+				tap._offset = static_cast<uint32_t>(_weightCount);
+				const auto end = static_cast<uint32_t>(std::clamp(std::ceil(to), tap._first + 1., static_cast<double>(srcSize)));
+				tap._count = end - tap._first;
+				if (const auto requiredCapacity = (_weightCount + tap._count) * sizeof(float); _weights.capacity() < requiredCapacity)
+					if (!_weights.tryReserve(std::max(requiredCapacity, 2 * _weights.capacity()), _weightCount * sizeof(float)))
+						return false;
+				const auto tapWeights = reinterpret_cast<float*>(_weights.data()) + _weightCount;
+				double sum = 0;
+				for (uint32_t i = 0; i < tap._count; ++i)
+					sum += tapWeights[i] = static_cast<float>(weight(tap._first + i));
+				if (sum != 0)
+					for (uint32_t i = 0; i < tap._count; ++i)
+						tapWeights[i] = static_cast<float>(tapWeights[i] / sum);
+				++_tapCount;
+				_weightCount += tap._count;
+				return true;
+			};
+			for (uint32_t x = 0; x < dstSize; ++x)
+			{
+				const auto center = (x + .5) * scale;
+				bool added = false;
+				if (_identity)
+					added = addTap(x, x + 1, [](uint32_t) { return 1.; });
+				else if (filter == seir::ImageFilter::Lanczos3)
+				{
+					// Downscaling stretches the kernel to cover all source pixels.
+					const auto kernelScale = std::max(scale, 1.);
+					const auto radius = 3 * kernelScale;
+					added = addTap(center - radius, center + radius, [center, kernelScale](uint32_t i) {
+						const auto t = (i + .5 - center) / kernelScale;
+						if (t == 0)
+							return 1.;
+						if (std::abs(t) >= 3)
+							return 0.;
+						const auto pt = std::numbers::pi * t;
+						return 3 * std::sin(pt) * std::sin(pt / 3) / (pt * pt);
+					});
+				}
+				else if (scale <= 1)
+					added = addTap(center, center, [](uint32_t) { return 1.; });
+				else
+				{
+					const auto from = x * scale;
+					const auto to = from + scale;
+					added = addTap(from, to, [from, to](uint32_t i) { return std::min<double>(to, i + 1) - std::max<double>(from, i); });
+				}
+				if (!added)
+					return false;
+			}
+			return true;
+		}
+
+		[[nodiscard]] const Tap* taps() const noexcept { return reinterpret_cast<const Tap*>(_taps.data()); }
+		[[nodiscard]] const float* weights() const noexcept { return reinterpret_cast<const float*>(_weights.data()); }
+
+		void resampleRow(Pixel* dst, const Pixel* src) const noexcept
+		{
+			for (const auto& tap : std::span{ taps(), _tapCount })
+			{
+				auto sum = ::zeroPixel();
+				const auto weights = this->weights() + tap._offset;
+				const auto pixels = src + tap._first;
+				for (uint32_t i = 0; i < tap._count; ++i)
+					sum = ::addPixels(sum, ::scalePixel(::loadPixel(pixels[i]), weights[i]));
+				::storePixel(*dst++, sum);
+			}
+		}
+	};
+
+	void accumulateRow(Pixel* dst, const Pixel* src, float weight, size_t width) noexcept
+	{
+		for (const auto end = dst + width; dst != end; ++dst, ++src)
+			::storePixel(*dst, ::addPixels(::loadPixel(*dst), ::scalePixel(::loadPixel(*src), weight)));
+	}
+
+	// Averages 2x2 pixel blocks, writing the result over the source rows.
+	void halveRows(Pixel* rows, size_t rowPixels, size_t srcWidth, size_t srcRows, size_t dstWidth, size_t dstRows) noexcept
+	{
+		for (size_t y = 0; y < dstRows; ++y)
+		{
+			const auto top = rows + 2 * y * rowPixels;
+			const auto bottom = 2 * y + 1 < srcRows ? top + rowPixels : top;
+			const auto dst = rows + y * rowPixels;
+			for (size_t x = 0; x < dstWidth; ++x)
+			{
+				const auto left = 2 * x;
+				const auto right = std::min(left + 1, srcWidth - 1);
+				const auto sum = ::addPixels(::addPixels(::loadPixel(top[left]), ::loadPixel(top[right])), ::addPixels(::loadPixel(bottom[left]), ::loadPixel(bottom[right])));
+				::storePixel(dst[x], ::scalePixel(sum, .25f));
+			}
+		}
+	}
+
+	// Rows are addressed top-to-bottom, so the stride is negative for bottom-to-top images.
+	struct Plane
+	{
+		uint8_t* _data = nullptr;
+		ptrdiff_t _stride = 0;
+		uint32_t _width = 0;
+		uint32_t _height = 0;
+
+		Plane(const seir::ImageInfo& info, uint8_t* data) noexcept
+			: _data{ data }, _stride{ static_cast<ptrdiff_t>(info.stride()) }, _width{ info.width() }, _height{ info.height() }
+		{
+			if (info.axes() == seir::ImageAxes::XRightYUp)
+			{
+				_data += static_cast<ptrdiff_t>(_height - 1) * _stride;
+				_stride = -_stride;
+			}
+		}
+
+		[[nodiscard]] uint8_t* row(size_t y) const noexcept { return _data + static_cast<ptrdiff_t>(y) * _stride; }
+	};
+
+	struct Pass
+	{
+		Plane _src;
+		seir::PixelFormat _srcFormat = seir::PixelFormat::Gray8;
+		bool _premultiply = false;
+		bool _writeFirstLevel = true;
+		const Plane* _levels = nullptr;
+		size_t _levelCount = 0;
+		seir::PixelFormat _dstFormat = seir::PixelFormat::Gray8;
+	};
+
+	// Produces the first pass level in strips of rows, each strip also producing as many subsequent
+	// mip levels as fit in its rows. Returns the number of levels produced, or zero on failure.
+	size_t runPass(const Pass& pass, seir::ImageFilter filter, seir::TaskScheduler* scheduler) noexcept
+	{
+		const auto& base = pass._levels[0];
+		Resampler horizontal;
+		Resampler vertical;
+		if (!horizontal.initialize(pass._src._width, base._width, filter) || !vertical.initialize(pass._src._height, base._height, filter))
+			return 0;
+		// Strips should fit in L2 cache, but also be tall enough for the overlap of source rows
+		// required by vertical resampling of adjacent strips to be small.
+		constexpr size_t kStripSize = 512 * 1024;
+		const auto stripRows = std::bit_floor(std::clamp<size_t>(kStripSize / (base._width * sizeof(Pixel)), 2, std::max<size_t>(std::bit_ceil(size_t{ base._height }), 2)));
+		const auto stripCount = (base._height + stripRows - 1) / stripRows;
+		const auto localLevels = stripCount > 1 ? std::min<size_t>(pass._levelCount, static_cast<size_t>(std::countr_zero(stripRows)) + 1) : pass._levelCount;
+		std::atomic<bool> failed{ false };
+		const auto processStrip = [&](size_t strip) {
+			seir::Buffer buffer;
+			if (!buffer.tryReserve((stripRows * base._width + pass._src._width + base._width) * sizeof(Pixel), 0))
+			{
+				failed = true;
+				return;
+			}
+			const auto rows = reinterpret_cast<Pixel*>(buffer.data());
+			const auto srcRow = rows + stripRows * base._width;
+			const auto resampledRow = srcRow + pass._src._width;
+			const auto loadRow = [&](Pixel* dst, size_t y) {
+				const auto unpacked = horizontal._identity ? dst : srcRow;
+				::unpackRow(unpacked, pass._src.row(y), pass._src._width, pass._srcFormat);
+				if (pass._premultiply)
+					::premultiplyRow(unpacked, pass._src._width);
+				if (!horizontal._identity)
+					horizontal.resampleRow(dst, unpacked);
+			};
+			const auto y0 = strip * stripRows;
+			const auto y1 = std::min(y0 + stripRows, size_t{ base._height });
+			if (vertical._identity)
+			{
+				for (auto y = y0; y < y1; ++y)
+					loadRow(rows + (y - y0) * base._width, y);
+			}
+			else
+			{
+				const auto taps = vertical.taps();
+				std::fill(rows, rows + (y1 - y0) * base._width, Pixel{});
+				size_t srcEnd = 0;
+				for (auto y = y0; y < y1; ++y)
+					srcEnd = std::max<size_t>(srcEnd, taps[y]._first + taps[y]._count);
+				auto firstAffected = y0;
+				for (size_t srcY = taps[y0]._first; srcY < srcEnd; ++srcY)
+				{
+					loadRow(resampledRow, srcY);
+					while (taps[firstAffected]._first + taps[firstAffected]._count <= srcY)
+						++firstAffected;
+					for (auto y = firstAffected; y < y1 && taps[y]._first <= srcY; ++y)
+					{
+						const auto& tap = taps[y];
+						::accumulateRow(rows + (y - y0) * base._width, resampledRow, vertical.weights()[tap._offset + srcY - tap._first], base._width);
+					}
+				}
+			}
+			if (pass._writeFirstLevel)
+				for (auto y = y0; y < y1; ++y)
+					::packRow(base.row(y), rows + (y - y0) * base._width, base._width, pass._dstFormat);
+			auto first = y0;
+			auto count = y1 - y0;
+			for (size_t level = 1; level < localLevels; ++level)
+			{
+				const auto& previous = pass._levels[level - 1];
+				const auto& current = pass._levels[level];
+				const auto end = first + count == previous._height ? size_t{ current._height } : (first + count) / 2;
+				first /= 2;
+				if (end <= first)
+					break;
+				const auto previousCount = count;
+				count = end - first;
+				::halveRows(rows, base._width, previous._width, previousCount, current._width, count);
+				for (size_t y = 0; y < count; ++y)
+					::packRow(current.row(first + y), rows + y * base._width, current._width, pass._dstFormat);
+			}
+		};
+		if (scheduler && scheduler->workerCount() > 0 && stripCount > 1)
+		{
+			try
+			{
+				scheduler->parallelFor(0, stripCount, 1, processStrip);
+			}
+			catch (...) // Task allocation failure; the strips which were scheduled have finished by now.
+			{
+				failed = true;
+			}
+		}
+		else
+			for (size_t strip = 0; strip < stripCount; ++strip)
+				processStrip(strip);
+		return failed ? 0 : localLevels;
+	}
+}
+
+namespace seir
+{
+	uint32_t ImagePipeline::mipLevelCount(uint32_t width, uint32_t height) noexcept
+	{
+		return static_cast<uint32_t>(std::bit_width(std::max(width, height)));
+	}
+
+	ImageInfo ImagePipeline::mipLevelInfo(const ImageInfo& dstInfo, uint32_t level) noexcept
+	{
+		if (!level)
+			return dstInfo;
+		return { std::max(dstInfo.width() >> level, 1u), std::max(dstInfo.height() >> level, 1u), dstInfo.pixelFormat(), dstInfo.axes() };
+	}
+
+	size_t ImagePipeline::mipLevelOffset(const ImageInfo& dstInfo, uint32_t level) noexcept
+	{
+		if (!level)
+			return 0;
+		size_t offset = dstInfo.frameSize();
+		for (uint32_t i = 1; i < level; ++i)
+			offset += mipLevelInfo(dstInfo, i).frameSize();
+		return offset;
+	}
+
+	size_t ImagePipeline::outputSize(const ImageInfo& dstInfo) const noexcept
+	{
+		return _mipChain ? mipLevelOffset(dstInfo, mipLevelCount(dstInfo.width(), dstInfo.height())) : dstInfo.frameSize();
+	}
+
+	bool ImagePipeline::run(const ImageInfo& srcInfo, const void* srcData, const ImageInfo& dstInfo, void* dstData, TaskScheduler* scheduler) const noexcept
+	{
+		if (!srcInfo.width() || !srcInfo.height() || !dstInfo.width() || !dstInfo.height())
+			return false;
+		if (!::canConvert(srcInfo.pixelFormat(), dstInfo.pixelFormat()))
+			return false;
+		const auto levelCount = _mipChain ? mipLevelCount(dstInfo.width(), dstInfo.height()) : 1;
+		if (levelCount == 1 && !_premultipliedAlpha && srcInfo.width() == dstInfo.width() && srcInfo.height() == dstInfo.height())
+			return copyImage(srcInfo, srcData, dstInfo, dstData, scheduler);
+		const auto dst = static_cast<uint8_t*>(dstData);
+		Buffer levelBuffer;
+		if (!levelBuffer.tryReserve(levelCount * sizeof(Plane), 0))
+			return false;
+		const auto levels = reinterpret_cast<Plane*>(levelBuffer.data());
+		for (uint32_t level = 0; level < levelCount; ++level)
+			new (levels + level) Plane{ mipLevelInfo(dstInfo, level), dst + mipLevelOffset(dstInfo, level) };
+		Pass pass{
+			._src{ srcInfo, static_cast<uint8_t*>(const_cast<void*>(srcData)) },
+			._srcFormat = srcInfo.pixelFormat(),
+			._premultiply = _premultipliedAlpha,
+			._writeFirstLevel = true,
+			._levels = levels,
+			._levelCount = levelCount,
+			._dstFormat = dstInfo.pixelFormat(),
+		};
+		for (;;)
+		{
+			const auto processed = ::runPass(pass, _filter, scheduler);
+			if (!processed)
+				return false;
+			if (processed == pass._levelCount)
+				return true;
+			// Levels which didn't fit in a strip are produced by the next pass from the last level produced.
+			pass._levels += processed - 1;
+			pass._levelCount -= processed - 1;
+			pass._src = pass._levels[0];
+			pass._srcFormat = pass._dstFormat;
+			pass._premultiply = false;
+			pass._writeFirstLevel = false;
+		}
+	}
+}
@@ -0,0 +1,407 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_base/cpu.hpp>
+#include <seir_base/intrinsics.hpp>
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+namespace seir
+{
+	enum class PngStandardFilterType : uint8_t
+	{
+		None = 0,
+		Sub = 1,
+		Up = 2,
+		Average = 3,
+		Paeth = 4,
+	};
+
+	// Paeth predictor which picks the neighbor closest to the linear estimate (a + b - c).
+	constexpr uint8_t pngPaeth(uint8_t a, uint8_t b, uint8_t c) noexcept
+	{
+		const auto pa = std::abs(b - c);
+		const auto pb = std::abs(a - c);
+		const auto pc = std::abs(a + b - 2 * c);
+		return pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+	}
+
+#if SEIR_INTRINSICS_SSE
+	// SSE rounds averages up, so the rounding bit is subtracted afterwards.
+	inline __m128i pngAverage(__m128i a, __m128i b) noexcept
+	{
+		return _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), _mm_set1_epi8(1)));
+	}
+
+	inline __m128i pngPaeth16(__m128i a16, __m128i b16, __m128i c16) noexcept
+	{
+		const auto pa = _mm_abs_epi16(_mm_sub_epi16(b16, c16));
+		const auto pb = _mm_abs_epi16(_mm_sub_epi16(a16, c16));
+		const auto pc = _mm_abs_epi16(_mm_sub_epi16(_mm_add_epi16(a16, b16), _mm_add_epi16(c16, c16)));
+		const auto bOrC = _mm_blendv_epi8(b16, c16, _mm_cmpgt_epi16(pb, pc));
+		return _mm_blendv_epi8(a16, bOrC, _mm_or_si128(_mm_cmpgt_epi16(pa, pb), _mm_cmpgt_epi16(pa, pc)));
+	}
+
+	inline __m128i pngPaeth(__m128i a, __m128i b, __m128i c) noexcept
+	{
+		const auto zero = _mm_setzero_si128();
+		const auto low = pngPaeth16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero));
+		const auto high = pngPaeth16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero), _mm_unpackhi_epi8(c, zero));
+		return _mm_packus_epi16(low, high);
+	}
+#elif SEIR_INTRINSICS_NEON
+	inline uint8x8_t pngPaeth(uint8x8_t a, uint8x8_t b, uint8x8_t c) noexcept
+	{
+		const auto pa = vabdl_u8(b, c);
+		const auto pb = vabdl_u8(a, c);
+		const auto pc = vabdq_u16(vaddl_u8(a, b), vaddl_u8(c, c));
+		const auto bOrC = vbsl_u8(vmovn_u16(vcleq_u16(pb, pc)), b, c);
+		return vbsl_u8(vmovn_u16(vandq_u16(vcleq_u16(pa, pb), vcleq_u16(pa, pc))), a, bOrC);
+	}
+
+	inline uint8x16_t pngPaeth(uint8x16_t a, uint8x16_t b, uint8x16_t c) noexcept
+	{
+		return vcombine_u8(pngPaeth(vget_low_u8(a), vget_low_u8(b), vget_low_u8(c)), pngPaeth(vget_high_u8(a), vget_high_u8(b), vget_high_u8(c)));
+	}
+#endif
+
+	// Reconstructs PNG scanlines filtered with standard filters.
+	// The destination row may start at or before the source row, which allows unfiltering in place.
+	// The vectorized implementation must produce exactly the same results as the scalar one.
+	template <bool kVectorized>
+	class PngUnfilter
+	{
+	public:
+		// Pixel size is the number of bytes the filters look back at (one for sub-byte pixels).
+		explicit PngUnfilter(size_t pixelSize) noexcept
+			: _pixelSize{ pixelSize } {}
+
+		// Returns false if the filter type is invalid.
+		[[nodiscard]] bool operator()(uint8_t filterType, uint8_t* dst, const uint8_t* src, const uint8_t* prev, size_t size) const noexcept
+		{
+			switch (static_cast<PngStandardFilterType>(filterType))
+			{
+			case PngStandardFilterType::None: std::memmove(dst, src, size); return true;
+			case PngStandardFilterType::Sub: unfilterSub(dst, src, size); return true;
+			case PngStandardFilterType::Up: unfilterUp(dst, src, prev, size); return true;
+			case PngStandardFilterType::Average: unfilterAverage(dst, src, prev, size); return true;
+			case PngStandardFilterType::Paeth: unfilterPaeth(dst, src, prev, size); return true;
+			}
+			return false;
+		}
+
+	private:
+		void unfilterSub(uint8_t* dst, const uint8_t* src, size_t size) const noexcept
+		{
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+				switch (_pixelSize)
+				{
+				case 3: return unfilterPixels<3>(dst, src, nullptr, size, [](Pixel a, Pixel, Pixel) { return a; });
+				case 4: return unfilterPixels<4>(dst, src, nullptr, size, [](Pixel a, Pixel, Pixel) { return a; });
+				default: break;
+				}
+#endif
+			}
+			const auto start = _pixelSize < size ? _pixelSize : size;
+			std::memmove(dst, src, start);
+			for (size_t i = start; i < size; ++i)
+				dst[i] = static_cast<uint8_t>(src[i] + dst[i - _pixelSize]);
+		}
+
+		void unfilterUp(uint8_t* dst, const uint8_t* src, const uint8_t* prev, size_t size) const noexcept
+		{
+			size_t i = 0;
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE
+				if (size >= 64 && hasCpuFeature(CpuFeature::Avx2))
+					i = unfilterUpAvx2(dst, src, prev, size);
+				for (; size - i >= 16; i += 16)
+				{
+					const auto sum = _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i)));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), sum);
+				}
+#elif SEIR_INTRINSICS_NEON
+				for (; size - i >= 16; i += 16)
+					vst1q_u8(dst + i, vaddq_u8(vld1q_u8(src + i), vld1q_u8(prev + i)));
+#endif
+			}
+			for (; i < size; ++i)
+				dst[i] = static_cast<uint8_t>(src[i] + prev[i]);
+		}
+
+		void unfilterAverage(uint8_t* dst, const uint8_t* src, const uint8_t* prev, size_t size) const noexcept
+		{
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+				switch (_pixelSize)
+				{
+				case 3: return unfilterPixels<3>(dst, src, prev, size, [](Pixel a, Pixel b, Pixel) { return average(a, b); });
+				case 4: return unfilterPixels<4>(dst, src, prev, size, [](Pixel a, Pixel b, Pixel) { return average(a, b); });
+				default: break;
+				}
+#endif
+			}
+			const auto start = _pixelSize < size ? _pixelSize : size;
+			for (size_t i = 0; i < start; ++i)
+				dst[i] = static_cast<uint8_t>(src[i] + (prev[i] >> 1));
+			for (size_t i = start; i < size; ++i)
+				dst[i] = static_cast<uint8_t>(src[i] + ((dst[i - _pixelSize] + prev[i]) >> 1));
+		}
+
+		void unfilterPaeth(uint8_t* dst, const uint8_t* src, const uint8_t* prev, size_t size) const noexcept
+		{
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+				switch (_pixelSize)
+				{
+				case 3: return unfilterPixels<3>(dst, src, prev, size, [](Pixel a, Pixel b, Pixel c) { return paeth(a, b, c); });
+				case 4: return unfilterPixels<4>(dst, src, prev, size, [](Pixel a, Pixel b, Pixel c) { return paeth(a, b, c); });
+				default: break;
+				}
+#endif
+			}
+			const auto start = _pixelSize < size ? _pixelSize : size;
+			for (size_t i = 0; i < start; ++i)
+				dst[i] = static_cast<uint8_t>(src[i] + prev[i]); // Paeth predictor is the pixel above when there is nothing to the left.
+			for (size_t i = start; i < size; ++i)
+				dst[i] = static_cast<uint8_t>(src[i] + pngPaeth(dst[i - _pixelSize], prev[i], prev[i - _pixelSize]));
+		}
+
+#if SEIR_INTRINSICS_SSE
+		using Pixel = __m128i;
+
+		template <size_t kPixelSize>
+		static Pixel load(const uint8_t* data) noexcept
+		{
+			const auto value = loadValue<kPixelSize>(data);
+			return _mm_cvtsi32_si128(static_cast<int>(value));
+		}
+
+		template <size_t kPixelSize>
+		static void store(uint8_t* data, Pixel pixel) noexcept
+		{
+			storeValue<kPixelSize>(data, static_cast<uint32_t>(_mm_cvtsi128_si32(pixel)));
+		}
+
+		static Pixel add(Pixel a, Pixel b) noexcept { return _mm_add_epi8(a, b); }
+		static Pixel average(Pixel a, Pixel b) noexcept { return pngAverage(a, b); }
+
+		// A pixel occupies only the low half of the register, so the high half isn't computed.
+		static Pixel paeth(Pixel a, Pixel b, Pixel c) noexcept
+		{
+			const auto zero = _mm_setzero_si128();
+			const auto result = pngPaeth16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero), _mm_unpacklo_epi8(c, zero));
+			return _mm_packus_epi16(result, result);
+		}
+
+		SEIR_TARGET("avx2")
+		static size_t unfilterUpAvx2(uint8_t* dst, const uint8_t* src, const uint8_t* prev, size_t size) noexcept
+		{
+			size_t i = 0;
+			for (; size - i >= 32; i += 32)
+			{
+				const auto sum = _mm256_add_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i)), _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + i)));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), sum);
+			}
+			return i;
+		}
+#elif SEIR_INTRINSICS_NEON
+		using Pixel = uint8x8_t;
+
+		template <size_t kPixelSize>
+		static Pixel load(const uint8_t* data) noexcept
+		{
+			const auto value = loadValue<kPixelSize>(data);
+			return vcreate_u8(value);
+		}
+
+		template <size_t kPixelSize>
+		static void store(uint8_t* data, Pixel pixel) noexcept
+		{
+			storeValue<kPixelSize>(data, vget_lane_u32(vreinterpret_u32_u8(pixel), 0));
+		}
+
+		static Pixel add(Pixel a, Pixel b) noexcept { return vadd_u8(a, b); }
+		static Pixel average(Pixel a, Pixel b) noexcept { return vhadd_u8(a, b); }
+		static Pixel paeth(Pixel a, Pixel b, Pixel c) noexcept { return pngPaeth(a, b, c); }
+#endif
+
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+		// Three-byte pixels are assembled in registers since copying them through memory stalls store forwarding.
+		template <size_t kPixelSize>
+		static uint32_t loadValue(const uint8_t* data) noexcept
+		{
+			static_assert(kPixelSize == 3 || kPixelSize == 4);
+			if constexpr (kPixelSize == 4)
+			{
+				uint32_t value;
+				std::memcpy(&value, data, sizeof value);
+				return value;
+			}
+			else
+			{
+				uint16_t value;
+				std::memcpy(&value, data, sizeof value);
+				return value | uint32_t{ data[2] } << 16;
+			}
+		}
+
+		template <size_t kPixelSize>
+		static void storeValue(uint8_t* data, uint32_t value) noexcept
+		{
+			static_assert(kPixelSize == 3 || kPixelSize == 4);
+			if constexpr (kPixelSize == 4)
+				std::memcpy(data, &value, sizeof value);
+			else
+			{
+				const auto low = static_cast<uint16_t>(value);
+				std::memcpy(data, &low, sizeof low);
+				data[2] = static_cast<uint8_t>(value >> 16);
+			}
+		}
+
+		// Unfilters pixels one by one since each one depends on the previous one.
+		// The predictor receives the pixels to the left, above and above-left.
+		template <size_t kPixelSize, typename Predictor>
+		static void unfilterPixels(uint8_t* dst, const uint8_t* src, const uint8_t* prev, size_t size, Predictor&& predictor) noexcept
+		{
+			assert(size % kPixelSize == 0);
+			const auto zero = Pixel{};
+			auto a = zero;
+			auto c = zero;
+			for (size_t i = 0; i < size; i += kPixelSize)
+			{
+				const auto b = prev ? load<kPixelSize>(prev + i) : zero;
+				a = add(load<kPixelSize>(src + i), predictor(a, b, c));
+				store<kPixelSize>(dst + i, a);
+				c = b;
+			}
+		}
+#endif
+
+	private:
+		const size_t _pixelSize;
+	};
+
+	// Filters PNG scanlines with standard filters.
+	// The vectorized implementation must produce exactly the same results as the scalar one.
+	template <bool kVectorized>
+	class PngFilter
+	{
+	public:
+		// Pixel size is the number of bytes the filters look back at (one for sub-byte pixels).
+		explicit PngFilter(size_t pixelSize) noexcept
+			: _pixelSize{ pixelSize } {}
+
+		// The destination row must not overlap the source rows.
+		void operator()(PngStandardFilterType filterType, uint8_t* dst, const uint8_t* src, const uint8_t* prev, size_t size) const noexcept
+		{
+			switch (filterType)
+			{
+			case PngStandardFilterType::None: std::memcpy(dst, src, size); break;
+			case PngStandardFilterType::Sub: filterRow(dst, src, prev, size, [](auto a, auto, auto) { return a; }); break;
+			case PngStandardFilterType::Up: filterRow(dst, src, prev, size, [](auto, auto b, auto) { return b; }); break;
+			case PngStandardFilterType::Average: filterRow(dst, src, prev, size, [](auto a, auto b, auto) { return average(a, b); }); break;
+			case PngStandardFilterType::Paeth: filterRow(dst, src, prev, size, [](auto a, auto b, auto c) { return pngPaeth(a, b, c); }); break;
+			}
+		}
+
+		// Filters the row with every standard filter and selects the one with the least sum of absolute values
+		// of the filtered bytes taken as signed, which is the heuristic recommended by the PNG specification.
+		// The scratch buffer must have space for five rows of (1 + size) bytes.
+		// Returns the selected row which consists of the filter type byte followed by the filtered bytes.
+		const uint8_t* filterAdaptive(uint8_t* scratch, const uint8_t* src, const uint8_t* prev, size_t size) const noexcept
+		{
+			const uint8_t* best = nullptr;
+			size_t bestCost = 0;
+			for (uint8_t filterType = 0; filterType <= static_cast<uint8_t>(PngStandardFilterType::Paeth); ++filterType)
+			{
+				const auto row = scratch + filterType * (1 + size);
+				row[0] = filterType;
+				(*this)(static_cast<PngStandardFilterType>(filterType), row + 1, src, prev, size);
+				if (const auto rowCost = cost(row + 1, size); !best || rowCost < bestCost)
+				{
+					best = row;
+					bestCost = rowCost;
+				}
+			}
+			return best;
+		}
+
+	private:
+		static constexpr uint8_t average(uint8_t a, uint8_t b) noexcept { return static_cast<uint8_t>((a + b) >> 1); }
+
+		static size_t cost(const uint8_t* data, size_t size) noexcept
+		{
+			size_t result = 0;
+			size_t i = 0;
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE
+				auto sums = _mm_setzero_si128();
+				for (; size - i >= 16; i += 16)
+					sums = _mm_add_epi64(sums, _mm_sad_epu8(_mm_abs_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i))), _mm_setzero_si128()));
+				result = static_cast<uint32_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(static_cast<uint32_t>(_mm_extract_epi32(sums, 2)));
+#elif SEIR_INTRINSICS_NEON
+				auto sums = vdupq_n_u32(0);
+				for (; size - i >= 16; i += 16)
+					sums = vpadalq_u16(sums, vpaddlq_u8(vreinterpretq_u8_s8(vabsq_s8(vreinterpretq_s8_u8(vld1q_u8(data + i))))));
+				result = vaddvq_u32(sums);
+#endif
+			}
+			for (; i < size; ++i)
+				result += static_cast<size_t>(std::abs(static_cast<int8_t>(data[i])));
+			return result;
+		}
+
+#if SEIR_INTRINSICS_SSE
+		static __m128i average(__m128i a, __m128i b) noexcept { return pngAverage(a, b); }
+#elif SEIR_INTRINSICS_NEON
+		static uint8x16_t average(uint8x16_t a, uint8x16_t b) noexcept { return vhaddq_u8(a, b); }
+#endif
+
+		// Subtracts predictions from the bytes. Since the source bytes are known in advance,
+		// the predictions are independent and can be computed for many bytes at once.
+		// The predictor receives the bytes to the left, above and above-left.
+		template <typename Predictor>
+		void filterRow(uint8_t* dst, const uint8_t* src, const uint8_t* prev, size_t size, Predictor&& predictor) const noexcept
+		{
+			const auto start = _pixelSize < size ? _pixelSize : size;
+			for (size_t i = 0; i < start; ++i)
+				dst[i] = static_cast<uint8_t>(src[i] - predictor(uint8_t{ 0 }, prev[i], uint8_t{ 0 }));
+			auto i = start;
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE
+				for (; size - i >= 16; i += 16)
+				{
+					const auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i - _pixelSize));
+					const auto b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i));
+					const auto c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(prev + i - _pixelSize));
+					const auto x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_sub_epi8(x, predictor(a, b, c)));
+				}
+#elif SEIR_INTRINSICS_NEON
+				for (; size - i >= 16; i += 16)
+					vst1q_u8(dst + i, vsubq_u8(vld1q_u8(src + i), predictor(vld1q_u8(src + i - _pixelSize), vld1q_u8(prev + i), vld1q_u8(prev + i - _pixelSize))));
+#endif
+			}
+			for (; i < size; ++i)
+				dst[i] = static_cast<uint8_t>(src[i] - predictor(src[i - _pixelSize], prev[i], prev[i - _pixelSize]));
+		}
+
+	private:
+		const size_t _pixelSize;
+	};
+}
@@ -4,144 +4,390 @@
 
 #include <seir_image/utils.hpp>
 
+#include <seir_base/cpu.hpp>
+#include <seir_base/intrinsics.hpp>
+#include <seir_base/task_scheduler.hpp>
 #include <seir_image/image.hpp>
+#include "bcn.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cstring>
 
 namespace
 {
-	void copyImage_rgb24_bgr24(size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride) noexcept
+	// Each conversion is described by a function which converts a single pixel,
+	// a shuffle which converts a 16-byte block of destination pixels with SSSE3/AVX2,
+	// and a function which converts 16 pixels with NEON structure loads and stores.
+	// Shuffle indices with the high bit set denote bytes taken from the alpha value.
+
+	struct Rgb24ToBgr24
 	{
-		const auto dst_row_size = width * 3;
-		for (auto y = height; y > 0; --y)
+		static constexpr size_t kSrcPixelSize = 3;
+		static constexpr size_t kDstPixelSize = 3;
+		static constexpr uint8_t kAlpha = 0;
+		static constexpr std::array<uint8_t, 16> kShuffle{ 2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 0x80 };
+
+		static void convertPixel(uint8_t* dst, const uint8_t* src) noexcept
 		{
-			for (size_t a = 0, b = 0; a < dst_row_size; a += 3, b += 3)
-			{
-				dst[a + 0] = src[b + 2];
-				dst[a + 1] = src[b + 1];
-				dst[a + 2] = src[b + 0];
-			}
-			src += srcStride;
-			dst += dstStride;
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
 		}
-	}
 
-	void copyImage_rgb24_bgra32(size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride) noexcept
+#if SEIR_INTRINSICS_NEON
+		static void convertBlock(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			const auto rgb = vld3q_u8(src);
+			vst3q_u8(dst, uint8x16x3_t{ { rgb.val[2], rgb.val[1], rgb.val[0] } });
+		}
+#endif
+	};
+
+	struct Rgb24ToBgra32
 	{
-		const auto dstRowSize = width * 4;
-		for (auto y = height; y > 0; --y)
+		static constexpr size_t kSrcPixelSize = 3;
+		static constexpr size_t kDstPixelSize = 4;
+		static constexpr uint8_t kAlpha = 0xff;
+		static constexpr std::array<uint8_t, 16> kShuffle{ 2, 1, 0, 0x80, 5, 4, 3, 0x80, 8, 7, 6, 0x80, 11, 10, 9, 0x80 };
+
+		static void convertPixel(uint8_t* dst, const uint8_t* src) noexcept
 		{
-			for (size_t a = 0, b = 0; a < dstRowSize; a += 4, b += 3)
-			{
-				dst[a + 0] = src[b + 2];
-				dst[a + 1] = src[b + 1];
-				dst[a + 2] = src[b + 0];
-				dst[a + 3] = 0xff;
-			}
-			src += srcStride;
-			dst += dstStride;
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			dst[3] = 0xff;
 		}
-	}
 
-	void copyImage_rgb24_rgba32(size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride) noexcept
+#if SEIR_INTRINSICS_NEON
+		static void convertBlock(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			const auto rgb = vld3q_u8(src);
+			vst4q_u8(dst, uint8x16x4_t{ { rgb.val[2], rgb.val[1], rgb.val[0], vdupq_n_u8(0xff) } });
+		}
+#endif
+	};
+
+	struct Rgb24ToRgba32
 	{
-		const auto dstRowSize = width * 4;
-		for (auto y = height; y > 0; --y)
+		static constexpr size_t kSrcPixelSize = 3;
+		static constexpr size_t kDstPixelSize = 4;
+		static constexpr uint8_t kAlpha = 0xff;
+		static constexpr std::array<uint8_t, 16> kShuffle{ 0, 1, 2, 0x80, 3, 4, 5, 0x80, 6, 7, 8, 0x80, 9, 10, 11, 0x80 };
+
+		static void convertPixel(uint8_t* dst, const uint8_t* src) noexcept
 		{
-			for (size_t a = 0, b = 0; a < dstRowSize; a += 4, b += 3)
-			{
-				dst[a + 0] = src[b + 0];
-				dst[a + 1] = src[b + 1];
-				dst[a + 2] = src[b + 2];
-				dst[a + 3] = 0xff;
-			}
-			src += srcStride;
-			dst += dstStride;
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			dst[3] = 0xff;
 		}
-	}
 
-	void copyImage_rgba32_bgra32(size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride) noexcept
+#if SEIR_INTRINSICS_NEON
+		static void convertBlock(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			const auto rgb = vld3q_u8(src);
+			vst4q_u8(dst, uint8x16x4_t{ { rgb.val[0], rgb.val[1], rgb.val[2], vdupq_n_u8(0xff) } });
+		}
+#endif
+	};
+
+	struct Rgba32ToBgra32
 	{
-		const auto dstRowSize = width * 4;
-		for (auto y = height; y > 0; --y)
+		static constexpr size_t kSrcPixelSize = 4;
+		static constexpr size_t kDstPixelSize = 4;
+		static constexpr uint8_t kAlpha = 0;
+		static constexpr std::array<uint8_t, 16> kShuffle{ 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15 };
+
+		static void convertPixel(uint8_t* dst, const uint8_t* src) noexcept
 		{
-			for (size_t a = 0, b = 0; a < dstRowSize; a += 4, b += 4)
-			{
-				dst[a + 0] = src[b + 2];
-				dst[a + 1] = src[b + 1];
-				dst[a + 2] = src[b + 0];
-				dst[a + 3] = src[b + 3];
-			}
-			src += srcStride;
-			dst += dstStride;
+			dst[0] = src[2];
+			dst[1] = src[1];
+			dst[2] = src[0];
+			dst[3] = src[3];
+		}
+
+#if SEIR_INTRINSICS_NEON
+		static void convertBlock(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			const auto rgba = vld4q_u8(src);
+			vst4q_u8(dst, uint8x16x4_t{ { rgba.val[2], rgba.val[1], rgba.val[0], rgba.val[3] } });
+		}
+#endif
+	};
+
+	struct X8ToXxxa32
+	{
+		static constexpr size_t kSrcPixelSize = 1;
+		static constexpr size_t kDstPixelSize = 4;
+		static constexpr uint8_t kAlpha = 0xff;
+		static constexpr std::array<uint8_t, 16> kShuffle{ 0, 0, 0, 0x80, 1, 1, 1, 0x80, 2, 2, 2, 0x80, 3, 3, 3, 0x80 };
+
+		static void convertPixel(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			dst[0] = src[0];
+			dst[1] = src[0];
+			dst[2] = src[0];
+			dst[3] = 0xff;
+		}
+
+#if SEIR_INTRINSICS_NEON
+		static void convertBlock(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			const auto x = vld1q_u8(src);
+			vst4q_u8(dst, uint8x16x4_t{ { x, x, x, vdupq_n_u8(0xff) } });
+		}
+#endif
+	};
+
+	struct X8ToXxxx32
+	{
+		static constexpr size_t kSrcPixelSize = 1;
+		static constexpr size_t kDstPixelSize = 4;
+		static constexpr uint8_t kAlpha = 0;
+		static constexpr std::array<uint8_t, 16> kShuffle{ 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3 };
+
+		static void convertPixel(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			dst[0] = src[0];
+			dst[1] = src[0];
+			dst[2] = src[0];
+			dst[3] = src[0];
+		}
+
+#if SEIR_INTRINSICS_NEON
+		static void convertBlock(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			const auto x = vld1q_u8(src);
+			vst4q_u8(dst, uint8x16x4_t{ { x, x, x, x } });
+		}
+#endif
+	};
+
+	struct Xa16ToXxxa32
+	{
+		static constexpr size_t kSrcPixelSize = 2;
+		static constexpr size_t kDstPixelSize = 4;
+		static constexpr uint8_t kAlpha = 0;
+		static constexpr std::array<uint8_t, 16> kShuffle{ 0, 0, 0, 1, 2, 2, 2, 3, 4, 4, 4, 5, 6, 6, 6, 7 };
+
+		static void convertPixel(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			dst[0] = src[0];
+			dst[1] = src[0];
+			dst[2] = src[0];
+			dst[3] = src[1];
+		}
+
+#if SEIR_INTRINSICS_NEON
+		static void convertBlock(uint8_t* dst, const uint8_t* src) noexcept
+		{
+			const auto xa = vld2q_u8(src);
+			vst4q_u8(dst, uint8x16x4_t{ { xa.val[0], xa.val[0], xa.val[0], xa.val[1] } });
 		}
+#endif
+	};
+
+	template <class Conversion>
+	void convertPixels(uint8_t* dst, const uint8_t* src, size_t width) noexcept
+	{
+		for (; width > 0; --width, dst += Conversion::kDstPixelSize, src += Conversion::kSrcPixelSize)
+			Conversion::convertPixel(dst, src);
 	}
 
-	void copyImage_x8_x8(size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride) noexcept
+#if SEIR_INTRINSICS_SSE
+	// Every 16-byte load of source pixels produces one or more 16-byte groups of destination pixels.
+	// Loads and stores may go past the pixels of a block, so blocks are converted
+	// only while there are enough pixels left in the row to keep them in bounds.
+	template <class Conversion>
+	struct ShuffleLayout
 	{
-		for (auto y = height; y > 0; --y)
+		static constexpr size_t kGroupPixels = 16 / Conversion::kDstPixelSize;
+		static constexpr size_t kGroupSrcSize = kGroupPixels * Conversion::kSrcPixelSize;
+		static constexpr size_t kGroups = 16 / kGroupSrcSize;
+		static constexpr size_t kBlockPixels = kGroups * kGroupPixels;
+		static constexpr size_t kSafePixels = std::max((16 + Conversion::kSrcPixelSize - 1) / Conversion::kSrcPixelSize,
+			((kGroups - 1) * 16 + 16 + Conversion::kDstPixelSize - 1) / Conversion::kDstPixelSize);
+
+		static __m128i groupShuffle(size_t group) noexcept
+		{
+			// Offsetting indices with the high bit set keeps it set.
+			return _mm_add_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(Conversion::kShuffle.data())), _mm_set1_epi8(static_cast<char>(group * kGroupSrcSize)));
+		}
+	};
+
+	template <class Conversion>
+	size_t convertPixelsSsse3(uint8_t* dst, const uint8_t* src, size_t width) noexcept
+	{
+		using Layout = ShuffleLayout<Conversion>;
+		__m128i shuffles[Layout::kGroups]; // NOLINT(*-avoid-c-arrays)
+		for (size_t i = 0; i < Layout::kGroups; ++i)
+			shuffles[i] = Layout::groupShuffle(i);
+		const auto alpha = _mm_set1_epi32(static_cast<int>(uint32_t{ Conversion::kAlpha } << 24));
+		size_t x = 0;
+		for (; x + Layout::kSafePixels <= width; x += Layout::kBlockPixels)
 		{
-			std::memcpy(dst, src, width);
-			src += srcStride;
-			dst += dstStride;
+			const auto pixels = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * Conversion::kSrcPixelSize));
+			for (size_t i = 0; i < Layout::kGroups; ++i)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * Conversion::kDstPixelSize + i * 16), _mm_or_si128(_mm_shuffle_epi8(pixels, shuffles[i]), alpha));
 		}
+		return x;
 	}
 
-	void copyImage_x8_xxxa32(size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride) noexcept
+	// Loads with multiple groups are broadcast into both lanes and each lane produces its own group.
+	// Otherwise, each lane converts a separate block.
+	template <class Conversion>
+	SEIR_TARGET("avx2")
+	size_t convertPixelsAvx2(uint8_t* dst, const uint8_t* src, size_t width) noexcept
 	{
-		const auto dstRowSize = width * 4;
-		for (auto y = height; y > 0; --y)
+		using Layout = ShuffleLayout<Conversion>;
+		const auto alpha = _mm256_set1_epi32(static_cast<int>(uint32_t{ Conversion::kAlpha } << 24));
+		size_t x = 0;
+		if constexpr (Layout::kGroups > 1)
+		{
+			constexpr auto kShuffles = Layout::kGroups / 2;
+			__m256i shuffles[kShuffles]; // NOLINT(*-avoid-c-arrays)
+			for (size_t i = 0; i < kShuffles; ++i)
+				shuffles[i] = _mm256_setr_m128i(Layout::groupShuffle(2 * i), Layout::groupShuffle(2 * i + 1));
+			for (; x + Layout::kSafePixels <= width; x += Layout::kBlockPixels)
+			{
+				const auto pixels = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + x * Conversion::kSrcPixelSize)));
+				for (size_t i = 0; i < kShuffles; ++i)
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + x * Conversion::kDstPixelSize + i * 32), _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffles[i]), alpha));
+			}
+		}
+		else
 		{
-			for (size_t a = 0, b = 0; a < dstRowSize; a += 4, ++b)
+			constexpr auto kLaneSrcOffset = Layout::kGroupPixels * Conversion::kSrcPixelSize;
+			constexpr auto kLaneDstOffset = Layout::kGroupPixels * Conversion::kDstPixelSize;
+			const auto shuffle = _mm256_broadcastsi128_si256(Layout::groupShuffle(0));
+			for (; x + Layout::kGroupPixels + Layout::kSafePixels <= width; x += 2 * Layout::kGroupPixels)
 			{
-				dst[a + 0] = src[b + 0];
-				dst[a + 1] = src[b + 0];
-				dst[a + 2] = src[b + 0];
-				dst[a + 3] = 0xff;
+				const auto srcBlock = src + x * Conversion::kSrcPixelSize;
+				const auto pixels = _mm256_loadu2_m128i(reinterpret_cast<const __m128i*>(srcBlock + kLaneSrcOffset), reinterpret_cast<const __m128i*>(srcBlock));
+				const auto result = _mm256_or_si256(_mm256_shuffle_epi8(pixels, shuffle), alpha);
+				const auto dstBlock = dst + x * Conversion::kDstPixelSize;
+				if constexpr (kLaneDstOffset == 16)
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(dstBlock), result);
+				else
+				{
+					// The padding byte of the first lane is overwritten by the second lane.
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dstBlock), _mm256_castsi256_si128(result));
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dstBlock + kLaneDstOffset), _mm256_extracti128_si256(result, 1));
+				}
 			}
-			src += srcStride;
-			dst += dstStride;
 		}
+		return x;
+	}
+#elif SEIR_INTRINSICS_NEON
+	template <class Conversion>
+	size_t convertPixelsNeon(uint8_t* dst, const uint8_t* src, size_t width) noexcept
+	{
+		size_t x = 0;
+		for (; x + 16 <= width; x += 16)
+			Conversion::convertBlock(dst + x * Conversion::kDstPixelSize, src + x * Conversion::kSrcPixelSize);
+		return x;
+	}
+#endif
+
+	using RowConverter = void (*)(uint8_t* dst, const uint8_t* src, size_t width) noexcept;
+
+	template <class Conversion>
+	RowConverter selectRowConverter() noexcept
+	{
+#if SEIR_INTRINSICS_SSE
+		if (seir::hasCpuFeature(seir::CpuFeature::Avx2))
+			return [](uint8_t* dst, const uint8_t* src, size_t width) noexcept {
+				const auto x = ::convertPixelsAvx2<Conversion>(dst, src, width);
+				::convertPixels<Conversion>(dst + x * Conversion::kDstPixelSize, src + x * Conversion::kSrcPixelSize, width - x);
+			};
+		return [](uint8_t* dst, const uint8_t* src, size_t width) noexcept {
+			const auto x = ::convertPixelsSsse3<Conversion>(dst, src, width);
+			::convertPixels<Conversion>(dst + x * Conversion::kDstPixelSize, src + x * Conversion::kSrcPixelSize, width - x);
+		};
+#elif SEIR_INTRINSICS_NEON
+		return [](uint8_t* dst, const uint8_t* src, size_t width) noexcept {
+			const auto x = ::convertPixelsNeon<Conversion>(dst, src, width);
+			::convertPixels<Conversion>(dst + x * Conversion::kDstPixelSize, src + x * Conversion::kSrcPixelSize, width - x);
+		};
+#else
+		return ::convertPixels<Conversion>;
+#endif
 	}
 
-	void copyImage_x8_xxxx32(size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride) noexcept
+	void copyBytes(uint8_t* dst, const uint8_t* src, size_t size) noexcept
 	{
-		const auto dstRowSize = width * 4;
-		for (auto y = height; y > 0; --y)
-		{
-			for (size_t a = 0, b = 0; a < dstRowSize; a += 4, ++b)
+		std::memcpy(dst, src, size);
+	}
+
+	// Large images are split into bands of rows which are converted in parallel.
+	template <class F>
+	void processBands(size_t height, size_t dstRowSize, seir::TaskScheduler* scheduler, F&& processRows) noexcept
+	{
+		constexpr size_t kBandSize = 256 * 1024;
+		const auto bandRows = std::clamp<size_t>(kBandSize / std::max<size_t>(dstRowSize, 1), 1, height);
+		const auto processBand = [&](size_t band) {
+			const auto first = band * bandRows;
+			processRows(first, std::min(bandRows, height - first));
+		};
+		const auto bandCount = (height + bandRows - 1) / bandRows;
+		if (scheduler && scheduler->workerCount() > 0 && bandCount > 1)
+			scheduler->parallelFor(0, bandCount, 1, processBand);
+		else
+			for (size_t band = 0; band < bandCount; ++band)
+				processBand(band);
+	}
+
+	void convertRows(RowConverter converter, size_t width, size_t dstRowSize, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride, seir::TaskScheduler* scheduler) noexcept
+	{
+		::processBands(height, dstRowSize, scheduler, [&](size_t first, size_t count) {
+			auto srcRow = src + static_cast<ptrdiff_t>(first) * srcStride;
+			auto dstRow = dst + static_cast<ptrdiff_t>(first) * dstStride;
+			for (; count > 0; --count)
 			{
-				dst[a + 0] = src[b + 0];
-				dst[a + 1] = src[b + 0];
-				dst[a + 2] = src[b + 0];
-				dst[a + 3] = src[b + 0];
+				converter(dstRow, srcRow, width);
+				srcRow += srcStride;
+				dstRow += dstStride;
 			}
-			src += srcStride;
-			dst += dstStride;
-		}
+		});
 	}
 
-	void copyImage_xa16_xxxa32(size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride) noexcept
+	// Decodes rows of blocks into RGBA or BGRA pixels, clipping blocks at the right and bottom edges.
+	void decodeBlocks(seir::PixelFormat format, bool bgra, size_t width, size_t height, const uint8_t* src, ptrdiff_t srcStride, uint8_t* dst, ptrdiff_t dstStride, seir::TaskScheduler* scheduler) noexcept
 	{
-		const auto dstRowSize = width * 4;
-		for (auto y = height; y > 0; --y)
-		{
-			for (size_t a = 0, b = 0; a < dstRowSize; a += 4, b += 2)
+		const auto blockSize = seir::blockSize(format);
+		const auto red = bgra ? 2u : 0u;
+		::processBands((height + 3) / 4, width * 16, scheduler, [&](size_t first, size_t count) {
+			for (auto blockY = first; blockY < first + count; ++blockY)
 			{
-				dst[a + 0] = src[b + 0];
-				dst[a + 1] = src[b + 0];
-				dst[a + 2] = src[b + 0];
-				dst[a + 3] = src[b + 1];
+				const auto rows = std::min<size_t>(4, height - blockY * 4);
+				auto block = src + static_cast<ptrdiff_t>(blockY) * srcStride;
+				for (size_t x = 0; x < width; x += 4, block += blockSize)
+				{
+					seir::BcPixels blockPixels{};
+					seir::bcDecodeBlock(blockPixels, format, block);
+					const auto columns = std::min<size_t>(4, width - x);
+					for (size_t row = 0; row < rows; ++row)
+					{
+						auto pixel = dst + static_cast<ptrdiff_t>(blockY * 4 + row) * dstStride + static_cast<ptrdiff_t>(x * 4);
+						for (size_t column = 0; column < columns; ++column, pixel += 4)
+						{
+							const auto& value = blockPixels[row * 4 + column];
+							pixel[red] = value[0];
+							pixel[1] = value[1];
+							pixel[2 - red] = value[2];
+							pixel[3] = value[3];
+						}
+					}
+				}
 			}
-			src += srcStride;
-			dst += dstStride;
-		}
+		});
 	}
 }
 
 namespace seir
 {
-	bool copyImage(const ImageInfo& srcInfo, const void* srcData, const ImageInfo& dstInfo, void* dstData) noexcept
+	bool copyImage(const ImageInfo& srcInfo, const void* srcData, const ImageInfo& dstInfo, void* dstData, TaskScheduler* scheduler) noexcept
 	{
 		const auto width = srcInfo.width();
 		const auto height = srcInfo.height();
@@ -156,83 +402,101 @@ namespace seir
 		auto dstStride = static_cast<ptrdiff_t>(dstInfo.stride());
 		const auto dstFormat = dstInfo.pixelFormat();
 
+		if (isBlockCompressed(srcFormat) && srcFormat == dstFormat)
+		{
+			// Blocks can't be flipped without decoding them.
+			if (srcInfo.axes() != dstInfo.axes())
+				return false;
+			const auto dstRowSize = rowSize(dstFormat, width);
+			::convertRows(::copyBytes, dstRowSize, dstRowSize, (height + 3) / 4, src, srcStride, dst, dstStride, scheduler);
+			return true;
+		}
+
 		if (srcInfo.axes() != dstInfo.axes())
 		{
 			dst += static_cast<ptrdiff_t>(height - 1) * dstStride;
 			dstStride = -dstStride;
 		}
 
+		if (isBlockCompressed(srcFormat) || isBlockCompressed(dstFormat))
+		{
+			if (!bcCanDecode(srcFormat) || (dstFormat != PixelFormat::Rgba32 && dstFormat != PixelFormat::Bgra32))
+				return false;
+			::decodeBlocks(srcFormat, dstFormat == PixelFormat::Bgra32, width, height, src, srcStride, dst, dstStride, scheduler);
+			return true;
+		}
+
+		const auto dstRowSize = size_t{ width } * pixelSize(dstFormat);
 		if (srcFormat == dstFormat)
 		{
-			::copyImage_x8_x8(size_t{ width } * pixelSize(dstFormat), height, src, srcStride, dst, dstStride);
+			::convertRows(::copyBytes, dstRowSize, dstRowSize, height, src, srcStride, dst, dstStride, scheduler);
 			return true;
 		}
 
+		RowConverter converter = nullptr;
 		switch (srcFormat)
 		{
 		case PixelFormat::Gray8:
 			if (dstFormat == PixelFormat::Bgra32 || dstFormat == PixelFormat::Rgba32)
-				::copyImage_x8_xxxa32(width, height, src, srcStride, dst, dstStride);
-			else
-				break;
-			return true;
+				converter = ::selectRowConverter<X8ToXxxa32>();
+			break;
 
 		case PixelFormat::Intensity8:
 			if (dstFormat == PixelFormat::Bgra32 || dstFormat == PixelFormat::Rgba32)
-				::copyImage_x8_xxxx32(width, height, src, srcStride, dst, dstStride);
-			else
-				break;
-			return true;
+				converter = ::selectRowConverter<X8ToXxxx32>();
+			break;
 
 		case PixelFormat::GrayAlpha16:
 			if (dstFormat == PixelFormat::Bgra32 || dstFormat == PixelFormat::Rgba32)
-				::copyImage_xa16_xxxa32(width, height, src, srcStride, dst, dstStride);
-			else
-				break;
-			return true;
+				converter = ::selectRowConverter<Xa16ToXxxa32>();
+			break;
 
 		case PixelFormat::Rgb24:
 			if (dstFormat == PixelFormat::Bgr24)
-				::copyImage_rgb24_bgr24(width, height, src, srcStride, dst, dstStride);
+				converter = ::selectRowConverter<Rgb24ToBgr24>();
 			else if (dstFormat == PixelFormat::Rgba32)
-				::copyImage_rgb24_rgba32(width, height, src, srcStride, dst, dstStride);
+				converter = ::selectRowConverter<Rgb24ToRgba32>();
 			else if (dstFormat == PixelFormat::Bgra32)
-				::copyImage_rgb24_bgra32(width, height, src, srcStride, dst, dstStride);
-			else
-				break;
-			return true;
+				converter = ::selectRowConverter<Rgb24ToBgra32>();
+			break;
 
 		case PixelFormat::Bgr24:
 			if (dstFormat == PixelFormat::Rgb24)
-				::copyImage_rgb24_bgr24(width, height, src, srcStride, dst, dstStride);
+				converter = ::selectRowConverter<Rgb24ToBgr24>();
 			else if (dstFormat == PixelFormat::Rgba32)
-				::copyImage_rgb24_bgra32(width, height, src, srcStride, dst, dstStride);
+				converter = ::selectRowConverter<Rgb24ToBgra32>();
 			else if (dstFormat == PixelFormat::Bgra32)
-				::copyImage_rgb24_rgba32(width, height, src, srcStride, dst, dstStride);
-			else
-				break;
-			return true;
+				converter = ::selectRowConverter<Rgb24ToRgba32>();
+			break;
 
 		case PixelFormat::Rgba32:
 			if (dstFormat == PixelFormat::Bgra32)
-				::copyImage_rgba32_bgra32(width, height, src, srcStride, dst, dstStride);
-			else
-				break;
-			return true;
+				converter = ::selectRowConverter<Rgba32ToBgra32>();
+			break;
 
 		case PixelFormat::Bgra32:
 			if (dstFormat == PixelFormat::Rgba32)
-				::copyImage_rgba32_bgra32(width, height, src, srcStride, dst, dstStride);
-			else
-				break;
-			return true;
+				converter = ::selectRowConverter<Rgba32ToBgra32>();
+			break;
+
+		case PixelFormat::Bc1:
+		case PixelFormat::Bc2:
+		case PixelFormat::Bc3:
+		case PixelFormat::Bc4:
+		case PixelFormat::Bc5:
+		case PixelFormat::Bc6h:
+		case PixelFormat::Bc7:
+			break;
 		}
+		if (!converter)
+			return false;
 
-		return false;
+		::convertRows(converter, width, dstRowSize, height, src, srcStride, dst, dstStride, scheduler);
+		return true;
 	}
 
-	bool copyImage(const Image& src, const ImageInfo& dstInfo, void* dstData) noexcept
+	bool copyImage(const Image& src, const ImageInfo& dstInfo, void* dstData, TaskScheduler* scheduler) noexcept
 	{
-		return copyImage(src.info(), src.data(), dstInfo, dstData);
+		return copyImage(src.info(), src.data(), dstInfo, dstData, scheduler);
 	}
 }
@@ -4,10 +4,18 @@
 
 #include "image.hpp"
 
+#include <seir_base/endian.hpp>
+#include <seir_base/task_scheduler.hpp>
+#include <seir_image/utils.hpp>
 #include <seir_io/blob.hpp>
+#include <seir_io/buffer_blob.hpp>
 #include <seir_io/writer.hpp>
 #include <seir_io/buffer_writer.hpp>
 
+#include <array>
+#include <random>
+#include <vector>
+
 #include <doctest/doctest.h>
 
 namespace
@@ -29,6 +37,16 @@ namespace
 		return std::move(*image);
 	}
 
+#if SEIR_IMAGE_PNG
+	seir::Image convertImage(const seir::Image& image, seir::PixelFormat pixelFormat)
+	{
+		const seir::ImageInfo info{ image.info().width(), image.info().height(), pixelFormat };
+		seir::Buffer buffer{ info.frameSize() };
+		REQUIRE(seir::copyImage(image, info, buffer.data()));
+		return { info, std::move(buffer) };
+	}
+#endif
+
 	seir::Image makeColorImage(bool withAlpha, seir::ImageAxes axes, bool padding = false)
 	{
 		constexpr uint32_t width = 16;
@@ -76,6 +94,22 @@ namespace
 		return { { width, height, stride, withAlpha ? seir::PixelFormat::Bgra32 : seir::PixelFormat::Bgr24, axes }, std::move(buffer) };
 	}
 
+#if SEIR_IMAGE_PNG
+	// An image large enough to be split into multiple parts when encoded in parallel.
+	seir::Image makeNoisyImage(uint32_t width, uint32_t height, seir::PixelFormat pixelFormat, seir::ImageAxes axes)
+	{
+		const seir::ImageInfo info{ width, height, pixelFormat, axes };
+		seir::Buffer buffer{ info.frameSize() };
+		std::minstd_rand random{ 1 };
+		auto data = reinterpret_cast<uint8_t*>(buffer.data());
+		for (uint32_t y = 0; y < height; ++y)
+			for (uint32_t x = 0; x < width; ++x)
+				for (uint32_t i = 0; i < info.pixelSize(); ++i)
+					*data++ = static_cast<uint8_t>((x + y) * (i + 1) + random() % 4);
+		return { info, std::move(buffer) };
+	}
+#endif
+
 	seir::Image makeGrayscaleImage(seir::ImageAxes axes, bool padding = false)
 	{
 		constexpr uint32_t width = 32;
@@ -115,6 +149,57 @@ TEST_CASE("DDS")
 	const auto image = ::loadImage("bgra32.dds");
 	CHECK(image == ::makeColorImage(true, seir::ImageAxes::XRightYDown));
 }
+
+TEST_CASE("DDS (block-compressed)")
+{
+	const auto makeDds = [](uint32_t width, uint32_t height, uint32_t mipmapCount, uint32_t fourcc, uint32_t dxgiFormat, size_t dataSize) {
+		std::vector<uint32_t> header(32);
+		header[0] = seir::makeCC('D', 'D', 'S', ' ');
+		header[1] = 124;                                                     // Header size.
+		header[2] = 0x1 | 0x2 | 0x4 | 0x1000 | (mipmapCount ? 0x20000 : 0); // CAPS | HEIGHT | WIDTH | PIXELFORMAT [| MIPMAPCOUNT]
+		header[3] = height;
+		header[4] = width;
+		header[7] = mipmapCount;
+		header[19] = 32;  // Pixel format size.
+		header[20] = 0x4; // FOURCC
+		header[21] = fourcc;
+		header[27] = 0x1000 | (mipmapCount ? 0x400008 : 0); // TEXTURE [| MIPMAP | COMPLEX]
+		if (dxgiFormat)
+			header.insert(header.end(), { dxgiFormat, 3, 0, 1, 0 }); // Format, TEXTURE2D, no flags, single image.
+		std::vector<uint8_t> file(header.size() * sizeof(uint32_t) + dataSize);
+		std::memcpy(file.data(), header.data(), header.size() * sizeof(uint32_t));
+		for (size_t i = header.size() * sizeof(uint32_t); i < file.size(); ++i)
+			file[i] = static_cast<uint8_t>(i);
+		return file;
+	};
+	const auto load = [](const std::vector<uint8_t>& file) { return seir::Image::load(seir::Blob::from(file.data(), file.size())); };
+	SUBCASE("DXT1")
+	{
+		const auto file = makeDds(8, 8, 4, seir::makeCC('D', 'X', 'T', '1'), 0, 32 + 8 + 8 + 8);
+		const auto image = load(file);
+		REQUIRE(image);
+		CHECK(image->info().width() == 8);
+		CHECK(image->info().height() == 8);
+		CHECK(image->info().stride() == 16);
+		CHECK(image->info().pixelFormat() == seir::PixelFormat::Bc1);
+		CHECK(image->info().frameSize() == 32);
+		CHECK(image->mipLevelCount() == 4);
+		CHECK(std::memcmp(image->data(), file.data() + 128, 56) == 0);
+		CHECK_FALSE(load(makeDds(8, 8, 4, seir::makeCC('D', 'X', 'T', '1'), 0, 55)));
+		CHECK_FALSE(load(makeDds(8, 8, 5, seir::makeCC('D', 'X', 'T', '1'), 0, 64)));
+	}
+	SUBCASE("DX10")
+	{
+		const auto file = makeDds(5, 3, 0, seir::makeCC('D', 'X', '1', '0'), 98, 32); // DXGI_FORMAT_BC7_UNORM
+		const auto image = load(file);
+		REQUIRE(image);
+		CHECK(image->info().stride() == 32);
+		CHECK(image->info().pixelFormat() == seir::PixelFormat::Bc7);
+		CHECK(image->mipLevelCount() == 1);
+		CHECK(std::memcmp(image->data(), file.data() + 148, 32) == 0);
+		CHECK_FALSE(load(makeDds(5, 3, 0, seir::makeCC('D', 'X', '1', '0'), 2, 32))); // DXGI_FORMAT_R32G32B32A32_FLOAT
+	}
+}
 #endif
 
 #if SEIR_IMAGE_ICO
@@ -204,9 +289,52 @@ TEST_CASE("PNG")
 {
 	SUBCASE("load")
 	{
-		auto blob = seir::Blob::from(SEIR_TEST_DIR "rgb24.png");
-		REQUIRE(blob);
-		CHECK_FALSE(static_cast<bool>(seir::Image::load(blob)));
+		SUBCASE("Gray8")
+		{
+			const auto image = ::loadImage("gray8_filters.png");
+			CHECK(image == ::makeGrayscaleImage(seir::ImageAxes::XRightYDown));
+		}
+		SUBCASE("Rgb24")
+		{
+			const auto image = ::loadImage("rgb24.png");
+			CHECK(image == ::convertImage(::makeColorImage(false, seir::ImageAxes::XRightYDown), seir::PixelFormat::Rgb24));
+		}
+		SUBCASE("Rgba32")
+		{
+			const auto image = ::loadImage("rgba32_filters.png");
+			CHECK(image == ::convertImage(::makeColorImage(true, seir::ImageAxes::XRightYDown), seir::PixelFormat::Rgba32));
+		}
+		SUBCASE("Indexed")
+		{
+			const auto image = ::loadImage("indexed4_filters.png");
+			REQUIRE(image.info() == seir::ImageInfo{ 16, 16, seir::PixelFormat::Rgba32 });
+			for (uint32_t y = 0; y < 16; ++y)
+				for (uint32_t x = 0; x < 16; ++x)
+				{
+					const auto index = (x + y) % 16;
+					const std::array<uint8_t, 4> expected{ static_cast<uint8_t>(index * 16), static_cast<uint8_t>(255 - index * 16), static_cast<uint8_t>(index * 8), static_cast<uint8_t>(index * 17) };
+					CHECK(!std::memcmp(static_cast<const uint8_t*>(image.data()) + (y * 16 + x) * 4, expected.data(), expected.size()));
+				}
+		}
+		SUBCASE("truncated")
+		{
+			auto blob = seir::Blob::from(SEIR_TEST_DIR "rgba32_filters.png");
+			REQUIRE(blob);
+			const auto size = blob->size();
+			for (const auto cut : { size_t{ 12 }, size_t{ 100 }, size_t{ 200 } })
+				CHECK_FALSE(static_cast<bool>(seir::Image::load(seir::Blob::from(seir::SharedPtr{ blob }, 0, size - cut))));
+		}
+		SUBCASE("duplicate IHDR")
+		{
+			const auto blob = seir::Blob::from(SEIR_TEST_DIR "rgb24.png");
+			REQUIRE(blob);
+			constexpr size_t ihdrOffset = 8;
+			constexpr size_t ihdrSize = 25;
+			const auto data = static_cast<const uint8_t*>(blob->data());
+			std::vector<uint8_t> png{ data, data + ihdrOffset + ihdrSize };
+			png.insert(png.end(), data + ihdrOffset, data + blob->size());
+			CHECK_FALSE(static_cast<bool>(seir::Image::load(seir::Blob::from(png.data(), png.size()))));
+		}
 	}
 	SUBCASE("save")
 	{
@@ -218,6 +346,25 @@ TEST_CASE("PNG")
 		REQUIRE(image.save(seir::ImageFormat::Png, writer, 0));
 		::checkSavedImage(buffer.data(), writer.size(), "rgb24.png");
 	}
+	SUBCASE("roundtrip")
+	{
+		const auto image = ::makeNoisyImage(400, 300, seir::PixelFormat::Bgra32, seir::ImageAxes::XRightYUp);
+		const auto expected = ::convertImage(image, seir::PixelFormat::Rgba32);
+		seir::TaskScheduler scheduler{ 2 };
+		for (const auto compressionLevel : { 0, 50, 100 })
+			for (const auto useScheduler : { false, true })
+			{
+				CAPTURE(compressionLevel);
+				CAPTURE(useScheduler);
+				seir::Buffer buffer;
+				uint64_t size = 0;
+				seir::BufferWriter writer{ buffer, &size };
+				REQUIRE(image.save(seir::ImageFormat::Png, writer, compressionLevel, useScheduler ? &scheduler : nullptr));
+				const auto loaded = seir::Image::load(seir::makeShared<seir::Blob, seir::BufferBlob>(std::move(buffer), static_cast<size_t>(size)));
+				REQUIRE(loaded);
+				CHECK(*loaded == expected);
+			}
+	}
 }
 #endif
 
@@ -20,11 +20,12 @@ namespace seir
 		const auto& info = a.info();
 		if (info != b.info())
 			return false;
-		for (uint32_t y = 0; y < info.height(); ++y)
+		const auto rows = isBlockCompressed(info.pixelFormat()) ? (info.height() + 3) / 4 : info.height();
+		for (uint32_t y = 0; y < rows; ++y)
 		{
 			const auto aRow = static_cast<const uint8_t*>(a.data()) + y * info.stride();
 			const auto bRow = static_cast<const uint8_t*>(b.data()) + y * info.stride();
-			if (std::memcmp(aRow, bRow, info.width() * pixelSize(info.pixelFormat())))
+			if (std::memcmp(aRow, bRow, rowSize(info.pixelFormat(), info.width())))
 				return false;
 		}
 		return true;
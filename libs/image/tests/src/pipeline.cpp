@@ -0,0 +1,188 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/buffer.hpp>
+#include <seir_base/task_scheduler.hpp>
+#include <seir_image/image.hpp>
+#include <seir_image/pipeline.hpp>
+#include <seir_image/utils.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+	std::vector<uint8_t> makeRandomData(size_t size)
+	{
+		std::mt19937 random{ 1 };
+		std::vector<uint8_t> result(size);
+		for (auto& byte : result)
+			byte = static_cast<uint8_t>(random());
+		return result;
+	}
+
+	const uint8_t* pixelAt(const seir::ImageInfo& info, const uint8_t* data, uint32_t x, uint32_t y)
+	{
+		const auto row = info.axes() == seir::ImageAxes::XRightYDown ? y : info.height() - 1 - y;
+		return data + size_t{ row } * info.stride() + size_t{ x } * info.pixelSize();
+	}
+}
+
+TEST_CASE("ImagePipeline (layout)")
+{
+	CHECK(seir::ImagePipeline::mipLevelCount(1, 1) == 1);
+	CHECK(seir::ImagePipeline::mipLevelCount(5, 3) == 3);
+	CHECK(seir::ImagePipeline::mipLevelCount(1024, 1) == 11);
+	const seir::ImageInfo info{ 5, 3, 24, seir::PixelFormat::Rgba32 };
+	const auto level1 = seir::ImagePipeline::mipLevelInfo(info, 1);
+	CHECK(level1.width() == 2);
+	CHECK(level1.height() == 1);
+	CHECK(level1.stride() == 8);
+	CHECK(seir::ImagePipeline::mipLevelOffset(info, 1) == 72);
+	CHECK(seir::ImagePipeline::mipLevelOffset(info, 2) == 80);
+	CHECK(seir::ImagePipeline{}.outputSize(info) == 72);
+	CHECK(seir::ImagePipeline{}.setMipChain(true).outputSize(info) == 84);
+}
+
+TEST_CASE("ImagePipeline (conversion)")
+{
+	const seir::ImageInfo srcInfo{ 37, 29, 37 * 4 + 3, seir::PixelFormat::Rgba32, seir::ImageAxes::XRightYUp };
+	const auto src = ::makeRandomData(srcInfo.frameSize());
+	seir::TaskScheduler scheduler{ 2 };
+	for (const auto parallel : { false, true })
+	{
+		CAPTURE(parallel);
+		{
+			const seir::ImageInfo dstInfo{ 37, 29, seir::PixelFormat::Bgra32 };
+			std::vector<uint8_t> expected(dstInfo.frameSize());
+			REQUIRE(seir::copyImage(srcInfo, src.data(), dstInfo, expected.data()));
+			std::vector<uint8_t> actual(dstInfo.frameSize());
+			REQUIRE(seir::ImagePipeline{}.run(srcInfo, src.data(), dstInfo, actual.data(), parallel ? &scheduler : nullptr));
+			CHECK(actual == expected);
+		}
+		{
+			const seir::ImageInfo dstInfo{ 37, 29, seir::PixelFormat::Bgra32 };
+			std::vector<uint8_t> actual(dstInfo.frameSize());
+			REQUIRE(seir::ImagePipeline{}.setPremultipliedAlpha(true).run(srcInfo, src.data(), dstInfo, actual.data(), parallel ? &scheduler : nullptr));
+			size_t mismatches = 0;
+			for (uint32_t y = 0; y < dstInfo.height(); ++y)
+				for (uint32_t x = 0; x < dstInfo.width(); ++x)
+				{
+					const auto srcPixel = ::pixelAt(srcInfo, src.data(), x, y);
+					const auto dstPixel = ::pixelAt(dstInfo, actual.data(), x, y);
+					const auto premultiply = [alpha = srcPixel[3]](uint8_t value) { return static_cast<uint8_t>((value * alpha + 127) / 255); };
+					if (dstPixel[0] != premultiply(srcPixel[2]) || dstPixel[1] != premultiply(srcPixel[1]) || dstPixel[2] != premultiply(srcPixel[0]) || dstPixel[3] != srcPixel[3])
+						++mismatches;
+				}
+			CHECK(mismatches == 0);
+		}
+	}
+	std::vector<uint8_t> dummy(srcInfo.frameSize());
+	CHECK_FALSE(seir::ImagePipeline{}.run(srcInfo, src.data(), { 37, 29, seir::PixelFormat::Rgb24 }, dummy.data()));
+	CHECK_FALSE(seir::ImagePipeline{}.run(srcInfo, src.data(), { 0, 29, seir::PixelFormat::Rgba32 }, dummy.data()));
+}
+
+TEST_CASE("ImagePipeline (resize)")
+{
+	SUBCASE("box")
+	{
+		const std::array<uint8_t, 8> gray{
+			10, 20, 30, 50,
+			70, 80, 90, 110
+		};
+		const seir::ImageInfo dstInfo{ 2, 1, seir::PixelFormat::Rgba32 };
+		std::array<uint8_t, 8> rgba{};
+		REQUIRE(seir::ImagePipeline{}.run({ 4, 2, seir::PixelFormat::Gray8 }, gray.data(), dstInfo, rgba.data()));
+		CHECK(rgba == std::array<uint8_t, 8>{ 45, 45, 45, 255, 70, 70, 70, 255 });
+	}
+	for (const auto filter : { seir::ImageFilter::Box, seir::ImageFilter::Lanczos3 })
+	{
+		CAPTURE(filter);
+		const seir::ImageInfo srcInfo{ 100, 70, seir::PixelFormat::Rgb24 };
+		std::vector<uint8_t> src(srcInfo.frameSize());
+		for (size_t i = 0; i < src.size(); i += 3)
+		{
+			src[i] = 11;
+			src[i + 1] = 222;
+			src[i + 2] = 133;
+		}
+		seir::TaskScheduler scheduler{ 2 };
+		for (const auto& dstInfo : { seir::ImageInfo{ 37, 23, seir::PixelFormat::Bgr24 }, seir::ImageInfo{ 301, 150, seir::PixelFormat::Bgr24 }, seir::ImageInfo{ 1, 1, seir::PixelFormat::Bgr24 } })
+		{
+			CAPTURE(dstInfo.width());
+			std::vector<uint8_t> dst(dstInfo.frameSize());
+			REQUIRE(seir::ImagePipeline{}.setFilter(filter).run(srcInfo, src.data(), dstInfo, dst.data(), &scheduler));
+			size_t mismatches = 0;
+			for (size_t i = 0; i < dst.size(); i += 3)
+				if (dst[i] != 133 || dst[i + 1] != 222 || dst[i + 2] != 11)
+					++mismatches;
+			CHECK(mismatches == 0);
+		}
+	}
+}
+
+TEST_CASE("ImagePipeline (mip chain)")
+{
+	const auto check = [](uint32_t width, uint32_t height) {
+		CAPTURE(width);
+		CAPTURE(height);
+		const seir::ImageInfo srcInfo{ width, height, seir::PixelFormat::Rgba32 };
+		const auto src = ::makeRandomData(srcInfo.frameSize());
+		const seir::ImageInfo dstInfo{ width, height, seir::PixelFormat::Bgra32, seir::ImageAxes::XRightYUp };
+		const auto pipeline = seir::ImagePipeline{}.setMipChain(true);
+		std::vector<uint8_t> serial(pipeline.outputSize(dstInfo) + 1, 0xee);
+		REQUIRE(pipeline.run(srcInfo, src.data(), dstInfo, serial.data()));
+		CHECK(serial.back() == 0xee);
+		seir::TaskScheduler scheduler{ 2 };
+		std::vector<uint8_t> parallel(serial.size(), 0xee);
+		REQUIRE(pipeline.run(srcInfo, src.data(), dstInfo, parallel.data(), &scheduler));
+		CHECK(parallel == serial);
+
+		// Each level must match the previous one averaged in 2x2 blocks.
+		auto previousInfo = srcInfo;
+		std::vector<float> previous(size_t{ width } * height * 4);
+		for (uint32_t y = 0; y < height; ++y)
+			for (uint32_t x = 0; x < width; ++x)
+				for (uint32_t c = 0; c < 4; ++c)
+					previous[(size_t{ y } * width + x) * 4 + c] = ::pixelAt(srcInfo, src.data(), x, y)[c];
+		for (uint32_t level = 0; level < seir::ImagePipeline::mipLevelCount(width, height); ++level)
+		{
+			CAPTURE(level);
+			const auto levelInfo = seir::ImagePipeline::mipLevelInfo(dstInfo, level);
+			const auto levelData = serial.data() + seir::ImagePipeline::mipLevelOffset(dstInfo, level);
+			std::vector<float> current(size_t{ levelInfo.width() } * levelInfo.height() * 4);
+			int maxError = 0;
+			for (uint32_t y = 0; y < levelInfo.height(); ++y)
+				for (uint32_t x = 0; x < levelInfo.width(); ++x)
+					for (uint32_t c = 0; c < 4; ++c)
+					{
+						auto& value = current[(size_t{ y } * levelInfo.width() + x) * 4 + c];
+						if (level > 0)
+						{
+							const auto at = [&](uint32_t px, uint32_t py) {
+								return previous[(size_t{ std::min(py, previousInfo.height() - 1) } * previousInfo.width() + std::min(px, previousInfo.width() - 1)) * 4 + c];
+							};
+							value = (at(2 * x, 2 * y) + at(2 * x + 1, 2 * y) + at(2 * x, 2 * y + 1) + at(2 * x + 1, 2 * y + 1)) / 4;
+						}
+						else
+							value = previous[(size_t{ y } * width + x) * 4 + c];
+						const auto actual = ::pixelAt(levelInfo, levelData, x, y)[c < 3 ? 2 - c : c];
+						maxError = std::max(maxError, std::abs(actual - static_cast<int>(value + .5f)));
+					}
+			CHECK(maxError <= 1);
+			previousInfo = levelInfo;
+			previous = std::move(current);
+		}
+	};
+	check(1, 1);
+	check(5, 3);
+	check(37, 29);
+	check(1000, 600);
+	check(3000, 1);
+}
@@ -0,0 +1,90 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../src/png_filters.hpp"
+
+#include <random>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("PngUnfilter")
+{
+	std::mt19937 random{ 1 };
+	const auto randomBytes = [&random](size_t size) {
+		std::vector<uint8_t> result(size);
+		for (auto& byte : result)
+			byte = static_cast<uint8_t>(random());
+		return result;
+	};
+	for (const size_t pixelSize : { 1u, 2u, 3u, 4u })
+		for (const size_t width : { 1u, 2u, 5u, 16u, 33u, 100u })
+		{
+			CAPTURE(pixelSize);
+			CAPTURE(width);
+			const auto size = width * pixelSize;
+			const seir::PngUnfilter<false> scalar{ pixelSize };
+			const seir::PngUnfilter<true> vectorized{ pixelSize };
+			for (uint8_t filter = 0; filter <= 4; ++filter)
+			{
+				CAPTURE(filter);
+				const auto src = randomBytes(size);
+				const auto prev = randomBytes(size);
+				std::vector<uint8_t> expected(size);
+				REQUIRE(scalar(filter, expected.data(), src.data(), prev.data(), size));
+				std::vector<uint8_t> actual(size);
+				REQUIRE(vectorized(filter, actual.data(), src.data(), prev.data(), size));
+				CHECK(actual == expected);
+				for (const size_t offset : { 0u, 1u, 2u, 7u, 40u }) // Unfiltering in place towards the beginning of the buffer.
+				{
+					std::vector<uint8_t> buffer(offset + size);
+					std::copy(src.begin(), src.end(), buffer.begin() + static_cast<ptrdiff_t>(offset));
+					REQUIRE(vectorized(filter, buffer.data(), buffer.data() + offset, prev.data(), size));
+					CHECK(std::equal(expected.begin(), expected.end(), buffer.begin()));
+				}
+			}
+			CHECK_FALSE(vectorized(5, std::vector<uint8_t>(size).data(), randomBytes(size).data(), randomBytes(size).data(), size));
+		}
+}
+
+TEST_CASE("PngFilter")
+{
+	std::mt19937 random{ 1 };
+	const auto randomBytes = [&random](size_t size) {
+		std::vector<uint8_t> result(size);
+		for (auto& byte : result)
+			byte = static_cast<uint8_t>(random() % 16); // Small values make different filters win.
+		return result;
+	};
+	for (const size_t pixelSize : { 1u, 2u, 3u, 4u })
+		for (const size_t width : { 1u, 2u, 5u, 16u, 33u, 100u })
+		{
+			CAPTURE(pixelSize);
+			CAPTURE(width);
+			const auto size = width * pixelSize;
+			const seir::PngFilter<false> scalar{ pixelSize };
+			const seir::PngFilter<true> vectorized{ pixelSize };
+			const seir::PngUnfilter<true> unfilter{ pixelSize };
+			const auto src = randomBytes(size);
+			const auto prev = randomBytes(size);
+			for (uint8_t filter = 0; filter <= 4; ++filter)
+			{
+				CAPTURE(filter);
+				std::vector<uint8_t> expected(size);
+				scalar(static_cast<seir::PngStandardFilterType>(filter), expected.data(), src.data(), prev.data(), size);
+				std::vector<uint8_t> actual(size);
+				vectorized(static_cast<seir::PngStandardFilterType>(filter), actual.data(), src.data(), prev.data(), size);
+				CHECK(actual == expected);
+				std::vector<uint8_t> unfiltered(size);
+				REQUIRE(unfilter(filter, unfiltered.data(), actual.data(), prev.data(), size));
+				CHECK(unfiltered == src);
+			}
+			std::vector<uint8_t> expectedScratch(5 * (1 + size));
+			const auto expected = scalar.filterAdaptive(expectedScratch.data(), src.data(), prev.data(), size);
+			std::vector<uint8_t> actualScratch(5 * (1 + size));
+			const auto actual = vectorized.filterAdaptive(actualScratch.data(), src.data(), prev.data(), size);
+			CHECK(actual[0] == expected[0]);
+			CHECK(std::equal(actual, actual + 1 + size, expected));
+		}
+}
@@ -4,9 +4,13 @@
 
 #include "image.hpp"
 
+#include <seir_base/task_scheduler.hpp>
 #include <seir_image/utils.hpp>
 
+#include <algorithm>
 #include <array>
+#include <random>
+#include <vector>
 
 #include <doctest/doctest.h>
 
@@ -143,6 +147,128 @@ TEST_CASE("copyImage")
 	}
 }
 
+TEST_CASE("copyImage (wide)")
+{
+	using seir::PixelFormat;
+	constexpr std::array<std::pair<PixelFormat, PixelFormat>, 16> kConversions{ {
+		{ PixelFormat::Gray8, PixelFormat::Bgra32 },
+		{ PixelFormat::Gray8, PixelFormat::Rgba32 },
+		{ PixelFormat::Intensity8, PixelFormat::Bgra32 },
+		{ PixelFormat::Intensity8, PixelFormat::Rgba32 },
+		{ PixelFormat::GrayAlpha16, PixelFormat::Bgra32 },
+		{ PixelFormat::GrayAlpha16, PixelFormat::Rgba32 },
+		{ PixelFormat::Rgb24, PixelFormat::Bgr24 },
+		{ PixelFormat::Rgb24, PixelFormat::Rgba32 },
+		{ PixelFormat::Rgb24, PixelFormat::Bgra32 },
+		{ PixelFormat::Bgr24, PixelFormat::Rgb24 },
+		{ PixelFormat::Bgr24, PixelFormat::Rgba32 },
+		{ PixelFormat::Bgr24, PixelFormat::Bgra32 },
+		{ PixelFormat::Rgba32, PixelFormat::Bgra32 },
+		{ PixelFormat::Rgba32, PixelFormat::Rgba32 },
+		{ PixelFormat::Bgra32, PixelFormat::Rgba32 },
+		{ PixelFormat::Bgra32, PixelFormat::Bgra32 },
+	} };
+	std::mt19937 random{ 1 };
+	seir::TaskScheduler scheduler{ 2 };
+	for (const auto& [srcFormat, dstFormat] : kConversions)
+		for (const auto& [width, height] : std::initializer_list<std::pair<uint32_t, uint32_t>>{ { 1, 3 }, { 5, 3 }, { 6, 3 }, { 15, 3 }, { 16, 3 }, { 17, 3 }, { 31, 3 }, { 33, 3 }, { 70, 3 }, { 1000, 300 } })
+		{
+			CAPTURE(srcFormat);
+			CAPTURE(dstFormat);
+			CAPTURE(width);
+			CAPTURE(height);
+			const auto srcPixelSize = seir::pixelSize(srcFormat);
+			const auto dstPixelSize = seir::pixelSize(dstFormat);
+			const seir::ImageInfo srcInfo{ width, height, width * srcPixelSize + 3, srcFormat };
+			std::vector<uint8_t> src(srcInfo.frameSize());
+			for (auto& byte : src)
+				byte = static_cast<uint8_t>(random());
+			// Single-pixel images are converted without SIMD.
+			std::vector<uint8_t> expected(size_t{ width } * height * dstPixelSize);
+			bool converted = true;
+			for (uint32_t y = 0; y < height; ++y)
+				for (uint32_t x = 0; x < width; ++x)
+					converted &= seir::copyImage({ 1, 1, srcFormat }, src.data() + y * srcInfo.stride() + x * srcPixelSize,
+						{ 1, 1, dstFormat }, expected.data() + ((height - 1 - y) * width + x) * dstPixelSize);
+			REQUIRE(converted);
+			for (auto* taskScheduler : { static_cast<seir::TaskScheduler*>(nullptr), &scheduler })
+			{
+				std::vector<uint8_t> actual(expected.size() + 1, 0xa5); // The extra byte checks that nothing is written past the image.
+				REQUIRE(seir::copyImage(srcInfo, src.data(), { width, height, dstFormat, seir::ImageAxes::XRightYUp }, actual.data(), taskScheduler));
+				CHECK(actual.back() == 0xa5);
+				actual.pop_back();
+				CHECK(actual == expected);
+			}
+		}
+}
+
+TEST_CASE("copyImage (block-compressed)")
+{
+	using Pixel = std::array<uint8_t, 4>;
+	constexpr Pixel red{ 255, 0, 0, 255 };
+	constexpr Pixel blue{ 0, 0, 255, 255 };
+	const auto decode = [](seir::PixelFormat format, const std::vector<uint8_t>& block) {
+		std::vector<Pixel> pixels(16);
+		REQUIRE(seir::copyImage({ 4, 4, format }, block.data(), { 4, 4, seir::PixelFormat::Rgba32 }, pixels.data()));
+		return pixels;
+	};
+	const auto repeat = [](std::initializer_list<Pixel> palette) {
+		std::vector<Pixel> pixels;
+		while (pixels.size() < 16)
+			pixels.insert(pixels.end(), palette);
+		return pixels;
+	};
+	SUBCASE("BC1")
+	{
+		CHECK(decode(seir::PixelFormat::Bc1, { 0x00, 0xf8, 0x1f, 0x00, 0xe4, 0xe4, 0xe4, 0xe4 }) == repeat({ red, blue, { 170, 0, 85, 255 }, { 85, 0, 170, 255 } }));
+		CHECK(decode(seir::PixelFormat::Bc1, { 0x1f, 0x00, 0x00, 0xf8, 0xe4, 0xe4, 0xe4, 0xe4 }) == repeat({ blue, red, { 128, 0, 128, 255 }, { 0, 0, 0, 0 } }));
+	}
+	SUBCASE("BC2")
+	{
+		std::vector<uint8_t> block{ 0x10, 0x32, 0x54, 0x76, 0x98, 0xba, 0xdc, 0xfe, 0x00, 0xf8, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00 };
+		std::vector<Pixel> expected(16, red);
+		for (size_t i = 0; i < expected.size(); ++i)
+			expected[i][3] = static_cast<uint8_t>(i * 17);
+		CHECK(decode(seir::PixelFormat::Bc2, block) == expected);
+	}
+	SUBCASE("BC3")
+	{
+		// The first color isn't greater than the second one, but BC3 always uses the four color mode.
+		std::vector<uint8_t> block{ 0xff, 0x00, 0x92, 0x24, 0x49, 0x92, 0x24, 0x49, 0x1f, 0x00, 0x00, 0xf8, 0xaa, 0xaa, 0xaa, 0xaa };
+		CHECK(decode(seir::PixelFormat::Bc3, block) == std::vector<Pixel>(16, { 85, 0, 170, 219 }));
+	}
+	SUBCASE("clipping")
+	{
+		// Each row of the block uses its own color index, and only a 3x2 corner of the block is decoded.
+		const std::array<uint8_t, 8> block{ 0x00, 0xf8, 0x1f, 0x00, 0x00, 0x55, 0xaa, 0xff };
+		seir::TaskScheduler taskScheduler{ 2 };
+		std::vector<uint8_t> bgra(3 * 2 * 4 + 1, 0xa5);
+		REQUIRE(seir::copyImage({ 3, 2, seir::PixelFormat::Bc1 }, block.data(), { 3, 2, seir::PixelFormat::Bgra32, seir::ImageAxes::XRightYUp }, bgra.data(), &taskScheduler));
+		CHECK(bgra == std::vector<uint8_t>{
+			255, 0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255,
+			0, 0, 255, 255, 0, 0, 255, 255, 0, 0, 255, 255,
+			0xa5 });
+	}
+	SUBCASE("copy")
+	{
+		std::array<uint8_t, 32> blocks{};
+		for (size_t i = 0; i < blocks.size(); ++i)
+			blocks[i] = static_cast<uint8_t>(i);
+		const seir::ImageInfo srcInfo{ 7, 3, seir::PixelFormat::Bc7 };
+		CHECK(srcInfo.stride() == 32);
+		CHECK(srcInfo.frameSize() == 32);
+		std::array<uint8_t, 40> copy{};
+		REQUIRE(seir::copyImage(srcInfo, blocks.data(), { 7, 3, 40, seir::PixelFormat::Bc7 }, copy.data()));
+		CHECK(std::equal(blocks.begin(), blocks.end(), copy.begin()));
+		CHECK(copy[32] == 0);
+		CHECK_FALSE(seir::copyImage(srcInfo, blocks.data(), { 7, 3, seir::PixelFormat::Bc7, seir::ImageAxes::XRightYUp }, copy.data()));
+	}
+	CHECK_FALSE(seir::copyImage({ 4, 4, seir::PixelFormat::Bc7 }, nullptr, { 4, 4, seir::PixelFormat::Rgba32 }, nullptr));
+	CHECK_FALSE(seir::copyImage({ 4, 4, seir::PixelFormat::Bc1 }, nullptr, { 4, 4, seir::PixelFormat::Rgb24 }, nullptr));
+	CHECK_FALSE(seir::copyImage({ 4, 4, seir::PixelFormat::Rgba32 }, nullptr, { 4, 4, seir::PixelFormat::Bc1 }, nullptr));
+	CHECK_FALSE(seir::copyImage({ 4, 4, seir::PixelFormat::Bc1 }, nullptr, { 4, 4, seir::PixelFormat::Bc3 }, nullptr));
+}
+
 TEST_CASE("copyImage = false")
 {
 	SUBCASE("PixelFormat")
@@ -0,0 +1,59 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_base/shared_ptr.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <string>
+
+namespace seir
+{
+	class Blob;
+
+	//
+	struct AsyncReaderOptions
+	{
+		unsigned _maxReads = 64;   // Maximum number of reads in flight.
+		unsigned _threadCount = 4; // Number of threads if the reads are performed by a thread pool.
+		bool _threadPool = false;  // Use a thread pool even if the platform provides asynchronous reading.
+	};
+
+	// Reads files into memory asynchronously.
+	// Linux uses io_uring if it's available, other platforms use a thread pool.
+	class AsyncReader
+	{
+	public:
+		// Called when a read is finished, with an empty pointer if the read has failed.
+		// Callbacks are called on reader threads and shouldn't block. Exceptions thrown by callbacks are ignored.
+		using Callback = std::function<void(SharedPtr<Blob>&&)>;
+
+		explicit AsyncReader(const AsyncReaderOptions& = {});
+		AsyncReader(const AsyncReader&) = delete;
+		AsyncReader& operator=(const AsyncReader&) = delete;
+		~AsyncReader() noexcept; // Waits for all reads to finish.
+
+		// Reads the whole file.
+		void read(const std::string& path, Callback&&);
+
+		// Reads up to the specified number of bytes from the specified file offset.
+		void read(const std::string& path, uint64_t offset, size_t size, Callback&&);
+
+		// Reads the whole file.
+		[[nodiscard]] std::future<SharedPtr<Blob>> read(const std::string& path);
+
+		// Reads up to the specified number of bytes from the specified file offset.
+		[[nodiscard]] std::future<SharedPtr<Blob>> read(const std::string& path, uint64_t offset, size_t size);
+
+		// Waits for all reads to finish.
+		void wait() noexcept;
+
+	private:
+		const std::unique_ptr<class AsyncReaderImpl> _impl;
+	};
+}
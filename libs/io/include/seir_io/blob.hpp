@@ -12,6 +12,22 @@ namespace seir
 {
 	class TemporaryFile;
 
+	// Expected access pattern of a memory-mapped file.
+	enum class FileAccess
+	{
+		Normal,
+		Sequential,
+		Random,
+	};
+
+	// Memory-mapped file options.
+	struct FileBlobOptions
+	{
+		FileAccess _access = FileAccess::Normal;
+		bool _populate = false;  // Load the whole file into memory before returning.
+		bool _hugePages = false; // Align the mapping for huge pages and use them if supported.
+	};
+
 	// Memory-based data source.
 	class Blob : public ReferenceCounter
 	{
@@ -24,7 +40,7 @@ namespace seir
 		[[nodiscard]] static SharedPtr<Blob> from(SharedPtr<Blob>&&, size_t offset, size_t size);
 
 		// Creates a Blob that references a memory-mapped file.
-		[[nodiscard]] static SharedPtr<Blob> from(const std::string&);
+		[[nodiscard]] static SharedPtr<Blob> from(const std::string&, const FileBlobOptions& = {});
 
 		// Creates a Blob from a TemporaryFile.
 		// NOTE: The TemporaryFile must stay valid for the lifetime of the Blob.
@@ -35,10 +51,17 @@ namespace seir
 		// Returns the data pointer.
 		[[nodiscard]] constexpr const void* data() const noexcept { return _data; }
 
+		// Allows the specified range of a memory-mapped file to be unloaded from memory.
+		// The data stays accessible and is loaded again when accessed.
+		virtual void evict(size_t /*offset*/, size_t /*size*/) const noexcept {}
+
 		//
 		template <typename T>
 		[[nodiscard]] constexpr const T* get(size_t offset, size_t count = 1) const noexcept;
 
+		// Starts loading the specified range of a memory-mapped file into memory in background.
+		virtual void prefetch(size_t /*offset*/, size_t /*size*/) const noexcept {}
+
 		// Returns the size of the data.
 		[[nodiscard]] constexpr size_t size() const noexcept { return _size; }
 
@@ -65,8 +88,19 @@ inline seir::SharedPtr<seir::Blob> seir::Blob::from(SharedPtr<Blob>&& parent, si
 	struct SubBlob final : Blob
 	{
 		const SharedPtr<Blob> _parent;
+		const size_t _offset;
 		constexpr SubBlob(SharedPtr<Blob>&& parent, size_t offset, size_t size) noexcept
-			: Blob{ static_cast<const std::byte*>(parent->data()) + offset, size }, _parent{ std::move(parent) } {}
+			: Blob{ static_cast<const std::byte*>(parent->data()) + offset, size }, _parent{ std::move(parent) }, _offset{ offset } {}
+		void evict(size_t offset, size_t size) const noexcept override
+		{
+			if (offset < _size)
+				_parent->evict(_offset + offset, size < _size - offset ? size : _size - offset);
+		}
+		void prefetch(size_t offset, size_t size) const noexcept override
+		{
+			if (offset < _size)
+				_parent->prefetch(_offset + offset, size < _size - offset ? size : _size - offset);
+		}
 	};
 	if (offset > parent->size())
 		offset = parent->size();
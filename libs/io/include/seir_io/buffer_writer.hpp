@@ -22,6 +22,8 @@ namespace seir
 	private:
 		bool reserveImpl(uint64_t capacity) noexcept override;
 		bool writeImpl(uint64_t offset64, const void* data, size_t size) noexcept override;
+		bool writePartsImpl(uint64_t offset64, std::span<const std::span<const std::byte>>) noexcept override;
+		bool prepareWrite(uint64_t offset64, size_t size) noexcept;
 
 	private:
 		Buffer& _buffer;
@@ -0,0 +1,42 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_io/writer.hpp>
+
+#include <memory>
+
+namespace seir
+{
+	//
+	struct BufferedWriterOptions
+	{
+		size_t _bufferSize = 64 * 1024;
+		bool _async = false; // Write full buffers on a background thread.
+	};
+
+	// A Writer that combines small sequential writes into larger ones.
+	// Buffered data is written when the buffer is full, when data is written
+	// to a non-adjacent offset, when the writer is flushed or destroyed.
+	class BufferedWriter final : public Writer
+	{
+	public:
+		explicit BufferedWriter(UniquePtr<Writer>&&, const BufferedWriterOptions& = {});
+		~BufferedWriter() noexcept override;
+
+		// Writes all buffered data and flushes the underlying Writer.
+		bool flush() noexcept override;
+
+		// Writes all buffered data to the underlying Writer without flushing it.
+		bool flushBuffer() noexcept;
+
+	private:
+		bool reserveImpl(uint64_t capacity) noexcept override;
+		bool writeImpl(uint64_t offset, const void* data, size_t size) noexcept override;
+
+	private:
+		const std::unique_ptr<class BufferedWriterImpl> _impl;
+	};
+}
@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <filesystem>
+#include <span>
 #include <string>
 
 namespace seir
@@ -44,9 +45,13 @@ namespace seir
 		template <class T>
 		bool write(const T& data) noexcept { return write(&data, sizeof data); }
 
+		// Writes multiple parts of data one after another, which may be faster than writing them separately.
+		bool writeParts(std::span<const std::span<const std::byte>>) noexcept;
+
 	protected:
 		virtual bool reserveImpl(uint64_t capacity) noexcept = 0;
 		virtual bool writeImpl(uint64_t offset, const void* data, size_t size) noexcept = 0;
+		virtual bool writePartsImpl(uint64_t offset, std::span<const std::span<const std::byte>>) noexcept;
 
 	private:
 		uint64_t _size = 0;
@@ -0,0 +1,171 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "async_reader.hpp"
+
+#include <seir_io/blob.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+	class ThreadPoolReader final : public seir::AsyncReaderBackend
+	{
+	public:
+		explicit ThreadPoolReader(unsigned threadCount)
+		{
+			_threads.reserve(threadCount);
+			for (unsigned i = 0; i < threadCount; ++i)
+				_threads.emplace_back([this] { run(); });
+		}
+
+		~ThreadPoolReader() noexcept override
+		{
+			{
+				const std::scoped_lock lock{ _mutex };
+				_stop = true;
+			}
+			_condition.notify_all();
+			for (auto& thread : _threads)
+				thread.join();
+		}
+
+		void submit(std::unique_ptr<seir::AsyncReadRequest>&& request) override
+		{
+			{
+				const std::scoped_lock lock{ _mutex };
+				_requests.emplace_back(std::move(request));
+			}
+			_condition.notify_one();
+		}
+
+	private:
+		void run()
+		{
+			for (;;)
+			{
+				std::unique_ptr<seir::AsyncReadRequest> request;
+				{
+					std::unique_lock lock{ _mutex };
+					_condition.wait(lock, [this] { return _stop || !_requests.empty(); });
+					if (_requests.empty())
+						break;
+					request = std::move(_requests.front());
+					_requests.pop_front();
+				}
+				request->finish(seir::readFile(request->_path, request->_offset, request->_size));
+			}
+		}
+
+	private:
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		std::deque<std::unique_ptr<seir::AsyncReadRequest>> _requests;
+		bool _stop = false;
+		std::vector<std::thread> _threads;
+	};
+}
+
+namespace seir
+{
+	class AsyncReaderImpl
+	{
+	public:
+		std::atomic<size_t> _pending{ 0 };
+		std::unique_ptr<AsyncReaderBackend> _backend;
+
+		explicit AsyncReaderImpl(const AsyncReaderOptions& options)
+		{
+#ifdef __linux__
+			if (!options._threadPool)
+				_backend = createIoUringReader(options._maxReads > 0 ? options._maxReads : 1);
+#endif
+			if (!_backend)
+				_backend = std::make_unique<ThreadPoolReader>(options._threadCount > 0 ? options._threadCount : 1);
+		}
+
+		~AsyncReaderImpl() noexcept
+		{
+			wait();
+		}
+
+		void submit(const std::string& path, uint64_t offset, size_t size, AsyncReader::Callback&& callback)
+		{
+			auto request = std::make_unique<AsyncReadRequest>(path, offset, size, std::move(callback), &_pending);
+			_pending.fetch_add(1);
+			try
+			{
+				_backend->submit(std::move(request));
+			}
+			catch (...)
+			{
+				// The request is destroyed without being finished.
+				if (_pending.fetch_sub(1) == 1)
+					_pending.notify_all();
+				throw;
+			}
+		}
+
+		void wait() noexcept
+		{
+			for (auto pending = _pending.load(); pending > 0; pending = _pending.load())
+				_pending.wait(pending);
+		}
+	};
+
+	void AsyncReadRequest::finish(SharedPtr<Blob>&& blob) noexcept
+	{
+		const auto pending = _pending;
+		try
+		{
+			_callback(std::move(blob));
+		}
+		catch (...)
+		{
+			// There is nowhere to propagate the exception from a reader thread.
+		}
+		_callback = {};
+		if (pending->fetch_sub(1) == 1)
+			pending->notify_all();
+	}
+
+	AsyncReader::AsyncReader(const AsyncReaderOptions& options)
+		: _impl{ std::make_unique<AsyncReaderImpl>(options) }
+	{
+	}
+
+	AsyncReader::~AsyncReader() noexcept = default;
+
+	void AsyncReader::read(const std::string& path, Callback&& callback)
+	{
+		_impl->submit(path, 0, AsyncReadRequest::kToEnd, std::move(callback));
+	}
+
+	void AsyncReader::read(const std::string& path, uint64_t offset, size_t size, Callback&& callback)
+	{
+		_impl->submit(path, offset, size, std::move(callback));
+	}
+
+	std::future<SharedPtr<Blob>> AsyncReader::read(const std::string& path)
+	{
+		return read(path, 0, AsyncReadRequest::kToEnd);
+	}
+
+	std::future<SharedPtr<Blob>> AsyncReader::read(const std::string& path, uint64_t offset, size_t size)
+	{
+		auto promise = std::make_shared<std::promise<SharedPtr<Blob>>>();
+		auto future = promise->get_future();
+		_impl->submit(path, offset, size, [promise = std::move(promise)](SharedPtr<Blob>&& blob) { promise->set_value(std::move(blob)); });
+		return future;
+	}
+
+	void AsyncReader::wait() noexcept
+	{
+		_impl->wait();
+	}
+}
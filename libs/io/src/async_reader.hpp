@@ -0,0 +1,42 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_io/async_reader.hpp>
+
+#include <atomic>
+#include <limits>
+
+namespace seir
+{
+	struct AsyncReadRequest
+	{
+		static constexpr size_t kToEnd = std::numeric_limits<size_t>::max();
+
+		std::string _path;
+		uint64_t _offset = 0;
+		size_t _size = kToEnd;
+		AsyncReader::Callback _callback;
+		std::atomic<size_t>* _pending = nullptr;
+
+		// Passes the result to the callback (ignoring any exceptions) and marks the request as finished.
+		void finish(SharedPtr<Blob>&&) noexcept;
+	};
+
+	class AsyncReaderBackend
+	{
+	public:
+		virtual ~AsyncReaderBackend() noexcept = default;
+		virtual void submit(std::unique_ptr<AsyncReadRequest>&&) = 0;
+	};
+
+#ifdef __linux__
+	// Returns an empty pointer if io_uring isn't available.
+	[[nodiscard]] std::unique_ptr<AsyncReaderBackend> createIoUringReader(unsigned maxReads);
+#endif
+
+	// Synchronously reads the specified range of the file.
+	[[nodiscard]] SharedPtr<Blob> readFile(const std::string& path, uint64_t offset, size_t size);
+}
@@ -25,6 +25,35 @@ namespace seir
 	}
 
 	bool BufferWriter::writeImpl(uint64_t offset64, const void* data, size_t size) noexcept
+	{
+		if (!prepareWrite(offset64, size))
+			return false;
+		std::memcpy(_buffer.data() + static_cast<size_t>(offset64), data, size);
+		return true;
+	}
+
+	bool BufferWriter::writePartsImpl(uint64_t offset64, std::span<const std::span<const std::byte>> parts) noexcept
+	{
+		size_t totalSize = 0;
+		for (const auto& part : parts)
+		{
+			if (part.size() > std::numeric_limits<size_t>::max() - totalSize)
+				return false;
+			totalSize += part.size();
+		}
+		if (!prepareWrite(offset64, totalSize))
+			return false;
+		auto offset = static_cast<size_t>(offset64);
+		for (const auto& part : parts)
+		{
+			if (!part.empty())
+				std::memcpy(_buffer.data() + offset, part.data(), part.size());
+			offset += part.size();
+		}
+		return true;
+	}
+
+	bool BufferWriter::prepareWrite(uint64_t offset64, size_t size) noexcept
 	{
 		if constexpr (sizeof(uint64_t) > sizeof(size_t))
 			if (offset64 > std::numeric_limits<size_t>::max())
@@ -39,7 +68,6 @@ namespace seir
 			if (!_buffer.tryReserve(requiredCapacity > grownCapacity ? requiredCapacity : grownCapacity, static_cast<size_t>(Writer::size())))
 				return false;
 		}
-		std::memcpy(_buffer.data() + offset, data, size);
 		if (_bufferBytes && *_bufferBytes < requiredCapacity)
 			*_bufferBytes = requiredCapacity;
 		return true;
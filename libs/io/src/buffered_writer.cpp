@@ -0,0 +1,186 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_io/buffered_writer.hpp>
+
+#include <seir_base/buffer.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace seir
+{
+	class BufferedWriterImpl
+	{
+	public:
+		const UniquePtr<Writer> _target;
+		Buffer _buffer;
+		size_t _bufferedBytes = 0;
+		uint64_t _bufferOffset = 0;
+
+		// Background writing state.
+		std::mutex _mutex;
+		std::condition_variable _condition;
+		Buffer _pendingBuffer;
+		size_t _pendingBytes = 0;
+		uint64_t _pendingOffset = 0;
+		bool _pending = false;
+		bool _failed = false;
+		bool _stop = false;
+		std::thread _thread;
+
+		BufferedWriterImpl(UniquePtr<Writer>&& target, const BufferedWriterOptions& options)
+			: _target{ std::move(target) }
+			, _buffer{ options._bufferSize > 0 ? options._bufferSize : 1 }
+		{
+			if (options._async)
+			{
+				_pendingBuffer = Buffer{ _buffer.capacity() };
+				_thread = std::thread{ [this] { run(); } };
+			}
+		}
+
+		~BufferedWriterImpl() noexcept
+		{
+			if (_thread.joinable())
+			{
+				{
+					const std::scoped_lock lock{ _mutex };
+					_stop = true;
+				}
+				_condition.notify_all();
+				_thread.join();
+			}
+		}
+
+		// Passes buffered data to the target, on the background thread if there is one.
+		bool submit() noexcept
+		{
+			if (!_bufferedBytes)
+				return true;
+			if (!_thread.joinable())
+				return writeThrough({});
+			std::unique_lock lock{ _mutex };
+			_condition.wait(lock, [this] { return !_pending; });
+			if (_failed)
+				return false;
+			swap(_buffer, _pendingBuffer);
+			_pendingBytes = std::exchange(_bufferedBytes, 0);
+			_pendingOffset = _bufferOffset;
+			_pending = true;
+			lock.unlock();
+			_condition.notify_all();
+			return true;
+		}
+
+		// Waits for the background thread to finish writing.
+		// Returns false if any background write has failed.
+		bool wait() noexcept
+		{
+			if (!_thread.joinable())
+				return true;
+			std::unique_lock lock{ _mutex };
+			_condition.wait(lock, [this] { return !_pending; });
+			return !_failed;
+		}
+
+		// Writes buffered data followed by the specified data to the target.
+		bool writeThrough(std::span<const std::byte> data) noexcept
+		{
+			if (!wait())
+				return false;
+			if (!_bufferedBytes && data.empty())
+				return true;
+			if (!_target->seek(_bufferOffset))
+				return false;
+			if (data.empty())
+			{
+				if (!_target->write(_buffer.data(), _bufferedBytes))
+					return false;
+			}
+			else if (const std::array parts{ std::span<const std::byte>{ _buffer.data(), _bufferedBytes }, data }; !_target->writeParts(parts))
+				return false;
+			_bufferedBytes = 0;
+			return true;
+		}
+
+	private:
+		void run()
+		{
+			std::unique_lock lock{ _mutex };
+			for (;;)
+			{
+				_condition.wait(lock, [this] { return _stop || _pending; });
+				if (!_pending)
+					break;
+				lock.unlock();
+				const auto written = _target->seek(_pendingOffset) && _target->write(_pendingBuffer.data(), _pendingBytes);
+				lock.lock();
+				if (!written)
+					_failed = true;
+				_pending = false;
+				_condition.notify_all();
+			}
+		}
+	};
+
+	BufferedWriter::BufferedWriter(UniquePtr<Writer>&& target, const BufferedWriterOptions& options)
+		: _impl{ std::make_unique<BufferedWriterImpl>(std::move(target), options) }
+	{
+	}
+
+	BufferedWriter::~BufferedWriter() noexcept
+	{
+		_impl->writeThrough({});
+	}
+
+	bool BufferedWriter::flush() noexcept
+	{
+		return flushBuffer() && _impl->_target->flush();
+	}
+
+	bool BufferedWriter::flushBuffer() noexcept
+	{
+		return _impl->writeThrough({});
+	}
+
+	bool BufferedWriter::reserveImpl(uint64_t capacity) noexcept
+	{
+		if (!_impl->wait())
+			return false;
+		const auto targetOffset = _impl->_target->offset();
+		return capacity <= targetOffset || _impl->_target->reserve(capacity - targetOffset);
+	}
+
+	bool BufferedWriter::writeImpl(uint64_t offset, const void* data, size_t size) noexcept
+	{
+		auto& impl = *_impl;
+		if (impl._bufferedBytes > 0 && offset != impl._bufferOffset + impl._bufferedBytes && !impl.submit())
+			return false;
+		if (!impl._bufferedBytes)
+			impl._bufferOffset = offset;
+		const auto capacity = impl._buffer.capacity();
+		if (size <= capacity - impl._bufferedBytes)
+		{
+			std::memcpy(impl._buffer.data() + impl._bufferedBytes, data, size);
+			impl._bufferedBytes += size;
+			return true;
+		}
+		if (size >= capacity) // Large writes go directly to the target together with buffered data.
+			return impl.writeThrough({ static_cast<const std::byte*>(data), size });
+		const auto head = capacity - impl._bufferedBytes;
+		std::memcpy(impl._buffer.data() + impl._bufferedBytes, data, head);
+		impl._bufferedBytes = capacity;
+		if (!impl.submit())
+			return false;
+		impl._bufferOffset = offset + head;
+		impl._bufferedBytes = size - head;
+		std::memcpy(impl._buffer.data(), static_cast<const std::byte*>(data) + head, impl._bufferedBytes);
+		return true;
+	}
+}
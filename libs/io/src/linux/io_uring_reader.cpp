@@ -0,0 +1,357 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../async_reader.hpp"
+
+#include <seir_base/buffer.hpp>
+#include <seir_io/buffer_blob.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstdio>  // fprintf, perror
+#include <cstdlib> // abort
+#include <cstring> // memset, strerror
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>           // AT_*, O_*
+#include <linux/io_uring.h>  // io_uring_*, IORING_*
+#include <sys/mman.h>        // mmap, munmap
+#include <sys/stat.h>        // statx
+#include <sys/syscall.h>     // __NR_io_uring_*
+#include <unistd.h>          // close, syscall
+
+namespace
+{
+	const auto kMapFailed = MAP_FAILED; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast, performance-no-int-to-ptr)
+
+	// Reads are split into parts because io_uring reads are limited to 32-bit sizes.
+	constexpr size_t kMaxReadSize = size_t{ 1 } << 30;
+
+	// Kernels before 5.6 support io_uring, but fail the operations we need with EINVAL
+	// (and also don't support probing, which is how we detect them).
+	bool hasRequiredOperations(int ring) noexcept
+	{
+		alignas(io_uring_probe) std::array<std::byte, sizeof(io_uring_probe) + IORING_OP_LAST * sizeof(io_uring_probe_op)> buffer{};
+		const auto probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+		if (::syscall(__NR_io_uring_register, ring, IORING_REGISTER_PROBE, probe, IORING_OP_LAST) == -1)
+			return false;
+		return std::ranges::all_of(std::array{ IORING_OP_NOP, IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ }, [probe](unsigned opcode) {
+			return opcode < probe->ops_len && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+		});
+	}
+
+	struct IoUringRequest
+	{
+		enum class Stage
+		{
+			Open,
+			Stat,
+			Read,
+		};
+
+		std::unique_ptr<seir::AsyncReadRequest> _request;
+		Stage _stage = Stage::Open;
+		int _descriptor = -1;
+		struct statx _statx;
+		seir::Buffer _buffer;
+		size_t _size = 0;      // Size of the buffer to fill.
+		size_t _bytesRead = 0; // Number of bytes already read.
+		bool _failed = false;
+
+		explicit IoUringRequest(std::unique_ptr<seir::AsyncReadRequest>&& request) noexcept
+			: _request{ std::move(request) } {}
+
+		~IoUringRequest() noexcept
+		{
+			if (_descriptor != -1 && ::close(_descriptor) == -1)
+				::perror("close");
+		}
+	};
+
+	// Every request has exactly one operation in flight, so there is no more
+	// in-flight operations than submission queue entries, and the completion
+	// queue (which is at least twice as large) never overflows.
+	class IoUringReader final : public seir::AsyncReaderBackend
+	{
+	public:
+		~IoUringReader() noexcept override
+		{
+			if (_thread.joinable())
+			{
+				{
+					const std::scoped_lock lock{ _mutex };
+					_stop = true;
+					pushEntry(IORING_OP_NOP, nullptr, [](io_uring_sqe&) {});
+					submitEntries();
+				}
+				_thread.join();
+			}
+			if (_completionRing != kMapFailed && _completionRing != _submissionRing && ::munmap(_completionRing, _completionRingSize) == -1)
+				::perror("munmap");
+			if (_submissionRing != kMapFailed && ::munmap(_submissionRing, _submissionRingSize) == -1)
+				::perror("munmap");
+			if (_entries != kMapFailed && ::munmap(_entries, _entriesSize) == -1)
+				::perror("munmap");
+			if (_ring != -1 && ::close(_ring) == -1)
+				::perror("close");
+		}
+
+		bool initialize(unsigned maxReads) noexcept
+		{
+			io_uring_params params;
+			std::memset(&params, 0, sizeof params);
+			_ring = static_cast<int>(::syscall(__NR_io_uring_setup, maxReads, &params));
+			if (_ring == -1)
+				return false; // Not supported by the kernel or forbidden.
+			if (!::hasRequiredOperations(_ring))
+				return false;
+			_submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+			_completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+			const auto singleMapping = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+			if (singleMapping && _completionRingSize > _submissionRingSize)
+				_submissionRingSize = _completionRingSize;
+			_submissionRing = ::mmap(nullptr, _submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQ_RING);
+			_completionRing = singleMapping || _submissionRing == kMapFailed
+				? _submissionRing
+				: ::mmap(nullptr, _completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_CQ_RING);
+			_entriesSize = params.sq_entries * sizeof(io_uring_sqe);
+			if (_completionRing != kMapFailed)
+				_entries = ::mmap(nullptr, _entriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, _ring, IORING_OFF_SQES);
+			if (_entries == kMapFailed)
+			{
+				::perror("mmap");
+				return false;
+			}
+			const auto submissionRing = static_cast<std::byte*>(_submissionRing);
+			_submissionHead = reinterpret_cast<unsigned*>(submissionRing + params.sq_off.head);
+			_submissionTail = reinterpret_cast<unsigned*>(submissionRing + params.sq_off.tail);
+			_submissionMask = *reinterpret_cast<const unsigned*>(submissionRing + params.sq_off.ring_mask);
+			_submissionArray = reinterpret_cast<unsigned*>(submissionRing + params.sq_off.array);
+			const auto completionRing = static_cast<std::byte*>(_completionRing);
+			_completionHead = reinterpret_cast<unsigned*>(completionRing + params.cq_off.head);
+			_completionTail = reinterpret_cast<unsigned*>(completionRing + params.cq_off.tail);
+			_completionMask = *reinterpret_cast<const unsigned*>(completionRing + params.cq_off.ring_mask);
+			_completions = reinterpret_cast<io_uring_cqe*>(completionRing + params.cq_off.cqes);
+			_capacity = params.sq_entries;
+			_thread = std::thread{ [this] { run(); } };
+			return true;
+		}
+
+		void submit(std::unique_ptr<seir::AsyncReadRequest>&& request) override
+		{
+			auto ioRequest = std::make_unique<IoUringRequest>(std::move(request));
+			const std::scoped_lock lock{ _mutex };
+			if (_inFlight < _capacity)
+			{
+				start(ioRequest.release());
+				submitEntries();
+			}
+			else
+				_queue.emplace_back(std::move(ioRequest));
+		}
+
+	private:
+		template <typename F>
+		void pushEntry(uint8_t opcode, IoUringRequest* request, F&& setup) noexcept
+		{
+			const auto tail = *_submissionTail;
+			const auto index = tail & _submissionMask;
+			auto& entry = static_cast<io_uring_sqe*>(_entries)[index];
+			std::memset(&entry, 0, sizeof entry);
+			entry.opcode = opcode;
+			entry.user_data = reinterpret_cast<uintptr_t>(request);
+			setup(entry);
+			_submissionArray[index] = index;
+			std::atomic_ref{ *_submissionTail }.store(tail + 1, std::memory_order_release);
+			++_unsubmitted;
+		}
+
+		void submitEntries() noexcept
+		{
+			while (_unsubmitted > 0)
+			{
+				const auto result = ::syscall(__NR_io_uring_enter, _ring, _unsubmitted, 0, 0, nullptr, 0);
+				if (result == -1)
+				{
+					if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+						continue;
+					::perror("io_uring_enter");
+					std::abort(); // Submitted requests would never finish.
+				}
+				_unsubmitted -= static_cast<unsigned>(result);
+			}
+		}
+
+		// Starts the first operation of a request.
+		void start(IoUringRequest* request) noexcept
+		{
+			++_inFlight;
+			pushOperation(request);
+		}
+
+		// Pushes the operation for the current stage of a request.
+		void pushOperation(IoUringRequest* request) noexcept
+		{
+			switch (request->_stage)
+			{
+			case IoUringRequest::Stage::Open:
+				pushEntry(IORING_OP_OPENAT, request, [request](io_uring_sqe& entry) {
+					entry.fd = AT_FDCWD;
+					entry.addr = reinterpret_cast<uintptr_t>(request->_request->_path.c_str());
+					entry.open_flags = O_RDONLY | O_CLOEXEC;
+				});
+				break;
+			case IoUringRequest::Stage::Stat:
+				pushEntry(IORING_OP_STATX, request, [request](io_uring_sqe& entry) {
+					entry.fd = request->_descriptor;
+					entry.addr = reinterpret_cast<uintptr_t>("");
+					entry.len = STATX_SIZE;
+					entry.off = reinterpret_cast<uintptr_t>(&request->_statx);
+					entry.statx_flags = AT_EMPTY_PATH;
+				});
+				break;
+			case IoUringRequest::Stage::Read:
+				pushEntry(IORING_OP_READ, request, [request](io_uring_sqe& entry) {
+					entry.fd = request->_descriptor;
+					entry.addr = reinterpret_cast<uintptr_t>(request->_buffer.data() + request->_bytesRead);
+					entry.len = static_cast<uint32_t>(std::min(request->_size - request->_bytesRead, kMaxReadSize));
+					entry.off = request->_request->_offset + request->_bytesRead;
+				});
+				break;
+			}
+		}
+
+		// Handles a finished operation and pushes the next one if needed.
+		// Returns false if the request is finished.
+		bool advance(IoUringRequest* request, int result) noexcept
+		{
+			if (result < 0)
+			{
+				if (result == -EINTR || result == -EAGAIN)
+				{
+					pushOperation(request);
+					return true;
+				}
+				constexpr std::array kOperations{ "openat", "statx", "read" };
+				std::fprintf(stderr, "%s: %s\n", kOperations[static_cast<size_t>(request->_stage)], std::strerror(-result));
+				request->_failed = true;
+				return false;
+			}
+			switch (request->_stage)
+			{
+			case IoUringRequest::Stage::Open:
+				request->_descriptor = result;
+				if (request->_request->_size == seir::AsyncReadRequest::kToEnd)
+				{
+					request->_stage = IoUringRequest::Stage::Stat;
+					pushOperation(request);
+					return true;
+				}
+				request->_size = request->_request->_size;
+				break;
+			case IoUringRequest::Stage::Stat:
+				request->_size = request->_statx.stx_size > request->_request->_offset ? static_cast<size_t>(request->_statx.stx_size - request->_request->_offset) : 0;
+				break;
+			case IoUringRequest::Stage::Read:
+				if (!result)
+					return false; // The end of the file.
+				request->_bytesRead += static_cast<size_t>(result);
+				if (request->_bytesRead == request->_size)
+					return false;
+				pushOperation(request);
+				return true;
+			}
+			if (!request->_size)
+				return false;
+			if (!request->_buffer.tryReserve(request->_size, 0))
+			{
+				request->_failed = true;
+				return false;
+			}
+			request->_stage = IoUringRequest::Stage::Read;
+			pushOperation(request);
+			return true;
+		}
+
+		void run()
+		{
+			for (;;)
+			{
+				if (::syscall(__NR_io_uring_enter, _ring, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0) == -1 && errno != EINTR)
+				{
+					::perror("io_uring_enter");
+					std::abort();
+				}
+				const auto head = *_completionHead;
+				const auto tail = std::atomic_ref{ *_completionTail }.load(std::memory_order_acquire);
+				if (head == tail)
+					continue;
+				std::unique_lock lock{ _mutex };
+				for (auto i = head; i != tail; ++i)
+				{
+					const auto& completion = _completions[i & _completionMask];
+					const auto request = reinterpret_cast<IoUringRequest*>(static_cast<uintptr_t>(completion.user_data));
+					if (!request)
+					{
+						if (_stop)
+							return;
+						continue;
+					}
+					if (advance(request, completion.res))
+						continue;
+					--_inFlight;
+					if (!_queue.empty())
+					{
+						start(_queue.front().release());
+						_queue.pop_front();
+					}
+					lock.unlock();
+					const std::unique_ptr<IoUringRequest> finished{ request };
+					finished->_request->finish(finished->_failed ? seir::SharedPtr<seir::Blob>{} : seir::makeShared<seir::Blob, seir::BufferBlob>(std::move(finished->_buffer), finished->_bytesRead));
+					lock.lock();
+				}
+				std::atomic_ref{ *_completionHead }.store(tail, std::memory_order_release);
+				submitEntries();
+			}
+		}
+
+	private:
+		int _ring = -1;
+		void* _submissionRing = kMapFailed;
+		size_t _submissionRingSize = 0;
+		void* _completionRing = kMapFailed;
+		size_t _completionRingSize = 0;
+		void* _entries = kMapFailed;
+		size_t _entriesSize = 0;
+		unsigned* _submissionHead = nullptr;
+		unsigned* _submissionTail = nullptr;
+		unsigned _submissionMask = 0;
+		unsigned* _submissionArray = nullptr;
+		unsigned* _completionHead = nullptr;
+		unsigned* _completionTail = nullptr;
+		unsigned _completionMask = 0;
+		io_uring_cqe* _completions = nullptr;
+		unsigned _capacity = 0;
+		std::mutex _mutex;
+		unsigned _inFlight = 0;
+		unsigned _unsubmitted = 0;
+		std::deque<std::unique_ptr<IoUringRequest>> _queue;
+		bool _stop = false;
+		std::thread _thread;
+	};
+}
+
+namespace seir
+{
+	std::unique_ptr<AsyncReaderBackend> createIoUringReader(unsigned maxReads)
+	{
+		if (auto reader = std::make_unique<IoUringReader>(); reader->initialize(maxReads))
+			return reader;
+		return {};
+	}
+}
@@ -4,13 +4,21 @@
 
 #include <seir_base/scope.hpp>
 #include <seir_io/blob.hpp>
+#include <seir_io/buffer_blob.hpp>
 #include <seir_io/save_file.hpp>
 #include <seir_io/temporary.hpp>
+#include "../async_reader.hpp"
 
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstdint>
 #include <cstdio>     // perror, rename
-#include <fcntl.h>    // open
-#include <sys/mman.h> // mmap, munmap
-#include <unistd.h>   // close, fsync, lseek, pwrite, unlink
+#include <fcntl.h>    // fallocate, open
+#include <sys/mman.h> // madvise, mmap, munmap
+#include <sys/stat.h> // fstat
+#include <sys/uio.h>  // pwritev
+#include <unistd.h>   // close, fsync, lseek, pread, pwrite, sysconf, unlink
 
 namespace
 {
@@ -30,6 +38,20 @@ namespace
 
 	const auto kMapFailed = MAP_FAILED; // NOLINT(cppcoreguidelines-pro-type-cstyle-cast, performance-no-int-to-ptr)
 
+	constexpr size_t kHugePageSize = size_t{ 2 } << 20;
+
+	uintptr_t pageMask() noexcept
+	{
+		static const auto mask = static_cast<uintptr_t>(::sysconf(_SC_PAGESIZE)) - 1;
+		return mask;
+	}
+
+	void adviseMemory(const void* data, size_t size, int advice) noexcept
+	{
+		if (::madvise(const_cast<void*>(data), size, advice) == -1)
+			::perror("madvise");
+	}
+
 	struct FileBlob final : seir::Blob
 	{
 		FileBlob(void*& data, size_t size) noexcept
@@ -39,9 +61,31 @@ namespace
 			if (_data != kMapFailed && ::munmap(const_cast<void*>(_data), _size) == -1)
 				::perror("munmap");
 		}
-		static seir::SharedPtr<seir::Blob> create(int descriptor, size_t size)
+		void evict(size_t offset, size_t size) const noexcept override
 		{
-			if (auto data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0); data == kMapFailed)
+			// The mapping is private and read-only, so the pages can't be modified
+			// and will be read from the file again when accessed.
+			adviseRange(offset, size, MADV_DONTNEED);
+		}
+		void prefetch(size_t offset, size_t size) const noexcept override
+		{
+			adviseRange(offset, size, MADV_WILLNEED);
+		}
+		void adviseRange(size_t offset, size_t size, int advice) const noexcept
+		{
+			if (offset >= _size || !size)
+				return;
+			if (size > _size - offset)
+				size = _size - offset;
+			const auto begin = reinterpret_cast<uintptr_t>(_data) + offset;
+			const auto alignedBegin = begin & ~::pageMask();
+			::adviseMemory(reinterpret_cast<const void*>(alignedBegin), begin + size - alignedBegin, advice);
+		}
+		static seir::SharedPtr<seir::Blob> create(int descriptor, size_t size, const seir::FileBlobOptions& options)
+		{
+			if (!size)
+				return seir::Blob::from(nullptr, 0);
+			if (auto data = map(descriptor, size, options); data == kMapFailed)
 				::perror("mmap");
 			else
 			{
@@ -49,10 +93,54 @@ namespace
 					if (data != kMapFailed && ::munmap(data, size) == -1)
 						::perror("munmap");
 				} };
+				if (options._access == seir::FileAccess::Sequential)
+					::adviseMemory(data, size, MADV_SEQUENTIAL);
+				else if (options._access == seir::FileAccess::Random)
+					::adviseMemory(data, size, MADV_RANDOM);
+#ifdef MADV_HUGEPAGE
+				if (options._hugePages && size >= kHugePageSize)
+					::madvise(data, size, MADV_HUGEPAGE); // Fails if the kernel doesn't support huge pages for files, which is fine.
+#endif
+#ifndef MAP_POPULATE
+				if (options._populate)
+					::adviseMemory(data, size, MADV_WILLNEED);
+#endif
 				return seir::makeShared<seir::Blob, FileBlob>(data, size);
 			}
 			return {};
 		}
+		static void* map(int descriptor, size_t size, const seir::FileBlobOptions& options) noexcept
+		{
+			auto flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+			if (options._populate)
+				flags |= MAP_POPULATE;
+#endif
+			if (!options._hugePages || size < kHugePageSize)
+				return ::mmap(nullptr, size, PROT_READ, flags, descriptor, 0);
+			// Reserve enough address space to place the mapping at a huge page boundary,
+			// then map the file over the reservation and release the unused parts.
+			const auto reservedSize = size + kHugePageSize;
+			const auto reserved = ::mmap(nullptr, reservedSize, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if (reserved == kMapFailed)
+				return ::mmap(nullptr, size, PROT_READ, flags, descriptor, 0);
+			const auto reservedBegin = reinterpret_cast<uintptr_t>(reserved);
+			const auto reservedEnd = reservedBegin + reservedSize;
+			const auto begin = (reservedBegin + kHugePageSize - 1) & ~(kHugePageSize - 1);
+			const auto data = ::mmap(reinterpret_cast<void*>(begin), size, PROT_READ, flags | MAP_FIXED, descriptor, 0);
+			if (data == kMapFailed)
+			{
+				if (::munmap(reserved, reservedSize) == -1)
+					::perror("munmap");
+				return kMapFailed;
+			}
+			const auto end = (begin + size + ::pageMask()) & ~::pageMask();
+			if (begin > reservedBegin && ::munmap(reserved, begin - reservedBegin) == -1)
+				::perror("munmap");
+			if (end < reservedEnd && ::munmap(reinterpret_cast<void*>(end), reservedEnd - end) == -1)
+				::perror("munmap");
+			return data;
+		}
 	};
 
 	bool flushFile(int descriptor) noexcept
@@ -71,14 +159,71 @@ namespace
 		return false;
 	}
 
+	bool writeFileParts(int descriptor, uint64_t offset, std::span<const std::span<const std::byte>> parts) noexcept
+	{
+		constexpr size_t kMaxVectors = 64;
+		std::array<iovec, kMaxVectors> vectors; // NOLINT(cppcoreguidelines-pro-type-member-init)
+		while (!parts.empty())
+		{
+			const auto count = std::min(parts.size(), kMaxVectors);
+			size_t size = 0;
+			for (size_t i = 0; i < count; ++i)
+			{
+				vectors[i] = { const_cast<std::byte*>(parts[i].data()), parts[i].size() };
+				size += parts[i].size();
+			}
+			auto written = ::pwritev(descriptor, vectors.data(), static_cast<int>(count), static_cast<int64_t>(offset));
+			if (written == -1)
+			{
+				::perror("pwritev");
+				return false;
+			}
+			if (static_cast<size_t>(written) < size)
+			{
+				// Complete a short write part by part.
+				auto partOffset = offset;
+				for (size_t i = 0; i < count; ++i)
+				{
+					const auto partSize = parts[i].size();
+					if (static_cast<size_t>(written) >= partSize)
+						written -= static_cast<ssize_t>(partSize);
+					else
+					{
+						if (!::writeFile(descriptor, partOffset + static_cast<size_t>(written), parts[i].data() + written, partSize - static_cast<size_t>(written)))
+							return false;
+						written = 0;
+					}
+					partOffset += partSize;
+				}
+			}
+			offset += size;
+			parts = parts.subspan(count);
+		}
+		return true;
+	}
+
+	bool reserveFile([[maybe_unused]] int descriptor, [[maybe_unused]] uint64_t capacity) noexcept
+	{
+#ifdef __linux__
+		// Allocates the space without changing the file size, so the file doesn't get fragmented as it grows.
+		if (::fallocate(descriptor, FALLOC_FL_KEEP_SIZE, 0, static_cast<int64_t>(capacity)) == -1 && errno != EOPNOTSUPP)
+		{
+			::perror("fallocate");
+			return false;
+		}
+#endif
+		return true;
+	}
+
 	struct FileWriter final : seir::Writer
 	{
 		const Descriptor _file;
 		constexpr explicit FileWriter(Descriptor&& file) noexcept
 			: _file{ std::move(file) } {}
 		bool flush() noexcept override { return ::flushFile(_file._descriptor); }
-		bool reserveImpl(uint64_t) noexcept override { return true; }
+		bool reserveImpl(uint64_t capacity) noexcept override { return capacity <= size() || ::reserveFile(_file._descriptor, capacity); }
 		bool writeImpl(uint64_t offset, const void* data, size_t size) noexcept override { return ::writeFile(_file._descriptor, offset, data, size); }
+		bool writePartsImpl(uint64_t offset, std::span<const std::span<const std::byte>> parts) noexcept override { return ::writeFileParts(_file._descriptor, offset, parts); }
 	};
 
 	seir::UniquePtr<seir::Writer> createFileWriter(const char* path)
@@ -108,8 +253,9 @@ namespace
 				::perror("unlink");
 		}
 		bool flush() noexcept override { return true; }
-		bool reserveImpl(uint64_t) noexcept override { return true; }
+		bool reserveImpl(uint64_t capacity) noexcept override { return capacity <= size() || ::reserveFile(_file._descriptor, capacity); }
 		bool writeImpl(uint64_t offset, const void* data, size_t size) noexcept override { return ::writeFile(_file._descriptor, offset, data, size); }
+		bool writePartsImpl(uint64_t offset, std::span<const std::span<const std::byte>> parts) noexcept override { return ::writeFileParts(_file._descriptor, offset, parts); }
 	};
 
 	struct TemporaryWriterImpl final : seir::TemporaryWriter
@@ -124,8 +270,9 @@ namespace
 				::perror("unlink");
 		}
 		bool flush() noexcept override { return true; }
-		bool reserveImpl(uint64_t) noexcept override { return true; }
+		bool reserveImpl(uint64_t capacity) noexcept override { return capacity <= size() || ::reserveFile(_file._descriptor, capacity); }
 		bool writeImpl(uint64_t offset, const void* data, size_t size) noexcept override { return ::writeFile(_file._descriptor, offset, data, size); }
+		bool writePartsImpl(uint64_t offset, std::span<const std::span<const std::byte>> parts) noexcept override { return ::writeFileParts(_file._descriptor, offset, parts); }
 	};
 
 	struct TemporaryFileImpl final : seir::TemporaryFile
@@ -144,7 +291,7 @@ namespace
 
 namespace seir
 {
-	SharedPtr<Blob> Blob::from(const std::string& path)
+	SharedPtr<Blob> Blob::from(const std::string& path, const FileBlobOptions& options)
 	{
 		constexpr int flags = O_RDONLY | O_CLOEXEC
 #ifdef __linux__
@@ -156,14 +303,14 @@ namespace seir
 		else if (const auto size = ::lseek(file._descriptor, 0, SEEK_END); size == -1)
 			::perror("lseek");
 		else
-			return FileBlob::create(file._descriptor, static_cast<uint64_t>(size));
+			return FileBlob::create(file._descriptor, static_cast<uint64_t>(size), options);
 		return {};
 	}
 
 	SharedPtr<Blob> Blob::from(TemporaryFile& file)
 	{
 		const auto& impl = static_cast<const TemporaryFileImpl&>(file);
-		return FileBlob::create(impl._file._descriptor, impl._size);
+		return FileBlob::create(impl._file._descriptor, impl._size, {});
 	}
 
 	UniquePtr<SaveFile> SaveFile::create(std::string&& path)
@@ -225,4 +372,43 @@ namespace seir
 	{
 		return ::createFileWriter(path.c_str());
 	}
+
+	SharedPtr<Blob> readFile(const std::string& path, uint64_t offset, size_t size)
+	{
+		const Descriptor file{ ::open(path.c_str(), O_RDONLY | O_CLOEXEC) };
+		if (file._descriptor == -1)
+		{
+			::perror("open");
+			return {};
+		}
+		if (size == AsyncReadRequest::kToEnd)
+		{
+			struct stat status; // NOLINT(cppcoreguidelines-pro-type-member-init)
+			if (::fstat(file._descriptor, &status) == -1)
+			{
+				::perror("fstat");
+				return {};
+			}
+			const auto fileSize = static_cast<uint64_t>(status.st_size);
+			size = fileSize > offset ? static_cast<size_t>(fileSize - offset) : 0;
+		}
+		Buffer buffer;
+		if (!buffer.tryReserve(size, 0))
+			return {};
+		size_t bytesRead = 0;
+		while (bytesRead < size)
+		{
+			const auto result = ::pread(file._descriptor, buffer.data() + bytesRead, size - bytesRead, static_cast<int64_t>(offset + bytesRead));
+			if (result > 0)
+				bytesRead += static_cast<size_t>(result);
+			else if (!result)
+				break;
+			else if (errno != EINTR)
+			{
+				::perror("pread");
+				return {};
+			}
+		}
+		return makeShared<Blob, BufferBlob>(std::move(buffer), bytesRead);
+	}
 }
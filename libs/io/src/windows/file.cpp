@@ -4,10 +4,14 @@
 
 #include <seir_base/scope.hpp>
 #include <seir_io/blob.hpp>
+#include <seir_io/buffer_blob.hpp>
 #include <seir_io/save_file.hpp>
 #include <seir_io/temporary.hpp>
+#include "../async_reader.hpp"
 #include "utils.hpp"
 
+#include <algorithm>
+
 namespace
 {
 	struct FileBlob final : seir::Blob
@@ -19,11 +23,30 @@ namespace
 			if (!::UnmapViewOfFile(_data))
 				seir::windows::reportError("UnmapViewOfFile");
 		}
+		void evict(size_t offset, size_t size) const noexcept override
+		{
+			if (offset < _size && size > 0)
+				::VirtualUnlock(const_cast<std::byte*>(static_cast<const std::byte*>(_data)) + offset, size < _size - offset ? size : _size - offset); // Unlocking unlocked pages removes them from the working set.
+		}
+		void prefetch(size_t offset, size_t size) const noexcept override
+		{
+			if (offset < _size && size > 0)
+			{
+				WIN32_MEMORY_RANGE_ENTRY range{ const_cast<std::byte*>(static_cast<const std::byte*>(_data)) + offset, size < _size - offset ? size : _size - offset };
+				if (!::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0))
+					seir::windows::reportError("PrefetchVirtualMemory");
+			}
+		}
 	};
 
-	seir::SharedPtr<seir::Blob> createFileBlob(const wchar_t* path)
+	seir::SharedPtr<seir::Blob> createFileBlob(const wchar_t* path, const seir::FileBlobOptions& options)
 	{
-		if (const seir::windows::Handle file{ ::CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) }; file == INVALID_HANDLE_VALUE)
+		DWORD attributes = FILE_ATTRIBUTE_NORMAL;
+		if (options._access == seir::FileAccess::Sequential)
+			attributes |= FILE_FLAG_SEQUENTIAL_SCAN;
+		else if (options._access == seir::FileAccess::Random)
+			attributes |= FILE_FLAG_RANDOM_ACCESS;
+		if (const seir::windows::Handle file{ ::CreateFileW(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, attributes, nullptr) }; file == INVALID_HANDLE_VALUE)
 		{
 			if (const auto error = ::GetLastError(); error != ERROR_PATH_NOT_FOUND)
 				seir::windows::reportError("CreateFileW", error);
@@ -45,7 +68,11 @@ namespace
 						if (data && !::UnmapViewOfFile(data))
 							seir::windows::reportError("UnmapViewOfFile");
 					} };
-					return seir::makeShared<seir::Blob, FileBlob>(data, static_cast<size_t>(size.QuadPart));
+					// Windows doesn't support huge pages for file mappings, so the option is ignored.
+					auto blob = seir::makeShared<seir::Blob, FileBlob>(data, static_cast<size_t>(size.QuadPart));
+					if (options._populate)
+						blob->prefetch(0, blob->size());
+					return blob;
 				}
 		}
 		return {};
@@ -59,6 +86,17 @@ namespace
 		return false;
 	}
 
+	bool reserveFile(HANDLE handle, uint64_t capacity) noexcept
+	{
+		// Allocates the space without changing the file size, so the file doesn't get fragmented as it grows.
+		FILE_ALLOCATION_INFO info{};
+		info.AllocationSize.QuadPart = static_cast<LONGLONG>(capacity);
+		if (::SetFileInformationByHandle(handle, FileAllocationInfo, &info, sizeof info))
+			return true;
+		seir::windows::reportError("SetFileInformationByHandle");
+		return false;
+	}
+
 	bool writeFile(HANDLE handle, uint64_t offset, const void* data, size_t size) noexcept
 	{
 		DWORD bytesWritten = 0;
@@ -79,7 +117,7 @@ namespace
 			explicit FileWriter(seir::windows::Handle&& handle) noexcept
 				: _handle{ std::move(handle) } {}
 			bool flush() noexcept override { return ::flushFile(_handle); }
-			bool reserveImpl(uint64_t) noexcept override { return true; }
+			bool reserveImpl(uint64_t capacity) noexcept override { return capacity <= size() || ::reserveFile(_handle, capacity); }
 			bool writeImpl(uint64_t offset, const void* data, size_t size) noexcept override { return ::writeFile(_handle, offset, data, size); }
 		};
 
@@ -131,10 +169,10 @@ namespace
 
 namespace seir
 {
-	SharedPtr<Blob> Blob::from(const std::string& path)
+	SharedPtr<Blob> Blob::from(const std::string& path, const FileBlobOptions& options)
 	{
 		if (const windows::WString wpath{ path })
-			return ::createFileBlob(wpath.c_str());
+			return ::createFileBlob(wpath.c_str(), options);
 		return {};
 	}
 
@@ -241,4 +279,51 @@ namespace seir
 			return ::createFileWriter(wpath.c_str(), FILE_ATTRIBUTE_NORMAL);
 		return {};
 	}
+
+	SharedPtr<Blob> readFile(const std::string& path, uint64_t offset, size_t size)
+	{
+		const windows::WString wpath{ path };
+		if (!wpath)
+			return {};
+		const windows::Handle file{ ::CreateFileW(wpath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr) };
+		if (file == INVALID_HANDLE_VALUE)
+		{
+			windows::reportError("CreateFileW");
+			return {};
+		}
+		if (size == AsyncReadRequest::kToEnd)
+		{
+			LARGE_INTEGER fileSize{};
+			if (!::GetFileSizeEx(file, &fileSize))
+			{
+				windows::reportError("GetFileSizeEx");
+				return {};
+			}
+			size = static_cast<uint64_t>(fileSize.QuadPart) > offset ? static_cast<size_t>(static_cast<uint64_t>(fileSize.QuadPart) - offset) : 0;
+		}
+		Buffer buffer;
+		if (!buffer.tryReserve(size, 0))
+			return {};
+		size_t bytesRead = 0;
+		while (bytesRead < size)
+		{
+			const auto position = offset + bytesRead;
+			OVERLAPPED overlapped{};
+			overlapped.Offset = static_cast<DWORD>(position);
+			overlapped.OffsetHigh = static_cast<DWORD>(position >> 32);
+			DWORD partSize = 0;
+			if (!::ReadFile(file, buffer.data() + bytesRead, static_cast<DWORD>(std::min<size_t>(size - bytesRead, 1u << 30)), &partSize, &overlapped))
+			{
+				if (const auto error = ::GetLastError(); error != ERROR_HANDLE_EOF)
+				{
+					windows::reportError("ReadFile", error);
+					return {};
+				}
+			}
+			if (!partSize)
+				break;
+			bytesRead += partSize;
+		}
+		return makeShared<Blob, BufferBlob>(std::move(buffer), bytesRead);
+	}
 }
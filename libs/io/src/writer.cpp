@@ -31,4 +31,26 @@ namespace seir
 			_size = _offset;
 		return true;
 	}
+
+	bool Writer::writeParts(std::span<const std::span<const std::byte>> parts) noexcept
+	{
+		if (!writePartsImpl(_offset, parts))
+			return false;
+		for (const auto& part : parts)
+			_offset += part.size();
+		if (_offset > _size)
+			_size = _offset;
+		return true;
+	}
+
+	bool Writer::writePartsImpl(uint64_t offset, std::span<const std::span<const std::byte>> parts) noexcept
+	{
+		for (const auto& part : parts)
+		{
+			if (!writeImpl(offset, part.data(), part.size()))
+				return false;
+			offset += part.size();
+		}
+		return true;
+	}
 }
@@ -0,0 +1,92 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_io/async_reader.hpp>
+
+#include <seir_io/blob.hpp>
+#include <seir_io/temporary.hpp>
+
+#include <atomic>
+#include <cstring>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+	std::string blobString(const seir::SharedPtr<seir::Blob>& blob)
+	{
+		return { static_cast<const char*>(blob->data()), blob->size() };
+	}
+}
+
+TEST_CASE("AsyncReader")
+{
+	bool threadPool = false;
+	SUBCASE("default") {}
+	SUBCASE("threadPool") { threadPool = true; }
+	seir::AsyncReader reader{ { ._maxReads = 4, ._threadPool = threadPool } };
+	SUBCASE("read(path)")
+	{
+		auto future = reader.read(SEIR_TEST_DIR "file.txt");
+		const auto blob = future.get();
+		REQUIRE(blob);
+		CHECK(::blobString(blob) == "contents");
+	}
+	SUBCASE("read(path, offset, size)")
+	{
+		auto middle = reader.read(SEIR_TEST_DIR "file.txt", 2, 3);
+		auto end = reader.read(SEIR_TEST_DIR "file.txt", 5, 100);
+		auto outside = reader.read(SEIR_TEST_DIR "file.txt", 100, 1);
+		const auto middleBlob = middle.get();
+		REQUIRE(middleBlob);
+		CHECK(::blobString(middleBlob) == "nte");
+		const auto endBlob = end.get();
+		REQUIRE(endBlob);
+		CHECK(::blobString(endBlob) == "nts");
+		const auto outsideBlob = outside.get();
+		REQUIRE(outsideBlob);
+		CHECK(outsideBlob->size() == 0);
+	}
+	SUBCASE("read(path, callback)")
+	{
+		constexpr size_t size = 1 << 20;
+		std::vector<std::byte> data(size);
+		for (size_t i = 0; i < size; ++i)
+			data[i] = static_cast<std::byte>(i * 7 / 3);
+		auto writer = seir::TemporaryWriter::create();
+		REQUIRE(writer);
+		REQUIRE(writer->write(data.data(), size));
+		const auto file = seir::TemporaryWriter::commit(std::move(writer));
+		REQUIRE(file);
+		constexpr size_t count = 32; // More reads than may be in flight.
+		std::atomic<size_t> succeeded{ 0 };
+		std::atomic<size_t> failed{ 0 };
+		for (size_t i = 0; i < count; ++i)
+			reader.read(file->path(), i * 1000, size - i * 1000, [&, i](seir::SharedPtr<seir::Blob>&& blob) {
+				if (blob && blob->size() == size - i * 1000 && !std::memcmp(blob->data(), data.data() + i * 1000, blob->size()))
+					succeeded.fetch_add(1);
+				else
+					failed.fetch_add(1);
+			});
+		reader.read(SEIR_TEST_DIR "missing.txt", [&](seir::SharedPtr<seir::Blob>&& blob) {
+			if (blob)
+				succeeded.fetch_add(1);
+			else
+				failed.fetch_add(1);
+		});
+		reader.wait();
+		CHECK(succeeded.load() == count);
+		CHECK(failed.load() == 1);
+	}
+	SUBCASE("read(path, throwingCallback)")
+	{
+		reader.read(SEIR_TEST_DIR "file.txt", [](seir::SharedPtr<seir::Blob>&&) { throw 1; });
+		reader.wait();
+		auto future = reader.read(SEIR_TEST_DIR "file.txt");
+		const auto blob = future.get();
+		REQUIRE(blob);
+		CHECK(::blobString(blob) == "contents");
+	}
+}
@@ -3,9 +3,12 @@
 // SPDX-License-Identifier: Apache-2.0
 
 #include <seir_io/blob.hpp>
+#include <seir_io/temporary.hpp>
 
 #include <array>
+#include <cstdint>
 #include <cstring>
+#include <vector>
 
 #include <doctest/doctest.h>
 
@@ -74,3 +77,45 @@ TEST_CASE("Blob::from(...)")
 		}
 	}
 }
+
+TEST_CASE("Blob::from(const std::string&, const FileBlobOptions&)")
+{
+	const std::string_view expected{ "contents" };
+	for (const auto access : { seir::FileAccess::Normal, seir::FileAccess::Sequential, seir::FileAccess::Random })
+		for (const auto populate : { false, true })
+		{
+			INFO("access = " << static_cast<int>(access) << ", populate = " << populate);
+			const auto blob = seir::Blob::from(SEIR_TEST_DIR "file.txt", { ._access = access, ._populate = populate });
+			REQUIRE(blob);
+			blob->prefetch(0, blob->size());
+			blob->evict(1, 100);
+			REQUIRE(blob->size() == expected.size());
+			CHECK_FALSE(std::memcmp(blob->data(), expected.data(), expected.size()));
+		}
+}
+
+TEST_CASE("Blob::from(const std::string&, const FileBlobOptions&) with huge pages")
+{
+	constexpr size_t size = 3 << 20;
+	std::vector<uint32_t> data(size / sizeof(uint32_t));
+	for (size_t i = 0; i < data.size(); ++i)
+		data[i] = static_cast<uint32_t>(i);
+	auto writer = seir::TemporaryWriter::create();
+	REQUIRE(writer);
+	REQUIRE(writer->write(data.data(), size));
+	const auto file = seir::TemporaryWriter::commit(std::move(writer));
+	REQUIRE(file);
+	const auto blob = seir::Blob::from(file->path(), { ._access = seir::FileAccess::Sequential, ._hugePages = true });
+	REQUIRE(blob);
+	REQUIRE(blob->size() == size);
+#ifndef _WIN32
+	CHECK(reinterpret_cast<uintptr_t>(blob->data()) % (2 << 20) == 0);
+#endif
+	CHECK_FALSE(std::memcmp(blob->data(), data.data(), size));
+	const auto part = seir::Blob::from(seir::SharedPtr{ blob }, size - 4096, 8192);
+	REQUIRE(part);
+	part->prefetch(0, part->size());
+	part->evict(0, part->size());
+	blob->evict(0, size);
+	CHECK_FALSE(std::memcmp(blob->data(), data.data(), size));
+}
@@ -6,6 +6,8 @@
 
 #include <seir_base/buffer.hpp>
 
+#include <algorithm>
+#include <array>
 #include <vector>
 
 #include <doctest/doctest.h>
@@ -45,3 +47,25 @@ TEST_CASE("BufferWriter")
 	CHECK(writer.seek(6));
 	CHECK(writer.offset() == 6);
 }
+
+TEST_CASE("BufferWriter::writeParts")
+{
+	seir::Buffer buffer;
+	uint64_t size = 0;
+	seir::BufferWriter writer{ buffer, &size };
+	REQUIRE(writer.write(uint8_t{ 0 }));
+	const auto capacity = buffer.capacity();
+	const std::vector<std::byte> first(3, std::byte{ 1 });
+	const std::vector<std::byte> second(capacity + 100, std::byte{ 2 }); // Enough to grow the buffer.
+	const std::vector<std::byte> third(5, std::byte{ 3 });
+	const std::array parts{ std::span{ first }, std::span<const std::byte>{}, std::span{ second }, std::span{ third } };
+	REQUIRE(writer.writeParts({ parts.begin(), parts.end() }));
+	CHECK(buffer.capacity() > capacity);
+	REQUIRE(size == 1 + first.size() + second.size() + third.size());
+	CHECK(writer.size() == size);
+	CHECK(writer.offset() == size);
+	CHECK(buffer.data()[0] == std::byte{ 0 });
+	CHECK(std::equal(first.begin(), first.end(), buffer.data() + 1));
+	CHECK(std::equal(second.begin(), second.end(), buffer.data() + 1 + first.size()));
+	CHECK(std::equal(third.begin(), third.end(), buffer.data() + 1 + first.size() + second.size()));
+}
@@ -0,0 +1,169 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_io/buffered_writer.hpp>
+
+#include <seir_io/blob.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+	struct TestWriter final : seir::Writer
+	{
+		std::vector<std::byte>& _data;
+		size_t& _writes;
+		size_t& _flushes;
+		TestWriter(std::vector<std::byte>& data, size_t& writes, size_t& flushes) noexcept
+			: _data{ data }, _writes{ writes }, _flushes{ flushes } {}
+		bool flush() noexcept override
+		{
+			++_flushes;
+			return true;
+		}
+		bool reserveImpl(uint64_t) noexcept override { return true; }
+		bool writeImpl(uint64_t offset, const void* data, size_t size) noexcept override
+		{
+			if (offset + size > _data.size())
+				_data.resize(static_cast<size_t>(offset + size));
+			std::memcpy(_data.data() + offset, data, size);
+			++_writes;
+			return true;
+		}
+	};
+
+	std::vector<std::byte> makeData(size_t size, unsigned seed)
+	{
+		std::vector<std::byte> data(size);
+		for (size_t i = 0; i < size; ++i)
+			data[i] = static_cast<std::byte>(i * seed / 3);
+		return data;
+	}
+}
+
+TEST_CASE("BufferedWriter")
+{
+	bool async = false;
+	SUBCASE("sync") {}
+	SUBCASE("async") { async = true; }
+	std::vector<std::byte> result;
+	size_t writes = 0;
+	size_t flushes = 0;
+	seir::BufferedWriter writer{ seir::makeUnique<seir::Writer, TestWriter>(result, writes, flushes), { ._bufferSize = 16, ._async = async } };
+	const auto small = ::makeData(6, 7);
+	SUBCASE("small writes")
+	{
+		REQUIRE(writer.write(small.data(), small.size()));
+		REQUIRE(writer.write(small.data(), small.size()));
+		CHECK(writer.size() == 12);
+		REQUIRE(writer.flush());
+		CHECK(writes == 1);
+		CHECK(flushes == 1);
+		REQUIRE(result.size() == 12);
+		CHECK(!std::memcmp(result.data(), small.data(), small.size()));
+		CHECK(!std::memcmp(result.data() + small.size(), small.data(), small.size()));
+	}
+	SUBCASE("flushBuffer")
+	{
+		REQUIRE(writer.write(small.data(), small.size()));
+		CHECK(result.empty());
+		REQUIRE(writer.flushBuffer());
+		CHECK(writes == 1);
+		CHECK(flushes == 0);
+		REQUIRE(result.size() == small.size());
+		CHECK(!std::memcmp(result.data(), small.data(), small.size()));
+	}
+	SUBCASE("buffer overflow")
+	{
+		for (int i = 0; i < 3; ++i)
+			REQUIRE(writer.write(small.data(), small.size()));
+		CHECK(writer.size() == 18);
+		REQUIRE(writer.flush());
+		CHECK(writes == 2);
+		REQUIRE(result.size() == 18);
+		for (size_t i = 0; i < 3; ++i)
+			CHECK(!std::memcmp(result.data() + i * small.size(), small.data(), small.size()));
+	}
+	SUBCASE("large write")
+	{
+		const auto large = ::makeData(40, 11);
+		REQUIRE(writer.write(small.data(), small.size()));
+		REQUIRE(writer.write(large.data(), large.size()));
+		CHECK(writer.size() == 46);
+		REQUIRE(writer.flush());
+		CHECK(writes == 2); // The default Writer::writeParts writes parts one by one.
+		REQUIRE(result.size() == 46);
+		CHECK(!std::memcmp(result.data(), small.data(), small.size()));
+		CHECK(!std::memcmp(result.data() + small.size(), large.data(), large.size()));
+	}
+	SUBCASE("seek")
+	{
+		REQUIRE(writer.write(uint32_t{ 0x01010101 }));
+		REQUIRE(writer.write(uint32_t{ 0x02020202 }));
+		REQUIRE(writer.seek(2));
+		REQUIRE(writer.write(uint32_t{ 0x03030303 }));
+		REQUIRE(writer.seek(writer.size()));
+		REQUIRE(writer.write(uint16_t{ 0x0404 }));
+		CHECK(writer.size() == 10);
+		REQUIRE(writer.flush());
+		CHECK(writes == 3);
+		const std::vector<uint8_t> expected{ 0x01, 0x01, 0x03, 0x03, 0x03, 0x03, 0x02, 0x02, 0x04, 0x04 };
+		REQUIRE(result.size() == expected.size());
+		CHECK(!std::memcmp(result.data(), expected.data(), expected.size()));
+	}
+	SUBCASE("destructor")
+	{
+		{
+			seir::BufferedWriter temporary{ seir::makeUnique<seir::Writer, TestWriter>(result, writes, flushes), { ._async = async } };
+			REQUIRE(temporary.write(small.data(), small.size()));
+			CHECK(result.empty());
+		}
+		REQUIRE(result.size() == small.size());
+		CHECK(!std::memcmp(result.data(), small.data(), small.size()));
+	}
+}
+
+TEST_CASE("BufferedWriter(Writer::create())")
+{
+	bool async = false;
+	SUBCASE("sync") {}
+	SUBCASE("async") { async = true; }
+	const auto path = std::filesystem::temp_directory_path() / "test.bin";
+	std::filesystem::remove(path);
+	constexpr size_t size = 100'000;
+	const auto data = ::makeData(size, 13);
+	{
+		auto fileWriter = seir::Writer::create(path.string());
+		REQUIRE(fileWriter);
+		seir::BufferedWriter writer{ std::move(fileWriter), { ._bufferSize = 4096, ._async = async } };
+		CHECK(writer.reserve(size));
+		CHECK(std::filesystem::file_size(path) == 0);
+		for (size_t offset = 0; offset < size;)
+		{
+			const auto chunk = std::min<size_t>(offset % 5000 + 1, size - offset); // Both smaller and larger than the buffer.
+			REQUIRE(writer.write(data.data() + offset, chunk));
+			offset += chunk;
+		}
+		CHECK(writer.size() == size);
+		REQUIRE(writer.flush());
+		CHECK(std::filesystem::file_size(path) == size);
+		REQUIRE(writer.seek(1000));
+		REQUIRE(writer.write(data.data(), 10));
+	}
+	{
+		const auto blob = seir::Blob::from(path.string());
+		REQUIRE(blob);
+		REQUIRE(blob->size() == size);
+		const auto blobData = static_cast<const std::byte*>(blob->data());
+		CHECK_FALSE(std::memcmp(blobData, data.data(), 1000));
+		CHECK_FALSE(std::memcmp(blobData + 1000, data.data(), 10));
+		CHECK_FALSE(std::memcmp(blobData + 1010, data.data() + 1010, size - 1010));
+	}
+	std::filesystem::remove(path);
+}
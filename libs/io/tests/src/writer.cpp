@@ -6,6 +6,7 @@
 
 #include <seir_io/blob.hpp>
 
+#include <array>
 #include <cstring>
 #include <filesystem>
 
@@ -85,6 +86,31 @@ TEST_CASE("Writer::create(const std::string&)")
 	std::filesystem::remove(path);
 }
 
+TEST_CASE("Writer::writeParts")
+{
+	const auto path = std::filesystem::temp_directory_path() / "test.txt";
+	std::filesystem::remove(path);
+	const std::string_view first{ "Hello " };
+	const std::string_view second{ "world!\n" };
+	const std::array parts{ std::as_bytes(std::span{ first }), std::span<const std::byte>{}, std::as_bytes(std::span{ second }) };
+	{
+		const auto writer = seir::Writer::create(path.string());
+		REQUIRE(writer);
+		REQUIRE(writer->writeParts(parts));
+		CHECK(writer->size() == first.size() + second.size());
+		CHECK(writer->offset() == first.size() + second.size());
+		REQUIRE(writer->seek(1));
+		REQUIRE(writer->writeParts({}));
+		CHECK(writer->offset() == 1);
+	}
+	{
+		const auto blob = seir::Blob::from(path.string());
+		REQUIRE(blob);
+		CHECK(std::string_view{ static_cast<const char*>(blob->data()), blob->size() } == "Hello world!\n");
+	}
+	std::filesystem::remove(path);
+}
+
 TEST_CASE("Writer::create({})")
 {
 	CHECK_FALSE(static_cast<bool>(seir::Writer::create(std::string{})));
@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <string_view>
 
 namespace seir
@@ -22,6 +23,14 @@ namespace seir
 		//
 		[[nodiscard]] static UniquePtr<Archiver> create(UniquePtr<Writer>&&, Compression);
 
+		// Creates an archiver which trains a compression dictionary of up to the specified size
+		// on the files added before the first finish() call and compresses all files using it.
+		// These files are kept in memory until finish() is called.
+		// If the compression doesn't support dictionaries, the files are compressed as usual.
+		// Large files are compressed using the specified number of worker threads if the compression supports it.
+		// If checksums are enabled, each file is stored with a CRC-32 of its contents which is verified when the file is opened.
+		[[nodiscard]] static UniquePtr<Archiver> create(UniquePtr<Writer>&&, Compression, size_t maxDictionarySize, unsigned workerCount = 0, bool checksums = false);
+
 		virtual ~Archiver() noexcept = default;
 
 		//
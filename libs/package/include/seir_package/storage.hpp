@@ -6,12 +6,14 @@
 
 #include <seir_base/unique_ptr.hpp>
 
+#include <cstdint>
 #include <string>
 
 namespace seir
 {
 	class Blob;
 	enum class Compression;
+	class CompressionDictionary;
 	template <class>
 	class SharedPtr;
 
@@ -34,10 +36,17 @@ namespace seir
 		//
 		void attach(std::string_view name, SharedPtr<Blob>&&, size_t offset, size_t size, Compression, size_t compressedSize);
 
+		// Attaches a file compressed using the specified dictionary.
+		void attach(std::string_view name, SharedPtr<Blob>&&, size_t offset, size_t size, Compression, size_t compressedSize, const SharedPtr<CompressionDictionary>&);
+
+		// Attaches a file which is verified against the specified CRC-32 of its original data when opened.
+		void attach(std::string_view name, SharedPtr<Blob>&&, size_t offset, size_t size, Compression, size_t compressedSize, const SharedPtr<CompressionDictionary>&, uint32_t crc32);
+
 		//
 		bool attachArchive(const SharedPtr<Blob>&);
 
-		//
+		// Compressed attachments are decompressed into memory and their source data is left resident.
+		// Callers which don't need it anymore can evict it from the attached Blob.
 		[[nodiscard]] SharedPtr<Blob> open(const std::string& name) const;
 
 	private:
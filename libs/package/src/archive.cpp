@@ -10,6 +10,11 @@ namespace seir
 {
 	UniquePtr<Archiver> Archiver::create(UniquePtr<Writer>&& writer, Compression compression)
 	{
-		return createSeirArchiver(std::move(writer), compression);
+		return createSeirArchiver(std::move(writer), compression, 0, 0, false);
+	}
+
+	UniquePtr<Archiver> Archiver::create(UniquePtr<Writer>&& writer, Compression compression, size_t maxDictionarySize, unsigned workerCount, bool checksums)
+	{
+		return createSeirArchiver(std::move(writer), compression, maxDictionarySize, workerCount, checksums);
 	}
 }
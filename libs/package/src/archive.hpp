@@ -16,5 +16,5 @@ namespace seir
 
 	constexpr uint32_t kSeirFileID = seir::makeCC('\xDF', 'S', 'a', '\x01');
 	bool attachSeirArchive(Storage&, const SharedPtr<Blob>&);
-	UniquePtr<Archiver> createSeirArchiver(UniquePtr<Writer>&&, Compression);
+	UniquePtr<Archiver> createSeirArchiver(UniquePtr<Writer>&&, Compression, size_t maxDictionarySize, unsigned workerCount, bool checksums);
 }
@@ -5,14 +5,19 @@
 #include "archive.hpp"
 
 #include <seir_base/buffer.hpp>
+#include <seir_base/checksum.hpp>
 #include <seir_compression/compression.hpp>
 #include <seir_io/blob.hpp>
 #include <seir_io/buffer_writer.hpp>
 #include <seir_io/writer.hpp>
 #include <seir_package/storage.hpp>
 
+#include <algorithm>
 #include <array>
+#include <cassert>
+#include <cstring>
 #include <limits>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -20,12 +25,20 @@ namespace
 {
 	constexpr size_t kSeirBlockAlignmentBits = 4;
 	constexpr size_t kSeirBlockAlignment = 1 << kSeirBlockAlignmentBits;
+	constexpr size_t kSeirCompressionBufferSize = 64 * 1024;
+	constexpr size_t kSeirMultithreadingThreshold = 4 * 1024 * 1024; // Smaller blocks don't benefit from multithreaded compression.
 
 	enum class SeirCompression : uint8_t
 	{
 		None = 0,
 		Zlib = 1,
 		Zstd = 2,
+		Lz4 = 3,
+	};
+
+	enum : uint8_t
+	{
+		kSeirFileChecksums = 1 << 0, // Blocks have CRC-32 checksums of their original data.
 	};
 
 	struct SeirBlockInfo
@@ -33,7 +46,7 @@ namespace
 		uint32_t _alignedOffset = 0;
 		uint32_t _archivedSize = 0;
 		uint32_t _originalSize = 0;
-		uint32_t _flags = 0;
+		uint32_t _checksum = 0; // Zero if the archive has no checksums.
 
 		[[nodiscard]] constexpr uint64_t offset() const noexcept { return uint64_t{ _alignedOffset } << kSeirBlockAlignmentBits; }
 	};
@@ -44,9 +57,9 @@ namespace
 	{
 		uint32_t _id = seir::kSeirFileID;
 		SeirCompression _compression = SeirCompression::None;
-		uint8_t _reserved8 = 0;
+		uint8_t _flags = 0;
 		uint16_t _reserved16 = 0;
-		uint32_t _reserved32 = 0;
+		uint32_t _dictionarySize = 0; // Nonzero if all compressed blocks use a dictionary stored right after the header.
 		uint32_t _fileCount = 0;
 		SeirBlockInfo _metaBlock;
 	};
@@ -56,16 +69,22 @@ namespace
 	class SeirArchiver final : public seir::Archiver
 	{
 	public:
-		SeirArchiver(seir::UniquePtr<seir::Writer>&& writer, seir::UniquePtr<seir::Compressor>&& compressor, seir::Compression compression) noexcept
+		SeirArchiver(seir::UniquePtr<seir::Writer>&& writer, seir::UniquePtr<seir::CompressStream>&& compressor, seir::Compression compression, size_t maxDictionarySize, unsigned workerCount, bool checksums) noexcept
 			: _writer{ std::move(writer) }
 			, _compressor{ std::move(compressor) }
+			, _compression{ compression }
+			, _maxDictionarySize{ _compressor ? std::min<size_t>(maxDictionarySize, std::numeric_limits<uint32_t>::max()) : 0 }
+			, _workerCount{ workerCount }
 		{
 			switch (compression)
 			{
 			case seir::Compression::None: break;
+			case seir::Compression::Lz4: _header._compression = SeirCompression::Lz4; break;
 			case seir::Compression::Zlib: _header._compression = SeirCompression::Zlib; break;
 			case seir::Compression::Zstd: _header._compression = SeirCompression::Zstd; break;
 			}
+			if (checksums)
+				_header._flags |= kSeirFileChecksums;
 		}
 
 		bool add(std::string_view name, const seir::Blob& blob, seir::CompressionLevel compressionLevel) override
@@ -73,8 +92,10 @@ namespace
 			if (name.size() > std::numeric_limits<uint8_t>::max())
 				return false;
 			if constexpr (sizeof(size_t) > sizeof(uint32_t))
-				if (_files.size() == std::numeric_limits<uint32_t>::max())
+				if (_files.size() + _pendingFiles.size() == std::numeric_limits<uint32_t>::max())
 					return false;
+			if (_maxDictionarySize)
+				return addPending(name, blob, compressionLevel);
 			SeirBlockInfo blockInfo;
 			if (!writeBlock(blockInfo, blob.data(), blob.size(), compressionLevel))
 				return false;
@@ -84,6 +105,8 @@ namespace
 
 		bool finish() override
 		{
+			if (!_pendingFiles.empty() && !writePending())
+				return false;
 			_header._fileCount = static_cast<uint32_t>(_files.size());
 			if (!_files.empty())
 			{
@@ -123,6 +146,67 @@ namespace
 				: _name{ name }, _blockInfo{ blockInfo } {}
 		};
 
+		struct PendingFileInfo
+		{
+			std::string _name;
+			size_t _size;
+			seir::CompressionLevel _compressionLevel;
+			PendingFileInfo(std::string_view name, size_t size, seir::CompressionLevel compressionLevel)
+				: _name{ name }, _size{ size }, _compressionLevel{ compressionLevel } {}
+		};
+
+		bool addPending(std::string_view name, const seir::Blob& blob, seir::CompressionLevel compressionLevel)
+		{
+			if constexpr (sizeof(size_t) > sizeof(uint32_t))
+				if (blob.size() > std::numeric_limits<uint32_t>::max())
+					return false;
+			if (const auto requiredCapacity = _pendingSize + blob.size(); _pendingData.capacity() < requiredCapacity)
+				if (!_pendingData.tryReserve(std::max(requiredCapacity, 2 * _pendingData.capacity()), _pendingSize))
+					return false;
+			std::memcpy(_pendingData.data() + _pendingSize, blob.data(), blob.size());
+			_pendingSize += blob.size();
+			_pendingFiles.emplace_back(name, blob.size(), compressionLevel);
+			return true;
+		}
+
+		bool writePending()
+		{
+			assert(_maxDictionarySize && _lastOffset == sizeof _header);
+			std::vector<size_t> sampleSizes;
+			sampleSizes.reserve(_pendingFiles.size());
+			for (const auto& file : _pendingFiles)
+				sampleSizes.emplace_back(file._size);
+			seir::Buffer dictionaryData;
+			if (!dictionaryData.tryReserve(_maxDictionarySize, 0))
+				return false;
+			// Training fails if there is not enough data, and we just compress the files without a dictionary then.
+			if (const auto dictionarySize = seir::CompressionDictionary::train(_compression, dictionaryData.data(), _maxDictionarySize, _pendingData.data(), sampleSizes.data(), sampleSizes.size()))
+			{
+				const auto dictionary = seir::CompressionDictionary::create(_compression, dictionaryData.data(), dictionarySize);
+				if (!dictionary
+					|| !_compressor->setDictionary(dictionary)
+					|| !_writer->seek(_lastOffset)
+					|| !_writer->write(dictionaryData.data(), dictionarySize))
+					return false;
+				_header._dictionarySize = static_cast<uint32_t>(dictionarySize);
+				_lastOffset = _writer->offset();
+			}
+			_maxDictionarySize = 0;
+			auto data = _pendingData.data();
+			for (const auto& file : _pendingFiles)
+			{
+				SeirBlockInfo blockInfo;
+				if (!writeBlock(blockInfo, data, file._size, file._compressionLevel))
+					return false;
+				_files.emplace_back(file._name, blockInfo);
+				data += file._size;
+			}
+			_pendingFiles.clear();
+			[[maybe_unused]] const auto pendingData = std::move(_pendingData); // Buffer move assignment doesn't free the old data.
+			_pendingSize = 0;
+			return true;
+		}
+
 		bool writeBlock(SeirBlockInfo& blockInfo, const void* data, size_t size, seir::CompressionLevel compressionLevel)
 		{
 			const auto requiredPadding = (~_lastOffset + 1) & (kSeirBlockAlignment - 1);
@@ -133,28 +217,6 @@ namespace
 			if constexpr (sizeof(size_t) > sizeof(uint32_t))
 				if (originalSize != size)
 					return false;
-			auto dataToWrite = data;
-			auto archivedSize = originalSize;
-			if (_compressor)
-			{
-				if (!_compressor->prepare(compressionLevel))
-					return false;
-				const auto maxCompressedSize = _compressor->maxCompressedSize(originalSize);
-				if (_compressionBuffer.capacity() < maxCompressedSize)
-				{
-					constexpr auto MiB = size_t{ 1 } << 20;
-					if (!_compressionBuffer.tryReserve((maxCompressedSize + (MiB - 1)) & ~(MiB - 1), 0))
-						return false;
-				}
-				const auto compressedSize = _compressor->compress(_compressionBuffer.data(), _compressionBuffer.capacity(), dataToWrite, originalSize);
-				if (!compressedSize)
-					return false;
-				if (compressedSize < originalSize)
-				{
-					dataToWrite = _compressionBuffer.data();
-					archivedSize = static_cast<uint32_t>(compressedSize);
-				}
-			}
 			if (!_writer->seek(_lastOffset))
 				return false;
 			if (requiredPadding > 0)
@@ -163,21 +225,63 @@ namespace
 				if (!_writer->write(padding.data(), static_cast<size_t>(requiredPadding)))
 					return false;
 			}
-			if (!_writer->write(dataToWrite, archivedSize))
+			auto archivedSize = originalSize;
+			if (_compressor)
+			{
+				const auto compressedSize = writeCompressed(data, originalSize, compressionLevel);
+				if (!compressedSize)
+					return false;
+				archivedSize = *compressedSize;
+			}
+			if (archivedSize == originalSize && (!_writer->seek(alignedOffset << kSeirBlockAlignmentBits) || !_writer->write(data, originalSize)))
 				return false;
 			blockInfo._alignedOffset = static_cast<uint32_t>(alignedOffset);
 			blockInfo._archivedSize = archivedSize;
 			blockInfo._originalSize = originalSize;
+			blockInfo._checksum = _header._flags & kSeirFileChecksums ? seir::Crc32{}.process(data, originalSize).value() : 0;
 			_lastOffset = _writer->offset();
 			return true;
 		}
 
+		// Compresses the data through a fixed-size buffer and returns the compressed size,
+		// or the original size if the compressed data turns out to be no smaller than the original.
+		std::optional<uint32_t> writeCompressed(const void* data, uint32_t size, seir::CompressionLevel compressionLevel)
+		{
+			_compressor->setWorkerCount(size >= kSeirMultithreadingThreshold ? _workerCount : 0);
+			if (!_compressionBuffer.tryReserve(kSeirCompressionBufferSize, 0)
+				|| !_compressor->prepare(compressionLevel, size))
+				return {};
+			seir::CompressionBuffers buffers{ static_cast<const std::byte*>(data), size, nullptr, 0 };
+			for (uint32_t compressedSize = 0;;)
+			{
+				buffers._dst = _compressionBuffer.data();
+				buffers._dstSize = kSeirCompressionBufferSize;
+				const auto status = _compressor->compress(buffers, true);
+				if (status == seir::CompressionStatus::Error)
+					return {};
+				const auto chunkSize = static_cast<uint32_t>(kSeirCompressionBufferSize - buffers._dstSize);
+				if (chunkSize >= size - compressedSize)
+					return size;
+				if (!_writer->write(_compressionBuffer.data(), chunkSize))
+					return {};
+				compressedSize += chunkSize;
+				if (status == seir::CompressionStatus::End)
+					return compressedSize;
+			}
+		}
+
 	private:
 		const seir::UniquePtr<seir::Writer> _writer;
-		const seir::UniquePtr<seir::Compressor> _compressor;
+		const seir::UniquePtr<seir::CompressStream> _compressor;
+		const seir::Compression _compression;
+		size_t _maxDictionarySize;
+		const unsigned _workerCount;
 		seir::Buffer _compressionBuffer;
 		SeirFileHeader _header;
 		std::vector<FileInfo> _files;
+		std::vector<PendingFileInfo> _pendingFiles;
+		seir::Buffer _pendingData;
+		size_t _pendingSize = 0;
 		uint64_t _lastOffset = 0;
 	};
 }
@@ -189,12 +293,13 @@ namespace seir
 		const auto fileHeader = blob->get<SeirFileHeader>(0);
 		if (!fileHeader
 			|| fileHeader->_id != seir::kSeirFileID
-			|| fileHeader->_reserved8 || fileHeader->_reserved16 || fileHeader->_reserved32)
+			|| (fileHeader->_flags & ~kSeirFileChecksums) || fileHeader->_reserved16)
 			return false;
 		if (!fileHeader->_fileCount)
 			return true;
+		const bool hasChecksums = fileHeader->_flags & kSeirFileChecksums;
 		if (fileHeader->_metaBlock._archivedSize > fileHeader->_metaBlock._originalSize
-			|| fileHeader->_metaBlock._flags)
+			|| (!hasChecksums && fileHeader->_metaBlock._checksum))
 			return false;
 		auto metaBlock = blob->get<std::byte>(static_cast<size_t>(fileHeader->_metaBlock.offset()), fileHeader->_metaBlock._archivedSize);
 		if (!metaBlock)
@@ -205,17 +310,32 @@ namespace seir
 		case SeirCompression::None: break;
 		case SeirCompression::Zlib: compression = Compression::Zlib; break;
 		case SeirCompression::Zstd: compression = Compression::Zstd; break;
+		case SeirCompression::Lz4: compression = Compression::Lz4; break;
+		}
+		SharedPtr<CompressionDictionary> dictionary;
+		if (fileHeader->_dictionarySize)
+		{
+			// The dictionary is loaded once and shared by all files from the archive.
+			const auto dictionaryData = blob->get<std::byte>(sizeof(SeirFileHeader), fileHeader->_dictionarySize);
+			if (!dictionaryData)
+				return false;
+			dictionary = CompressionDictionary::create(compression, dictionaryData, fileHeader->_dictionarySize);
+			if (!dictionary)
+				return false;
 		}
 		seir::Buffer metaBuffer;
 		if (fileHeader->_metaBlock._archivedSize < fileHeader->_metaBlock._originalSize)
 		{
 			const auto decompressor = seir::Decompressor::create(compression);
 			if (!decompressor
+				|| !decompressor->setDictionary(dictionary)
 				|| !metaBuffer.tryReserve(fileHeader->_metaBlock._originalSize, 0)
 				|| !decompressor->decompress(metaBuffer.data(), fileHeader->_metaBlock._originalSize, metaBlock, fileHeader->_metaBlock._archivedSize))
 				return false;
 			metaBlock = metaBuffer.data();
 		}
+		if (hasChecksums && Crc32{}.process(metaBlock, fileHeader->_metaBlock._originalSize).value() != fileHeader->_metaBlock._checksum)
+			return false;
 		if (fileHeader->_fileCount > fileHeader->_metaBlock._originalSize / sizeof(SeirBlockInfo))
 			return false;
 		auto nameOffset = fileHeader->_fileCount * sizeof(SeirBlockInfo);
@@ -226,22 +346,30 @@ namespace seir
 			const auto nameSize = std::to_integer<uint8_t>(metaBlock[nameOffset++]);
 			if (nameOffset + nameSize > fileHeader->_metaBlock._originalSize)
 				break;
-			storage.attach(std::string{ reinterpret_cast<const char*>(metaBlock + nameOffset), nameSize }, SharedPtr{ blob }, static_cast<size_t>(i->offset()), i->_originalSize, compression, i->_archivedSize);
+			const std::string_view name{ reinterpret_cast<const char*>(metaBlock + nameOffset), nameSize };
+			// Blocks which don't become smaller when compressed are stored as is.
+			const auto isCompressed = i->_archivedSize < i->_originalSize;
+			const auto blockCompression = isCompressed ? compression : Compression::None;
+			const auto& blockDictionary = isCompressed ? dictionary : SharedPtr<CompressionDictionary>{};
+			if (hasChecksums)
+				storage.attach(name, SharedPtr{ blob }, static_cast<size_t>(i->offset()), i->_originalSize, blockCompression, i->_archivedSize, blockDictionary, i->_checksum);
+			else
+				storage.attach(name, SharedPtr{ blob }, static_cast<size_t>(i->offset()), i->_originalSize, blockCompression, i->_archivedSize, blockDictionary);
 			nameOffset += nameSize;
 		}
 		return true;
 	}
 
-	UniquePtr<Archiver> createSeirArchiver(UniquePtr<Writer>&& writer, Compression compression)
+	UniquePtr<Archiver> createSeirArchiver(UniquePtr<Writer>&& writer, Compression compression, size_t maxDictionarySize, unsigned workerCount, bool checksums)
 	{
-		UniquePtr<seir::Compressor> compressor;
+		UniquePtr<CompressStream> compressor;
 		if (compression != Compression::None)
 		{
-			compressor = Compressor::create(compression);
+			compressor = CompressStream::create(compression);
 			if (!compressor)
 				return {};
 		}
-		auto archiver = makeUnique<Archiver, SeirArchiver>(std::move(writer), std::move(compressor), compression);
+		auto archiver = makeUnique<Archiver, SeirArchiver>(std::move(writer), std::move(compressor), compression, maxDictionarySize, workerCount, checksums);
 		if (!archiver->finish())
 			return {};
 		return archiver;
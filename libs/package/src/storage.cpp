@@ -4,15 +4,33 @@
 
 #include <seir_package/storage.hpp>
 
+#include <seir_base/checksum.hpp>
 #include <seir_compression/compression.hpp>
 #include <seir_io/buffer_blob.hpp>
 #include "archive.hpp"
 
+#include <atomic>
 #include <cassert>
+#include <optional>
 #include <unordered_map>
 
 namespace
 {
+	// A flag which may be set by concurrent readers of a Storage.
+	struct VerifiedFlag
+	{
+		std::atomic<bool> _value{ false };
+
+		VerifiedFlag() noexcept = default;
+		VerifiedFlag(VerifiedFlag&& other) noexcept
+			: _value{ other._value.load(std::memory_order_relaxed) } {}
+		VerifiedFlag& operator=(VerifiedFlag&& other) noexcept
+		{
+			_value.store(other._value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+			return *this;
+		}
+	};
+
 	struct Attachment
 	{
 		seir::SharedPtr<seir::Blob> _blob;
@@ -20,6 +38,9 @@ namespace
 		size_t _uncompressedSize = 0;
 		size_t _compressedSize = 0;
 		seir::Compression _compression = seir::Compression::None;
+		seir::SharedPtr<seir::CompressionDictionary> _dictionary;
+		std::optional<uint32_t> _crc32;
+		VerifiedFlag _verified; // Uncompressed data is shared with the attachment, so it is verified only once.
 	};
 }
 
@@ -44,13 +65,24 @@ namespace seir
 	void Storage::attach(std::string_view name, SharedPtr<Blob>&& blob)
 	{
 		const auto size = blob->size();
-		_impl->_attachments.insert_or_assign(std::string{ name }, Attachment{ std::move(blob), 0, size, size, Compression::None });
+		_impl->_attachments.insert_or_assign(std::string{ name }, Attachment{ std::move(blob), 0, size, size, Compression::None, {}, {}, {} });
 	}
 
 	void Storage::attach(std::string_view name, SharedPtr<Blob>&& blob, size_t offset, size_t size, Compression compression, size_t compressedSize)
+	{
+		attach(name, std::move(blob), offset, size, compression, compressedSize, {});
+	}
+
+	void Storage::attach(std::string_view name, SharedPtr<Blob>&& blob, size_t offset, size_t size, Compression compression, size_t compressedSize, const SharedPtr<CompressionDictionary>& dictionary)
 	{
 		assert(offset <= blob->size() && compressedSize <= blob->size() - offset);
-		_impl->_attachments.insert_or_assign(std::string{ name }, Attachment{ std::move(blob), offset, size, compressedSize, compression });
+		_impl->_attachments.insert_or_assign(std::string{ name }, Attachment{ std::move(blob), offset, size, compressedSize, compression, dictionary, {}, {} });
+	}
+
+	void Storage::attach(std::string_view name, SharedPtr<Blob>&& blob, size_t offset, size_t size, Compression compression, size_t compressedSize, const SharedPtr<CompressionDictionary>& dictionary, uint32_t crc32)
+	{
+		assert(offset <= blob->size() && compressedSize <= blob->size() - offset);
+		_impl->_attachments.insert_or_assign(std::string{ name }, Attachment{ std::move(blob), offset, size, compressedSize, compression, dictionary, crc32, {} });
 	}
 
 	bool Storage::attachArchive(const SharedPtr<Blob>& blob)
@@ -74,16 +106,26 @@ namespace seir
 				return blob;
 		if (const auto i = _impl->_attachments.find(name); i != _impl->_attachments.end())
 		{
+			const auto isIntact = [&attachment = i->second](const void* data) {
+				return !attachment._crc32 || Crc32{}.process(data, attachment._uncompressedSize).value() == *attachment._crc32;
+			};
 			if (i->second._compression == Compression::None)
 			{
+				if (!i->second._verified._value.load(std::memory_order_acquire))
+				{
+					if (!isIntact(static_cast<const std::byte*>(i->second._blob->data()) + i->second._offset))
+						return {};
+					i->second._verified._value.store(true, std::memory_order_release);
+				}
 				return i->second._offset == 0 && i->second._uncompressedSize == i->second._blob->size()
 					? i->second._blob
 					: Blob::from(SharedPtr{ i->second._blob }, i->second._offset, i->second._uncompressedSize);
 			}
-			if (const auto decompressor = Decompressor::create(i->second._compression))
+			if (const auto decompressor = Decompressor::create(i->second._compression); decompressor && decompressor->setDictionary(i->second._dictionary))
 			{
 				Buffer buffer{ i->second._uncompressedSize };
-				if (decompressor->decompress(buffer.data(), i->second._uncompressedSize, static_cast<const std::byte*>(i->second._blob->data()) + i->second._offset, i->second._compressedSize))
+				if (decompressor->decompress(buffer.data(), i->second._uncompressedSize, static_cast<const std::byte*>(i->second._blob->data()) + i->second._offset, i->second._compressedSize)
+					&& isIntact(buffer.data()))
 					return makeShared<Blob, BufferBlob>(std::move(buffer), i->second._uncompressedSize);
 			}
 			return {};
@@ -14,6 +14,7 @@
 #include <algorithm>
 #include <cstring>
 #include <iterator>
+#include <string>
 #include <unordered_map>
 
 #include <doctest/doctest.h>
@@ -24,6 +25,9 @@ TEST_CASE("Archiver")
 	std::generate_n(std::back_inserter(entries["digits.txt"]), 10 * 1024, [i = 0]() mutable { return static_cast<char>('0' + (i++ % 10)); });
 	std::generate_n(std::back_inserter(entries["lowercase.txt"]), 26 * 1024, [i = 0]() mutable { return static_cast<char>('a' + (i++ % 26)); });
 	std::generate_n(std::back_inserter(entries["uppercase.txt"]), 26 * 1024, [i = 0]() mutable { return static_cast<char>('A' + (i++ % 26)); });
+	// Compressed size of these exceeds the archiver's internal compression buffer size.
+	std::generate_n(std::back_inserter(entries["hex.txt"]), 512 * 1024, [i = 1u]() mutable { return "0123456789ABCDEF"[(i = i * 1664525u + 1013904223u) >> 28]; });
+	std::generate_n(std::back_inserter(entries["noise.bin"]), 256 * 1024, [i = 1u]() mutable { return static_cast<char>((i = i * 1664525u + 1013904223u) >> 24); });
 	seir::Buffer buffer;
 	uint64_t bufferSize = 0;
 	{
@@ -33,6 +37,12 @@ TEST_CASE("Archiver")
 		{
 			archiver = seir::Archiver::create(std::move(writer), seir::Compression::None);
 		}
+#if SEIR_COMPRESSION_LZ4
+		SUBCASE("Compression::Lz4")
+		{
+			archiver = seir::Archiver::create(std::move(writer), seir::Compression::Lz4); // cppcheck-suppress[accessMoved]
+		}
+#endif
 #if SEIR_COMPRESSION_ZLIB
 		SUBCASE("Compression::Zlib")
 		{
@@ -44,6 +54,11 @@ TEST_CASE("Archiver")
 		{
 			archiver = seir::Archiver::create(std::move(writer), seir::Compression::Zstd); // cppcheck-suppress[accessMoved]
 		}
+		SUBCASE("Compression::Zstd (dictionary)")
+		{
+			// There is not enough data to train a dictionary, so the files should be compressed without it.
+			archiver = seir::Archiver::create(std::move(writer), seir::Compression::Zstd, 1024); // cppcheck-suppress[accessMoved]
+		}
 #endif
 		REQUIRE(archiver);
 		for (const auto& [name, contents] : entries)
@@ -64,3 +79,92 @@ TEST_CASE("Archiver")
 		CHECK_FALSE(std::memcmp(blob->data(), contents.data(), contents.size()));
 	}
 }
+
+#if SEIR_COMPRESSION_ZSTD
+TEST_CASE("Archiver (dictionary)")
+{
+	std::unordered_map<std::string, std::string> entries;
+	for (int i = 0; i < 1000; ++i)
+		entries["item" + std::to_string(i) + ".txt"] = "name \"item" + std::to_string(i) + "\"\nsize " + std::to_string(i * 7 % 100) + "\ncolor " + std::to_string(i * 13 % 256) + "\n";
+	const auto createArchive = [&entries](seir::Buffer& buffer, size_t maxDictionarySize) {
+		uint64_t bufferSize = 0;
+		auto archiver = seir::Archiver::create(seir::makeUnique<seir::Writer, seir::BufferWriter>(buffer, &bufferSize), seir::Compression::Zstd, maxDictionarySize);
+		REQUIRE(archiver);
+		for (const auto& [name, contents] : entries)
+			REQUIRE(archiver->add(name, *seir::Blob::from(contents.data(), contents.size()), seir::CompressionLevel::Maximum));
+		REQUIRE(archiver->finish());
+		return static_cast<size_t>(bufferSize);
+	};
+	seir::Buffer buffer;
+	const auto bufferSize = createArchive(buffer, 4096);
+	{
+		seir::Buffer bufferWithoutDictionary;
+		CHECK(bufferSize < createArchive(bufferWithoutDictionary, 0));
+	}
+	seir::Storage storage{ seir::Storage::UseFileSystem::Never };
+	REQUIRE(storage.attachArchive(seir::Blob::from(buffer.data(), bufferSize)));
+	for (const auto& [name, contents] : entries)
+	{
+		const auto blob = storage.open(name);
+		REQUIRE(blob);
+		REQUIRE(blob->size() == contents.size());
+		CHECK_FALSE(std::memcmp(blob->data(), contents.data(), contents.size()));
+	}
+}
+#endif
+
+TEST_CASE("Archiver (checksums)")
+{
+	const std::string original(1000, 'A');
+	const std::string other(1000, 'B');
+	seir::Buffer buffer;
+	uint64_t bufferSize = 0;
+	{
+		auto archiver = seir::Archiver::create(seir::makeUnique<seir::Writer, seir::BufferWriter>(buffer, &bufferSize), seir::Compression::None, 0, 0, true);
+		REQUIRE(archiver);
+		REQUIRE(archiver->add("original.txt", *seir::Blob::from(original.data(), original.size()), seir::CompressionLevel::None));
+		REQUIRE(archiver->add("other.txt", *seir::Blob::from(other.data(), other.size()), seir::CompressionLevel::None));
+		REQUIRE(archiver->finish());
+	}
+	const auto data = reinterpret_cast<char*>(buffer.data());
+	const auto corrupted = std::search(data, data + bufferSize, original.begin(), original.end());
+	REQUIRE(corrupted != data + bufferSize);
+	corrupted[original.size() / 2] = 'X';
+	seir::Storage storage{ seir::Storage::UseFileSystem::Never };
+	REQUIRE(storage.attachArchive(seir::Blob::from(buffer.data(), static_cast<size_t>(bufferSize))));
+	CHECK_FALSE(storage.open("original.txt"));
+	const auto blob = storage.open("other.txt");
+	REQUIRE(blob);
+	REQUIRE(blob->size() == other.size());
+	CHECK_FALSE(std::memcmp(blob->data(), other.data(), other.size()));
+}
+
+#if SEIR_COMPRESSION_LZ4
+TEST_CASE("Archiver (checksums, compressed)")
+{
+	// LZ4 stores the first occurrence of the marker as literals, so corrupting it keeps the block decompressible.
+	const std::string marker = "The quick brown fox jumps over the lazy dog.";
+	const auto original = marker + std::string(1000, 'A');
+	const auto other = std::string(1000, 'B');
+	seir::Buffer buffer;
+	uint64_t bufferSize = 0;
+	{
+		auto archiver = seir::Archiver::create(seir::makeUnique<seir::Writer, seir::BufferWriter>(buffer, &bufferSize), seir::Compression::Lz4, 0, 0, true);
+		REQUIRE(archiver);
+		REQUIRE(archiver->add("original.txt", *seir::Blob::from(original.data(), original.size()), seir::CompressionLevel::Default));
+		REQUIRE(archiver->add("other.txt", *seir::Blob::from(other.data(), other.size()), seir::CompressionLevel::Default));
+		REQUIRE(archiver->finish());
+	}
+	const auto data = reinterpret_cast<char*>(buffer.data());
+	const auto corrupted = std::search(data, data + bufferSize, marker.begin(), marker.end());
+	REQUIRE(corrupted != data + bufferSize);
+	corrupted[marker.size() / 2] = 'X';
+	seir::Storage storage{ seir::Storage::UseFileSystem::Never };
+	REQUIRE(storage.attachArchive(seir::Blob::from(buffer.data(), static_cast<size_t>(bufferSize))));
+	CHECK_FALSE(storage.open("original.txt"));
+	const auto blob = storage.open("other.txt");
+	REQUIRE(blob);
+	REQUIRE(blob->size() == other.size());
+	CHECK_FALSE(std::memcmp(blob->data(), other.data(), other.size()));
+}
+#endif
@@ -81,8 +81,9 @@ namespace seir
 		//
 		[[nodiscard]] SharedPtr<ShaderSet> createShaders(std::span<const uint32_t> vertexShader, std::span<const uint32_t> fragmentShader);
 
-		//
-		[[nodiscard]] SharedPtr<Texture2D> createTexture2D(const ImageInfo&, const void*);
+		// Mip levels (if any) must follow the image data the way ImagePipeline lays them out.
+		// Block-compressed formats are uploaded as is if supported by the device, and decoded if possible otherwise.
+		[[nodiscard]] SharedPtr<Texture2D> createTexture2D(const ImageInfo&, const void*, uint32_t mipLevelCount = 1);
 		[[nodiscard]] SharedPtr<Texture2D> createTexture2D(const Image&);
 
 		//
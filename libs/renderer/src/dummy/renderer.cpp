@@ -53,7 +53,7 @@ namespace seir
 		return makeShared<ShaderSet, DummyShaderSet>();
 	}
 
-	SharedPtr<Texture2D> Renderer::createTexture2D(const ImageInfo& info, const void*)
+	SharedPtr<Texture2D> Renderer::createTexture2D(const ImageInfo& info, const void*, uint32_t)
 	{
 		return makeShared<Texture2D, DummyTexture>(SizeF{ static_cast<float>(info.width()), static_cast<float>(info.height()) });
 	}
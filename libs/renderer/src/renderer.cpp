@@ -10,6 +10,6 @@ namespace seir
 {
 	SharedPtr<Texture2D> Renderer::createTexture2D(const Image& image)
 	{
-		return createTexture2D(image.info(), image.data());
+		return createTexture2D(image.info(), image.data(), image.mipLevelCount());
 	}
 }
@@ -120,7 +120,7 @@ namespace
 		return fifoMode;
 	}
 
-	VkImageView createImageView2D(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspect)
+	VkImageView createImageView2D(VkDevice device, VkImage image, VkFormat format, VkImageAspectFlags aspect, uint32_t mipLevels)
 	{
 		const VkImageViewCreateInfo createInfo{
 			.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -136,7 +136,7 @@ namespace
 			.subresourceRange{
 				.aspectMask = aspect,
 				.baseMipLevel = 0,
-				.levelCount = 1,
+				.levelCount = mipLevels,
 				.baseArrayLayer = 0,
 				.layerCount = 1,
 			},
@@ -352,20 +352,20 @@ namespace seir
 	{
 		_swapchainImageViews.assign(_swapchainImages.size(), VK_NULL_HANDLE);
 		for (size_t i = 0; i < _swapchainImages.size(); ++i)
-			_swapchainImageViews[i] = ::createImageView2D(device, _swapchainImages[i], surfaceFormat.format, VK_IMAGE_ASPECT_COLOR_BIT);
+			_swapchainImageViews[i] = ::createImageView2D(device, _swapchainImages[i], surfaceFormat.format, VK_IMAGE_ASPECT_COLOR_BIT, 1);
 	}
 
 	void VulkanRenderTarget::createColorBuffer(const VulkanContext& context)
 	{
 		if (context._maxSampleCount != VK_SAMPLE_COUNT_1_BIT)
-			_colorBuffer = context.createImage2D(_swapchainExtent, context._surfaceFormat.format, context._maxSampleCount, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+			_colorBuffer = context.createImage2D(_swapchainExtent, 1, context._surfaceFormat.format, context._maxSampleCount, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
 	}
 
 	void VulkanRenderTarget::createDepthBuffer(const VulkanContext& context)
 	{
 		constexpr auto tiling = VK_IMAGE_TILING_OPTIMAL;
 		const auto format = context.findFormat({ VK_FORMAT_X8_D24_UNORM_PACK32, VK_FORMAT_D32_SFLOAT, VK_FORMAT_D24_UNORM_S8_UINT, VK_FORMAT_D32_SFLOAT_S8_UINT }, tiling, VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
-		_depthBuffer = context.createImage2D(_swapchainExtent, format, context._maxSampleCount, tiling, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
+		_depthBuffer = context.createImage2D(_swapchainExtent, 1, format, context._maxSampleCount, tiling, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT);
 		_depthBuffer.transitionLayout(context, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 	}
 
@@ -546,40 +546,21 @@ namespace seir
 		_device = other._device;
 		_view = other._view;
 		_format = other._format;
+		_mipLevels = other._mipLevels;
 		other._allocator = VK_NULL_HANDLE;
 		other._image = VK_NULL_HANDLE;
 		other._allocation = VK_NULL_HANDLE;
 		other._device = VK_NULL_HANDLE;
 		other._view = VK_NULL_HANDLE;
 		other._format = VK_FORMAT_UNDEFINED;
+		other._mipLevels = 0;
 		return *this;
 	}
 
-	void VulkanImage::copy2D(const VulkanContext& context, VkBuffer buffer, const VkExtent2D& extent, uint32_t pixelStride)
+	void VulkanImage::copy2D(const VulkanContext& context, VkBuffer buffer, const std::vector<VkBufferImageCopy>& regions)
 	{
 		auto commandBuffer = context.createCommandBuffer(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
-		const VkBufferImageCopy region{
-			.bufferOffset = 0,
-			.bufferRowLength = pixelStride,
-			.bufferImageHeight = 0,
-			.imageSubresource{
-				.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
-				.mipLevel = 0,
-				.baseArrayLayer = 0,
-				.layerCount = 1,
-			},
-			.imageOffset{
-				.x = 0,
-				.y = 0,
-				.z = 0,
-			},
-			.imageExtent{
-				.width = extent.width,
-				.height = extent.height,
-				.depth = 1,
-			}
-		};
-		vkCmdCopyBufferToImage(commandBuffer, buffer, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+		vkCmdCopyBufferToImage(commandBuffer, buffer, _image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, static_cast<uint32_t>(regions.size()), regions.data());
 		commandBuffer.finishAndSubmit(context._graphicsQueue);
 	}
 
@@ -599,6 +580,7 @@ namespace seir
 			_allocation = VK_NULL_HANDLE;
 		}
 		_format = VK_FORMAT_UNDEFINED;
+		_mipLevels = 0;
 	}
 
 	void VulkanImage::transitionLayout(const VulkanContext& context, VkImageLayout oldLayout, VkImageLayout newLayout)
@@ -619,7 +601,7 @@ namespace seir
 							  : VK_IMAGE_ASPECT_DEPTH_BIT)
 					: VK_IMAGE_ASPECT_COLOR_BIT,
 				.baseMipLevel = 0,
-				.levelCount = 1,
+				.levelCount = _mipLevels,
 				.baseArrayLayer = 0,
 				.layerCount = 1,
 			}
@@ -774,10 +756,10 @@ namespace seir
 		return buffer;
 	}
 
-	VulkanImage VulkanContext::createImage2D(const VkExtent2D& extent, VkFormat format, VkSampleCountFlagBits sampleCount, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect) const
+	VulkanImage VulkanContext::createImage2D(const VkExtent2D& extent, uint32_t mipLevels, VkFormat format, VkSampleCountFlagBits sampleCount, VkImageTiling tiling, VkImageUsageFlags usage, VkImageAspectFlags aspect) const
 	{
 		assert(_allocator);
-		VulkanImage image{ _allocator, _device, format };
+		VulkanImage image{ _allocator, _device, format, mipLevels };
 		const VkImageCreateInfo createInfo{
 			.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
 			.flags = 0,
@@ -788,7 +770,7 @@ namespace seir
 				.height = extent.height,
 				.depth = 1,
 			},
-			.mipLevels = 1,
+			.mipLevels = mipLevels,
 			.arrayLayers = 1,
 			.samples = sampleCount,
 			.tiling = tiling,
@@ -806,7 +788,7 @@ namespace seir
 			.priority = 0,
 		};
 		SEIR_VK(vmaCreateImage(_allocator, &createInfo, &allocateInfo, &image._image, &image._allocation, nullptr));
-		image._view = ::createImageView2D(_device, image._image, format, aspect);
+		image._view = ::createImageView2D(_device, image._image, format, aspect, mipLevels);
 		return image;
 	}
 
@@ -828,7 +810,7 @@ namespace seir
 			.compareEnable = VK_FALSE,
 			.compareOp = VK_COMPARE_OP_ALWAYS,
 			.minLod = 0,
-			.maxLod = 0,
+			.maxLod = VK_LOD_CLAMP_NONE,
 			.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK,
 			.unnormalizedCoordinates = VK_FALSE,
 		};
@@ -849,14 +831,14 @@ namespace seir
 		return shader;
 	}
 
-	VulkanImage VulkanContext::createTextureImage2D(const VkExtent2D& extent, VkFormat format, VkDeviceSize size, const void* data, uint32_t pixelStride) const
+	VulkanImage VulkanContext::createTextureImage2D(const VkExtent2D& extent, VkFormat format, VkDeviceSize size, const void* data, const std::vector<VkBufferImageCopy>& mipLevels) const
 	{
-		auto image = createImage2D(extent, format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
+		auto image = createImage2D(extent, static_cast<uint32_t>(mipLevels.size()), format, VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT);
 		image.transitionLayout(*this, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 		{
 			auto stagingBuffer = createBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT);
 			stagingBuffer.write(data, size);
-			image.copy2D(*this, stagingBuffer.handle(), extent, pixelStride);
+			image.copy2D(*this, stagingBuffer.handle(), mipLevels);
 		}
 		image.transitionLayout(*this, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 		return image;
@@ -962,6 +944,7 @@ namespace seir
 
 			VkPhysicalDeviceFeatures features{};
 			vkGetPhysicalDeviceFeatures(device, &features);
+			_hasTextureCompressionBc = features.textureCompressionBC == VK_TRUE;
 			if ((_options.anisotropicFiltering && !features.samplerAnisotropy)
 				|| (_options.sampleShading && !features.sampleRateShading)) // TODO: Use the best device even if it doesn't have all supported features.
 				continue;
@@ -1085,6 +1068,7 @@ namespace seir
 		const VkPhysicalDeviceFeatures features{
 			.sampleRateShading = static_cast<VkBool32>(_options.sampleShading),
 			.samplerAnisotropy = static_cast<VkBool32>(_options.anisotropicFiltering),
+			.textureCompressionBC = static_cast<VkBool32>(_hasTextureCompressionBc),
 		};
 		std::vector<const char*> extensions{ kRequiredDeviceExtensions.begin(), kRequiredDeviceExtensions.end() };
 		if (_hasPortabilitySubset)
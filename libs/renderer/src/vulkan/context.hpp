@@ -77,7 +77,7 @@ namespace seir
 		VulkanImage& operator=(VulkanImage&&) noexcept;
 		~VulkanImage() noexcept { destroy(); }
 
-		void copy2D(const VulkanContext&, VkBuffer, const VkExtent2D&, uint32_t pixelStride);
+		void copy2D(const VulkanContext&, VkBuffer, const std::vector<VkBufferImageCopy>&);
 		void destroy() noexcept;
 		[[nodiscard]] constexpr VkFormat format() const noexcept { return _format; }
 		[[nodiscard]] constexpr VkImage handle() const noexcept { return _image; }
@@ -91,8 +91,9 @@ namespace seir
 		VkDevice _device = VK_NULL_HANDLE;
 		VkImageView _view = VK_NULL_HANDLE;
 		VkFormat _format = VK_FORMAT_UNDEFINED;
-		constexpr VulkanImage(VmaAllocator allocator, VkDevice device, VkFormat format) noexcept
-			: _allocator{ allocator }, _device{ device }, _format{ format } {}
+		uint32_t _mipLevels = 0;
+		constexpr VulkanImage(VmaAllocator allocator, VkDevice device, VkFormat format, uint32_t mipLevels) noexcept
+			: _allocator{ allocator }, _device{ device }, _format{ format }, _mipLevels{ mipLevels } {}
 		friend VulkanContext;
 	};
 
@@ -203,6 +204,7 @@ namespace seir
 		VkPhysicalDevice _physicalDevice = VK_NULL_HANDLE;
 		VkPhysicalDeviceProperties _physicalDeviceProperties{};
 		bool _hasPortabilitySubset = false;
+		bool _hasTextureCompressionBc = false;
 		VkSurfaceFormatKHR _surfaceFormat{};
 		VkPresentModeKHR _presentMode = VK_PRESENT_MODE_FIFO_KHR;
 		uint32_t _graphicsQueueFamily = 0;
@@ -222,10 +224,10 @@ namespace seir
 		[[nodiscard]] VulkanBuffer createBuffer(VkDeviceSize, VkBufferUsageFlags, VkMemoryPropertyFlags, VmaAllocationCreateFlags) const;
 		[[nodiscard]] vulkan::CommandBuffer createCommandBuffer(VkCommandBufferUsageFlags) const;
 		[[nodiscard]] VulkanBuffer createDeviceBuffer(const void* data, VkDeviceSize, VkBufferUsageFlags) const;
-		[[nodiscard]] VulkanImage createImage2D(const VkExtent2D&, VkFormat, VkSampleCountFlagBits, VkImageTiling, VkImageUsageFlags, VkImageAspectFlags) const;
+		[[nodiscard]] VulkanImage createImage2D(const VkExtent2D&, uint32_t mipLevels, VkFormat, VkSampleCountFlagBits, VkImageTiling, VkImageUsageFlags, VkImageAspectFlags) const;
 		[[nodiscard]] VulkanSampler createSampler2D() const;
 		[[nodiscard]] VulkanShader createShader(const uint32_t* data, size_t bytes) const;
-		[[nodiscard]] VulkanImage createTextureImage2D(const VkExtent2D&, VkFormat, VkDeviceSize, const void* data, uint32_t pixelStride) const;
+		[[nodiscard]] VulkanImage createTextureImage2D(const VkExtent2D&, VkFormat, VkDeviceSize, const void* data, const std::vector<VkBufferImageCopy>& mipLevels) const;
 		[[nodiscard]] VulkanUniformBuffers createUniformBuffers(VkDeviceSize size, size_t count) const;
 		[[nodiscard]] uint32_t findMemoryType(uint32_t filter, VkMemoryPropertyFlags properties) const;
 		[[nodiscard]] VkFormat findFormat(const std::vector<VkFormat>& candidates, VkImageTiling, VkFormatFeatureFlags) const;
@@ -261,6 +263,7 @@ constexpr seir::VulkanImage::VulkanImage(VulkanImage&& other) noexcept
 	, _device{ other._device }
 	, _view{ other._view }
 	, _format{ other._format }
+	, _mipLevels{ other._mipLevels }
 {
 	other._allocator = VK_NULL_HANDLE;
 	other._image = VK_NULL_HANDLE;
@@ -268,6 +271,7 @@ constexpr seir::VulkanImage::VulkanImage(VulkanImage&& other) noexcept
 	other._device = VK_NULL_HANDLE;
 	other._view = VK_NULL_HANDLE;
 	other._format = VK_FORMAT_UNDEFINED;
+	other._mipLevels = 0;
 }
 
 constexpr seir::VulkanSampler::VulkanSampler(VulkanSampler&& other) noexcept
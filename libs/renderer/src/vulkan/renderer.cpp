@@ -5,8 +5,12 @@
 #include "renderer.hpp"
 
 #include <seir_app/window.hpp>
+#include <seir_base/buffer.hpp>
+#include <seir_base/profiler.hpp>
 #include <seir_graphics/sizef.hpp>
 #include <seir_image/image.hpp>
+#include <seir_image/pipeline.hpp>
+#include <seir_image/utils.hpp>
 #include <seir_math/mat.hpp>
 #include <seir_renderer/mesh.hpp>
 #include "../pass.hpp"
@@ -55,6 +59,65 @@ namespace
 		const VkIndexType _indexType;
 		const uint32_t _indexCount;
 	};
+
+	VkFormat textureFormat(seir::PixelFormat pixelFormat) noexcept
+	{
+		switch (pixelFormat)
+		{
+		case seir::PixelFormat::Gray8:
+		case seir::PixelFormat::Intensity8:
+		case seir::PixelFormat::GrayAlpha16:
+		case seir::PixelFormat::Rgb24:
+		case seir::PixelFormat::Bgr24:
+		case seir::PixelFormat::Rgba32:
+			break;
+		case seir::PixelFormat::Bgra32: return VK_FORMAT_B8G8R8A8_SRGB;
+		case seir::PixelFormat::Bc1: return VK_FORMAT_BC1_RGBA_SRGB_BLOCK;
+		case seir::PixelFormat::Bc2: return VK_FORMAT_BC2_SRGB_BLOCK;
+		case seir::PixelFormat::Bc3: return VK_FORMAT_BC3_SRGB_BLOCK;
+		case seir::PixelFormat::Bc4: return VK_FORMAT_BC4_UNORM_BLOCK;
+		case seir::PixelFormat::Bc5: return VK_FORMAT_BC5_UNORM_BLOCK;
+		case seir::PixelFormat::Bc6h: return VK_FORMAT_BC6H_UFLOAT_BLOCK;
+		case seir::PixelFormat::Bc7: return VK_FORMAT_BC7_SRGB_BLOCK;
+		}
+		return VK_FORMAT_UNDEFINED;
+	}
+
+	// Mip levels are expected to be laid out the way ImagePipeline produces them.
+	std::vector<VkBufferImageCopy> textureMipLevels(const seir::ImageInfo& info, uint32_t mipLevelCount)
+	{
+		const auto compressed = seir::isBlockCompressed(info.pixelFormat());
+		const auto unitSize = compressed ? seir::blockSize(info.pixelFormat()) : info.pixelSize();
+		const auto unitWidth = compressed ? 4u : 1u;
+		std::vector<VkBufferImageCopy> regions;
+		regions.reserve(mipLevelCount);
+		for (uint32_t level = 0; level < mipLevelCount; ++level)
+		{
+			const auto levelInfo = seir::ImagePipeline::mipLevelInfo(info, level);
+			regions.push_back({
+				.bufferOffset = seir::ImagePipeline::mipLevelOffset(info, level),
+				.bufferRowLength = levelInfo.stride() / unitSize * unitWidth,
+				.bufferImageHeight = 0,
+				.imageSubresource{
+					.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+					.mipLevel = level,
+					.baseArrayLayer = 0,
+					.layerCount = 1,
+				},
+				.imageOffset{
+					.x = 0,
+					.y = 0,
+					.z = 0,
+				},
+				.imageExtent{
+					.width = levelInfo.width(),
+					.height = levelInfo.height(),
+					.depth = 1,
+				},
+			});
+		}
+		return regions;
+	}
 }
 
 namespace seir
@@ -308,7 +371,7 @@ namespace seir
 				constexpr uint32_t height = 1;
 				static uint32_t data = 0xffffffff;
 				_whiteTexture2D = makeShared<VulkanTexture2D>(SizeF{ width, height },
-					_context.createTextureImage2D({ width, height }, VK_FORMAT_B8G8R8A8_SRGB, sizeof(data), &data, width));
+					_context.createTextureImage2D({ width, height }, VK_FORMAT_B8G8R8A8_SRGB, sizeof(data), &data, ::textureMipLevels({ width, height, PixelFormat::Bgra32 }, 1)));
 			}
 			_2d.initialize(*this);
 		}
@@ -324,6 +387,7 @@ namespace seir
 
 	void RendererImpl::render(const std::function<void(RenderPass&)>& callback)
 	{
+		SEIR_PROFILE_ZONE("Rendering");
 		if (!_renderTarget)
 		{
 			const auto windowSize = _window.size();
@@ -438,18 +502,35 @@ namespace seir
 		return _impl->createShaders(vertexShader, fragmentShader);
 	}
 
-	SharedPtr<Texture2D> Renderer::createTexture2D(const ImageInfo& info, const void* data)
+	SharedPtr<Texture2D> Renderer::createTexture2D(const ImageInfo& info, const void* data, uint32_t mipLevelCount)
 	{
-		if (info.pixelFormat() != PixelFormat::Bgra32)
+		if (!mipLevelCount || mipLevelCount > ImagePipeline::mipLevelCount(info.width(), info.height()))
+			return {};
+		auto textureInfo = info;
+		auto textureData = data;
+		Buffer decodedData;
+		if (isBlockCompressed(info.pixelFormat()) && !_impl->_context._hasTextureCompressionBc)
+		{
+			// Blocks which the device can't sample are decoded on the CPU if possible.
+			textureInfo = { info.width(), info.height(), PixelFormat::Bgra32 };
+			if (!decodedData.tryReserve(ImagePipeline::mipLevelOffset(textureInfo, mipLevelCount), 0))
+				return {};
+			for (uint32_t level = 0; level < mipLevelCount; ++level)
+				if (!copyImage(ImagePipeline::mipLevelInfo(info, level), static_cast<const std::byte*>(data) + ImagePipeline::mipLevelOffset(info, level),
+						ImagePipeline::mipLevelInfo(textureInfo, level), decodedData.data() + ImagePipeline::mipLevelOffset(textureInfo, level)))
+					return {};
+			textureData = decodedData.data();
+		}
+		const auto format = ::textureFormat(textureInfo.pixelFormat());
+		if (format == VK_FORMAT_UNDEFINED)
 			return {};
-		const auto pixelSize = info.pixelSize();
-		const auto stride = info.stride();
-		if (stride % pixelSize)
+		const auto unitSize = isBlockCompressed(textureInfo.pixelFormat()) ? blockSize(textureInfo.pixelFormat()) : textureInfo.pixelSize();
+		if (textureInfo.stride() % unitSize)
 			return {};
 		try
 		{
 			return makeShared<Texture2D, VulkanTexture2D>(SizeF{ static_cast<float>(info.width()), static_cast<float>(info.height()) },
-				_impl->_context.createTextureImage2D({ info.width(), info.height() }, VK_FORMAT_B8G8R8A8_SRGB, info.frameSize(), data, stride / pixelSize));
+				_impl->_context.createTextureImage2D({ info.width(), info.height() }, format, ImagePipeline::mipLevelOffset(textureInfo, mipLevelCount), textureData, ::textureMipLevels(textureInfo, mipLevelCount)));
 		}
 		catch ([[maybe_unused]] const VulkanError& e)
 		{
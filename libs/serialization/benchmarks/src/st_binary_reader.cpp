@@ -0,0 +1,94 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_base/buffer.hpp>
+#include <seir_io/blob.hpp>
+#include <seir_io/buffer_writer.hpp>
+#include <seir_serialization/st_binary_reader.hpp>
+#include <seir_serialization/st_binary_writer.hpp>
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	std::string makeText()
+	{
+		constexpr std::string_view kFragment =
+			"object {\n\tname \"Crate\"\n\tposition [\"12\" \"0\" \"-7.5\"]\n\tflags [\"static\" \"breakable\"]\n"
+			"\tdescription \"A wooden crate which can be broken to obtain its contents.\"\n}\n";
+		std::string result;
+		while (result.size() < 1024 * 1024)
+			result += kFragment;
+		return result;
+	}
+
+	std::vector<std::byte> makeBinary(const std::string& text)
+	{
+		seir::StReader reader{ seir::Blob::from(text.data(), text.size()) };
+		seir::StBinaryWriter writer;
+		for (;;)
+		{
+			const auto token = reader.read();
+			switch (token.type())
+			{
+			case seir::StToken::Type::ListBegin: writer.beginList(); break;
+			case seir::StToken::Type::ListEnd: writer.endList(); break;
+			case seir::StToken::Type::ObjectBegin: writer.beginObject(); break;
+			case seir::StToken::Type::ObjectEnd: writer.endObject(); break;
+			case seir::StToken::Type::Key: writer.addKey(token.text()); break;
+			case seir::StToken::Type::Value: writer.addValue(token.text()); break;
+			case seir::StToken::Type::End:
+			{
+				seir::Buffer buffer;
+				uint64_t size = 0;
+				seir::BufferWriter bufferWriter{ buffer, &size };
+				if (!writer.finish(bufferWriter))
+					return {};
+				return { buffer.data(), buffer.data() + size };
+			}
+			case seir::StToken::Type::Error: return {};
+			}
+		}
+	}
+
+	template <typename Reader>
+	void readAll(benchmark::State& state, const seir::SharedPtr<seir::Blob>& blob)
+	{
+		int64_t tokens = 0;
+		for (auto _ : state)
+		{
+			Reader reader{ blob };
+			for (auto token = reader.read(); token.type() != seir::StToken::Type::End; token = reader.read())
+			{
+				if (token.type() == seir::StToken::Type::Error)
+				{
+					state.SkipWithError("Parsing error");
+					return;
+				}
+				++tokens;
+			}
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(blob->size()));
+		state.SetItemsProcessed(tokens);
+	}
+
+	void StReader_Binary(benchmark::State& state)
+	{
+		const auto binary = makeBinary(makeText());
+		if (binary.empty())
+			return state.SkipWithError("Conversion error");
+		readAll<seir::StBinaryReader>(state, seir::Blob::from(binary.data(), binary.size()));
+	}
+
+	void StReader_Text(benchmark::State& state)
+	{
+		const auto text = makeText();
+		readAll<seir::StReader>(state, seir::Blob::from(text.data(), text.size()));
+	}
+}
+
+BENCHMARK(StReader_Binary);
+BENCHMARK(StReader_Text);
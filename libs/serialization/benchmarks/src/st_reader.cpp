@@ -0,0 +1,68 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../src/st_tokenizer.hpp"
+
+#include <array>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	constexpr size_t kCorpusSize = 1024 * 1024;
+
+	// Texts of about the same size with different kinds of data.
+	std::string makeCorpus(int64_t index)
+	{
+		constexpr std::array<std::string_view, 3> kFragments{
+			"object {\n\tname \"Crate\"\n\tposition [\"12\" \"0\" \"-7.5\"]\n\tflags [\"static\" \"breakable\"]\n}\n",
+			"message_with_a_long_identifier \"The quick brown fox jumps over the lazy dog, then runs back into the forest.\"\n",
+			"// This is a long comment explaining the meaning of the following line in great detail.\n\t\t\t\tkey \"value\"\n",
+		};
+		const auto fragment = kFragments[static_cast<size_t>(index)];
+		std::string result;
+		result.reserve(kCorpusSize + fragment.size());
+		while (result.size() < kCorpusSize)
+			result += fragment;
+		return result;
+	}
+
+	template <bool kVectorized>
+	void tokenize(benchmark::State& state)
+	{
+		constexpr std::array<const char*, 3> kLabels{ "Objects", "Strings", "Comments" };
+		const auto text = makeCorpus(state.range(0));
+		int64_t tokens = 0;
+		for (auto _ : state)
+		{
+			seir::StTokenizer<kVectorized> tokenizer{ text.data(), text.size() };
+			for (auto token = tokenizer.read(); token.type() != seir::StToken::Type::End; token = tokenizer.read())
+			{
+				if (token.type() == seir::StToken::Type::Error)
+				{
+					state.SkipWithError("Tokenization error");
+					return;
+				}
+				++tokens;
+			}
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(text.size()));
+		state.SetItemsProcessed(tokens);
+		state.SetLabel(kLabels[static_cast<size_t>(state.range(0))]);
+	}
+
+	void StTokenizer_Opt(benchmark::State& state)
+	{
+		tokenize<true>(state);
+	}
+
+	void StTokenizer_Ref(benchmark::State& state)
+	{
+		tokenize<false>(state);
+	}
+}
+
+BENCHMARK(StTokenizer_Opt)->DenseRange(0, 2);
+BENCHMARK(StTokenizer_Ref)->DenseRange(0, 2);
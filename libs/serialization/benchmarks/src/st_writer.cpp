@@ -0,0 +1,75 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_io/writer.hpp>
+#include <seir_serialization/st_writer.hpp>
+
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+	struct NullWriter final : seir::Writer
+	{
+		bool flush() noexcept override { return true; }
+		bool reserveImpl(uint64_t) noexcept override { return true; }
+		bool writeImpl(uint64_t, const void* data, size_t) noexcept override
+		{
+			benchmark::DoNotOptimize(data);
+			return true;
+		}
+	};
+
+	void writeObjects(seir::StWriter& writer)
+	{
+		for (int i = 0; i < 10'000; ++i)
+		{
+			writer.addKey("object");
+			writer.beginObject();
+			writer.addKey("name");
+			writer.addValue("Crate");
+			writer.addKey("position");
+			writer.beginList();
+			writer.addValue("12");
+			writer.addValue("0");
+			writer.addValue("-7.5");
+			writer.endList();
+			writer.addKey("description");
+			writer.addValue("A wooden crate which can be broken to obtain its contents.");
+			writer.endObject();
+		}
+	}
+
+	void StWriter_Buffer(benchmark::State& state)
+	{
+		size_t size = 0;
+		for (auto _ : state)
+		{
+			std::string buffer;
+			seir::StWriter writer{ buffer, seir::StWriter::Formatting::Pretty };
+			writeObjects(writer);
+			writer.finish();
+			size = buffer.size();
+			benchmark::DoNotOptimize(buffer.data());
+		}
+		state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+	}
+
+	void StWriter_Stream(benchmark::State& state)
+	{
+		for (auto _ : state)
+		{
+			NullWriter output;
+			seir::StWriter writer{ output, seir::StWriter::Formatting::Pretty };
+			writeObjects(writer);
+			if (!writer.finish())
+				return state.SkipWithError("Writing error");
+			state.SetBytesProcessed(state.bytes_processed() + static_cast<int64_t>(output.size()));
+		}
+	}
+}
+
+BENCHMARK(StWriter_Buffer);
+BENCHMARK(StWriter_Stream);
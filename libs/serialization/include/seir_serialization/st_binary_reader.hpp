@@ -0,0 +1,22 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_serialization/st_reader.hpp>
+
+namespace seir
+{
+	// Reads tokens from binary .st data produced by StBinaryWriter.
+	// Binary tokens have zero line numbers and byte offsets instead of column numbers.
+	// Token texts point into the Blob data and remain valid as long as the reader exists.
+	class StBinaryReader final : public StReader
+	{
+	public:
+		explicit StBinaryReader(const SharedPtr<Blob>&);
+
+		// Checks whether the data looks like binary .st data.
+		[[nodiscard]] static bool isBinary(const Blob&) noexcept;
+	};
+}
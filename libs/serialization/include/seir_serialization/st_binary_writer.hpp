@@ -0,0 +1,57 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_serialization/st_writer.hpp>
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace seir
+{
+	class Writer;
+
+	// Produces binary .st data with length-prefixed values and a table of unique keys,
+	// which can be read by StBinaryReader much faster than text can be parsed.
+	// Throws StWriter::BadToken on the same conditions as StWriter.
+	class StBinaryWriter
+	{
+	public:
+		StBinaryWriter();
+		~StBinaryWriter() noexcept;
+
+		//
+		void addKey(std::string_view);
+
+		//
+		void addValue(std::string_view);
+
+		//
+		void beginList();
+
+		//
+		void beginObject();
+
+		//
+		void endList();
+
+		//
+		void endObject();
+
+		// Writes the data to the Writer. Returns false if writing has failed.
+		[[nodiscard]] bool finish(Writer&);
+
+	private:
+		void beginValue();
+
+	private:
+		std::unordered_map<std::string, size_t> _keyIndices;
+		std::vector<std::string_view> _keys;
+		std::string _tokens;
+		std::vector<uint8_t> _stack;
+	};
+}
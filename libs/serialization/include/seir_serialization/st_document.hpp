@@ -0,0 +1,78 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+namespace seir
+{
+	class Blob;
+	template <class>
+	class SharedPtr;
+
+	// A reference to a key, a value, a list or an object in an StDocument.
+	// Null nodes are returned where there is no node to return.
+	class StNode
+	{
+	public:
+		//
+		enum class Type : uint8_t
+		{
+			Key,    // Contains values.
+			Value,  // Contains no nodes.
+			List,   // Contains values.
+			Object, // Contains keys.
+		};
+
+		constexpr StNode() noexcept = default;
+
+		[[nodiscard]] constexpr explicit operator bool() const noexcept { return _document; }
+
+		// Returns the first key with the specified name if the node is an object.
+		[[nodiscard]] StNode find(std::string_view key) const noexcept;
+
+		// Returns the first node contained in this one.
+		[[nodiscard]] StNode first() const noexcept;
+
+		// Returns the next node contained in the same parent, skipping everything contained in this one.
+		[[nodiscard]] StNode next() const noexcept;
+
+		// Returns the next key with the same name in the same object.
+		[[nodiscard]] StNode nextSame() const noexcept;
+
+		// Returns the key name or the value text, and an empty string for other nodes.
+		[[nodiscard]] std::string_view text() const noexcept;
+
+		// Returns the type of a non-null node.
+		[[nodiscard]] Type type() const noexcept;
+
+	private:
+		const class StDocumentImpl* _document = nullptr;
+		uint32_t _index = 0;
+		constexpr StNode(const StDocumentImpl* document, uint32_t index) noexcept
+			: _document{ document }, _index{ index } {}
+		friend StDocumentImpl;
+	};
+
+	// Random-access representation of .st data, built in one pass over the tokens.
+	// Nodes are stored in a flat array and reference texts in the Blob, which is kept alive by the document.
+	// Nodes can be skipped together with their contents in constant time, and keys in objects are looked up by hash.
+	class StDocument
+	{
+	public:
+		// Reads the text or binary (see StBinaryReader) data.
+		// Throws StStreamError if the data is invalid.
+		explicit StDocument(const SharedPtr<Blob>&);
+		~StDocument() noexcept;
+
+		// Returns the root object.
+		[[nodiscard]] StNode root() const noexcept;
+
+	private:
+		const std::unique_ptr<StDocumentImpl> _impl;
+	};
+}
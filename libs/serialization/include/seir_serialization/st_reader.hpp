@@ -44,6 +44,8 @@ namespace seir
 		std::string_view _text;
 	};
 
+	// Tokenizes the text in place, so token texts point into the Blob data
+	// and remain valid as long as the reader exists.
 	class StReader
 	{
 	public:
@@ -52,6 +54,9 @@ namespace seir
 
 		[[nodiscard]] StToken read();
 
+	protected:
+		StReader(const SharedPtr<Blob>&, bool binary);
+
 	private:
 		const std::unique_ptr<class StReaderImpl> _impl;
 	};
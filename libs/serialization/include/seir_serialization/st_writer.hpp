@@ -11,6 +11,8 @@
 
 namespace seir
 {
+	class Writer;
+
 	//
 	class StWriter
 	{
@@ -29,9 +31,18 @@ namespace seir
 			Pretty,  //
 		};
 
-		//
+		// Appends the text to the buffer.
 		StWriter(std::string& buffer, Formatting);
 
+		// Streams the text to the Writer through a staging buffer of the specified size,
+		// so memory usage doesn't depend on the amount of data written.
+		// NOTE: The Writer must stay valid for the lifetime of the StWriter.
+		StWriter(Writer&, Formatting, size_t bufferSize = 64 * 1024);
+
+		StWriter(const StWriter&) = delete;
+		StWriter(StWriter&&) = delete;
+		StWriter& operator=(const StWriter&) = delete;
+		StWriter& operator=(StWriter&&) = delete;
 		~StWriter() noexcept;
 
 		//
@@ -52,15 +63,22 @@ namespace seir
 		//
 		void endObject();
 
-		//
-		void finish();
+		// Writes any staged text to the Writer. Returns false if writing has failed.
+		bool finish();
 
 	private:
+		void appendRun(const char*, size_t);
 		void beginPrettyValue(uint8_t);
+		void flush();
+		void flushIfFull();
 
 	private:
+		std::string _staging;
 		std::string& _buffer;
+		Writer* const _writer = nullptr;
+		const size_t _bufferSize = 0;
 		std::vector<uint8_t> _stack;
 		const bool _pretty;
+		bool _failed = false;
 	};
 }
@@ -0,0 +1,173 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_serialization/st_binary_reader.hpp>
+
+#include <seir_base/shared_ptr.hpp>
+#include <seir_io/blob.hpp>
+#include "st_format.hpp"
+#include "st_reader_impl.hpp"
+
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace
+{
+	class StBinaryReaderImpl final : public seir::StReaderImpl
+	{
+	public:
+		explicit StBinaryReaderImpl(const seir::SharedPtr<seir::Blob>& blob)
+			: _blob{ blob }
+		{
+			if (!_blob || !seir::StBinaryReader::isBinary(*_blob))
+			{
+				fail(0);
+				return;
+			}
+			_data = static_cast<const char*>(_blob->data());
+			_size = _blob->size();
+			_offset = seir::kStBinarySignature.size();
+			size_t keyCount = 0;
+			if (!readNumber(keyCount) || keyCount > (_size - _offset) / 2) // Each key takes at least two bytes.
+			{
+				fail(_offset);
+				return;
+			}
+			_keys.reserve(keyCount);
+			for (size_t i = 0; i < keyCount; ++i)
+			{
+				const auto offset = _offset;
+				size_t size = 0;
+				if (!readNumber(size) || size > _size - _offset)
+				{
+					fail(offset);
+					return;
+				}
+				const auto& key = _keys.emplace_back(_data + _offset, size);
+				if (!seir::isValidStKey(key))
+				{
+					fail(offset);
+					return;
+				}
+				_offset += size;
+			}
+		}
+
+		seir::StToken read() override
+		{
+			if (_finished)
+				return _last;
+			const auto offset = _offset;
+			if (offset == _size)
+				return fail(offset);
+			switch (static_cast<seir::StBinaryToken>(_data[_offset++]))
+			{
+			case seir::StBinaryToken::End:
+				if (_offset != _size || _stack.size() != 1)
+					break;
+				_finished = true;
+				_last = { 0, offset, seir::StToken::Type::End, {} };
+				return _last;
+
+			case seir::StBinaryToken::ListBegin:
+				if (!(_stack.back() & AcceptValues))
+					break;
+				_stack.emplace_back(AcceptValues);
+				return { 0, offset, seir::StToken::Type::ListBegin, "[" };
+
+			case seir::StBinaryToken::ListEnd:
+				if (_stack.back() != AcceptValues || _stack.size() == 1)
+					break;
+				_stack.pop_back();
+				return { 0, offset, seir::StToken::Type::ListEnd, "]" };
+
+			case seir::StBinaryToken::ObjectBegin:
+				if (!(_stack.back() & AcceptValues))
+					break;
+				_stack.emplace_back(AcceptKeys);
+				return { 0, offset, seir::StToken::Type::ObjectBegin, "{" };
+
+			case seir::StBinaryToken::ObjectEnd:
+				if (!(_stack.back() & AcceptKeys) || _stack.size() == 1)
+					break;
+				_stack.pop_back();
+				return { 0, offset, seir::StToken::Type::ObjectEnd, "}" };
+
+			case seir::StBinaryToken::Key:
+				if (size_t index = 0; _stack.back() & AcceptKeys && readNumber(index) && index < _keys.size())
+				{
+					_stack.back() |= AcceptValues;
+					return { 0, offset, seir::StToken::Type::Key, _keys[index] };
+				}
+				break;
+
+			case seir::StBinaryToken::Value:
+				if (size_t size = 0; _stack.back() & AcceptValues && readNumber(size) && size <= _size - _offset)
+				{
+					const std::string_view value{ _data + _offset, size };
+					_offset += size;
+					return { 0, offset, seir::StToken::Type::Value, value };
+				}
+				break;
+			}
+			return fail(offset);
+		}
+
+	private:
+		seir::StToken fail(size_t offset) noexcept
+		{
+			_finished = true;
+			_last = { 0, offset, seir::StToken::Type::Error, {} };
+			return _last;
+		}
+
+		bool readNumber(size_t& number) noexcept
+		{
+			number = 0;
+			for (unsigned shift = 0; _offset < _size && shift < std::numeric_limits<size_t>::digits; shift += 7)
+			{
+				const auto part = static_cast<size_t>(static_cast<uint8_t>(_data[_offset++]) & 0x7fu);
+				if ((part << shift) >> shift != part)
+					return false;
+				number |= part << shift;
+				if (!(static_cast<uint8_t>(_data[_offset - 1]) & 0x80))
+					return true;
+			}
+			return false;
+		}
+
+	private:
+		enum : uint8_t
+		{
+			AcceptKeys = 1 << 0,
+			AcceptValues = 1 << 1,
+		};
+
+		const seir::SharedPtr<seir::Blob> _blob;
+		const char* _data = nullptr;
+		size_t _size = 0;
+		size_t _offset = 0;
+		std::vector<std::string_view> _keys;
+		std::vector<uint8_t> _stack{ AcceptKeys };
+		bool _finished = false;
+		seir::StToken _last;
+	};
+}
+
+namespace seir
+{
+	std::unique_ptr<StReaderImpl> createStBinaryReader(const SharedPtr<Blob>& blob)
+	{
+		return std::make_unique<StBinaryReaderImpl>(blob);
+	}
+
+	StBinaryReader::StBinaryReader(const SharedPtr<Blob>& blob)
+		: StReader{ blob, true } {}
+
+	bool StBinaryReader::isBinary(const Blob& blob) noexcept
+	{
+		return blob.size() >= kStBinarySignature.size() && !std::memcmp(blob.data(), kStBinarySignature.data(), kStBinarySignature.size());
+	}
+}
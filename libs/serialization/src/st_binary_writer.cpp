@@ -0,0 +1,117 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_serialization/st_binary_writer.hpp>
+
+#include <seir_io/writer.hpp>
+#include "st_format.hpp"
+
+#include <array>
+#include <span>
+
+namespace
+{
+	enum : uint8_t
+	{
+		IsRoot = 1 << 0,
+		IsList = 1 << 1,
+		AcceptsValues = 1 << 2,
+	};
+
+	void appendNumber(std::string& buffer, size_t number)
+	{
+		for (; number >= 0x80; number >>= 7)
+			buffer += static_cast<char>((number & 0x7f) | 0x80);
+		buffer += static_cast<char>(number);
+	}
+
+	void appendToken(std::string& buffer, seir::StBinaryToken token)
+	{
+		buffer += static_cast<char>(token);
+	}
+}
+
+namespace seir
+{
+	StBinaryWriter::StBinaryWriter()
+		: _stack{ IsRoot }
+	{
+	}
+
+	StBinaryWriter::~StBinaryWriter() noexcept = default;
+
+	void StBinaryWriter::addKey(std::string_view key)
+	{
+		if (!isValidStKey(key)) [[unlikely]]
+			throw StWriter::BadToken{};
+		if (_stack.back() & IsList) [[unlikely]]
+			throw StWriter::BadToken{};
+		auto [i, inserted] = _keyIndices.try_emplace(std::string{ key }, _keys.size());
+		if (inserted)
+			_keys.emplace_back(i->first);
+		::appendToken(_tokens, StBinaryToken::Key);
+		::appendNumber(_tokens, i->second);
+		_stack.back() |= AcceptsValues;
+	}
+
+	void StBinaryWriter::addValue(std::string_view value)
+	{
+		beginValue();
+		::appendToken(_tokens, StBinaryToken::Value);
+		::appendNumber(_tokens, value.size());
+		_tokens += value;
+	}
+
+	void StBinaryWriter::beginList()
+	{
+		beginValue();
+		::appendToken(_tokens, StBinaryToken::ListBegin);
+		_stack.emplace_back(IsList | AcceptsValues);
+	}
+
+	void StBinaryWriter::beginObject()
+	{
+		beginValue();
+		::appendToken(_tokens, StBinaryToken::ObjectBegin);
+		_stack.emplace_back(uint8_t{});
+	}
+
+	void StBinaryWriter::endList()
+	{
+		if (!(_stack.back() & IsList)) [[unlikely]]
+			throw StWriter::BadToken{};
+		::appendToken(_tokens, StBinaryToken::ListEnd);
+		_stack.pop_back();
+	}
+
+	void StBinaryWriter::endObject()
+	{
+		if (_stack.back() & (IsRoot | IsList)) [[unlikely]]
+			throw StWriter::BadToken{};
+		::appendToken(_tokens, StBinaryToken::ObjectEnd);
+		_stack.pop_back();
+	}
+
+	bool StBinaryWriter::finish(Writer& writer)
+	{
+		if (_stack.size() != 1) [[unlikely]]
+			throw StWriter::BadToken{};
+		std::string header{ kStBinarySignature.data(), kStBinarySignature.size() };
+		::appendNumber(header, _keys.size());
+		for (const auto key : _keys)
+		{
+			::appendNumber(header, key.size());
+			header += key;
+		}
+		static constexpr auto kEnd = StBinaryToken::End;
+		const std::array parts{ std::as_bytes(std::span{ header }), std::as_bytes(std::span{ _tokens }), std::as_bytes(std::span{ &kEnd, 1 }) };
+		return writer.writeParts(parts);
+	}
+
+	void StBinaryWriter::beginValue()
+	{
+		if (!(_stack.back() & AcceptsValues)) [[unlikely]]
+			throw StWriter::BadToken{};
+	}
+}
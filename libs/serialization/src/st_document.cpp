@@ -0,0 +1,209 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_serialization/st_document.hpp>
+
+#include <seir_base/shared_ptr.hpp>
+#include <seir_io/blob.hpp>
+#include <seir_serialization/st_binary_reader.hpp>
+#include <seir_serialization/st_stream.hpp>
+
+#include <bit>
+#include <cassert>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace seir
+{
+	class StDocumentImpl
+	{
+	public:
+		static constexpr auto kNone = std::numeric_limits<uint32_t>::max();
+
+		struct Node
+		{
+			std::string_view _text;
+			uint32_t _parent = kNone;
+			uint32_t _end = 0;     // The index after the last contained node.
+			uint32_t _sameKey = 0; // The index of the next key with the same name, or zero.
+			StNode::Type _type = StNode::Type::Object;
+		};
+
+		const SharedPtr<Blob> _blob;
+		std::vector<Node> _nodes;
+		std::vector<uint32_t> _keyTable; // Indices of the first keys with each name in each object, or zeros.
+
+		explicit StDocumentImpl(const SharedPtr<Blob>& blob)
+			: _blob{ blob }
+		{
+			if (_blob && StBinaryReader::isBinary(*_blob))
+			{
+				StBinaryReader reader{ _blob };
+				build(reader);
+			}
+			else
+			{
+				StReader reader{ _blob };
+				build(reader);
+			}
+			buildKeyTable();
+		}
+
+		StNode find(uint32_t object, std::string_view key) const noexcept
+		{
+			const auto mask = _keyTable.size() - 1;
+			for (auto slot = hash(object, key) & mask;; slot = (slot + 1) & mask)
+			{
+				const auto index = _keyTable[slot];
+				if (!index)
+					return {};
+				if (const auto& node = _nodes[index]; node._parent == object && node._text == key)
+					return makeNode(index);
+			}
+		}
+
+		StNode makeNode(uint32_t index) const noexcept
+		{
+			return { this, index };
+		}
+
+	private:
+		void build(StReader& reader)
+		{
+			std::vector<uint32_t> stack;
+			const auto open = [&](StNode::Type type, std::string_view text) {
+				if (_nodes.size() == kNone) [[unlikely]]
+					throw std::length_error{ "Too many StDocument nodes" };
+				const auto index = static_cast<uint32_t>(_nodes.size());
+				_nodes.emplace_back(text, stack.empty() ? kNone : stack.back(), index + 1, 0u, type);
+				return index;
+			};
+			const auto close = [&] {
+				_nodes[stack.back()]._end = static_cast<uint32_t>(_nodes.size());
+				stack.pop_back();
+			};
+			const auto closeKey = [&] {
+				if (_nodes[stack.back()]._type == StNode::Type::Key)
+					close();
+			};
+			stack.emplace_back(open(StNode::Type::Object, {}));
+			for (;;)
+			{
+				const auto token = reader.read();
+				switch (token.type())
+				{
+				case StToken::Type::Error: throw StStreamError{ token };
+				case StToken::Type::End:
+					closeKey();
+					if (stack.size() > 1) // Unterminated list or object.
+						throw StStreamError{ token };
+					close();
+					return;
+				case StToken::Type::Key:
+					closeKey();
+					stack.emplace_back(open(StNode::Type::Key, token.text()));
+					break;
+				case StToken::Type::Value: open(StNode::Type::Value, token.text()); break;
+				case StToken::Type::ListBegin: stack.emplace_back(open(StNode::Type::List, {})); break;
+				case StToken::Type::ObjectBegin: stack.emplace_back(open(StNode::Type::Object, {})); break;
+				case StToken::Type::ListEnd: close(); break;
+				case StToken::Type::ObjectEnd:
+					closeKey();
+					close();
+					break;
+				}
+			}
+		}
+
+		// Keys are inserted in reverse order so that the table references the first key
+		// with each name and each key references the next one with the same name.
+		void buildKeyTable()
+		{
+			size_t keyCount = 0;
+			for (const auto& node : _nodes)
+				if (node._type == StNode::Type::Key)
+					++keyCount;
+			_keyTable.resize(std::bit_ceil(keyCount * 2 + 1)); // Keeps at least one slot empty.
+			const auto mask = _keyTable.size() - 1;
+			for (auto index = static_cast<uint32_t>(_nodes.size()); index > 0;)
+			{
+				auto& node = _nodes[--index];
+				if (node._type != StNode::Type::Key)
+					continue;
+				for (auto slot = hash(node._parent, node._text) & mask;; slot = (slot + 1) & mask)
+				{
+					auto& entry = _keyTable[slot];
+					if (!entry)
+					{
+						entry = index;
+						break;
+					}
+					if (const auto& other = _nodes[entry]; other._parent == node._parent && other._text == node._text)
+					{
+						node._sameKey = entry;
+						entry = index;
+						break;
+					}
+				}
+			}
+		}
+
+		static size_t hash(uint32_t object, std::string_view key) noexcept
+		{
+			return std::hash<std::string_view>{}(key) ^ (object * static_cast<size_t>(0x9e3779b97f4a7c15u));
+		}
+	};
+
+	StNode StNode::find(std::string_view key) const noexcept
+	{
+		return _document && _document->_nodes[_index]._type == Type::Object ? _document->find(_index, key) : StNode{};
+	}
+
+	StNode StNode::first() const noexcept
+	{
+		return _document && _document->_nodes[_index]._end > _index + 1 ? _document->makeNode(_index + 1) : StNode{};
+	}
+
+	StNode StNode::next() const noexcept
+	{
+		if (!_document)
+			return {};
+		const auto& nodes = _document->_nodes;
+		const auto& node = nodes[_index];
+		return node._end < nodes.size() && nodes[node._end]._parent == node._parent ? _document->makeNode(node._end) : StNode{};
+	}
+
+	StNode StNode::nextSame() const noexcept
+	{
+		if (!_document)
+			return {};
+		const auto sameKey = _document->_nodes[_index]._sameKey;
+		return sameKey ? _document->makeNode(sameKey) : StNode{};
+	}
+
+	std::string_view StNode::text() const noexcept
+	{
+		return _document ? _document->_nodes[_index]._text : std::string_view{};
+	}
+
+	StNode::Type StNode::type() const noexcept
+	{
+		assert(_document);
+		return _document->_nodes[_index]._type;
+	}
+
+	StDocument::StDocument(const SharedPtr<Blob>& blob)
+		: _impl{ std::make_unique<StDocumentImpl>(blob) }
+	{
+	}
+
+	StDocument::~StDocument() noexcept = default;
+
+	StNode StDocument::root() const noexcept
+	{
+		return _impl->makeNode(0);
+	}
+}
@@ -0,0 +1,45 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace seir
+{
+	// Binary .st data consists of:
+	// - the signature;
+	// - the number of keys followed by the keys, each prefixed with its size;
+	// - the tokens, each consisting of a type byte and additional data (key index or value size and bytes);
+	// - the End token which must be the last byte.
+	// All numbers are unsigned LEB128.
+	constexpr std::array<char, 8> kStBinarySignature{ '\0', 'S', 'e', 'i', 'r', 'S', 'T', '\1' };
+
+	enum class StBinaryToken : uint8_t
+	{
+		End,
+		ListBegin,
+		ListEnd,
+		ObjectBegin,
+		ObjectEnd,
+		Key,   // Followed by the key index.
+		Value, // Followed by the value size and bytes.
+	};
+
+	// Keys must start with a letter or an underscore and may contain letters, digits and underscores.
+	constexpr bool isValidStKey(std::string_view key) noexcept
+	{
+		if (key.empty()) [[unlikely]]
+			return false;
+		if (const char c = key[0]; !((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_')) [[unlikely]]
+			return false;
+		for (size_t i = 1; i < key.size(); ++i)
+			if (const char c = key[i]; !((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_' || (c >= '0' && c <= '9'))) [[unlikely]]
+				return false;
+		return true;
+	}
+}
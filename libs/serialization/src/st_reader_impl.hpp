@@ -0,0 +1,21 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_serialization/st_reader.hpp>
+
+#include <memory>
+
+namespace seir
+{
+	class StReaderImpl
+	{
+	public:
+		virtual ~StReaderImpl() noexcept = default;
+		virtual StToken read() = 0;
+	};
+
+	std::unique_ptr<StReaderImpl> createStBinaryReader(const SharedPtr<Blob>&);
+}
@@ -0,0 +1,344 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#pragma once
+
+#include <seir_base/cpu.hpp>
+#include <seir_base/intrinsics.hpp>
+#include <seir_serialization/st_reader.hpp>
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace seir
+{
+	// Splits .st text into tokens. The text doesn't need to be null-terminated.
+	// The vectorized tokenizer skips runs of spaces, key characters, comments and quoted values
+	// in 16 or 32-byte blocks and must produce exactly the same tokens as the scalar one.
+	template <bool kVectorized>
+	class StTokenizer
+	{
+	public:
+		StTokenizer(const char* data, size_t size)
+		{
+			if (size > 0)
+			{
+				_cursor = data;
+				_end = data + size;
+				_lineBegin = data;
+			}
+		}
+
+		StToken read()
+		{
+			for (;;)
+			{
+				// The text is scanned in place, so the end of data is treated as a null character.
+				switch (classOf(_cursor != _end ? *_cursor : '\0'))
+				{
+				case Other:
+				case Digit:
+					return makeError(_cursor);
+
+				case End:
+					if (_cursor == _end)
+						return makeToken(StToken::Type::End, _cursor, 0);
+					else
+						return makeError(_cursor);
+
+				case Space:
+					_cursor = skipSpaces(_cursor + 1);
+					break;
+
+				case Cr:
+					if (_cursor + 1 != _end && _cursor[1] == '\n')
+						++_cursor;
+					[[fallthrough]];
+				case Lf:
+					_lineBegin = ++_cursor;
+					++_line;
+					break;
+
+				case Key:
+					if (_stack.back() & AcceptKeys)
+					{
+						const auto begin = _cursor;
+						_cursor = skipKey(_cursor + 1);
+						_stack.back() |= AcceptValues;
+						return makeToken(StToken::Type::Key, begin, _cursor - begin);
+					}
+					else
+						return makeError(_cursor);
+
+				case Quote:
+					if (_stack.back() & AcceptValues)
+					{
+						const auto quote = *_cursor;
+						const auto base = _cursor + 1;
+						const auto cursor = findLineEnd(base, quote);
+						if (cursor == _end || *cursor != quote)
+							return makeError(cursor);
+						_cursor = cursor + 1;
+						return makeToken<-1>(StToken::Type::Value, base, cursor - base);
+					}
+					else
+						return makeError(_cursor);
+
+				case LBracket:
+					if (_stack.back() & AcceptValues)
+					{
+						_stack.emplace_back(AcceptValues);
+						return makeToken(StToken::Type::ListBegin, _cursor++, 1);
+					}
+					else
+						return makeError(_cursor);
+
+				case RBracket:
+					if (_stack.back() == AcceptValues && _stack.size() > 1)
+					{
+						_stack.pop_back();
+						return makeToken(StToken::Type::ListEnd, _cursor++, 1);
+					}
+					else
+						return makeError(_cursor);
+
+				case LBrace:
+					if (_stack.back() & AcceptValues)
+					{
+						_stack.emplace_back(AcceptKeys);
+						return makeToken(StToken::Type::ObjectBegin, _cursor++, 1);
+					}
+					else
+						return makeError(_cursor);
+
+				case RBrace:
+					if (_stack.back() & AcceptKeys && _stack.size() > 1)
+					{
+						_stack.pop_back();
+						return makeToken(StToken::Type::ObjectEnd, _cursor++, 1);
+					}
+					else
+						return makeError(_cursor);
+
+				case Comment:
+					if (auto next = _cursor + 1; next != _end && *next == '/')
+					{
+						_cursor = findLineEnd(next + 1, '\n');
+						break;
+					}
+					else
+						return makeError(_cursor);
+				}
+			}
+		}
+
+	private:
+		static constexpr uint8_t kAlphanumeric = 0b10000;
+
+		enum CharClass : uint8_t
+		{
+			Other,
+			End,
+			Space,
+			Cr,
+			Lf,
+			Quote,
+			LBracket,
+			RBracket,
+			LBrace,
+			RBrace,
+			Comment,
+			Key = kAlphanumeric,
+			Digit,
+		};
+
+		static constexpr std::array<CharClass, 256> kCharClasses{
+			End, Other, Other, Other, Other, Other, Other, Other,     // \0
+			Other, Space, Lf, Space, Space, Cr, Other, Other,         // \t \n \v \f \r
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Space, Other, Quote, Other, Other, Other, Other, Other,   //   ! " # $ % & '
+			Other, Other, Other, Other, Other, Other, Other, Comment, // ( ) * + , - . /
+			Digit, Digit, Digit, Digit, Digit, Digit, Digit, Digit,   // 0 1 2 3 4 5 6 7
+			Digit, Digit, Other, Other, Other, Other, Other, Other,   // 8 9 : ; < = > ?
+			Other, Key, Key, Key, Key, Key, Key, Key,                 // @ A B C D E F G
+			Key, Key, Key, Key, Key, Key, Key, Key,                   // H I J K L M N O
+			Key, Key, Key, Key, Key, Key, Key, Key,                   // P Q R S T U V W
+			Key, Key, Key, LBracket, Other, RBracket, Other, Key,     // X Y Z [ \ ] ^ _
+			Quote, Key, Key, Key, Key, Key, Key, Key,                 // ` a b c d e f g
+			Key, Key, Key, Key, Key, Key, Key, Key,                   // h i j k l m n o
+			Key, Key, Key, Key, Key, Key, Key, Key,                   // p q r s t u v w
+			Key, Key, Key, LBrace, Other, RBrace, Other, Other,       // x y z { | } ~
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+			Other, Other, Other, Other, Other, Other, Other, Other,   //
+		};
+
+		static constexpr CharClass classOf(char c) noexcept
+		{
+			return kCharClasses[static_cast<unsigned char>(c)]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+		}
+
+		static constexpr bool isLineEnd(char c, char quote) noexcept
+		{
+			return c == '\0' || c == '\n' || c == '\r' || c == quote;
+		}
+
+#if SEIR_INTRINSICS_SSE
+		using Block = __m128i;
+		static Block load(const char* data) noexcept { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(data)); }
+		static Block equal(Block block, char c) noexcept { return _mm_cmpeq_epi8(block, _mm_set1_epi8(c)); }
+		static Block inRange(Block block, char first, char last) noexcept
+		{
+			const auto offsets = _mm_sub_epi8(block, _mm_set1_epi8(first));
+			return _mm_cmpeq_epi8(_mm_min_epu8(offsets, _mm_set1_epi8(static_cast<char>(last - first))), offsets);
+		}
+		static Block either(Block first, Block second) noexcept { return _mm_or_si128(first, second); }
+		static unsigned firstSet(Block block) noexcept { return static_cast<unsigned>(std::countr_zero(static_cast<unsigned>(_mm_movemask_epi8(block)) | 0x10000u)); }
+		static unsigned firstClear(Block block) noexcept { return static_cast<unsigned>(std::countr_zero(~static_cast<unsigned>(_mm_movemask_epi8(block)))); }
+
+		SEIR_TARGET("avx2")
+		static const char* findLineEndAvx2(const char* cursor, const char* end, char quote) noexcept
+		{
+			for (; end - cursor >= 32; cursor += 32)
+			{
+				const auto block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cursor));
+				const auto stops = _mm256_or_si256(
+					_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_setzero_si256()), _mm256_cmpeq_epi8(block, _mm256_set1_epi8('\n'))),
+					_mm256_or_si256(_mm256_cmpeq_epi8(block, _mm256_set1_epi8('\r')), _mm256_cmpeq_epi8(block, _mm256_set1_epi8(quote))));
+				if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(stops)))
+					return cursor + std::countr_zero(mask);
+			}
+			return cursor;
+		}
+#elif SEIR_INTRINSICS_NEON
+		using Block = uint8x16_t;
+		static Block load(const char* data) noexcept { return vld1q_u8(reinterpret_cast<const uint8_t*>(data)); }
+		static Block equal(Block block, char c) noexcept { return vceqq_u8(block, vdupq_n_u8(static_cast<uint8_t>(c))); }
+		static Block inRange(Block block, char first, char last) noexcept
+		{
+			return vcleq_u8(vsubq_u8(block, vdupq_n_u8(static_cast<uint8_t>(first))), vdupq_n_u8(static_cast<uint8_t>(last - first)));
+		}
+		static Block either(Block first, Block second) noexcept { return vorrq_u8(first, second); }
+		static unsigned firstSet(Block block) noexcept
+		{
+			// Narrowing shift packs the comparison results into 4 bits per byte.
+			return static_cast<unsigned>(std::countr_zero(vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(block), 4)), 0))) / 4;
+		}
+		static unsigned firstClear(Block block) noexcept { return firstSet(vmvnq_u8(block)); }
+#endif
+
+		// Returns the first character after the run of spaces which starts at the cursor.
+		const char* skipSpaces(const char* cursor) const noexcept
+		{
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+				// Most runs are just a single space, so the first character is checked separately.
+				if (_end - cursor > 16 && classOf(*cursor) == Space)
+					for (++cursor; _end - cursor >= 16; cursor += 16)
+					{
+						const auto block = load(cursor);
+						const auto spaces = either(either(equal(block, ' '), equal(block, '\t')), inRange(block, '\v', '\f'));
+						if (const auto offset = firstClear(spaces); offset < 16)
+							return cursor + offset;
+					}
+#endif
+			}
+			while (cursor != _end && classOf(*cursor) == Space)
+				++cursor;
+			return cursor;
+		}
+
+		// Returns the first character after the run of key characters which starts at the cursor.
+		const char* skipKey(const char* cursor) const noexcept
+		{
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+				while (_end - cursor >= 16)
+				{
+					const auto block = load(cursor);
+					const auto keys = either(either(inRange(block, '0', '9'), inRange(block, 'A', 'Z')), either(inRange(block, 'a', 'z'), equal(block, '_')));
+					if (const auto offset = firstClear(keys); offset < 16)
+						return cursor + offset;
+					cursor += 16;
+				}
+#endif
+			}
+			while (cursor != _end && classOf(*cursor) & kAlphanumeric)
+				++cursor;
+			return cursor;
+		}
+
+		// Returns the first line ending or quote character starting from the cursor.
+		const char* findLineEnd(const char* cursor, char quote) const noexcept
+		{
+			if constexpr (kVectorized)
+			{
+#if SEIR_INTRINSICS_SSE || SEIR_INTRINSICS_NEON
+				while (_end - cursor >= 16)
+				{
+					const auto block = load(cursor);
+					const auto stops = either(either(equal(block, '\0'), equal(block, '\n')), either(equal(block, '\r'), equal(block, quote)));
+					if (const auto offset = firstSet(stops); offset < 16)
+						return cursor + offset;
+					cursor += 16;
+#	if SEIR_INTRINSICS_SSE
+					// Long comments and values are scanned in larger blocks.
+					if (_avx2)
+						cursor = findLineEndAvx2(cursor, _end, quote);
+#	endif
+				}
+#endif
+			}
+			while (cursor != _end && !isLineEnd(*cursor, quote))
+				++cursor;
+			return cursor;
+		}
+
+		constexpr StToken makeError(const char* at) noexcept
+		{
+			return { _line, static_cast<size_t>(at - _lineBegin + 1), StToken::Type::Error, std::string_view{} };
+		}
+
+		template <ptrdiff_t columnOffset = 0>
+		StToken makeToken(StToken::Type type, const char* begin, ptrdiff_t size) noexcept
+		{
+			const std::string_view text{ begin, static_cast<size_t>(size) };
+			return { _line, static_cast<size_t>(begin - _lineBegin + 1 + columnOffset), type, text };
+		}
+
+	private:
+		enum : uint8_t
+		{
+			AcceptKeys = 1 << 0,
+			AcceptValues = 1 << 1,
+		};
+
+		const char* _cursor = "";
+		const char* _end = _cursor;
+		size_t _line = 1;
+		const char* _lineBegin = _cursor;
+		std::vector<uint8_t> _stack{ AcceptKeys };
+#if SEIR_INTRINSICS_SSE
+		const bool _avx2 = kVectorized && hasCpuFeature(CpuFeature::Avx2);
+#endif
+	};
+}
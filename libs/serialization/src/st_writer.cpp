@@ -4,8 +4,11 @@
 
 #include <seir_serialization/st_writer.hpp>
 
-#include <algorithm>
-#include <array>
+#include <seir_base/intrinsics.hpp>
+#include <seir_io/writer.hpp>
+#include "st_format.hpp"
+
+#include <bit>
 #include <cassert>
 
 namespace
@@ -18,16 +21,35 @@ namespace
 		IsList = 1 << 3,
 	};
 
-	constexpr bool isKeyValid(std::string_view key) noexcept
+	constexpr bool needsEscaping(char c) noexcept
 	{
-		if (key.empty()) [[unlikely]]
-			return false;
-		if (const char c = key[0]; !((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_')) [[unlikely]]
-			return false;
-		for (size_t i = 1; i < key.size(); ++i)
-			if (const char c = key[i]; !((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || c == '_' || (c >= '0' && c <= '9'))) [[unlikely]]
-				return false;
-		return true;
+		return c == '\\' || c == '"';
+	}
+
+	// Returns the first character which must be escaped, or the end.
+	const char* findEscape(const char* begin, const char* end) noexcept
+	{
+#if SEIR_INTRINSICS_SSE
+		for (; end - begin >= 16; begin += 16)
+		{
+			const auto block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+			const auto escapes = _mm_or_si128(_mm_cmpeq_epi8(block, _mm_set1_epi8('\\')), _mm_cmpeq_epi8(block, _mm_set1_epi8('"')));
+			if (const auto mask = static_cast<unsigned>(_mm_movemask_epi8(escapes)))
+				return begin + std::countr_zero(mask);
+		}
+#elif SEIR_INTRINSICS_NEON
+		for (; end - begin >= 16; begin += 16)
+		{
+			const auto block = vld1q_u8(reinterpret_cast<const uint8_t*>(begin));
+			const auto escapes = vorrq_u8(vceqq_u8(block, vdupq_n_u8('\\')), vceqq_u8(block, vdupq_n_u8('"')));
+			// Narrowing shift packs the comparison results into 4 bits per byte.
+			if (const auto mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(escapes), 4)), 0))
+				return begin + std::countr_zero(mask) / 4;
+		}
+#endif
+		while (begin != end && !needsEscaping(*begin))
+			++begin;
+		return begin;
 	}
 }
 
@@ -40,11 +62,21 @@ namespace seir
 	{
 	}
 
+	StWriter::StWriter(Writer& writer, Formatting formatting, size_t bufferSize)
+		: _buffer{ _staging }
+		, _writer{ &writer }
+		, _bufferSize{ bufferSize > 0 ? bufferSize : 1 }
+		, _stack{ IsRoot }
+		, _pretty{ formatting == StWriter::Formatting::Pretty }
+	{
+		_staging.reserve(_bufferSize);
+	}
+
 	StWriter::~StWriter() noexcept = default;
 
 	void StWriter::addKey(std::string_view key)
 	{
-		if (!::isKeyValid(key)) [[unlikely]]
+		if (!isValidStKey(key)) [[unlikely]]
 			throw BadToken{};
 		const auto entry = _stack.back();
 		if (entry & IsList) [[unlikely]]
@@ -59,6 +91,7 @@ namespace seir
 			_buffer += ' ';
 		_buffer += key;
 		_stack.back() = static_cast<uint8_t>(entry | IsNonEmptyObject | EndsWithKey);
+		flushIfFull();
 	}
 
 	void StWriter::addValue(std::string_view value)
@@ -71,16 +104,18 @@ namespace seir
 		_buffer += '"';
 		for (auto begin = value.data(), end = begin + value.size();;)
 		{
-			const auto i = std::find_if(begin, end, [](char c) { return c == '\\' || c == '"'; });
+			const auto i = ::findEscape(begin, end);
 			if (i != begin)
-				_buffer.append(begin, static_cast<size_t>(i - begin));
+				appendRun(begin, static_cast<size_t>(i - begin));
 			if (i == end)
 				break;
 			_buffer.append({ '\\', *i });
+			flushIfFull();
 			begin = i + 1;
 		}
 		_buffer += '"';
 		_stack.back() = static_cast<uint8_t>(entry & ~EndsWithKey);
+		flushIfFull();
 	}
 
 	void StWriter::beginList()
@@ -93,6 +128,7 @@ namespace seir
 		_buffer += '[';
 		_stack.back() = static_cast<uint8_t>(entry & ~EndsWithKey);
 		_stack.emplace_back(IsList);
+		flushIfFull();
 	}
 
 	void StWriter::beginObject()
@@ -105,6 +141,7 @@ namespace seir
 		_buffer += '{';
 		_stack.back() = static_cast<uint8_t>(entry & ~EndsWithKey);
 		_stack.emplace_back(uint8_t{});
+		flushIfFull();
 	}
 
 	void StWriter::endList()
@@ -119,6 +156,7 @@ namespace seir
 		_buffer += ']';
 		_stack.pop_back();
 		assert(!_stack.empty());
+		flushIfFull();
 	}
 
 	void StWriter::endObject()
@@ -133,9 +171,10 @@ namespace seir
 		_buffer += '}';
 		_stack.pop_back();
 		assert(!_stack.empty());
+		flushIfFull();
 	}
 
-	void StWriter::finish()
+	bool StWriter::finish()
 	{
 		if (_stack.size() != 1) [[unlikely]]
 			throw BadToken{};
@@ -143,6 +182,22 @@ namespace seir
 		if (_pretty)
 			if (_stack.back() & IsNonEmptyObject) [[likely]]
 				_buffer += '\n';
+		if (_writer)
+			flush();
+		return !_failed;
+	}
+
+	void StWriter::appendRun(const char* data, size_t size)
+	{
+		if (_writer && size >= _bufferSize)
+		{
+			// Long runs are written directly instead of being copied to the staging buffer.
+			flush();
+			if (!_failed && !_writer->write(data, size))
+				_failed = true;
+		}
+		else
+			_buffer.append(data, size);
 	}
 
 	void StWriter::beginPrettyValue(uint8_t entry)
@@ -156,4 +211,18 @@ namespace seir
 		else
 			_buffer += ' ';
 	}
+
+	void StWriter::flush()
+	{
+		assert(_writer);
+		if (!_failed && !_buffer.empty() && !_writer->write(_buffer.data(), _buffer.size()))
+			_failed = true;
+		_buffer.clear();
+	}
+
+	void StWriter::flushIfFull()
+	{
+		if (_writer && _buffer.size() >= _bufferSize)
+			flush();
+	}
 }
@@ -0,0 +1,117 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_serialization/st_binary_reader.hpp>
+
+#include <seir_base/buffer.hpp>
+#include <seir_io/buffer_blob.hpp>
+#include <seir_io/buffer_writer.hpp>
+#include <seir_serialization/st_binary_writer.hpp>
+#include <seir_serialization/st_stream.hpp>
+
+#include <vector>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+	seir::SharedPtr<seir::Blob> convert(std::string_view text)
+	{
+		seir::StReader reader{ seir::Blob::from(text.data(), text.size()) };
+		seir::StBinaryWriter writer;
+		for (auto token = reader.read(); token.type() != seir::StToken::Type::End; token = reader.read())
+			switch (token.type())
+			{
+			case seir::StToken::Type::Key: writer.addKey(token.text()); break;
+			case seir::StToken::Type::Value: writer.addValue(token.text()); break;
+			case seir::StToken::Type::ListBegin: writer.beginList(); break;
+			case seir::StToken::Type::ListEnd: writer.endList(); break;
+			case seir::StToken::Type::ObjectBegin: writer.beginObject(); break;
+			case seir::StToken::Type::ObjectEnd: writer.endObject(); break;
+			default: return {};
+			}
+		seir::Buffer buffer;
+		uint64_t size = 0;
+		seir::BufferWriter bufferWriter{ buffer, &size };
+		REQUIRE(writer.finish(bufferWriter));
+		return seir::makeShared<seir::Blob, seir::BufferBlob>(std::move(buffer), static_cast<size_t>(size));
+	}
+
+	constexpr std::string_view kText = "key \"value\" other \"1\" \"2\"\nlist [\"\" {key \"3\"} []]\nobject {inner {}} key";
+}
+
+TEST_CASE("StBinaryReader")
+{
+	const auto blob = ::convert(kText);
+	REQUIRE(blob);
+	CHECK(seir::StBinaryReader::isBinary(*blob));
+	CHECK_FALSE(seir::StBinaryReader::isBinary(*seir::Blob::from(kText.data(), kText.size())));
+	SUBCASE("read")
+	{
+		seir::StReader textReader{ seir::Blob::from(kText.data(), kText.size()) };
+		seir::StBinaryReader binaryReader{ blob };
+		for (;;)
+		{
+			const auto expected = textReader.read();
+			const auto actual = binaryReader.read();
+			CHECK(actual.type() == expected.type());
+			CHECK(actual.text() == expected.text());
+			CHECK(actual.line() == 0);
+			if (expected.type() == seir::StToken::Type::End || actual.type() != expected.type())
+				break;
+		}
+		CHECK(binaryReader.read().type() == seir::StToken::Type::End);
+	}
+	SUBCASE("StStream")
+	{
+		seir::StBinaryReader reader{ blob };
+		seir::StStream stream{ reader };
+		stream.key("key");
+		CHECK(stream.value() == "value");
+		stream.key("other");
+		CHECK(stream.value() == "1");
+		CHECK(stream.value() == "2");
+		stream.key("list");
+		stream.beginList();
+		CHECK(stream.value().empty());
+		stream.beginObject();
+		stream.key("key");
+		CHECK(stream.value() == "3");
+		stream.endObject();
+		stream.beginList();
+		stream.endList();
+		stream.endList();
+		stream.key("object");
+		stream.beginObject();
+		stream.key("inner");
+		stream.beginObject();
+		stream.endObject();
+		stream.endObject();
+		stream.key("key");
+		CHECK(stream.tryEnd());
+	}
+	SUBCASE("errors")
+	{
+		const auto read = [](const seir::SharedPtr<seir::Blob>& data) {
+			seir::StBinaryReader reader{ data };
+			auto token = reader.read();
+			while (token.type() != seir::StToken::Type::End && token.type() != seir::StToken::Type::Error)
+				token = reader.read();
+			CHECK(reader.read().type() == token.type());
+			return token.type();
+		};
+		CHECK(read({}) == seir::StToken::Type::Error);
+		const auto data = static_cast<const std::byte*>(blob->data());
+		for (size_t size = 0; size < blob->size(); ++size)
+			CHECK(read(seir::Blob::from(data, size)) == seir::StToken::Type::Error);
+		std::vector<std::byte> corrupted(data, data + blob->size());
+		for (auto& byte : corrupted)
+		{
+			const auto original = byte;
+			byte = std::byte{ 0xff };
+			static_cast<void>(read(seir::Blob::from(corrupted.data(), corrupted.size())));
+			byte = original;
+		}
+	}
+}
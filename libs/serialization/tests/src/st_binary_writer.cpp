@@ -0,0 +1,71 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_serialization/st_binary_writer.hpp>
+
+#include <seir_base/buffer.hpp>
+#include <seir_io/buffer_writer.hpp>
+
+#include <functional>
+
+#include <doctest/doctest.h>
+
+TEST_CASE("StBinaryWriter")
+{
+	SUBCASE("positive")
+	{
+		seir::StBinaryWriter writer;
+		writer.addKey("key");
+		writer.addValue("value");
+		writer.addKey("list");
+		writer.beginList();
+		writer.addValue("");
+		writer.beginObject();
+		writer.addKey("key");
+		writer.endObject();
+		writer.endList();
+		seir::Buffer buffer;
+		uint64_t size = 0;
+		seir::BufferWriter bufferWriter{ buffer, &size };
+		REQUIRE(writer.finish(bufferWriter));
+		using namespace std::literals::string_view_literals;
+		constexpr auto expected =
+			"\0SeirST\1"sv                // Signature.
+			"\2\3key\4list"sv             // Keys.
+			"\5\0\6\5value"sv             // key "value"
+			"\5\1\1\6\0\3\5\0\4\2\0"sv; // list [ "" { key } ]
+		REQUIRE(size == expected.size());
+		CHECK(std::string_view{ reinterpret_cast<const char*>(buffer.data()), expected.size() } == expected);
+	}
+	SUBCASE("negative")
+	{
+		const auto check = [](const std::function<void(seir::StBinaryWriter&)>& usage) {
+			seir::StBinaryWriter writer;
+			CHECK_THROWS_AS(usage(writer), seir::StWriter::BadToken);
+		};
+
+		check([](seir::StBinaryWriter& w) { w.addKey(""); });
+		check([](seir::StBinaryWriter& w) { w.addKey("1key"); });
+		check([](seir::StBinaryWriter& w) { w.addKey("key 1"); });
+
+		check([](seir::StBinaryWriter& w) { w.addValue("value"); });
+		check([](seir::StBinaryWriter& w) { w.beginList(); });
+		check([](seir::StBinaryWriter& w) { w.beginObject(); });
+		check([](seir::StBinaryWriter& w) { w.endList(); });
+		check([](seir::StBinaryWriter& w) { w.endObject(); });
+
+		check([](seir::StBinaryWriter& w) { CHECK_NOTHROW(w.addKey("key")); CHECK_NOTHROW(w.beginList()); w.addKey("key2"); });
+		check([](seir::StBinaryWriter& w) { CHECK_NOTHROW(w.addKey("key")); CHECK_NOTHROW(w.beginList()); w.endObject(); });
+		check([](seir::StBinaryWriter& w) {
+			CHECK_NOTHROW(w.addKey("key"));
+			CHECK_NOTHROW(w.beginList());
+			seir::Buffer buffer;
+			seir::BufferWriter bufferWriter{ buffer };
+			static_cast<void>(w.finish(bufferWriter));
+		});
+
+		check([](seir::StBinaryWriter& w) { CHECK_NOTHROW(w.addKey("key")); CHECK_NOTHROW(w.beginObject()); w.addValue("value"); });
+		check([](seir::StBinaryWriter& w) { CHECK_NOTHROW(w.addKey("key")); CHECK_NOTHROW(w.beginObject()); w.endList(); });
+	}
+}
@@ -0,0 +1,208 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_serialization/st_document.hpp>
+
+#include <seir_base/buffer.hpp>
+#include <seir_base/shared_ptr.hpp>
+#include <seir_io/blob.hpp>
+#include <seir_io/buffer_blob.hpp>
+#include <seir_io/buffer_writer.hpp>
+#include <seir_serialization/st_binary_writer.hpp>
+#include <seir_serialization/st_stream.hpp>
+
+#include <string>
+#include <vector>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+	std::vector<std::string_view> texts(seir::StNode node)
+	{
+		std::vector<std::string_view> result;
+		for (; node; node = node.next())
+			result.emplace_back(node.text());
+		return result;
+	}
+}
+
+TEST_CASE("StDocument")
+{
+	constexpr std::string_view text =
+		"name \"first\"\n"
+		"items [\"1\" [\"2\" \"3\"] {key \"4\"}] \"5\"\n"
+		"empty\n"
+		"object {\n"
+		"  name \"inner\"\n"
+		"  child { name \"deep\" }\n"
+		"  name \"second inner\"\n"
+		"}\n"
+		"name \"second\" \"third\"\n";
+	const auto blob = seir::Blob::from(text.data(), text.size());
+	std::string_view description;
+	SUBCASE("text")
+	{
+		description = "text";
+	}
+	SUBCASE("binary")
+	{
+		description = "binary";
+	}
+	CAPTURE(description);
+	seir::SharedPtr<seir::Blob> source = blob;
+	if (description == "binary")
+	{
+		seir::StBinaryWriter writer;
+		writer.addKey("name");
+		writer.addValue("first");
+		writer.addKey("items");
+		writer.beginList();
+		writer.addValue("1");
+		writer.beginList();
+		writer.addValue("2");
+		writer.addValue("3");
+		writer.endList();
+		writer.beginObject();
+		writer.addKey("key");
+		writer.addValue("4");
+		writer.endObject();
+		writer.endList();
+		writer.addValue("5");
+		writer.addKey("empty");
+		writer.addKey("object");
+		writer.beginObject();
+		writer.addKey("name");
+		writer.addValue("inner");
+		writer.addKey("child");
+		writer.beginObject();
+		writer.addKey("name");
+		writer.addValue("deep");
+		writer.endObject();
+		writer.addKey("name");
+		writer.addValue("second inner");
+		writer.endObject();
+		writer.addKey("name");
+		writer.addValue("second");
+		writer.addValue("third");
+		seir::Buffer buffer;
+		uint64_t size = 0;
+		seir::BufferWriter bufferWriter{ buffer, &size };
+		REQUIRE(writer.finish(bufferWriter));
+		source = seir::makeShared<seir::Blob, seir::BufferBlob>(std::move(buffer), static_cast<size_t>(size));
+	}
+	const seir::StDocument document{ source };
+	const auto root = document.root();
+	REQUIRE(root);
+	CHECK(root.type() == seir::StNode::Type::Object);
+	CHECK(root.text().empty());
+	CHECK_FALSE(root.next());
+	CHECK(::texts(root.first()) == std::vector<std::string_view>{ "name", "items", "empty", "object", "name" });
+
+	const auto name = root.find("name");
+	REQUIRE(name);
+	CHECK(name.type() == seir::StNode::Type::Key);
+	CHECK(::texts(name.first()) == std::vector<std::string_view>{ "first" });
+	const auto secondName = name.nextSame();
+	REQUIRE(secondName);
+	CHECK(::texts(secondName.first()) == std::vector<std::string_view>{ "second", "third" });
+	CHECK_FALSE(secondName.nextSame());
+
+	const auto items = root.find("items");
+	REQUIRE(items);
+	CHECK_FALSE(items.nextSame());
+	const auto list = items.first();
+	REQUIRE(list);
+	CHECK(list.type() == seir::StNode::Type::List);
+	CHECK(list.next().text() == "5");
+	CHECK_FALSE(list.find("key"));
+	const auto one = list.first();
+	CHECK(one.type() == seir::StNode::Type::Value);
+	CHECK(one.text() == "1");
+	CHECK_FALSE(one.first());
+	const auto innerList = one.next();
+	CHECK(innerList.type() == seir::StNode::Type::List);
+	CHECK(::texts(innerList.first()) == std::vector<std::string_view>{ "2", "3" });
+	const auto innerObject = innerList.next();
+	REQUIRE(innerObject);
+	CHECK(innerObject.type() == seir::StNode::Type::Object);
+	CHECK_FALSE(innerObject.next());
+	CHECK(innerObject.find("key").first().text() == "4");
+
+	const auto empty = root.find("empty");
+	REQUIRE(empty);
+	CHECK_FALSE(empty.first());
+	CHECK(empty.next().text() == "object");
+
+	const auto object = root.find("object").first();
+	REQUIRE(object);
+	const auto innerName = object.find("name");
+	CHECK(::texts(innerName.first()) == std::vector<std::string_view>{ "inner" });
+	CHECK(::texts(innerName.nextSame().first()) == std::vector<std::string_view>{ "second inner" });
+	CHECK_FALSE(innerName.nextSame().nextSame());
+	CHECK(object.find("child").first().find("name").first().text() == "deep");
+	CHECK_FALSE(object.find("key"));
+	CHECK_FALSE(object.find("items"));
+	CHECK_FALSE(root.find("child"));
+	CHECK_FALSE(root.find("missing"));
+
+	const seir::StNode null;
+	CHECK_FALSE(null.find("name"));
+	CHECK_FALSE(null.first());
+	CHECK_FALSE(null.next());
+	CHECK_FALSE(null.nextSame());
+	CHECK(null.text().empty());
+}
+
+TEST_CASE("StDocument(empty)")
+{
+	const seir::StDocument document{ seir::Blob::from("", 0) };
+	const auto root = document.root();
+	REQUIRE(root);
+	CHECK_FALSE(root.first());
+	CHECK_FALSE(root.find("key"));
+}
+
+TEST_CASE("StDocument(error)")
+{
+	constexpr std::string_view text = "key {\n  \"value\"\n}";
+	try
+	{
+		seir::StDocument document{ seir::Blob::from(text.data(), text.size()) };
+		CHECK(false);
+	}
+	catch (const seir::StStreamError& e)
+	{
+		CHECK(e.line() == 2);
+		CHECK(e.column() == 3);
+	}
+}
+
+TEST_CASE("StDocument(unterminated)")
+{
+	for (const std::string_view text : { "key {", "key [", "key { nested \"value\"", "key [ { nested [" })
+	{
+		CAPTURE(text);
+		CHECK_THROWS_AS(seir::StDocument(seir::Blob::from(text.data(), text.size())), seir::StStreamError);
+	}
+}
+
+TEST_CASE("StDocument(many keys)")
+{
+	std::string text;
+	for (int i = 0; i < 1000; ++i)
+		text += "key" + std::to_string(i % 300) + " \"" + std::to_string(i) + "\"\n";
+	const seir::StDocument document{ seir::Blob::from(text.data(), text.size()) };
+	for (int i = 0; i < 300; ++i)
+	{
+		auto key = document.root().find("key" + std::to_string(i));
+		for (int j = i; j < 1000; j += 300)
+		{
+			REQUIRE(key);
+			CHECK(key.first().text() == std::to_string(j));
+			key = key.nextSame();
+		}
+		CHECK_FALSE(key);
+	}
+}
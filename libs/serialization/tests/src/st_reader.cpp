@@ -47,7 +47,8 @@ TEST_CASE("StReader::StReader")
 TEST_CASE("StReader::read")
 {
 	const auto check = [](std::string_view data, const std::vector<seir::StToken>& tokens) {
-		seir::StReader reader{ seir::Blob::from(data.data(), data.size()) };
+		const std::vector<char> buffer(data.begin(), data.end()); // Not null-terminated.
+		seir::StReader reader{ seir::Blob::from(buffer.data(), buffer.size()) };
 		for (const auto& token : tokens)
 		{
 			CHECK(reader.read() == token);
@@ -318,3 +319,19 @@ TEST_CASE("StReader::read")
 		}
 	}
 }
+
+TEST_CASE("StReader::read(SubBlob)")
+{
+	const auto check = [](std::string_view data, size_t size, seir::StToken::Type type) {
+		seir::StReader reader{ seir::Blob::from(data.data(), size) };
+		seir::StToken token;
+		do
+			token = reader.read();
+		while (token.type() != seir::StToken::Type::End && token.type() != seir::StToken::Type::Error);
+		CHECK(token.type() == type);
+	};
+	check(R"(key "value")", 10, seir::StToken::Type::Error);
+	check(R"(key "value"x)", 11, seir::StToken::Type::End);
+	check("key//", 4, seir::StToken::Type::Error);
+	check("key\r\n", 4, seir::StToken::Type::End);
+}
@@ -0,0 +1,96 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include "../../src/st_tokenizer.hpp"
+
+#include <random>
+#include <string>
+
+#include <doctest/doctest.h>
+
+namespace
+{
+	class StGenerator
+	{
+	public:
+		explicit StGenerator(unsigned seed)
+			: _random{ seed } {}
+
+		std::string generate()
+		{
+			std::string text;
+			const auto fragments = uniform(0, 40);
+			for (size_t i = 0; i < fragments; ++i)
+				switch (uniform(0, 9))
+				{
+				case 0: repeat(text, " \t\v\f", uniform(1, 40)); break;
+				case 1: repeat(text, "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz", uniform(1, 40)); break;
+				case 2:
+				{
+					const char quote = uniform(0, 1) ? '"' : '`';
+					text += quote;
+					repeat(text, "abc ,.'\"`{}[]/", uniform(0, 60));
+					if (uniform(0, 7))
+						text += quote;
+					else
+						text += "\0\n\r"[uniform(0, 2)];
+					break;
+				}
+				case 3:
+					text += "//";
+					repeat(text, "abc /\"`{}", uniform(0, 80));
+					break;
+				case 4: text += std::string_view{ "\n\r\0", 3 }.substr(uniform(0, 2), uniform(1, 2)); break;
+				case 5: text += "[]{}"[uniform(0, 3)]; break;
+				case 6: text += static_cast<char>(uniform(0, 255)); break;
+				default: text += " key \"value\" "; break;
+				}
+			return text;
+		}
+
+	private:
+		void repeat(std::string& text, std::string_view alphabet, size_t count)
+		{
+			for (size_t i = 0; i < count; ++i)
+				text += alphabet[uniform(0, alphabet.size() - 1)];
+		}
+
+		size_t uniform(size_t min, size_t max)
+		{
+			return std::uniform_int_distribution<size_t>{ min, max }(_random);
+		}
+
+	private:
+		std::mt19937 _random;
+	};
+}
+
+TEST_CASE("StTokenizer")
+{
+	::StGenerator generator{ 1 };
+	size_t tokenCount = 0;
+	for (int i = 0; i < 2000; ++i)
+	{
+		const auto text = generator.generate();
+		for (size_t size = text.size(), step = 1; size > 0; size -= std::min(size, step), step += 7)
+		{
+			seir::StTokenizer<false> scalar{ text.data(), size };
+			seir::StTokenizer<true> vectorized{ text.data(), size };
+			for (;;)
+			{
+				const auto expected = scalar.read();
+				const auto actual = vectorized.read();
+				CHECK(actual.type() == expected.type());
+				CHECK(actual.line() == expected.line());
+				CHECK(actual.column() == expected.column());
+				CHECK(actual.text().data() == expected.text().data());
+				CHECK(actual.text().size() == expected.text().size());
+				if (expected.type() == seir::StToken::Type::End || expected.type() == seir::StToken::Type::Error || actual.type() != expected.type())
+					break;
+				++tokenCount;
+			}
+		}
+	}
+	CHECK(tokenCount > 10'000);
+}
@@ -4,7 +4,12 @@
 
 #include <seir_serialization/st_writer.hpp>
 
+#include <seir_base/buffer.hpp>
+#include <seir_io/buffer_writer.hpp>
+
+#include <algorithm>
 #include <functional>
+#include <limits>
 
 #include <doctest/doctest.h>
 
@@ -24,8 +29,22 @@ TEST_CASE("StWriter")
 				const std::string separator(64, '-');
 				return '\n' + separator + '\n' + value + separator + '\n';
 			};
+			const auto stream = [&usage](seir::StWriter::Formatting formatting, size_t bufferSize) {
+				seir::Buffer buffer;
+				uint64_t size = 0;
+				seir::BufferWriter writer{ buffer, &size };
+				seir::StWriter stWriter{ writer, formatting, bufferSize };
+				usage(stWriter);
+				CHECK(stWriter.finish());
+				return std::string{ reinterpret_cast<const char*>(buffer.data()), static_cast<size_t>(size) };
+			};
 			CHECK(wrap(write(seir::StWriter::Formatting::Compact)) == wrap(expectedCompact));
 			CHECK(wrap(write(seir::StWriter::Formatting::Pretty)) == wrap(expectedPretty));
+			for (const auto bufferSize : { size_t{ 1 }, size_t{ 5 } })
+			{
+				CHECK(wrap(stream(seir::StWriter::Formatting::Compact, bufferSize)) == wrap(expectedCompact));
+				CHECK(wrap(stream(seir::StWriter::Formatting::Pretty, bufferSize)) == wrap(expectedPretty));
+			}
 		};
 		SUBCASE("empty")
 		{
@@ -402,3 +421,69 @@ TEST_CASE("StWriter")
 		check([](seir::StWriter& w) { CHECK_NOTHROW(w.addKey("key")); CHECK_NOTHROW(w.beginObject()); w.finish(); });
 	}
 }
+
+TEST_CASE("StWriter(Writer&)")
+{
+	struct TestWriter final : seir::Writer
+	{
+		std::string _data;
+		size_t _maxWrite = 0;
+		size_t _writes = 0;
+		size_t _failAt = std::numeric_limits<size_t>::max();
+		bool flush() noexcept override { return true; }
+		bool reserveImpl(uint64_t) noexcept override { return true; }
+		bool writeImpl(uint64_t offset, const void* data, size_t size) noexcept override
+		{
+			if (_writes++ == _failAt || offset != _data.size())
+				return false;
+			_data.append(static_cast<const char*>(data), size);
+			_maxWrite = std::max(_maxWrite, size);
+			return true;
+		}
+	};
+
+	std::string longValue(1000, 'a');
+	std::string escapedValue(1000, '"');
+	for (size_t i = 0; i < longValue.size(); i += 37)
+		longValue[i] = '\\';
+	const auto usage = [&](seir::StWriter& w) {
+		w.addKey("key");
+		w.beginList();
+		for (int i = 0; i < 100; ++i)
+		{
+			w.addValue(longValue);
+			w.addValue(escapedValue);
+			w.addValue(std::string_view{ longValue }.substr(1, 36));
+		}
+		w.endList();
+	};
+
+	std::string expected;
+	{
+		seir::StWriter writer{ expected, seir::StWriter::Formatting::Pretty };
+		usage(writer);
+		writer.finish();
+	}
+	constexpr size_t bufferSize = 256;
+	SUBCASE("success")
+	{
+		TestWriter writer;
+		{
+			seir::StWriter stWriter{ writer, seir::StWriter::Formatting::Pretty, bufferSize };
+			usage(stWriter);
+			CHECK(writer._data.size() > expected.size() - 2 * bufferSize); // Most of the data is written before finishing.
+			CHECK(stWriter.finish());
+		}
+		CHECK(writer._data == expected);
+		CHECK(writer._maxWrite < 2 * bufferSize);
+	}
+	SUBCASE("failure")
+	{
+		TestWriter writer;
+		writer._failAt = 3;
+		seir::StWriter stWriter{ writer, seir::StWriter::Formatting::Pretty, bufferSize };
+		usage(stWriter);
+		CHECK_FALSE(stWriter.finish());
+		CHECK(writer._writes == 4);
+	}
+}
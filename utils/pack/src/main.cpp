@@ -4,14 +4,16 @@
 
 #include <seir_compression/compression.hpp>
 #include <seir_io/blob.hpp>
-#include <seir_io/writer.hpp>
+#include <seir_io/buffered_writer.hpp>
 #include <seir_package/archive.hpp>
 #include <seir_serialization/st_stream.hpp>
 #include <seir_u8main/u8main.hpp>
 
+#include <charconv>
 #include <cstring>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace
@@ -40,6 +42,7 @@ namespace
 			std::vector<std::string> _files;
 		};
 		seir::Compression _compression = seir::Compression::None;
+		size_t _dictionarySize = 0;
 		std::vector<FileGroup> _groups;
 	};
 
@@ -52,8 +55,22 @@ namespace
 		seir::StStream stream{ reader };
 		if (stream.tryKey("compressor"))
 		{
-			check(stream.value() == "zlib", "Bad compression algorithm");
-			result._compression = seir::Compression::Zlib;
+			if (const auto compressor = stream.value(); compressor == "lz4")
+				result._compression = seir::Compression::Lz4;
+			else if (compressor == "zstd")
+				result._compression = seir::Compression::Zstd;
+			else
+			{
+				check(compressor == "zlib", "Bad compression algorithm");
+				result._compression = seir::Compression::Zlib;
+			}
+		}
+		if (stream.tryKey("dictionary"))
+		{
+			const auto value = stream.value();
+			const auto end = value.data() + value.size();
+			const auto [ptr, ec] = std::from_chars(value.data(), end, result._dictionarySize);
+			check(ec == std::errc{} && ptr == end, "Bad dictionary size");
 		}
 		while (!stream.tryEnd())
 		{
@@ -116,7 +133,14 @@ int u8main(int argc, char** argv)
 				std::cerr << "ERROR: Unable to open " << packagePath << " for writing\n";
 				return 1;
 			}
-			auto packageWriter = seir::Archiver::create(std::move(fileWriter), index._compression);
+			auto bufferedWriter = seir::makeUnique<seir::Writer, seir::BufferedWriter>(std::move(fileWriter), seir::BufferedWriterOptions{ ._bufferSize = 1 << 20, ._async = true });
+			auto& packageFile = static_cast<seir::BufferedWriter&>(*bufferedWriter);
+			auto packageWriter = seir::Archiver::create(std::move(bufferedWriter), index._compression, index._dictionarySize, std::thread::hardware_concurrency());
+			if (!packageWriter)
+			{
+				std::cerr << "ERROR: Unsupported compression algorithm\n";
+				return 1;
+			}
 			bool failed = false;
 			std::cerr << "Writing " << packagePath << "...\n";
 			for (const auto& group : index._groups)
@@ -132,7 +156,7 @@ int u8main(int argc, char** argv)
 						failed = true;
 						break;
 					}
-			if (failed || !packageWriter->finish())
+			if (failed || !packageWriter->finish() || !packageFile.flushBuffer()) // Buffered write errors aren't reported otherwise.
 			{
 				std::cerr << "ERROR: Unable to write " << packagePath << '\n';
 				packageWriter.reset();
@@ -0,0 +1,99 @@
+// This file is part of Seir.
+// Copyright (C) Sergei Blagodarin.
+// SPDX-License-Identifier: Apache-2.0
+
+#include <seir_io/blob.hpp>
+#include <seir_io/writer.hpp>
+#include <seir_serialization/st_binary_reader.hpp>
+#include <seir_serialization/st_binary_writer.hpp>
+#include <seir_u8main/u8main.hpp>
+
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+namespace
+{
+	int usage()
+	{
+		std::cerr
+			<< "Usage:\n"
+			<< "  seir_st_convert INPUT OUTPUT\n"
+			<< "  seir_st_convert --text INPUT OUTPUT\n"
+			<< "Converts text .st data to binary, or binary .st data to text with --text.\n";
+		return 1;
+	}
+
+	// Passes all tokens from the reader to the writer, which may be either StWriter or StBinaryWriter.
+	template <typename StWriterType>
+	bool convert(seir::StReader& reader, StWriterType& writer)
+	{
+		for (;;)
+		{
+			const auto token = reader.read();
+			switch (token.type())
+			{
+			case seir::StToken::Type::Error:
+				std::cerr << "ERROR: Bad token at " << token.line() << ':' << token.column() << '\n';
+				return false;
+			case seir::StToken::Type::End: return true;
+			case seir::StToken::Type::Key: writer.addKey(token.text()); break;
+			case seir::StToken::Type::Value: writer.addValue(token.text()); break;
+			case seir::StToken::Type::ListBegin: writer.beginList(); break;
+			case seir::StToken::Type::ListEnd: writer.endList(); break;
+			case seir::StToken::Type::ObjectBegin: writer.beginObject(); break;
+			case seir::StToken::Type::ObjectEnd: writer.endObject(); break;
+			}
+		}
+	}
+
+	auto toPath(const char* path) { return std::filesystem::path{ reinterpret_cast<const char8_t*>(path) }; }
+}
+
+int u8main(int argc, char** argv)
+{
+	const bool toText = argc == 4 && !std::strcmp(argv[1], "--text");
+	if (argc != (toText ? 4 : 3))
+		return usage();
+	const std::string inputPath = argv[argc - 2];
+	const auto outputPath = ::toPath(argv[argc - 1]);
+	const auto blob = seir::Blob::from(inputPath);
+	if (!blob)
+	{
+		std::cerr << "ERROR: Unable to open " << inputPath << '\n';
+		return 1;
+	}
+	const auto writer = seir::Writer::create(outputPath);
+	if (!writer)
+	{
+		std::cerr << "ERROR: Unable to open " << outputPath << " for writing\n";
+		return 1;
+	}
+	bool written = false;
+	try
+	{
+		if (toText)
+		{
+			seir::StBinaryReader reader{ blob };
+			seir::StWriter stWriter{ *writer, seir::StWriter::Formatting::Pretty };
+			written = ::convert(reader, stWriter) && stWriter.finish() && writer->flush();
+		}
+		else
+		{
+			seir::StReader reader{ blob };
+			seir::StBinaryWriter stWriter;
+			written = ::convert(reader, stWriter) && stWriter.finish(*writer) && writer->flush();
+		}
+	}
+	catch (const seir::StWriter::BadToken&)
+	{
+		std::cerr << "ERROR: Unexpected end of data\n";
+	}
+	if (!written)
+	{
+		std::cerr << "ERROR: Unable to convert " << inputPath << '\n';
+		return 1;
+	}
+	return 0;
+}